@@ -13,10 +13,12 @@ Texture2D gColorTex : SourceTexture
 <
     string UIName = "Color Texture";
 > = NULL;
-// Color texture sampler.
+// Color texture sampler. Bilinear, the color texture is smaller than the viewport with dynamic resolution.
 SamplerState gColorSampler 
 {
-   FILTER = MIN_MAG_MIP_POINT;
+   FILTER = MIN_MAG_LINEAR_MIP_POINT;
+   AddressU = Clamp;
+   AddressV = Clamp;
 };
 
 // Disable alpha output.
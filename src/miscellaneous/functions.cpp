@@ -41,15 +41,6 @@ namespace wmr::func
 #endif
 	}
 
-	size_t HashCString(const char * str)
-	{
-		size_t h = 5381;
-		int c;
-		while ((c = *str++))
-			h = ((h << 5) + h) + c;
-		return h;
-	}
-
 	std::uint32_t RoundUpToNearestMultiple(std::uint32_t input, std::uint32_t multiple)
 	{
 		if (multiple == 0)
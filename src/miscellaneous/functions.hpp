@@ -48,12 +48,6 @@ namespace wmr
 		 *  /param msg The message to log to the output. */
 		void LogDebug(const char* msg);
 
-		//! Hash a c-string
-		/*! Implementation from: http://www.cse.yorku.ca/~oz/hash.html .
-		 * 
-		 *  \param str The string to hash. */
-		size_t HashCString(const char* str);
-
 		// https://stackoverflow.com/a/3407254
 		//! Round the input number to the nearest multiple of the specified number
 		/*! \param input Number to round.
@@ -0,0 +1,123 @@
+// Copyright 2019 Breda University of Applied Sciences and Team Wisp (Viktor Zoutman, Emilio Laiso, Jens Hagen, Meine Zeinstra, Tahar Meijs, Koen Buitenhuis, Niels Brunekreef, Darius Bouma, Florian Schut)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "profiler.hpp"
+
+// C++ standard
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace wmr
+{
+	RollingTimingStatistics::RollingTimingStatistics(std::size_t window_size)
+		: m_window_size(std::max<std::size_t>(window_size, 1))
+		, m_next_sample(0)
+	{
+		m_samples.reserve(m_window_size);
+	}
+
+	void RollingTimingStatistics::AddSample(double time)
+	{
+		if (m_samples.size() < m_window_size)
+		{
+			m_samples.push_back(time);
+			return;
+		}
+
+		m_samples[m_next_sample] = time;
+		m_next_sample = (m_next_sample + 1) % m_window_size;
+	}
+
+	TimingStatistics RollingTimingStatistics::GetStatistics() const
+	{
+		TimingStatistics statistics;
+		statistics.m_sample_count = m_samples.size();
+
+		if (m_samples.empty())
+		{
+			return statistics;
+		}
+
+		statistics.m_min = *std::min_element(m_samples.begin(), m_samples.end());
+		statistics.m_average = std::accumulate(m_samples.begin(), m_samples.end(), 0.0) / static_cast<double>(m_samples.size());
+
+		// Nearest-rank percentile
+		auto sorted = m_samples;
+		const auto rank = static_cast<std::size_t>(std::ceil(0.95 * static_cast<double>(sorted.size())));
+		const auto p95 = sorted.begin() + (std::max<std::size_t>(rank, 1) - 1);
+
+		std::nth_element(sorted.begin(), p95, sorted.end());
+		statistics.m_p95 = *p95;
+
+		return statistics;
+	}
+
+	void RollingTimingStatistics::Reset() noexcept
+	{
+		m_samples.clear();
+		m_next_sample = 0;
+	}
+
+	Profiler::Profiler(std::size_t window_size)
+		: m_window_size(window_size)
+	{
+	}
+
+	void Profiler::AddSample(const std::string& name, double time)
+	{
+		auto timer = m_timer_indices.find(name);
+
+		if (timer == m_timer_indices.end())
+		{
+			timer = m_timer_indices.emplace(name, m_timers.size()).first;
+			m_timers.emplace_back(name, RollingTimingStatistics(m_window_size));
+		}
+
+		m_timers[timer->second].second.AddSample(time);
+	}
+
+	std::vector<std::pair<std::string, TimingStatistics>> Profiler::GetStatistics() const
+	{
+		std::vector<std::pair<std::string, TimingStatistics>> statistics;
+		statistics.reserve(m_timers.size());
+
+		for (const auto& timer : m_timers)
+		{
+			statistics.emplace_back(timer.first, timer.second.GetStatistics());
+		}
+
+		return statistics;
+	}
+
+	void Profiler::Reset() noexcept
+	{
+		m_timers.clear();
+		m_timer_indices.clear();
+	}
+
+	ScopedCPUTimer::ScopedCPUTimer(Profiler& profiler, const char* name)
+		: m_profiler(profiler)
+		, m_name(name)
+		, m_start_time(std::chrono::steady_clock::now())
+	{
+	}
+
+	ScopedCPUTimer::~ScopedCPUTimer()
+	{
+		const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - m_start_time;
+		m_profiler.AddSample(m_name, elapsed.count());
+	}
+}
@@ -0,0 +1,101 @@
+// Copyright 2019 Breda University of Applied Sciences and Team Wisp (Viktor Zoutman, Emilio Laiso, Jens Hagen, Meine Zeinstra, Tahar Meijs, Koen Buitenhuis, Niels Brunekreef, Darius Bouma, Florian Schut)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+// C++ standard
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+//! Generic plug-in namespace (Wisp Maya Renderer)
+namespace wmr
+{
+	//! Summary of the samples in a rolling window, in milliseconds
+	struct TimingStatistics
+	{
+		double m_min = 0.0;					//!< Shortest sample
+		double m_average = 0.0;				//!< Mean of all samples
+		double m_p95 = 0.0;					//!< 95th percentile, 95% of the samples are not longer than this
+		std::size_t m_sample_count = 0;		//!< Number of samples in the window
+	};
+
+	//! Keeps the newest samples of a single timer
+	class RollingTimingStatistics
+	{
+	public:
+		//! \param window_size Number of samples kept, older samples are overwritten (at least one).
+		explicit RollingTimingStatistics(std::size_t window_size = 120);
+		~RollingTimingStatistics() = default;
+
+		//! Add a sample in milliseconds
+		void AddSample(double time);
+
+		//! Statistics of the samples in the window, all zero when there are no samples
+		TimingStatistics GetStatistics() const;
+
+		//! Forget all samples
+		void Reset() noexcept;
+
+	private:
+		std::vector<double> m_samples;	//!< Ring buffer of samples
+		std::size_t m_window_size;		//!< Capacity of the ring buffer
+		std::size_t m_next_sample;		//!< Index the next sample is written to once the window is full
+	};
+
+	//! Collects CPU and GPU timings of the plug-in by name
+	/*! Timers are reported in the order in which they were first sampled. Not thread-safe, only sample on the main
+	 *  thread (Maya callbacks and render operations run there). */
+	class Profiler
+	{
+	public:
+		//! \param window_size Number of samples kept per timer.
+		explicit Profiler(std::size_t window_size = 120);
+		~Profiler() = default;
+
+		//! Add a sample in milliseconds to the timer with the specified name
+		void AddSample(const std::string& name, double time);
+
+		//! Statistics of every timer, in the order in which the timers were first sampled
+		std::vector<std::pair<std::string, TimingStatistics>> GetStatistics() const;
+
+		//! Remove all timers
+		void Reset() noexcept;
+
+	private:
+		std::size_t m_window_size;
+		std::vector<std::pair<std::string, RollingTimingStatistics>> m_timers;	//!< Timers in the order they were added
+		std::unordered_map<std::string, std::size_t> m_timer_indices;			//!< Index into m_timers by name
+	};
+
+	//! Adds the time between construction and destruction of the timer to a profiler
+	class ScopedCPUTimer
+	{
+	public:
+		ScopedCPUTimer(Profiler& profiler, const char* name);
+		~ScopedCPUTimer();
+
+		ScopedCPUTimer(const ScopedCPUTimer&) = delete;
+		ScopedCPUTimer& operator=(const ScopedCPUTimer&) = delete;
+
+	private:
+		Profiler& m_profiler;
+		const char* m_name;
+		std::chrono::steady_clock::time_point m_start_time;
+	};
+}
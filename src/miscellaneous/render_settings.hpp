@@ -9,6 +9,7 @@
 #include <render_tasks/d3d12_shadow_denoiser_task.hpp>
 
 // STD includes
+#include <optional>
 #include <string>
 
 //! Generic plug-in namespace (Wisp Maya Renderer)
@@ -22,6 +23,12 @@ namespace wmr
 	template<typename T>
 	inline std::optional<T> GetRenderSettings(wr::FrameGraph* frame_graph)
 	{
+		// Pipelines are created lazily, the frame graph may not exist yet
+		if (!frame_graph)
+		{
+			return std::nullopt;
+		}
+
 		// Ray Tracing Ambient Oclussion settings
 		if constexpr (std::is_same<wr::RTAOSettings, T>::value)
 		{
@@ -82,6 +89,11 @@ namespace wmr
 	template<typename T>
 	inline void SetRenderSettings(wr::FrameGraph* frame_graph, T &settings)
 	{
+		if (!frame_graph)
+		{
+			return;
+		}
+
 		// Ray Tracing Ambient Oclussion settings
 		if constexpr (std::is_same<wr::RTAOSettings, T>::value)
 		{
@@ -131,4 +143,69 @@ namespace wmr
 			}
 		}
 	}
-}
\ No newline at end of file
+
+	//! Runtime settings of all configurable tasks in a frame graph
+	/*! The frame graph manager keeps one for every pipeline to carry the settings over when a frame graph is created
+	 *  again or rebuilt, settings of absent tasks stay empty. */
+	struct RenderSettingsSnapshot
+	{
+		std::optional<wr::BloomSettings> m_bloom;
+		std::optional<wr::HBAOSettings> m_hbao;
+		std::optional<wr::RTAOSettings> m_rtao;
+		std::optional<wr::ASBuildSettings> m_as_build;
+		std::optional<wr::RTShadowSettings> m_rt_shadow;
+		std::optional<wr::ShadowDenoiserSettings> m_shadow_denoiser;
+	};
+
+	//! Gets the settings of every configurable task in the framegraph
+	inline RenderSettingsSnapshot CaptureRenderSettings(wr::FrameGraph* frame_graph)
+	{
+		RenderSettingsSnapshot snapshot;
+		snapshot.m_bloom = GetRenderSettings<wr::BloomSettings>(frame_graph);
+		snapshot.m_hbao = GetRenderSettings<wr::HBAOSettings>(frame_graph);
+		snapshot.m_rtao = GetRenderSettings<wr::RTAOSettings>(frame_graph);
+		snapshot.m_as_build = GetRenderSettings<wr::ASBuildSettings>(frame_graph);
+		snapshot.m_rt_shadow = GetRenderSettings<wr::RTShadowSettings>(frame_graph);
+		snapshot.m_shadow_denoiser = GetRenderSettings<wr::ShadowDenoiserSettings>(frame_graph);
+
+		return snapshot;
+	}
+
+	//! Sets the captured settings on the tasks the framegraph has
+	inline void RestoreRenderSettings(wr::FrameGraph* frame_graph, RenderSettingsSnapshot& snapshot)
+	{
+		auto restore = [frame_graph](auto& settings)
+		{
+			if (settings.has_value())
+			{
+				SetRenderSettings(frame_graph, settings.value());
+			}
+		};
+
+		restore(snapshot.m_bloom);
+		restore(snapshot.m_hbao);
+		restore(snapshot.m_rtao);
+		restore(snapshot.m_as_build);
+		restore(snapshot.m_rt_shadow);
+		restore(snapshot.m_shadow_denoiser);
+	}
+
+	//! Fills the empty settings of a snapshot with the settings of another snapshot
+	inline void FillMissingRenderSettings(RenderSettingsSnapshot& snapshot, const RenderSettingsSnapshot& defaults)
+	{
+		auto fill = [](auto& settings, const auto& default_settings)
+		{
+			if (!settings.has_value())
+			{
+				settings = default_settings;
+			}
+		};
+
+		fill(snapshot.m_bloom, defaults.m_bloom);
+		fill(snapshot.m_hbao, defaults.m_hbao);
+		fill(snapshot.m_rtao, defaults.m_rtao);
+		fill(snapshot.m_as_build, defaults.m_as_build);
+		fill(snapshot.m_rt_shadow, defaults.m_rt_shadow);
+		fill(snapshot.m_shadow_denoiser, defaults.m_shadow_denoiser);
+	}
+}
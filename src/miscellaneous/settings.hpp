@@ -26,12 +26,105 @@ namespace wmr
 	//! Holds all global settings for the plug-in
 	namespace settings
 	{
-		//! Maximum amount of vertex data in the model pool in MB
+		//! Amount of vertex data in a single model pool page in MB (pages for larger models are sized to fit)
 		static const constexpr std::uint32_t MAX_VERTEX_DATA_SIZE_MB = 4MB;
 
-		//! Maximum amount of index data in the model pool in MB
+		//! Amount of index data in a single model pool page in MB (pages for larger models are sized to fit)
 		static const constexpr std::uint32_t MAX_INDEX_DATA_SIZE_MB = 1MB;
 
+		//! Model pool pages with a lower occupancy than this are emptied into other pages during idle frames
+		static const constexpr float MODEL_POOL_COMPACTION_OCCUPANCY = 0.25f;
+
+		//! Maximum number of models moved to another model pool page per idle frame
+		static const constexpr std::size_t MAX_MODEL_RELOCATIONS_PER_FRAME = 16;
+
+		//! Number of frames the GPU may work on while the CPU prepares the next frame, when the plug-in starts
+		/*! A single frame in flight gives the lowest latency, more frames in flight give a higher frame rate. */
+		static const constexpr std::uint32_t DEFAULT_FRAMES_IN_FLIGHT = 1;
+
+		//! Maximum number of frames in flight (limited by the number of back buffers in Wisp)
+		static const constexpr std::uint32_t MAX_FRAMES_IN_FLIGHT = 3;
+
+		//! Whether the path tracer accumulates samples while the scene and camera are static, when the plug-in starts
+		static const constexpr bool DEFAULT_PROGRESSIVE_ACCUMULATION = false;
+
+		//! Number of accumulated path tracer samples per pixel after which the image counts as converged
+		/*! Rendering stops once this many samples have been accumulated, until the scene or camera changes again. */
+		static const constexpr std::uint32_t PROGRESSIVE_ACCUMULATION_TARGET_SAMPLE_COUNT = 512;
+
+		//! Whether the render resolution follows the GPU frame time budget, when the plug-in starts
+		static const constexpr bool DEFAULT_DYNAMIC_RESOLUTION = false;
+
+		//! GPU frame time budget of the dynamic resolution in milliseconds, when the plug-in starts
+		static const constexpr double DEFAULT_GPU_FRAME_TIME_BUDGET = 16.6;
+
+		//! Lowest fraction of the viewport resolution the dynamic resolution renders at
+		static const constexpr double DYNAMIC_RESOLUTION_MIN_SCALE = 0.5;
+
+		//! Time in milliseconds the viewport size has to stay the same before the frame graphs are resized
+		/*! Dragging a panel changes its size every refresh, until then the old render textures are stretched to fit. */
+		static const constexpr std::uint32_t VIEWPORT_RESIZE_DEBOUNCE_INTERVAL_MS = 150;
+
+		//! Seconds after which a rendering pipeline that is not used anymore is released, zero keeps every pipeline alive
+		/*! Render settings changed through the UI are kept and applied when a released pipeline is created again. */
+		static const constexpr std::uint32_t INACTIVE_PIPELINE_RELEASE_DELAY_S = 0;
+
+		//! Whether the GPU time of every frame graph task is measured when the plug-in starts, instead of the entire frame
+		static const constexpr bool DEFAULT_GPU_TASK_TIMING = false;
+
+		//! Whether the timing statistics are drawn on top of the viewport when the plug-in starts
+		static const constexpr bool DEFAULT_TIMING_HUD = false;
+
+		//! Number of samples the timing statistics (min / average / 95th percentile) are computed over
+		static const constexpr std::size_t TIMING_STATISTICS_WINDOW = 120;
+
+		//! Bound to material texture slots while their textures are decoded in the background
+		static const constexpr char* PLACEHOLDER_TEXTURE_PATH = "./resources/materials/white.png";
+
+		//! Bound to material normal map slots while their textures are decoded in the background
+		static const constexpr char* PLACEHOLDER_NORMAL_TEXTURE_PATH = "./resources/materials/flat_normal.png";
+
+		//! Maximum number of decoded textures uploaded to the GPU per frame, spreads the upload of a scene over frames
+		static const constexpr std::size_t MAX_TEXTURE_UPLOADS_PER_FRAME = 8;
+
+		//! GPU memory in MB the material textures should fit in when the plug-in starts
+		/*! Half of an 8 GB card, the other half is left for the meshes, the render targets, and Maya itself. */
+		static const constexpr std::uint32_t DEFAULT_TEXTURE_MEMORY_BUDGET_MB = 4096;
+
+		//! Width and height below which no mip levels are dropped to fit the texture memory budget
+		static const constexpr std::uint32_t MIN_STREAMED_TEXTURE_SIZE = 128;
+
+		//! Maximum number of textures loaded again with fewer or more mip levels per frame
+		static const constexpr std::size_t MAX_TEXTURE_RESIDENCY_CHANGES_PER_FRAME = 2;
+
+		//! Directory the block-compressed, mip-mapped copies of material textures are cached in
+		/*! Copies of edited files are made again, clear the directory to reclaim the disk space of outdated copies. */
+		static const constexpr char* TEXTURE_CACHE_DIRECTORY = "wisp_texture_cache";
+
+		//! Maximum number of cached copies of textures queued for building, further misses are built when they miss again
+		static const constexpr std::size_t MAX_PENDING_TEXTURE_CACHE_BUILDS = 64;
+
+		//! File the trace of plug-in activity is written to when a trace recording stops (wisp_handle_ui_input -trace off)
+		/*! Open the file in chrome://tracing or https://ui.perfetto.dev to inspect the timeline of every thread. */
+		static const constexpr char* TRACE_FILE_PATH = "wisp_trace.json";
+
+		//! Pipeline description files of the frame graphs, in the order of RendererFrameGraphType
+		/*! Edit these files to build lighter pipelines without recompiling the plug-in. */
+		static const constexpr std::array<const char*, 3> PIPELINE_DESCRIPTION_FILES =
+		{
+			"resources/pipelines/deferred.pipeline",
+			"resources/pipelines/hybrid_ray_tracing.pipeline",
+			"resources/pipelines/progressive_path_tracing.pipeline"
+		};
+
+		//! Pipeline description file of the deferred frame graph on low-end workstations, without ambient occlusion and depth of field
+		/*! Used instead of the deferred entry of PIPELINE_DESCRIPTION_FILES when the low-end pipeline is selected
+		 *  (wisp_handle_ui_input -low_end_pipeline on). */
+		static const constexpr char* LOW_END_DEFERRED_PIPELINE_DESCRIPTION_FILE = "resources/pipelines/deferred_low_end.pipeline";
+
+		//! Whether the deferred frame graph uses LOW_END_DEFERRED_PIPELINE_DESCRIPTION_FILE when the plug-in starts
+		static const constexpr bool DEFAULT_LOW_END_DEFERRED_PIPELINE = false;
+
 		//! Name of the studio / company developing this product
 		static const constexpr char* COMPANY_NAME = "Team Wisp";
 
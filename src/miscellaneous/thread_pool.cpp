@@ -0,0 +1,147 @@
+// Copyright 2019 Breda University of Applied Sciences and Team Wisp (Viktor Zoutman, Emilio Laiso, Jens Hagen, Meine Zeinstra, Tahar Meijs, Koen Buitenhuis, Niels Brunekreef, Darius Bouma, Florian Schut)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "thread_pool.hpp"
+
+// C++ standard
+#include <algorithm>
+#include <exception>
+
+namespace wmr
+{
+	ThreadPool::ThreadPool(std::size_t thread_count)
+		: m_stop(false)
+	{
+		thread_count = std::max<std::size_t>(thread_count, 1);
+
+		m_workers.reserve(thread_count);
+		for (std::size_t i = 0; i < thread_count; ++i)
+		{
+			m_workers.emplace_back(&ThreadPool::WorkerThread, this);
+		}
+	}
+
+	ThreadPool::~ThreadPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_stop = true;
+		}
+
+		m_condition.notify_all();
+
+		for (auto& worker : m_workers)
+		{
+			worker.join();
+		}
+	}
+
+	std::future<void> ThreadPool::Enqueue(std::function<void()> task)
+	{
+		std::packaged_task<void()> packaged_task(std::move(task));
+		auto future = packaged_task.get_future();
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_tasks.push(std::move(packaged_task));
+		}
+
+		m_condition.notify_one();
+
+		return future;
+	}
+
+	std::size_t ThreadPool::GetThreadCount() const noexcept
+	{
+		return m_workers.size();
+	}
+
+	void ThreadPool::ParallelFor(std::size_t count, std::size_t chunk_count, const std::function<void(std::size_t chunk, std::size_t begin, std::size_t end)>& function)
+	{
+		if (count == 0)
+		{
+			return;
+		}
+
+		chunk_count = std::clamp<std::size_t>(chunk_count, 1, count);
+
+		// Spread the remainder over the first chunks, so chunk sizes differ by one item at most
+		auto chunk_begin = [count, chunk_count](std::size_t chunk) -> std::size_t
+		{
+			return (count / chunk_count) * chunk + std::min(chunk, count % chunk_count);
+		};
+
+		std::vector<std::future<void>> futures;
+		futures.reserve(chunk_count - 1);
+
+		for (std::size_t chunk = 1; chunk < chunk_count; ++chunk)
+		{
+			futures.push_back(Enqueue([&function, chunk, begin = chunk_begin(chunk), end = chunk_begin(chunk + 1)]()
+			{
+				function(chunk, begin, end);
+			}));
+		}
+
+		// The calling thread takes care of the first chunk
+		std::exception_ptr first_chunk_exception;
+
+		try
+		{
+			function(0, chunk_begin(0), chunk_begin(1));
+		}
+		catch (...)
+		{
+			first_chunk_exception = std::current_exception();
+		}
+
+		// Wait for every chunk before rethrowing, the function object and the stack of the caller have to outlive all tasks
+		for (auto& future : futures)
+		{
+			future.wait();
+		}
+
+		if (first_chunk_exception)
+		{
+			std::rethrow_exception(first_chunk_exception);
+		}
+
+		for (auto& future : futures)
+		{
+			future.get();
+		}
+	}
+
+	void ThreadPool::WorkerThread()
+	{
+		while (true)
+		{
+			std::packaged_task<void()> task;
+
+			{
+				std::unique_lock<std::mutex> lock(m_mutex);
+				m_condition.wait(lock, [this]() { return m_stop || !m_tasks.empty(); });
+
+				if (m_stop && m_tasks.empty())
+				{
+					return;
+				}
+
+				task = std::move(m_tasks.front());
+				m_tasks.pop();
+			}
+
+			task();
+		}
+	}
+}
@@ -0,0 +1,74 @@
+// Copyright 2019 Breda University of Applied Sciences and Team Wisp (Viktor Zoutman, Emilio Laiso, Jens Hagen, Meine Zeinstra, Tahar Meijs, Koen Buitenhuis, Niels Brunekreef, Darius Bouma, Florian Schut)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+// C++ standard
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+//! Generic plug-in namespace (Wisp Maya Renderer)
+namespace wmr
+{
+	//! Fixed-size pool of worker threads
+	/*! Tasks are executed in the order in which they were enqueued. Tasks running on the pool must never call into the
+	 *  Maya API, as Maya is not thread-safe. Gather all Maya data on the main thread first. */
+	class ThreadPool
+	{
+	public:
+		//! Spawn the worker threads
+		/*! \param thread_count Number of worker threads, at least one thread is always created. */
+		explicit ThreadPool(std::size_t thread_count = std::thread::hardware_concurrency());
+
+		//! Finish all queued tasks and join the worker threads
+		~ThreadPool();
+
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool& operator=(const ThreadPool&) = delete;
+
+		//! Queue a task for execution on one of the worker threads
+		/*! \return Future that becomes ready once the task has finished, exceptions are forwarded through it. */
+		std::future<void> Enqueue(std::function<void()> task);
+
+		//! Number of worker threads in this pool
+		std::size_t GetThreadCount() const noexcept;
+
+		//! Split a range into chunks and process them in parallel
+		/*! The calling thread processes the first chunk itself and blocks until all chunks have been processed. Do not
+		 *  call this function from a task that runs on the same pool, as that can deadlock. When a chunk throws, the
+		 *  exception is rethrown after every chunk has finished.
+		 *
+		 *  \param count Number of items in the range.
+		 *  \param chunk_count Number of chunks to split the range into (clamped to [1, count]).
+		 *  \param function Called once per chunk with the chunk index and the [begin, end) range of the chunk. */
+		void ParallelFor(std::size_t count, std::size_t chunk_count, const std::function<void(std::size_t chunk, std::size_t begin, std::size_t end)>& function);
+
+	private:
+		//! Worker thread loop
+		void WorkerThread();
+
+		std::vector<std::thread> m_workers;				//!< Worker threads
+		std::queue<std::packaged_task<void()>> m_tasks;	//!< Tasks that have not been picked up yet
+
+		std::mutex m_mutex;								//!< Guards the task queue and the stop flag
+		std::condition_variable m_condition;			//!< Signalled when a task is queued or the pool stops
+		bool m_stop;									//!< Set when the pool is being destroyed
+	};
+}
@@ -0,0 +1,299 @@
+// Copyright 2019 Breda University of Applied Sciences and Team Wisp (Viktor Zoutman, Emilio Laiso, Jens Hagen, Meine Zeinstra, Tahar Meijs, Koen Buitenhuis, Niels Brunekreef, Darius Bouma, Florian Schut)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "trace_recorder.hpp"
+
+// C++ standard
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+
+namespace wmr
+{
+	namespace
+	{
+		std::int64_t ToNanoseconds(std::chrono::steady_clock::time_point time) noexcept
+		{
+			return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+		}
+
+		// Recorder IDs start at one, zero marks an empty cache
+		std::atomic<std::uint64_t> next_recorder_id{ 1 };
+
+		// Buffer of the calling thread in the recorder it was last used with
+		struct ThreadBufferCache
+		{
+			std::uint64_t m_recorder_id = 0;
+			void* m_buffer = nullptr;
+		};
+
+		thread_local ThreadBufferCache thread_buffer_cache;
+
+		void WriteJSONString(std::ostream& stream, const char* string)
+		{
+			stream << '"';
+
+			for (auto* character = string; character && *character; ++character)
+			{
+				switch (*character)
+				{
+				case '"':	stream << "\\\""; break;
+				case '\\':	stream << "\\\\"; break;
+				case '\n':	stream << "\\n"; break;
+				case '\t':	stream << "\\t"; break;
+				default:
+					if (static_cast<unsigned char>(*character) < 0x20)
+					{
+						char escaped[8];
+						std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned int>(*character));
+						stream << escaped;
+					}
+					else
+					{
+						stream << *character;
+					}
+					break;
+				}
+			}
+
+			stream << '"';
+		}
+
+		// Microseconds with nanosecond precision
+		void WriteMicroseconds(std::ostream& stream, std::int64_t nanoseconds)
+		{
+			char buffer[32];
+			std::snprintf(buffer, sizeof(buffer), "%lld.%03lld", static_cast<long long>(nanoseconds / 1000), static_cast<long long>(nanoseconds % 1000));
+			stream << buffer;
+		}
+	}
+
+	TraceRecorder::TraceRecorder(std::size_t max_events_per_thread)
+		: m_id(next_recorder_id.fetch_add(1, std::memory_order_relaxed))
+		, m_max_events_per_thread(std::max<std::size_t>(max_events_per_thread, 1))
+		, m_recording(false)
+		, m_session(0)
+		, m_start_time(0)
+	{
+	}
+
+	TraceRecorder& TraceRecorder::GetInstance()
+	{
+		static TraceRecorder instance;
+		return instance;
+	}
+
+	void TraceRecorder::Start() noexcept
+	{
+		m_start_time = ToNanoseconds(std::chrono::steady_clock::now());
+
+		// Every thread resets its own buffer when it records the first event of the new session
+		m_session.fetch_add(1, std::memory_order_acq_rel);
+		m_recording.store(true, std::memory_order_release);
+	}
+
+	void TraceRecorder::Stop() noexcept
+	{
+		m_recording.store(false, std::memory_order_release);
+	}
+
+	bool TraceRecorder::IsRecording() const noexcept
+	{
+		return m_recording.load(std::memory_order_relaxed);
+	}
+
+	void TraceRecorder::AddEvent(const char* name, const char* category, std::chrono::steady_clock::time_point begin, std::chrono::steady_clock::time_point end) noexcept
+	{
+		if (!IsRecording())
+		{
+			return;
+		}
+
+		auto& buffer = GetThreadBuffer();
+
+		const auto session = m_session.load(std::memory_order_acquire);
+
+		if (buffer.m_session.load(std::memory_order_relaxed) != session)
+		{
+			buffer.m_count.store(0, std::memory_order_relaxed);
+			buffer.m_dropped.store(0, std::memory_order_relaxed);
+			buffer.m_session.store(session, std::memory_order_release);
+		}
+
+		const auto count = buffer.m_count.load(std::memory_order_relaxed);
+
+		if (count >= buffer.m_events.size())
+		{
+			buffer.m_dropped.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+
+		auto& event = buffer.m_events[count];
+		event.m_name = name;
+		event.m_category = category;
+		event.m_begin = ToNanoseconds(begin);
+		event.m_duration = ToNanoseconds(end) - event.m_begin;
+
+		// Readers only look at events below the published count
+		buffer.m_count.store(count + 1, std::memory_order_release);
+	}
+
+	std::size_t TraceRecorder::GetEventCount() const
+	{
+		std::size_t event_count = 0;
+
+		ForEachBuffer([&event_count](const ThreadBuffer&, std::size_t count)
+		{
+			event_count += count;
+		});
+
+		return event_count;
+	}
+
+	std::size_t TraceRecorder::GetDroppedEventCount() const
+	{
+		std::size_t dropped_count = 0;
+
+		ForEachBuffer([&dropped_count](const ThreadBuffer& buffer, std::size_t)
+		{
+			dropped_count += buffer.m_dropped.load(std::memory_order_relaxed);
+		});
+
+		return dropped_count;
+	}
+
+	void TraceRecorder::WriteJSON(std::ostream& stream) const
+	{
+		stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+		bool first_event = true;
+
+		auto begin_event = [&stream, &first_event]()
+		{
+			stream << (first_event ? "\n" : ",\n");
+			first_event = false;
+		};
+
+		ForEachBuffer([&](const ThreadBuffer& buffer, std::size_t count)
+		{
+			begin_event();
+			stream << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer.m_thread_index
+				<< ",\"args\":{\"name\":\"Thread " << buffer.m_thread_index << "\"}}";
+
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				const auto& event = buffer.m_events[i];
+
+				begin_event();
+				stream << "{\"name\":";
+				WriteJSONString(stream, event.m_name);
+				stream << ",\"cat\":";
+				WriteJSONString(stream, event.m_category);
+				stream << ",\"ph\":\"X\",\"ts\":";
+				WriteMicroseconds(stream, std::max<std::int64_t>(event.m_begin - m_start_time, 0));
+				stream << ",\"dur\":";
+				WriteMicroseconds(stream, std::max<std::int64_t>(event.m_duration, 0));
+				stream << ",\"pid\":1,\"tid\":" << buffer.m_thread_index << "}";
+			}
+		});
+
+		stream << "\n]}\n";
+	}
+
+	bool TraceRecorder::WriteJSONFile(const std::string& path) const
+	{
+		std::ofstream file(path, std::ios::out | std::ios::trunc);
+
+		if (!file)
+		{
+			return false;
+		}
+
+		WriteJSON(file);
+
+		return static_cast<bool>(file);
+	}
+
+	TraceRecorder::ThreadBuffer& TraceRecorder::GetThreadBuffer()
+	{
+		if (thread_buffer_cache.m_recorder_id == m_id)
+		{
+			return *static_cast<ThreadBuffer*>(thread_buffer_cache.m_buffer);
+		}
+
+		std::lock_guard<std::mutex> lock(m_buffers_mutex);
+
+		const auto thread_id = std::this_thread::get_id();
+
+		auto buffer = std::find_if(m_buffers.begin(), m_buffers.end(), [&thread_id](const std::unique_ptr<ThreadBuffer>& buffer)
+		{
+			return buffer->m_thread_id == thread_id;
+		});
+
+		if (buffer == m_buffers.end())
+		{
+			auto new_buffer = std::make_unique<ThreadBuffer>();
+			new_buffer->m_thread_id = thread_id;
+			new_buffer->m_thread_index = static_cast<std::uint32_t>(m_buffers.size());
+			new_buffer->m_events.resize(m_max_events_per_thread);
+
+			buffer = m_buffers.insert(m_buffers.end(), std::move(new_buffer));
+		}
+
+		thread_buffer_cache.m_recorder_id = m_id;
+		thread_buffer_cache.m_buffer = buffer->get();
+
+		return **buffer;
+	}
+
+	template<typename Function>
+	void TraceRecorder::ForEachBuffer(const Function& function) const
+	{
+		const auto session = m_session.load(std::memory_order_acquire);
+
+		std::lock_guard<std::mutex> lock(m_buffers_mutex);
+
+		for (const auto& buffer : m_buffers)
+		{
+			// Buffers of threads that did not record anything in this session still hold older events
+			if (buffer->m_session.load(std::memory_order_acquire) != session)
+			{
+				continue;
+			}
+
+			function(*buffer, buffer->m_count.load(std::memory_order_acquire));
+		}
+	}
+
+	ScopedTraceEvent::ScopedTraceEvent(const char* name, const char* category, TraceRecorder& recorder) noexcept
+		: m_recorder(recorder)
+		, m_name(name)
+		, m_category(category)
+		, m_active(recorder.IsRecording())
+	{
+		if (m_active)
+		{
+			m_begin = std::chrono::steady_clock::now();
+		}
+	}
+
+	ScopedTraceEvent::~ScopedTraceEvent()
+	{
+		if (m_active)
+		{
+			m_recorder.AddEvent(m_name, m_category, m_begin, std::chrono::steady_clock::now());
+		}
+	}
+}
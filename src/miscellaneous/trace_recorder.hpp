@@ -0,0 +1,139 @@
+// Copyright 2019 Breda University of Applied Sciences and Team Wisp (Viktor Zoutman, Emilio Laiso, Jens Hagen, Meine Zeinstra, Tahar Meijs, Koen Buitenhuis, Niels Brunekreef, Darius Bouma, Florian Schut)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+// C++ standard
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+//! Generic plug-in namespace (Wisp Maya Renderer)
+namespace wmr
+{
+	//! Scoped event on the timeline of a thread
+	struct TraceEvent
+	{
+		const char* m_name = nullptr;		//!< Static string, only the pointer is stored
+		const char* m_category = nullptr;	//!< Static string, only the pointer is stored
+		std::int64_t m_begin = 0;			//!< Steady clock time in nanoseconds
+		std::int64_t m_duration = 0;		//!< Nanoseconds
+	};
+
+	//! Records scoped events of every thread and exports them as a Chrome trace (chrome://tracing or Perfetto)
+	/*! Every thread writes into a buffer of its own, so recording an event does not lock or contend with other threads.
+	 *  Only the first event a thread records in a recorder registers its buffer under a mutex. Events that do not fit
+	 *  in the buffer of a thread are dropped and counted. When the recorder is not recording, a scoped event costs a
+	 *  single atomic load.
+	 *
+	 *  Start(), Stop(), and the export functions have to be called from the same thread. */
+	class TraceRecorder
+	{
+	public:
+		//! \param max_events_per_thread Capacity of the buffer of every thread, allocated when a thread first records.
+		explicit TraceRecorder(std::size_t max_events_per_thread = 65536);
+		~TraceRecorder() = default;
+
+		TraceRecorder(const TraceRecorder&) = delete;
+		TraceRecorder& operator=(const TraceRecorder&) = delete;
+
+		//! Recorder used by the plug-in
+		static TraceRecorder& GetInstance();
+
+		//! Start a new recording, the events of the previous recording are discarded
+		void Start() noexcept;
+
+		//! Stop recording, the recorded events are kept until the next call to Start()
+		void Stop() noexcept;
+
+		//! Whether events are recorded
+		bool IsRecording() const noexcept;
+
+		//! Record an event on the timeline of the calling thread, ignored when the recorder is not recording
+		/*! \param name Static string (e.g. a string literal), only the pointer is stored.
+		 *  \param category Static string (e.g. a string literal), only the pointer is stored. */
+		void AddEvent(const char* name, const char* category, std::chrono::steady_clock::time_point begin, std::chrono::steady_clock::time_point end) noexcept;
+
+		//! Number of events in the current (or last) recording
+		std::size_t GetEventCount() const;
+
+		//! Number of events that did not fit in the buffer of their thread in the current (or last) recording
+		std::size_t GetDroppedEventCount() const;
+
+		//! Write the events of the current (or last) recording in the Chrome trace event format
+		/*! Timestamps are in microseconds since the recording started, every thread gets a timeline of its own. */
+		void WriteJSON(std::ostream& stream) const;
+
+		//! Write the events to a file in the Chrome trace event format
+		/*! \return False when the file cannot be written. */
+		bool WriteJSONFile(const std::string& path) const;
+
+	private:
+		//! Events of a single thread, only that thread writes to it
+		struct ThreadBuffer
+		{
+			std::thread::id m_thread_id;
+			std::uint32_t m_thread_index = 0;				//!< Order in which the threads started recording
+			std::vector<TraceEvent> m_events;				//!< Fixed capacity, never reallocated
+			std::atomic<std::size_t> m_count{ 0 };		//!< Events written, published with release semantics
+			std::atomic<std::size_t> m_dropped{ 0 };		//!< Events that did not fit in the buffer
+			std::atomic<std::uint64_t> m_session{ 0 };		//!< Recording the events belong to
+		};
+
+		//! Buffer of the calling thread, registered on the first call of a thread
+		ThreadBuffer& GetThreadBuffer();
+
+		//! Calls the function for every buffer with events of the current recording
+		template<typename Function>
+		void ForEachBuffer(const Function& function) const;
+
+		const std::uint64_t m_id;						//!< Unique per recorder, identifies the recorder in the thread-local cache
+		const std::size_t m_max_events_per_thread;
+
+		std::atomic<bool> m_recording;
+		std::atomic<std::uint64_t> m_session;			//!< Incremented by Start(), buffers of older sessions are reset lazily
+		std::int64_t m_start_time;						//!< Steady clock time in nanoseconds of the last call to Start()
+
+		mutable std::mutex m_buffers_mutex;
+		std::vector<std::unique_ptr<ThreadBuffer>> m_buffers;
+	};
+
+	//! Records the time between construction and destruction as an event of the calling thread
+	class ScopedTraceEvent
+	{
+	public:
+		//! \param name Static string (e.g. a string literal).
+		//! \param category Static string (e.g. a string literal).
+		ScopedTraceEvent(const char* name, const char* category, TraceRecorder& recorder = TraceRecorder::GetInstance()) noexcept;
+		~ScopedTraceEvent();
+
+		ScopedTraceEvent(const ScopedTraceEvent&) = delete;
+		ScopedTraceEvent& operator=(const ScopedTraceEvent&) = delete;
+
+	private:
+		TraceRecorder& m_recorder;
+		const char* m_name;
+		const char* m_category;
+		bool m_active;									//!< The recorder was recording when the scope started
+		std::chrono::steady_clock::time_point m_begin;
+	};
+}
@@ -16,6 +16,9 @@
 
 // Wisp plug-in
 #include "frame_graph/frame_graph.hpp"
+#include "miscellaneous/render_settings.hpp"
+#include "miscellaneous/settings.hpp"
+#include "pipeline_description.hpp"
 
 // TODO: Find the best order of include in alphabetical order without breaking the dependencies
 // Wisp rendering framework
@@ -55,7 +58,88 @@
 
 
 #include "wisp_render_tasks/d3d12_depth_data_readback.hpp"
+#include "wisp_render_tasks/d3d12_gpu_frame_timer.hpp"
 #include "wisp_render_tasks/d3d12_pixel_data_readback.hpp"
+#include "wisp_render_tasks/d3d12_vertex_patch_upload.hpp"
+
+// C++ standard
+#include <chrono>
+#include <string>
+#include <unordered_map>
+
+static_assert(wmr::settings::PIPELINE_DESCRIPTION_FILES.size() == static_cast<size_t>(wmr::RendererFrameGraphType::RENDERING_PIPELINE_TYPE_COUNT), "Every frame graph type needs a pipeline description file.");
+
+namespace
+{
+	//! Everything a task factory may need to add a render task to a frame graph
+	struct TaskFactoryContext
+	{
+		wr::RenderSystem& m_render_system;
+		const wmr::PipelineDescription& m_pipeline;
+		const std::shared_ptr<wr::GPUFrameTimerData>& m_gpu_frame_timer;
+	};
+
+	using TaskFactory = void(*)(wr::FrameGraph& frame_graph, const TaskFactoryContext& context);
+
+	//! Render tasks available to pipeline descriptions, by task signature
+	/*! The inputs of a task are template arguments of the Wisp task, so every combination of inputs a pipeline may use
+	 *  needs its own entry. This includes the combinations that result from disabling task chains (PrunePipeline()). */
+	const std::unordered_map<std::string, TaskFactory>& GetTaskFactories()
+	{
+		static const std::unordered_map<std::string, TaskFactory> factories =
+		{
+			// Image based lighting
+			{ "brdf_lut_precalculation()", [](wr::FrameGraph& fg, const TaskFactoryContext&) { wr::AddBrdfLutPrecalculationTask(fg); } },
+			{ "equirect_to_cubemap()", [](wr::FrameGraph& fg, const TaskFactoryContext&) { wr::AddEquirectToCubemapTask(fg); } },
+			{ "cubemap_convolution()", [](wr::FrameGraph& fg, const TaskFactoryContext&) { wr::AddCubemapConvolutionTask(fg); } },
+
+			// G-buffer, ray tracing pipelines need the G-buffer in a format the ray tracing tasks can read
+			{ "deferred_main()", [](wr::FrameGraph& fg, const TaskFactoryContext& context) { wr::AddDeferredMainTask(fg, std::nullopt, std::nullopt, context.m_pipeline.m_requires_ray_tracing); } },
+			{ "depth_data_readback(deferred_main)", [](wr::FrameGraph& fg, const TaskFactoryContext&) { wr::AddDepthDataReadBackTask<wr::DeferredMainTaskData>(fg, std::nullopt, std::nullopt); } },
+			{ "hbao()", [](wr::FrameGraph& fg, const TaskFactoryContext&) { wr::AddHBAOTask(fg); } },
+			{ "deferred_composition()", [](wr::FrameGraph& fg, const TaskFactoryContext&) { wr::AddDeferredCompositionTask(fg, std::nullopt, std::nullopt); } },
+
+			// Ray tracing
+			{ "build_acceleration_structures()", [](wr::FrameGraph& fg, const TaskFactoryContext&) { wr::AddBuildAccelerationStructuresTask(fg); } },
+			{ "rt_reflection()", [](wr::FrameGraph& fg, const TaskFactoryContext&) { wr::AddRTReflectionTask(fg); } },
+			{ "rt_shadow()", [](wr::FrameGraph& fg, const TaskFactoryContext&) { wr::AddRTShadowTask(fg); } },
+			{ "shadow_denoiser()", [](wr::FrameGraph& fg, const TaskFactoryContext&) { wr::AddShadowDenoiserTask(fg); } },
+			{ "spatial_reconstruction()", [](wr::FrameGraph& fg, const TaskFactoryContext&) { wr::AddSpatialReconstructionTask(fg); } },
+			{ "reflection_denoiser()", [](wr::FrameGraph& fg, const TaskFactoryContext&) { wr::AddReflectionDenoiserTask(fg); } },
+			{ "rtao()", [](wr::FrameGraph& fg, const TaskFactoryContext& context) { wr::AddRTAOTask(fg, static_cast<wr::D3D12RenderSystem&>(context.m_render_system).m_device); } },
+			{ "path_tracer()", [](wr::FrameGraph& fg, const TaskFactoryContext&) { wr::AddPathTracerTask(fg); } },
+			{ "accumulation(path_tracer)", [](wr::FrameGraph& fg, const TaskFactoryContext&) { wr::AddAccumulationTask<wr::PathTracerData>(fg); } },
+
+			// High quality bloom
+			{ "bloom_extract_bright(deferred_composition,deferred_main)", [](wr::FrameGraph& fg, const TaskFactoryContext&) { wr::AddBloomExtractBrightTask<wr::DeferredCompositionTaskData, wr::DeferredMainTaskData>(fg); } },
+			{ "bloom_blur_horizontal(bloom_extract_bright)", [](wr::FrameGraph& fg, const TaskFactoryContext&) { wr::AddBloomBlurHorizontalTask<wr::BloomExtractBrightData>(fg); } },
+			{ "bloom_blur_vertical(bloom_blur_horizontal)", [](wr::FrameGraph& fg, const TaskFactoryContext&) { wr::AddBloomBlurVerticalTask<wr::BloomBlurHorizontalData>(fg); } },
+			{ "bloom_composition(deferred_composition,bloom_blur_vertical)", [](wr::FrameGraph& fg, const TaskFactoryContext&) { wr::AddBloomCompositionTask<wr::DeferredCompositionTaskData, wr::BloomBlurVerticalData>(fg); } },
+
+			// Depth of field
+			{ "dof_coc(deferred_main)", [](wr::FrameGraph& fg, const TaskFactoryContext&) { wr::AddDoFCoCTask<wr::DeferredMainTaskData>(fg); } },
+			{ "down_scale(bloom_composition,dof_coc)", [](wr::FrameGraph& fg, const TaskFactoryContext&) { wr::AddDownScaleTask<wr::BloomCompostionData, wr::DoFCoCData>(fg); } },
+			{ "down_scale(deferred_composition,dof_coc)", [](wr::FrameGraph& fg, const TaskFactoryContext&) { wr::AddDownScaleTask<wr::DeferredCompositionTaskData, wr::DoFCoCData>(fg); } },
+			{ "dof_near_mask(down_scale)", [](wr::FrameGraph& fg, const TaskFactoryContext&) { wr::AddDoFNearMaskTask<wr::DownScaleData>(fg); } },
+			{ "dof_dilate(dof_near_mask)", [](wr::FrameGraph& fg, const TaskFactoryContext&) { wr::AddDoFDilateTask<wr::DoFNearMaskData>(fg); } },
+			{ "dof_bokeh(down_scale,dof_dilate)", [](wr::FrameGraph& fg, const TaskFactoryContext&) { wr::AddDoFBokehTask<wr::DownScaleData, wr::DoFDilateData>(fg); } },
+			{ "dof_bokeh_post_filter(dof_bokeh)", [](wr::FrameGraph& fg, const TaskFactoryContext&) { wr::AddDoFBokehPostFilterTask<wr::DoFBokehData>(fg); } },
+			{ "dof_composition(bloom_composition,dof_bokeh_post_filter,dof_coc)", [](wr::FrameGraph& fg, const TaskFactoryContext&) { wr::AddDoFCompositionTask<wr::BloomCompostionData, wr::DoFBokehPostFilterData, wr::DoFCoCData>(fg); } },
+			{ "dof_composition(deferred_composition,dof_bokeh_post_filter,dof_coc)", [](wr::FrameGraph& fg, const TaskFactoryContext&) { wr::AddDoFCompositionTask<wr::DeferredCompositionTaskData, wr::DoFBokehPostFilterData, wr::DoFCoCData>(fg); } },
+
+			// Post-processing
+			{ "post_processing(dof_composition)", [](wr::FrameGraph& fg, const TaskFactoryContext&) { wr::AddPostProcessingTask<wr::DoFCompositionData>(fg); } },
+			{ "post_processing(bloom_composition)", [](wr::FrameGraph& fg, const TaskFactoryContext&) { wr::AddPostProcessingTask<wr::BloomCompostionData>(fg); } },
+			{ "post_processing(deferred_composition)", [](wr::FrameGraph& fg, const TaskFactoryContext&) { wr::AddPostProcessingTask<wr::DeferredCompositionTaskData>(fg); } },
+			{ "post_processing(accumulation)", [](wr::FrameGraph& fg, const TaskFactoryContext&) { wr::AddPostProcessingTask<wr::AccumulationData>(fg); } },
+
+			// Final image
+			{ "pixel_data_readback(post_processing)", [](wr::FrameGraph& fg, const TaskFactoryContext&) { wr::AddPixelDataReadBackTask<wr::PostProcessingData>(fg, std::nullopt, std::nullopt); } }
+		};
+
+		return factories;
+	}
+}
 
 namespace wmr
 {
@@ -65,34 +149,158 @@ namespace wmr
 
 		m_width = initial_width;
 		m_height = initial_height;
+		m_creation_size = { initial_width, initial_height };
 
 		m_current_rendering_pipeline_type = initial_type;
 
-		LOG("Starting to create all rendering pipelines.");
+		for (auto& timer : m_gpu_frame_timers)
+		{
+			timer = std::make_shared<wr::GPUFrameTimerData>();
+		}
 
-		// Add required tasks to each frame graph
-		CreateDeferredPipeline();
-		CreateHybridRTPipeline(render_system);
+		m_vertex_patch_upload = std::make_shared<wr::VertexPatchUploadData>();
 
-		LOG("Finished creating all rendering pipelines.");
+		// The other pipelines are created the first time they are activated
+		m_renderer_frame_graphs.fill(nullptr);
+		m_failed_pipelines.fill(false);
+		m_ray_tracing_pipelines.fill(false);
+		m_outdated_pipelines.fill(false);
+		m_low_end_deferred_pipeline = settings::DEFAULT_LOW_END_DEFERRED_PIPELINE;
+		m_gpu_task_timing = settings::DEFAULT_GPU_TASK_TIMING;
+		CreatePipeline(initial_type, render_system);
+		m_last_activation_times.fill(std::chrono::steady_clock::now());
+
+		LOG("Finished framegraph manager creation.");
+	}
 
-		LOG("Finalizing framegraphs...");
+	bool FrameGraphManager::CreatePipeline(RendererFrameGraphType type, wr::RenderSystem& render_system) noexcept
+	{
+		const auto start_time = std::chrono::steady_clock::now();
+		const auto type_index = static_cast<size_t>(type);
 
-		// Set-up the rendering pipelines (frame graph configuration)
-		for (auto& frame_graph : m_renderer_frame_graphs)
+		// A pipeline that failed once fails again, do not flood the log
+		if (m_failed_pipelines[type_index])
 		{
-			frame_graph->Setup(render_system);
+			return false;
 		}
 
-		LOG("Finished finalizing framegraphs.");
+		PipelineDescription description;
+		std::string error;
 
-		LOG("Finished framegraph manager creation.");
+		if (!LoadPipelineDescription(GetPipelineDescriptionFile(type), description, error))
+		{
+			LOGC("Cannot load the rendering pipeline description: {}", error);
+			m_failed_pipelines[type_index] = true;
+			return false;
+		}
+
+		// Disabled task chains are not part of the frame graph at all
+		description = PrunePipeline(description, m_disabled_task_chains);
+		m_outdated_pipelines[type_index] = false;
+
+		auto* frame_graph = BuildPipeline(description, m_gpu_frame_timers[type_index], render_system);
+
+		if (!frame_graph)
+		{
+			m_failed_pipelines[type_index] = true;
+			return false;
+		}
+
+		// Set-up the rendering pipeline (frame graph configuration)
+		frame_graph->Setup(render_system);
+
+		// Settings changed before the frame graph existed or while a task was pruned carry over, the tasks that have no
+		// stored settings yet keep their defaults
+		auto& render_settings = m_render_settings[type_index];
+		FillMissingRenderSettings(render_settings, CaptureRenderSettings(frame_graph));
+		RestoreRenderSettings(frame_graph, render_settings);
+
+		m_renderer_frame_graphs[type_index] = frame_graph;
+		m_frame_graph_sizes[type_index] = m_creation_size;
+		m_ray_tracing_pipelines[type_index] = description.m_requires_ray_tracing;
+
+		const std::chrono::duration<double, std::milli> setup_time = std::chrono::steady_clock::now() - start_time;
+		LOG("Created and set up the \"{}\" rendering pipeline ({} tasks) in {:.2f} ms.", description.m_name, description.m_tasks.size(), setup_time.count());
+
+		return true;
+	}
+
+	bool FrameGraphManager::RebuildPipeline(RendererFrameGraphType type, wr::D3D12RenderSystem& render_system) noexcept
+	{
+		const auto type_index = static_cast<size_t>(type);
+		auto*& frame_graph = m_renderer_frame_graphs[type_index];
+
+		// The frame graph may still be in flight
+		render_system.WaitForAllPreviousWork();
+
+		// Destroy the old frame graph first, its render targets and the GPU frame timer resources are released. The new
+		// frame graph receives the stored render settings.
+		frame_graph->Destroy();
+		delete frame_graph;
+		frame_graph = nullptr;
+
+		return CreatePipeline(type, render_system);
+	}
+
+	wr::FrameGraph* FrameGraphManager::BuildPipeline(const PipelineDescription& description, const std::shared_ptr<wr::GPUFrameTimerData>& gpu_frame_timer, wr::RenderSystem& render_system) noexcept
+	{
+		const auto& factories = GetTaskFactories();
+		const TaskFactoryContext context{ render_system, description, gpu_frame_timer };
+
+		gpu_frame_timer->name = description.m_name;
+		gpu_frame_timer->section_names.clear();
+
+		// Every task is a section of the frame, when timed separately
+		if (m_gpu_task_timing)
+		{
+			for (const auto& task : description.m_tasks)
+			{
+				gpu_frame_timer->section_names.push_back(task.m_name);
+			}
+		}
+
+		// The vertex patch upload and GPU frame timer tasks are not part of the descriptions, the timer tasks enclose
+		// every other task so the timer queries are always begun and resolved
+		const auto section_count = gpu_frame_timer->section_names.size();
+		auto* frame_graph = new wr::FrameGraph(3 + description.m_tasks.size() + (section_count > 0 ? section_count - 1 : 0));
+
+		wr::AddVertexPatchUploadTask(*frame_graph, m_vertex_patch_upload);
+		wr::AddGPUFrameTimerBeginTask(*frame_graph, gpu_frame_timer);
+
+		std::uint32_t timed_task_count = 0;
+
+		for (const auto& task : description.m_tasks)
+		{
+			// The end of the previous section, the end of the last section is written by the end task
+			if (m_gpu_task_timing && timed_task_count > 0)
+			{
+				wr::AddGPUTimestampTask(*frame_graph, gpu_frame_timer, timed_task_count);
+			}
+
+			++timed_task_count;
+
+			const auto signature = task.GetSignature();
+			const auto factory = factories.find(signature);
+
+			if (factory == factories.end())
+			{
+				LOGC("The \"{}\" rendering pipeline uses the unknown task {} (line {}).", description.m_name, signature, task.m_line);
+				delete frame_graph;
+				return nullptr;
+			}
+
+			factory->second(*frame_graph, context);
+		}
+
+		wr::AddGPUFrameTimerEndTask(*frame_graph, gpu_frame_timer);
+
+		return frame_graph;
 	}
 
 	void FrameGraphManager::Destroy() noexcept
 	{
 		// Clean up the allocated frame graphs
-		for (auto* frame_graph : m_renderer_frame_graphs)
+		for (auto*& frame_graph : m_renderer_frame_graphs)
 		{
 			// Not allocated
 			if (!frame_graph)
@@ -129,6 +337,11 @@ namespace wmr
 		return m_renderer_frame_graphs[static_cast<size_t>(m_current_rendering_pipeline_type)];
 	}
 
+	RendererFrameGraphType FrameGraphManager::GetType() const noexcept
+	{
+		return m_current_rendering_pipeline_type;
+	}
+
 	void FrameGraphManager::Resize(unsigned int new_width, unsigned int new_height, wr::D3D12RenderSystem& render_system) noexcept
 	{
 		LOG("Starting framegraph resizing");
@@ -146,15 +359,167 @@ namespace wmr
 
 		LOG("Resized the render system.");
 
-		LOG("Starting to resize every framegraph...");
+		// Only resize the active frame graph, the others are resized once they are activated again
+		const auto type_index = static_cast<size_t>(m_current_rendering_pipeline_type);
+
+		if (m_renderer_frame_graphs[type_index])
+		{
+			m_renderer_frame_graphs[type_index]->Resize(new_width, new_height);
+			m_frame_graph_sizes[type_index] = { new_width, new_height };
+		}
+
+		LOG("Resized the active framegraph successfully.");
+	}
+
+	wr::FrameGraph* FrameGraphManager::Activate(RendererFrameGraphType type, wr::D3D12RenderSystem& render_system) noexcept
+	{
+		const auto type_index = static_cast<size_t>(type);
+		auto* frame_graph = m_renderer_frame_graphs[type_index];
+
+		// Create the pipeline the first time it is used
+		if (!frame_graph)
+		{
+			if (!CreatePipeline(type, render_system))
+			{
+				return nullptr;
+			}
+
+			frame_graph = m_renderer_frame_graphs[type_index];
+		}
+		// Task chains were enabled or disabled since the pipeline was created
+		else if (m_outdated_pipelines[type_index])
+		{
+			if (!RebuildPipeline(type, render_system))
+			{
+				return nullptr;
+			}
+
+			frame_graph = m_renderer_frame_graphs[type_index];
+		}
+
+		if (m_frame_graph_sizes[type_index] != GetCurrentDimensions())
+		{
+			// The frame graph may still be in flight when it was used recently
+			render_system.WaitForAllPreviousWork();
+
+			frame_graph->Resize(m_width, m_height);
+			m_frame_graph_sizes[type_index] = GetCurrentDimensions();
+
+			LOG("Resized an inactive framegraph to {}x{} pixels on activation.", m_width, m_height);
+		}
+
+		const auto now = std::chrono::steady_clock::now();
+		m_last_activation_times[type_index] = now;
 
-		// Resize all framegraphs
-		for (auto& frame_graph : m_renderer_frame_graphs)
+		if (settings::INACTIVE_PIPELINE_RELEASE_DELAY_S > 0)
 		{
-			frame_graph->Resize( new_width, new_height);
+			ReleaseIdlePipelines(type, now, render_system);
 		}
 
-		LOG("Resized all framegraphs successfully.");
+		return frame_graph;
+	}
+
+	void FrameGraphManager::ReleaseIdlePipelines(RendererFrameGraphType active_type, std::chrono::steady_clock::time_point now, wr::D3D12RenderSystem& render_system) noexcept
+	{
+		for (size_t type_index = 0; type_index < m_renderer_frame_graphs.size(); ++type_index)
+		{
+			auto*& frame_graph = m_renderer_frame_graphs[type_index];
+
+			// The selected pipeline is kept alive, even while the path tracer renders instead
+			if (!frame_graph ||
+				type_index == static_cast<size_t>(active_type) ||
+				type_index == static_cast<size_t>(m_current_rendering_pipeline_type) ||
+				now - m_last_activation_times[type_index] < std::chrono::seconds(settings::INACTIVE_PIPELINE_RELEASE_DELAY_S))
+			{
+				continue;
+			}
+
+			// The frame graph may still be in flight
+			render_system.WaitForAllPreviousWork();
+
+			frame_graph->Destroy();
+			delete frame_graph;
+			frame_graph = nullptr;
+
+			LOG("Released a rendering pipeline that was not used for {} seconds.", settings::INACTIVE_PIPELINE_RELEASE_DELAY_S);
+		}
+	}
+
+	void FrameGraphManager::SetTaskChainEnabled(const std::string& toggle, bool enabled) noexcept
+	{
+		const auto changed = (enabled ? m_disabled_task_chains.erase(toggle) : m_disabled_task_chains.insert(toggle).second);
+
+		if (!changed)
+		{
+			return;
+		}
+
+		LOG("Task chain \"{}\" {}, the rendering pipelines are rebuilt when they are used next.", toggle, enabled ? "enabled" : "disabled");
+
+		MarkPipelinesOutdated();
+	}
+
+	void FrameGraphManager::SetLowEndDeferredPipeline(bool enabled) noexcept
+	{
+		if (m_low_end_deferred_pipeline == enabled)
+		{
+			return;
+		}
+
+		m_low_end_deferred_pipeline = enabled;
+		LOG("Low-end deferred rendering pipeline {}, the deferred pipeline is rebuilt when it is used next.", enabled ? "enabled" : "disabled");
+
+		// The other description may load where the previous one failed
+		const auto type_index = static_cast<size_t>(RendererFrameGraphType::DEFERRED);
+		m_failed_pipelines[type_index] = false;
+		m_outdated_pipelines[type_index] = (m_renderer_frame_graphs[type_index] != nullptr);
+	}
+
+	bool FrameGraphManager::IsLowEndDeferredPipelineEnabled() const noexcept
+	{
+		return m_low_end_deferred_pipeline;
+	}
+
+	const char* FrameGraphManager::GetPipelineDescriptionFile(RendererFrameGraphType type) const noexcept
+	{
+		if (type == RendererFrameGraphType::DEFERRED && m_low_end_deferred_pipeline)
+		{
+			return settings::LOW_END_DEFERRED_PIPELINE_DESCRIPTION_FILE;
+		}
+
+		return settings::PIPELINE_DESCRIPTION_FILES[static_cast<size_t>(type)];
+	}
+
+	void FrameGraphManager::SetGPUTaskTiming(bool enabled) noexcept
+	{
+		if (m_gpu_task_timing == enabled)
+		{
+			return;
+		}
+
+		m_gpu_task_timing = enabled;
+		LOG("GPU timing of every task {}, the rendering pipelines are rebuilt when they are used next.", enabled ? "enabled" : "disabled");
+
+		MarkPipelinesOutdated();
+	}
+
+	bool FrameGraphManager::IsGPUTaskTimingEnabled() const noexcept
+	{
+		return m_gpu_task_timing;
+	}
+
+	void FrameGraphManager::MarkPipelinesOutdated() noexcept
+	{
+		// Pipelines that have not been created yet use the current configuration when they are created
+		for (size_t type_index = 0; type_index < m_renderer_frame_graphs.size(); ++type_index)
+		{
+			m_outdated_pipelines[type_index] = (m_renderer_frame_graphs[type_index] != nullptr);
+		}
+	}
+
+	bool FrameGraphManager::IsTaskChainEnabled(const std::string& toggle) const noexcept
+	{
+		return (m_disabled_task_chains.count(toggle) == 0);
 	}
 
 	std::pair<std::uint32_t, std::uint32_t> FrameGraphManager::GetCurrentDimensions() const noexcept
@@ -167,142 +532,57 @@ namespace wmr
 		return m_renderer_frame_graphs[static_cast<size_t>(type)];
 	}
 
-	void FrameGraphManager::CreateDeferredPipeline() noexcept
+	const wr::GPUFrameTimerData& FrameGraphManager::GetGPUFrameTimer(RendererFrameGraphType type) const noexcept
+	{
+		return *m_gpu_frame_timers[static_cast<size_t>(type)];
+	}
+
+	bool FrameGraphManager::HasRayTracingPipeline() const noexcept
+	{
+		for (size_t type_index = 0; type_index < m_renderer_frame_graphs.size(); ++type_index)
+		{
+			if (m_renderer_frame_graphs[type_index] && m_ray_tracing_pipelines[type_index])
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	wr::VertexPatchUploadData& FrameGraphManager::GetVertexPatchUpload() const noexcept
+	{
+		return *m_vertex_patch_upload;
+	}
+
+	RenderSettingsSnapshot& FrameGraphManager::GetPipelineRenderSettings(RendererFrameGraphType type) noexcept
 	{
-		LOG("Starting deferred pipeline creation.");
-		auto fg = new wr::FrameGraph(19);
-
-		// Precalculate BRDF Lut
-		wr::AddBrdfLutPrecalculationTask(*fg);
-		LOG("Added BRDF LUT precalculation task.");
-
-		// Skybox
-		wr::AddEquirectToCubemapTask(*fg);
-		LOG("Added equirect to cubemap task.");
-		wr::AddCubemapConvolutionTask(*fg);
-		LOG("Added cubemap convolution task.");
-
-		// Construct the G-buffer
-		wr::AddDeferredMainTask(*fg, std::nullopt, std::nullopt, false);
-		LOG("Added deferred main task.");
-
-		// Save the depth buffer CPU pointer
-		wr::AddDepthDataReadBackTask<wr::DeferredMainTaskData>(*fg, std::nullopt, std::nullopt);
-		LOG("Added depth data readback task.");
-
-		// Do HBAO
-		wr::AddHBAOTask(*fg);
-		LOG("Added HBAO.");
-
-		// Merge the G-buffer into one final texture
-		wr::AddDeferredCompositionTask(*fg, std::nullopt, std::nullopt);
-		LOG("Added deferred composition task.");
-
-		// High quality bloom pass
-		wr::AddBloomExtractBrightTask<wr::DeferredCompositionTaskData, wr::DeferredMainTaskData>(*fg);
-		wr::AddBloomBlurHorizontalTask<wr::BloomExtractBrightData>(*fg);
-		wr::AddBloomBlurVerticalTask<wr::BloomBlurHorizontalData>(*fg);
-		wr::AddBloomCompositionTask<wr::DeferredCompositionTaskData, wr::BloomBlurVerticalData>(*fg);
-		LOG("Added high quality bloom task.");
-
-		// Do Depth of field task
-		wr::AddDoFCoCTask<wr::DeferredMainTaskData>(*fg);
-		wr::AddDownScaleTask<wr::BloomCompostionData, wr::DoFCoCData>(*fg);
-		wr::AddDoFNearMaskTask<wr::DownScaleData>(*fg);
-		wr::AddDoFDilateTask<wr::DoFNearMaskData>(*fg);
-		wr::AddDoFBokehTask<wr::DownScaleData, wr::DoFDilateData>(*fg);
-		wr::AddDoFBokehPostFilterTask<wr::DoFBokehData>(*fg);
-		wr::AddDoFCompositionTask<wr::BloomCompostionData, wr::DoFBokehPostFilterData, wr::DoFCoCData>(*fg);
-		LOG("Added depth of field task.");
-
-		wr::AddPostProcessingTask<wr::DoFCompositionData>(*fg);
-		LOG("Added post-processing task.");
-
-		// Save the final texture CPU pointer
-		wr::AddPixelDataReadBackTask<wr::PostProcessingData>(*fg, std::nullopt, std::nullopt);
-		LOG("Added pixel data readback task.");
-
-		// Store the frame graph for future use
-		m_renderer_frame_graphs[static_cast<size_t>(RendererFrameGraphType::DEFERRED)] = fg;
-
-		LOG("Finished deferred pipeline creation.");
+		return m_render_settings[static_cast<size_t>(type)];
 	}
 
-	void FrameGraphManager::CreateHybridRTPipeline(wr::RenderSystem& render_system) noexcept
+	void FrameGraphManager::ApplyPipelineRenderSettings() noexcept
 	{
-		LOG("Starting hybrid pipeline creation.");
-		auto fg = new wr::FrameGraph(18);
-
-		// Precalculate BRDF Lut
-		wr::AddBrdfLutPrecalculationTask( *fg);
-		LOG("Added BRDF LUT precalculation task.");
-
-		// Skybox
-		wr::AddEquirectToCubemapTask( *fg);
-		LOG("Added equirect to cubemap task.");
-		wr::AddCubemapConvolutionTask( *fg);
-		LOG("Added cubemap convolution task.");
-
-		// Construct the G-buffer
-		wr::AddDeferredMainTask(*fg, std::nullopt, std::nullopt, true);
-		LOG("Added deferred main task.");
-
-		// Save the depth buffer CPU pointer
-		wr::AddDepthDataReadBackTask<wr::DeferredMainTaskData>(*fg, std::nullopt, std::nullopt);
-		LOG("Added depth data readback task.");
-
-		// Build acceleration structure
-		wr::AddBuildAccelerationStructuresTask(*fg);
-		LOG("Added build acceleration structures task.");
-
-		// Ray tracing
-		wr::AddRTReflectionTask(*fg);
-		LOG("Added raytraced reflections task.");
-		wr::AddRTShadowTask(*fg);
-		LOG("Added raytraced shadows task.");
-
-		wr::AddShadowDenoiserTask(*fg);
-		LOG("Added shadow denoiser task.");
-		wr::AddSpatialReconstructionTask(*fg);
-		LOG("Added spatial reconstruction task.");
-
-		wr::AddReflectionDenoiserTask(*fg);
-		LOG("Added reflection denoiser task.");
-
-		wr::AddRTAOTask(*fg, static_cast<wr::D3D12RenderSystem&>(render_system).m_device);
-		LOG("Added raytraced ambient occlussion task.");
-
-		wr::AddDeferredCompositionTask(*fg, std::nullopt, std::nullopt);
-		LOG("Added deferred composition task.");
-
-		// High quality bloom pass
-		wr::AddBloomExtractBrightTask<wr::DeferredCompositionTaskData, wr::DeferredMainTaskData>(*fg);
-		wr::AddBloomBlurHorizontalTask<wr::BloomExtractBrightData>(*fg);
-		wr::AddBloomBlurVerticalTask<wr::BloomBlurHorizontalData>(*fg);
-		wr::AddBloomCompositionTask<wr::DeferredCompositionTaskData, wr::BloomBlurVerticalData>(*fg);
-		LOG("Added high quality bloom task.");
-
-		// Do Depth of field task
-		wr::AddDoFCoCTask<wr::DeferredMainTaskData>(*fg);
-		wr::AddDownScaleTask<wr::BloomCompostionData, wr::DoFCoCData>(*fg);
-		wr::AddDoFNearMaskTask<wr::DownScaleData>(*fg);
-		wr::AddDoFDilateTask<wr::DoFNearMaskData>(*fg);
-		wr::AddDoFBokehTask<wr::DownScaleData, wr::DoFDilateData>(*fg);
-		wr::AddDoFBokehPostFilterTask<wr::DoFBokehData>(*fg);
-		wr::AddDoFCompositionTask<wr::BloomCompostionData, wr::DoFBokehPostFilterData, wr::DoFCoCData>(*fg);
-		LOG("Added depth of field task.");
-
-		// Do some post processing
-		wr::AddPostProcessingTask<wr::DoFCompositionData>(*fg);
-		LOG("Added post-processing task.");
-
-		// Save the ray tracing pixel data CPU pointer
-		wr::AddPixelDataReadBackTask<wr::PostProcessingData>(*fg, std::nullopt, std::nullopt);
-		LOG("Added pixel data readback task.");
-
-		// Store the frame graph for future use
-		m_renderer_frame_graphs[static_cast<size_t>(RendererFrameGraphType::HYBRID_RAY_TRACING)] = fg;
-
-		LOG("Finished hybrid pipeline creation.");
+		for (size_t type_index = 0; type_index < m_renderer_frame_graphs.size(); ++type_index)
+		{
+			// Frame graphs that do not exist receive the settings when they are created
+			if (m_renderer_frame_graphs[type_index])
+			{
+				RestoreRenderSettings(m_renderer_frame_graphs[type_index], m_render_settings[type_index]);
+			}
+		}
+	}
+
+	bool FrameGraphManager::PipelineHasTask(RendererFrameGraphType type, const std::string& task_name) const noexcept
+	{
+		PipelineDescription description;
+		std::string error;
+
+		// The unpruned description, settings of disabled task chains are applied when the chain is enabled again
+		if (!LoadPipelineDescription(GetPipelineDescriptionFile(type), description, error))
+		{
+			return false;
+		}
+
+		return (description.FindTask(task_name) < description.m_tasks.size());
 	}
 }
@@ -14,8 +14,16 @@
 
 #pragma once
 
+// Wisp plug-in
+#include "miscellaneous/render_settings.hpp"
+
 // C++ standard
 #include <array>
+#include <chrono>
+#include <memory>
+#include <set>
+#include <string>
+#include <utility>
 
 // Wisp rendering framework
 namespace wr
@@ -23,21 +31,32 @@ namespace wr
 	class FrameGraph;
 	class RenderSystem;
 	class D3D12RenderSystem;
+	struct GPUFrameTimerData;
+	struct VertexPatchUploadData;
 }
 
 //! Generic plug-in namespace (Wisp Maya Renderer)
 namespace wmr
 {
+	struct PipelineDescription;
+
 	//! Available rendering pipelines
 	/*! This enumeration is used to select different types of rendering "pipelines" when creating the Wisp frame graphs. */
 	enum class RendererFrameGraphType
 	{
 		DEFERRED = 0,					/*!< Only use the basic deferred rendering pipeline. */
 		HYBRID_RAY_TRACING,				/*!< Combine deferred rendering and ray tracing to render the scene. */
+		PROGRESSIVE_PATH_TRACING,		/*!< Path trace the scene and accumulate the samples of successive frames. Used
+											 by the renderer while nothing changes, cannot be selected using SetType(). */
 
 		RENDERING_PIPELINE_TYPE_COUNT	/*!< Total number of rendering frame graph types available. */
 	};
 
+	//! Toggle groups of the task chains that can be disabled (see SetTaskChainEnabled())
+	const constexpr char* BLOOM_TASK_CHAIN = "bloom";
+	const constexpr char* DOF_TASK_CHAIN = "dof";
+	const constexpr char* HBAO_TASK_CHAIN = "hbao";
+
 	//! Configures the render passes
 	/*! Based on the frame graph type passed to the Create() function, render passes will be configured. */
 	class FrameGraphManager
@@ -49,9 +68,10 @@ namespace wmr
 		//! Unused
 		~FrameGraphManager() = default;
 
-		//! Create all frame graphs
-		/*! Configure the render passes for all the frame graphs. For every single type in the RendererFrameGraphType
-		 *  enumeration, a new frame graph is created.
+		//! Create the initial frame graph
+		/*! Configure the render passes for the frame graph of the initial type. The other frame graphs are created by
+		 *  Activate() the first time they are used to render, so machines that never use ray tracing never allocate
+		 *  the ray tracing resources.
 		 *  
 		 *  /param render_system Reference to the Wisp framework render system object.
 		 *  /param initial_type Default rendering pipeline used in the application.
@@ -77,29 +97,151 @@ namespace wmr
 		 *  handle clean-up whenever it goes out of scope. */
 		wr::FrameGraph* Get() const noexcept;
 
-		//! Resize the current active frame graph */
+		//! Type of the currently active frame graph
+		RendererFrameGraphType GetType() const noexcept;
+
+		//! Resize the current active frame graph
+		/*! Only the active frame graph is resized right away, the other frame graphs are resized by Activate() once
+		 *  they are used to render again. */
 		void Resize(unsigned int new_width, unsigned int new_height, wr::D3D12RenderSystem& render_system) noexcept;
 
+		//! Enable or disable a chain of tasks in all pipelines
+		/*! Disabled task chains are pruned from the frame graphs, their render targets are released and the tasks
+		 *  after the chain read the output of the task before the chain instead. Frame graphs are rebuilt by Activate()
+		 *  when they are used next, their render settings are carried over.
+		 *
+		 *  /param toggle Toggle group of the task chain in the pipeline descriptions ("bloom", "dof", "hbao").
+		 *  /param enabled Whether the tasks of the chain are part of the frame graphs. */
+		void SetTaskChainEnabled(const std::string& toggle, bool enabled) noexcept;
+
+		//! Whether a chain of tasks is part of the frame graphs
+		bool IsTaskChainEnabled(const std::string& toggle) const noexcept;
+
+		//! Build the deferred frame graph from the low-end pipeline description
+		/*! The deferred frame graph is rebuilt by Activate() when it is used next, from
+		 *  settings::LOW_END_DEFERRED_PIPELINE_DESCRIPTION_FILE instead of the deferred entry of
+		 *  settings::PIPELINE_DESCRIPTION_FILES, or the other way around. */
+		void SetLowEndDeferredPipeline(bool enabled) noexcept;
+
+		//! Whether the deferred frame graph is built from the low-end pipeline description
+		bool IsLowEndDeferredPipelineEnabled() const noexcept;
+
+		//! Measure the GPU time of every task instead of only the entire frame
+		/*! Adds a timestamp task between every two tasks of the frame graphs, which are rebuilt by Activate() when they
+		 *  are used next. The times are published through GetGPUFrameTimer(). */
+		void SetGPUTaskTiming(bool enabled) noexcept;
+
+		//! Whether the GPU time of every task is measured
+		bool IsGPUTaskTimingEnabled() const noexcept;
+
+		//! Get a frame graph for rendering
+		/*! Creates the specified frame graph when it does not exist yet, and resizes it first when it missed a resize
+		 *  while it was inactive. Pipelines that have not been activated for settings::INACTIVE_PIPELINE_RELEASE_DELAY_S
+		 *  seconds are released, their render settings are kept.
+		 *
+		 *  /param type Type of the frame graph that is about to render.
+		 *  /param render_system Reference to the Wisp framework render system object.
+		 *  /return Pointer to the specified frame graph at the current size, nullptr when it cannot be created. */
+		wr::FrameGraph* Activate(RendererFrameGraphType type, wr::D3D12RenderSystem& render_system) noexcept;
+
 		//! Retrieve the size of the frame graph
 		/*! /return Pair containing the width and height respectively. */
 		std::pair<std::uint32_t, std::uint32_t> GetCurrentDimensions() const noexcept;
 
 		//! Get the specified frame graph
+		/*! /return Pointer to the frame graph, or nullptr when the pipeline has not been created (yet). */
 		wr::FrameGraph* GetSpecifiedFramegraph(RendererFrameGraphType type) const noexcept;
 
+		//! GPU time of the newest completed frame of the specified frame graph
+		const wr::GPUFrameTimerData& GetGPUFrameTimer(RendererFrameGraphType type) const noexcept;
+
+		//! Whether a frame graph that exists uses ray tracing
+		/*! Those frame graphs trace against acceleration structures Wisp only updates for models that are edited through
+		 *  the model pool. Frame graphs that are created later build their acceleration structures from scratch. */
+		bool HasRayTracingPipeline() const noexcept;
+
+		//! Vertex ranges of the model pools that are copied to the GPU at the start of the next frame
+		/*! Every frame graph starts with a task that records these copies, whichever frame graph renders next. */
+		wr::VertexPatchUploadData& GetVertexPatchUpload() const noexcept;
+
+		//! Render settings of a pipeline
+		/*! The settings are kept whether the frame graph of the pipeline exists or not, and applied whenever it is
+		 *  created or rebuilt, also after a pruned task chain is enabled again. Settings of tasks that have not been
+		 *  part of the frame graph yet are empty. Call ApplyPipelineRenderSettings() after changing them. */
+		RenderSettingsSnapshot& GetPipelineRenderSettings(RendererFrameGraphType type) noexcept;
+
+		//! Set the stored render settings on the frame graphs that exist
+		void ApplyPipelineRenderSettings() noexcept;
+
+		//! Whether the description of a pipeline has a task, also when the task chain of the task is disabled
+		/*! /return False when the description does not have the task or cannot be loaded. */
+		bool PipelineHasTask(RendererFrameGraphType type, const std::string& task_name) const noexcept;
+
 	private:
-		//! Configure a frame graph for a full deferred rendering pipeline
-		void CreateDeferredPipeline() noexcept;
+		//! Configure and set up the frame graph of the specified type, logs the time this takes
+		/*! The tasks of the frame graph are read from the pipeline description file of the type.
+		 *
+		 *  /return False when the description cannot be loaded or uses unknown tasks. */
+		bool CreatePipeline(RendererFrameGraphType type, wr::RenderSystem& render_system) noexcept;
+
+		//! Replace the frame graph of the specified type with a frame graph that uses the current task chain toggles
+		/*! /return False when the new frame graph cannot be created, the old frame graph is gone either way. */
+		bool RebuildPipeline(RendererFrameGraphType type, wr::D3D12RenderSystem& render_system) noexcept;
+
+		//! Pipeline description file the frame graph of the specified type is built from
+		const char* GetPipelineDescriptionFile(RendererFrameGraphType type) const noexcept;
 
-		//! Configure a frame graph for a hybrid rendering pipeline
-		void CreateHybridRTPipeline(wr::RenderSystem& render_system) noexcept;
+		//! Rebuild every existing frame graph when it is activated next
+		void MarkPipelinesOutdated() noexcept;
+
+		//! Instantiate the render tasks of a pipeline description
+		/*! /return New frame graph that still has to be set up, or nullptr when the description uses an unknown task. */
+		wr::FrameGraph* BuildPipeline(const PipelineDescription& description, const std::shared_ptr<wr::GPUFrameTimerData>& gpu_frame_timer, wr::RenderSystem& render_system) noexcept;
+
+		//! Destroy the frame graphs that have not been activated for settings::INACTIVE_PIPELINE_RELEASE_DELAY_S seconds
+		void ReleaseIdlePipelines(RendererFrameGraphType active_type, std::chrono::steady_clock::time_point now, wr::D3D12RenderSystem& render_system) noexcept;
 
 	private:
 		std::uint32_t m_width;										//! Width of the render texture
 		std::uint32_t m_height;										//! Height of the render texture
 		RendererFrameGraphType m_current_rendering_pipeline_type;	//! Currently selected rendering pipeline type
 
+		std::pair<std::uint32_t, std::uint32_t> m_creation_size;	//! Size of the render texture when a frame graph is created
+
+		//! Time every frame graph was last used to render
+		std::array<std::chrono::steady_clock::time_point, static_cast<size_t>(RendererFrameGraphType::RENDERING_PIPELINE_TYPE_COUNT)> m_last_activation_times;
+
+		//! Size every frame graph was last resized to, inactive frame graphs lag behind m_width and m_height
+		std::array<std::pair<std::uint32_t, std::uint32_t>, static_cast<size_t>(RendererFrameGraphType::RENDERING_PIPELINE_TYPE_COUNT)> m_frame_graph_sizes;
+
 		//! Container that holds all available frame graphs
 		std::array<wr::FrameGraph*, static_cast<size_t>(RendererFrameGraphType::RENDERING_PIPELINE_TYPE_COUNT)> m_renderer_frame_graphs;
+
+		//! Frame graphs whose pipeline description requires ray tracing
+		std::array<bool, static_cast<size_t>(RendererFrameGraphType::RENDERING_PIPELINE_TYPE_COUNT)> m_ray_tracing_pipelines;
+
+		//! Pipelines that could not be created, they are not retried
+		std::array<bool, static_cast<size_t>(RendererFrameGraphType::RENDERING_PIPELINE_TYPE_COUNT)> m_failed_pipelines;
+
+		//! Pipelines that were created before a task chain was enabled or disabled
+		std::array<bool, static_cast<size_t>(RendererFrameGraphType::RENDERING_PIPELINE_TYPE_COUNT)> m_outdated_pipelines;
+
+		//! Render settings of every pipeline, see GetPipelineRenderSettings()
+		std::array<RenderSettingsSnapshot, static_cast<size_t>(RendererFrameGraphType::RENDERING_PIPELINE_TYPE_COUNT)> m_render_settings;
+
+		//! Toggle groups of the task chains that are pruned from the frame graphs
+		std::set<std::string> m_disabled_task_chains;
+
+		//! Whether the deferred frame graph is built from the low-end pipeline description
+		bool m_low_end_deferred_pipeline;
+
+		//! Whether timestamp tasks are added between the tasks of the frame graphs
+		bool m_gpu_task_timing;
+
+		//! Timestamps written at the start and end of every frame graph
+		std::array<std::shared_ptr<wr::GPUFrameTimerData>, static_cast<size_t>(RendererFrameGraphType::RENDERING_PIPELINE_TYPE_COUNT)> m_gpu_frame_timers;
+
+		//! Shared by the vertex patch upload tasks of all frame graphs
+		std::shared_ptr<wr::VertexPatchUploadData> m_vertex_patch_upload;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,271 @@
+// Copyright 2019 Breda University of Applied Sciences and Team Wisp (Viktor Zoutman, Emilio Laiso, Jens Hagen, Meine Zeinstra, Tahar Meijs, Koen Buitenhuis, Niels Brunekreef, Darius Bouma, Florian Schut)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "pipeline_description.hpp"
+
+// C++ standard
+#include <fstream>
+#include <sstream>
+#include <unordered_map>
+
+namespace wmr
+{
+	namespace
+	{
+		//! Tasks the frame graph manager adds to every pipeline, a description cannot declare them
+		bool IsReservedTask(const std::string& name) noexcept
+		{
+			return (name == "vertex_patch_upload" || name == "gpu_frame_timer_begin" || name == "gpu_frame_timer_end");
+		}
+	}
+
+	std::string PipelineTaskDescription::GetSignature() const
+	{
+		auto signature = m_name + "(";
+
+		for (std::size_t i = 0; i < m_inputs.size(); ++i)
+		{
+			signature += (i == 0 ? "" : ",") + m_inputs[i];
+		}
+
+		return signature + ")";
+	}
+
+	std::size_t PipelineDescription::FindTask(const std::string& name) const noexcept
+	{
+		for (std::size_t i = 0; i < m_tasks.size(); ++i)
+		{
+			if (m_tasks[i].m_name == name)
+			{
+				return i;
+			}
+		}
+
+		return m_tasks.size();
+	}
+
+	bool ParsePipelineDescription(std::istream& stream, PipelineDescription& description, std::string& error)
+	{
+		description = PipelineDescription();
+
+		auto fail = [&error](std::size_t line_number, const std::string& message)
+		{
+			error = "line " + std::to_string(line_number) + ": " + message;
+			return false;
+		};
+
+		std::string line;
+		std::size_t line_number = 0;
+
+		while (std::getline(stream, line))
+		{
+			++line_number;
+
+			std::istringstream tokens(line);
+			std::string keyword;
+
+			// Empty line or comment
+			if (!(tokens >> keyword) || keyword[0] == '#')
+			{
+				continue;
+			}
+
+			if (keyword == "pipeline")
+			{
+				if (!description.m_name.empty())
+				{
+					return fail(line_number, "the pipeline is named twice");
+				}
+
+				if (!(tokens >> description.m_name))
+				{
+					return fail(line_number, "expected a pipeline name");
+				}
+			}
+			else if (keyword == "requires")
+			{
+				std::string feature;
+				if (!(tokens >> feature) || feature != "ray_tracing")
+				{
+					return fail(line_number, "expected \"requires ray_tracing\"");
+				}
+
+				description.m_requires_ray_tracing = true;
+			}
+			else if (keyword == "task")
+			{
+				PipelineTaskDescription task;
+				task.m_line = line_number;
+
+				if (!(tokens >> task.m_name))
+				{
+					return fail(line_number, "expected a task name");
+				}
+
+				// Attributes: "inputs" consumes every name up to the next attribute
+				std::string token;
+				bool reading_inputs = false;
+
+				while (tokens >> token)
+				{
+					if (token == "inputs")
+					{
+						reading_inputs = true;
+					}
+					else if (token == "toggle")
+					{
+						reading_inputs = false;
+
+						if (!(tokens >> task.m_toggle))
+						{
+							return fail(line_number, "expected a toggle group after \"toggle\"");
+						}
+					}
+					else if (reading_inputs)
+					{
+						task.m_inputs.push_back(token);
+					}
+					else
+					{
+						return fail(line_number, "unexpected \"" + token + "\"");
+					}
+				}
+
+				description.m_tasks.push_back(std::move(task));
+			}
+			else
+			{
+				return fail(line_number, "unknown statement \"" + keyword + "\"");
+			}
+		}
+
+		if (description.m_name.empty())
+		{
+			error = "the pipeline has no name";
+			return false;
+		}
+
+		return ValidatePipelineOrder(description, error);
+	}
+
+	bool LoadPipelineDescription(const std::string& path, PipelineDescription& description, std::string& error)
+	{
+		std::ifstream file(path);
+
+		if (!file.is_open())
+		{
+			error = "cannot open \"" + path + "\"";
+			return false;
+		}
+
+		if (!ParsePipelineDescription(file, description, error))
+		{
+			error = path + ", " + error;
+			return false;
+		}
+
+		return true;
+	}
+
+	bool ValidatePipelineOrder(const PipelineDescription& description, std::string& error)
+	{
+		if (description.m_tasks.empty())
+		{
+			error = "the pipeline \"" + description.m_name + "\" has no tasks";
+			return false;
+		}
+
+		for (std::size_t i = 0; i < description.m_tasks.size(); ++i)
+		{
+			const auto& task = description.m_tasks[i];
+			const auto location = "line " + std::to_string(task.m_line) + ": ";
+
+			if (IsReservedTask(task.m_name))
+			{
+				error = location + "the task \"" + task.m_name + "\" is added by the renderer";
+				return false;
+			}
+
+			if (description.FindTask(task.m_name) != i)
+			{
+				error = location + "the task \"" + task.m_name + "\" is declared twice";
+				return false;
+			}
+
+			for (const auto& input : task.m_inputs)
+			{
+				const auto input_index = description.FindTask(input);
+
+				if (input_index == description.m_tasks.size())
+				{
+					error = location + "the task \"" + task.m_name + "\" reads \"" + input + "\", which is not part of the pipeline";
+					return false;
+				}
+
+				if (input_index >= i)
+				{
+					error = location + "the task \"" + task.m_name + "\" reads \"" + input + "\", which executes after it";
+					return false;
+				}
+			}
+		}
+
+		return true;
+	}
+
+	PipelineDescription PrunePipeline(const PipelineDescription& description, const std::set<std::string>& disabled_toggles)
+	{
+		PipelineDescription pruned;
+		pruned.m_name = description.m_name;
+		pruned.m_requires_ray_tracing = description.m_requires_ray_tracing;
+
+		// Output that replaces the output of every removed task, empty when there is nothing to replace it with
+		std::unordered_map<std::string, std::string> bypasses;
+
+		for (auto task : description.m_tasks)
+		{
+			// Inputs are declared before the task, so a bypass never points to another removed task
+			std::vector<std::string> inputs;
+			inputs.reserve(task.m_inputs.size());
+
+			for (const auto& input : task.m_inputs)
+			{
+				const auto bypass = bypasses.find(input);
+
+				if (bypass == bypasses.end())
+				{
+					inputs.push_back(input);
+				}
+				else if (!bypass->second.empty())
+				{
+					inputs.push_back(bypass->second);
+				}
+			}
+
+			task.m_inputs = std::move(inputs);
+
+			if (!task.m_toggle.empty() && disabled_toggles.count(task.m_toggle) != 0)
+			{
+				bypasses[task.m_name] = task.m_inputs.empty() ? std::string() : task.m_inputs.front();
+			}
+			else
+			{
+				pruned.m_tasks.push_back(std::move(task));
+			}
+		}
+
+		return pruned;
+	}
+}
@@ -0,0 +1,90 @@
+// Copyright 2019 Breda University of Applied Sciences and Team Wisp (Viktor Zoutman, Emilio Laiso, Jens Hagen, Meine Zeinstra, Tahar Meijs, Koen Buitenhuis, Niels Brunekreef, Darius Bouma, Florian Schut)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+// C++ standard
+#include <cstddef>
+#include <istream>
+#include <set>
+#include <string>
+#include <vector>
+
+//! Generic plug-in namespace (Wisp Maya Renderer)
+namespace wmr
+{
+	//! A single task in a pipeline description
+	struct PipelineTaskDescription
+	{
+		std::string m_name;					//!< Name of the task, every task appears at most once in a pipeline
+		std::vector<std::string> m_inputs;	//!< Earlier tasks whose output this task reads, in the order the task expects them
+		std::string m_toggle;				//!< Group of tasks that can be disabled together, empty when the task is always enabled
+		std::size_t m_line = 0;				//!< Line in the description file, used in error messages
+
+		//! Name and inputs of the task in the form "name(input,input)", identifies the render task to instantiate
+		std::string GetSignature() const;
+	};
+
+	//! Declarative description of a rendering pipeline (frame graph)
+	/*! Pipeline descriptions are loaded from the "resources/pipelines" directory. Every non-empty line that does not
+	 *  start with "#" is one of the following statements:
+	 *
+	 *      pipeline <name>
+	 *      requires ray_tracing
+	 *      task <name> [inputs <task> ...] [toggle <group>]
+	 *
+	 *  The tasks are listed in execution order. The frame graph manager maps every task name and input list to a Wisp
+	 *  render task. */
+	struct PipelineDescription
+	{
+		std::string m_name;									//!< Name of the pipeline
+		bool m_requires_ray_tracing = false;				//!< The pipeline uses DXR, the G-buffer is created for ray tracing
+		std::vector<PipelineTaskDescription> m_tasks;		//!< Tasks in execution order
+
+		//! Index of the task with the specified name
+		/*! \return Index into m_tasks, or m_tasks.size() when the pipeline has no task with this name. */
+		std::size_t FindTask(const std::string& name) const noexcept;
+	};
+
+	//! Parse a pipeline description
+	/*! \param stream Stream containing the description.
+	 *  \param description Receives the parsed description.
+	 *  \param error Receives a message when the description is invalid.
+	 *  \return True when the description was parsed and its task order is valid. */
+	bool ParsePipelineDescription(std::istream& stream, PipelineDescription& description, std::string& error);
+
+	//! Load and parse a pipeline description file
+	/*! \sa ParsePipelineDescription() */
+	bool LoadPipelineDescription(const std::string& path, PipelineDescription& description, std::string& error);
+
+	//! Check the dependency order of a pipeline
+	/*! Every task must have a unique name and may only read the output of tasks that execute before it. The vertex
+	 *  patch upload and GPU frame timer tasks are added to every pipeline when its frame graph is built, a description
+	 *  that declares them is invalid.
+	 *
+	 *  \param description Pipeline to validate.
+	 *  \param error Receives a message when the order is invalid.
+	 *  \return True when the order is valid. */
+	bool ValidatePipelineOrder(const PipelineDescription& description, std::string& error);
+
+	//! Remove the tasks of disabled toggle groups from a pipeline
+	/*! A task that read the output of a removed task reads the first input of the removed task instead, so the task
+	 *  chain is bypassed. When the removed task has no inputs, the input is dropped.
+	 *
+	 *  \param description Complete pipeline.
+	 *  \param disabled_toggles Toggle groups to remove.
+	 *  \return Pipeline without the tasks of the disabled toggle groups. */
+	PipelineDescription PrunePipeline(const PipelineDescription& description, const std::set<std::string>& disabled_toggles);
+}
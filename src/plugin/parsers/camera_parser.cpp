@@ -31,10 +31,27 @@
 
 #include <DirectXMath.h>
 
+bool wmr::ViewportCameraState::operator==(const ViewportCameraState& rhs) const
+{
+	return (m_model_view == rhs.m_model_view &&
+			m_projection == rhs.m_projection &&
+			m_viewport_width == rhs.m_viewport_width &&
+			m_viewport_height == rhs.m_viewport_height &&
+			m_near_clip == rhs.m_near_clip &&
+			m_far_clip == rhs.m_far_clip &&
+			m_horizontal_fov == rhs.m_horizontal_fov &&
+			m_depth_of_field == rhs.m_depth_of_field &&
+			m_f_stop == rhs.m_f_stop &&
+			m_focus_distance == rhs.m_focus_distance &&
+			m_focal_length == rhs.m_focal_length &&
+			m_focus_region_scale == rhs.m_focus_region_scale);
+}
+
 void wmr::CameraParser::Initialize()
 {
 	LOG("Attempting to get a reference to the renderer.");
-	m_viewport_camera = dynamic_cast<const ViewportRendererOverride*>(MHWRender::MRenderer::theRenderer()->findRenderOverride(settings::VIEWPORT_OVERRIDE_NAME))->GetRenderer().GetCamera();
+	m_renderer = &dynamic_cast<const ViewportRendererOverride*>(MHWRender::MRenderer::theRenderer()->findRenderOverride(settings::VIEWPORT_OVERRIDE_NAME))->GetRenderer();
+	m_viewport_camera = m_renderer->GetCamera();
 }
 
 void wmr::CameraParser::UpdateViewportCamera(const MString & panel_name)
@@ -104,6 +121,27 @@ void wmr::CameraParser::UpdateViewportCamera(const MString & panel_name)
 	MMatrix proj;
 	viewport.projectionMatrix(proj);
 
+	ViewportCameraState camera_state;
+	camera_state.m_model_view = model_view_matrix;
+	camera_state.m_projection = proj;
+	camera_state.m_viewport_width = current_viewport_width;
+	camera_state.m_viewport_height = current_viewport_height;
+	camera_state.m_near_clip = camera_functions.nearClippingPlane();
+	camera_state.m_far_clip = camera_functions.farClippingPlane();
+	camera_state.m_horizontal_fov = camera_functions.horizontalFieldOfView();
+	camera_state.m_depth_of_field = camera_functions.isDepthOfField();
+	camera_state.m_f_stop = camera_functions.fStop();
+	camera_state.m_focus_distance = camera_functions.focusDistance();
+	camera_state.m_focal_length = camera_functions.focalLength();
+	camera_state.m_focus_region_scale = m_viewport_camera->m_dof_range;
+
+	// Render-on-demand only renders a new frame when the camera actually moved
+	if (!(camera_state == m_last_camera_state))
+	{
+		m_last_camera_state = camera_state;
+		m_renderer->MarkSceneChanged();
+	}
+
 	DirectX::XMVECTOR vec0 = DirectX::XMVectorSet(proj.matrix[0][0], proj.matrix[0][1], proj.matrix[0][2], proj.matrix[0][3]);
 	DirectX::XMVECTOR vec1 = DirectX::XMVectorSet(proj.matrix[1][0], proj.matrix[1][1], proj.matrix[1][2], proj.matrix[1][3]);
 	DirectX::XMVECTOR vec2 = DirectX::XMVectorSet(proj.matrix[2][0], proj.matrix[2][1], proj.matrix[2][2], proj.matrix[2][3]);
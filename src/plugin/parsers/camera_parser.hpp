@@ -16,8 +16,10 @@
 
 // Maya API
 #include <maya/MApiNamespace.h>
+#include <maya/MMatrix.h>
 
 // C++ standard
+#include <cstdint>
 #include <memory>
 
 namespace wr
@@ -27,6 +29,27 @@ namespace wr
 
 namespace wmr
 {
+	class Renderer;
+
+	//! Everything of the Maya viewport camera that affects the rendered image
+	struct ViewportCameraState
+	{
+		MMatrix m_model_view;
+		MMatrix m_projection;
+		std::uint32_t m_viewport_width = 0;
+		std::uint32_t m_viewport_height = 0;
+		double m_near_clip = 0.0;
+		double m_far_clip = 0.0;
+		double m_horizontal_fov = 0.0;
+		bool m_depth_of_field = false;
+		double m_f_stop = 0.0;
+		double m_focus_distance = 0.0;
+		double m_focal_length = 0.0;
+		float m_focus_region_scale = 0.0f;
+
+		bool operator==(const ViewportCameraState& rhs) const;
+	};
+
 	class CameraParser
 	{
 	public:
@@ -37,10 +60,17 @@ namespace wmr
 		void Initialize();
 
 		//! Set the Wisp camera to the currently active Maya camera
+		/*! Marks the scene as changed when the camera differs from the camera of the previous call. */
 		void UpdateViewportCamera(const MString& panel_name);
 
 	private:
 		//! Pointer to the Wisp camera used to render the scene
 		std::shared_ptr<wr::CameraNode> m_viewport_camera;
+
+		//! Renderer to notify of camera changes
+		Renderer* m_renderer = nullptr;
+
+		//! Camera state of the previous call to UpdateViewportCamera()
+		ViewportCameraState m_last_camera_state;
 	};
 }
\ No newline at end of file
@@ -19,6 +19,7 @@
 #include "plugin/renderer/renderer.hpp"
 #include "plugin/renderer/model_manager.hpp"
 #include "miscellaneous/settings.hpp"
+#include "miscellaneous/trace_recorder.hpp"
 #include "plugin/renderer/texture_manager.hpp"
 #include "plugin/renderer/material_manager.hpp"
 
@@ -43,6 +44,8 @@
 
 #include <DirectXMath.h>
 
+#include <algorithm>
+
 using namespace DirectX;
 
 // region for internally used functions, these functions cannot be use outside this cpp file
@@ -73,29 +76,6 @@ static void updateTransform( MFnTransform& transform, std::shared_ptr<wr::LightN
 	mesh_node->SetScale( { static_cast< float >( scale[0] ), static_cast< float >( scale[1] ),static_cast< float >( scale[2] ) } );
 }
 
-auto getTransformFindAlgorithm( MFnTransform& transform)
-{
-	return [ &transform ]( std::pair<MObject, std::shared_ptr<wr::LightNode>> pair ) -> bool
-	{
-		MStatus status;
-		MFnLight fn_light( pair.first );
-		MFnDagNode dagnode = fn_light.parent( 0, &status );
-		MObject object = dagnode.object();
-		MFnTransform transform_rhs( dagnode.object(), &status );
-		
-		if (status != MS::kSuccess)
-		{
-			LOGC("Could not get the transform functionset.");
-		}
-
-		if( transform.object() == transform_rhs.object() )
-		{
-			return true;
-		}
-		return false;
-	};
-}
-
 #pragma endregion
 
 #pragma region callbacks
@@ -109,27 +89,14 @@ namespace wmr
 			return;
 		}
 
-		MStatus status = MS::kSuccess;
-		MFnTransform transform( plug.node(), &status );
-		if( status != MS::kSuccess )
-		{
-			LOGE("Could not get a transform node.");
-			return;
-		}
+		ScopedTraceEvent trace_event("AttributeLightTransformCallback", "callback");
+
 		wmr::LightParser* light_parser = reinterpret_cast< wmr::LightParser* >( client_data );
+		++light_parser->m_transform_statistics.m_messages_received;
 
-		// specialized find_if algorithm
-		auto it = std::find_if( light_parser->m_object_transform_vector.begin(), light_parser->m_object_transform_vector.end(), getTransformFindAlgorithm(transform) );
-		
-		MFnLight fn_light( it->first );
-		MFnDagNode dagnode = fn_light.parent( 0, &status );
-		MObject object = dagnode.object();
-		MFnTransform transform_rhs( dagnode.object(), &status );
-		if( transform_rhs.object() != transform.object() )
-		{
-			return; // find_if returns last element even if it is not a positive result
-		}
-		updateTransform( transform, it->second );
+		// A drag sends many messages per frame for the same transform, the transform is read once when the frame starts
+		light_parser->m_dirty_transforms.insert( MObjectHandle( plug.node() ) );
+		light_parser->m_renderer.MarkSceneChanged();
 	}
 	void AttributeLightCallback(MNodeMessage::AttributeMessage msg, MPlug& plug, MPlug& other_plug, void* client_data)
 	{
@@ -139,32 +106,27 @@ namespace wmr
 			return;
 		}
 
+		ScopedTraceEvent trace_event("AttributeLightCallback", "callback");
+
 		wmr::LightParser* light_parser = reinterpret_cast<wmr::LightParser*>(client_data);
 
 		MStatus status = MS::kSuccess;
 		MFnLight fn_light(plug.node(), &status);
-		
-		MFnDagNode dagnode = fn_light.parent(0, &status);
 		if (status != MS::kSuccess)
 		{
-			LOGE("Could not get the dag node.");
+			LOGE("Could not get the light function set.");
+			return;
 		}
-		MFnTransform transform = dagnode.object();
 
-		// specialized find_if algorithm
-		auto it = std::find_if(light_parser->m_object_transform_vector.begin(), light_parser->m_object_transform_vector.end(), getTransformFindAlgorithm(transform));
-
-		auto api_type = fn_light.object().apiType();
-		auto light_node = it->second;
-
-		if (it == --light_parser->m_object_transform_vector.end())
+		auto it = light_parser->m_light_node_map.find(MObjectHandle(fn_light.object()));
+		if (it == light_parser->m_light_node_map.end() || !it->second.m_light_node)
 		{
-			if (it->first != transform.object() )
-			{
-				return;
-			}
+			return;
 		}
 
+		auto api_type = fn_light.object().apiType();
+		auto light_node = it->second.m_light_node;
+
 		switch (api_type)
 		{
 		case MFn::Type::kAmbientLight:
@@ -207,8 +169,7 @@ namespace wmr
 			break;
 		}
 
-
-
+		light_parser->m_renderer.MarkSceneChanged();
 	}
 }
 #pragma endregion
@@ -218,7 +179,8 @@ wmr::LightParser::LightParser() :
 		MHWRender::MRenderer::theRenderer()->findRenderOverride( settings::VIEWPORT_OVERRIDE_NAME )
 		)->GetRenderer() ),
 	m_mesh_added_callback_vector(),
-	m_object_transform_vector()
+	m_light_node_map(),
+	m_transform_light_map()
 {
 }
 
@@ -244,35 +206,68 @@ void wmr::LightParser::UnSubscribeObject( MObject & maya_object )
 {
 	MStatus status = MS::kSuccess;
 
-	MFnLight fn_light( maya_object );
+	auto it = m_light_node_map.find( MObjectHandle( maya_object ) );
+	if( it == m_light_node_map.end() )
+	{
+		LOGC("Light was never added to the light parser.");
+		return;
+	}
+	m_renderer.GetScenegraph().DestroyNode( it->second.m_light_node );
+	m_renderer.MarkSceneChanged();
 
-	auto findCallback = [ &maya_object ]( std::pair<MObject, std::shared_ptr<wr::LightNode>> pair ) -> bool
+	auto transform_it = m_transform_light_map.find( MObjectHandle( it->second.m_transform ) );
+	if( transform_it != m_transform_light_map.end() )
 	{
-		if( maya_object == pair.first )
+		auto& lights = transform_it->second;
+		lights.erase( std::remove( lights.begin(), lights.end(), maya_object ), lights.end() );
+
+		if( lights.empty() )
 		{
-			return true;
+			m_transform_light_map.erase( transform_it );
 		}
-		return false;
-	};
-	auto it = std::find_if( m_object_transform_vector.begin(), m_object_transform_vector.end(), findCallback );
-	if( it->first != maya_object )
-	{
-		LOGC("Could not find the callback in the transform vector.");
-		return; // find_if returns last element even if it is not a positive result
 	}
-	m_renderer.GetScenegraph().DestroyNode( it->second );
-	
-	auto it_end = --m_object_transform_vector.end();
 
-	if( it == it_end )
-	{
-		m_object_transform_vector.pop_back();
-	}
-	else
+	m_light_node_map.erase( it );
+}
+
+void wmr::LightParser::Update()
+{
+	ScopedTraceEvent trace_event("LightParser::Update", "parser");
+
+	for( auto& handle : m_dirty_transforms )
 	{
-		std::iter_swap( it, it_end );
-		m_object_transform_vector.pop_back();
+		// Transforms can be removed after they changed
+		auto it = m_transform_light_map.find( handle );
+		if( it == m_transform_light_map.end() || !handle.isValid() )
+		{
+			continue;
+		}
+
+		MStatus status = MS::kSuccess;
+		MFnTransform transform( handle.object(), &status );
+		if( status != MS::kSuccess )
+		{
+			LOGE("Could not get a transform node.");
+			continue;
+		}
+
+		for( auto& light_object : it->second )
+		{
+			auto light_it = m_light_node_map.find( MObjectHandle( light_object ) );
+			if( light_it != m_light_node_map.end() && light_it->second.m_light_node )
+			{
+				updateTransform( transform, light_it->second.m_light_node );
+			}
+		}
+
+		++m_transform_statistics.m_updates_applied;
 	}
+	m_dirty_transforms.clear();
+}
+
+const wmr::TransformUpdateStatistics& wmr::LightParser::GetTransformUpdateStatistics() const noexcept
+{
+	return m_transform_statistics;
 }
 
 void wmr::LightParser::LightAdded( MFnLight & fn_light )
@@ -280,7 +275,9 @@ void wmr::LightParser::LightAdded( MFnLight & fn_light )
 
 	auto api_type = fn_light.object().apiType();
 
-	m_renderer.GetD3D12Renderer().WaitForAllPreviousWork();
+	// Batched with all other scene changes of this frame, only the first change waits for the GPU
+	m_renderer.PrepareSceneUpdate();
+
 	std::shared_ptr<wr::LightNode> light_node;
 	switch( api_type )
 	{
@@ -345,7 +342,8 @@ void wmr::LightParser::LightAdded( MFnLight & fn_light )
 
 	updateTransform( transform, light_node );
 
-	m_object_transform_vector.push_back( std::make_pair( fn_light.object(), light_node ) );
+	m_light_node_map[ MObjectHandle( fn_light.object() ) ] = LightNodeEntry{ object, light_node };
+	m_transform_light_map[ MObjectHandle( object ) ].push_back( fn_light.object() );
 
 	MCallbackId attributeId = MNodeMessage::addAttributeChangedCallback(
 		object,
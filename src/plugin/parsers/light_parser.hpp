@@ -15,6 +15,8 @@
 #pragma once
 #include <maya/MApiNamespace.h>
 #include <maya/MNodeMessage.h>
+#include "plugin/parsers/object_map.hpp"
+#include "plugin/parsers/scene_graph_parser.hpp"
 #include <scene_graph/scene_graph.hpp>	
 #include <vector>
 #include <memory>
@@ -40,12 +42,28 @@ namespace wmr
 		void UnSubscribeObject( MObject& maya_object );
 		void LightAdded( MFnLight & fn_light );
 
+		//! Apply the transform changes collected since the last update to the light nodes
+		void Update();
+
+		const TransformUpdateStatistics& GetTransformUpdateStatistics() const noexcept;
+
 	private:
 		//callbacks that require private access and are part of the ModelParser.
 		friend void AttributeLightTransformCallback( MNodeMessage::AttributeMessage msg, MPlug &plug, MPlug &otherPlug, void *clientData );
 		friend void AttributeLightCallback( MNodeMessage::AttributeMessage msg, MPlug &plug, MPlug &otherPlug, void *clientData );
 
-		std::vector<std::pair<MObject, std::shared_ptr<wr::LightNode>>> m_object_transform_vector;
+		//! Wisp node of a Maya light and the transform the node follows
+		struct LightNodeEntry
+		{
+			MObject m_transform;
+			std::shared_ptr<wr::LightNode> m_light_node;
+		};
+
+		MObjectMap<LightNodeEntry> m_light_node_map;					// Light to Wisp node
+		MObjectMap<std::vector<MObject>> m_transform_light_map;		// Transform to the lights parented to it
+		MObjectSet m_dirty_transforms;									// Transforms changed since the last update
+
+		TransformUpdateStatistics m_transform_statistics;
 		std::vector<std::pair<MObject, MCallbackId>> m_mesh_added_callback_vector;
 
 		Renderer& m_renderer;
@@ -14,6 +14,7 @@
 
 #include "material_parser.hpp"
 
+#include "miscellaneous/trace_recorder.hpp"
 #include "plugin/callback_manager.hpp"
 #include "plugin/renderer/material_manager.hpp"
 #include "plugin/renderer/renderer.hpp"
@@ -57,6 +58,8 @@ namespace wmr
 {
 	void DirtyNodeCallback(MObject &node, MPlug &plug, void *clientData)
 	{
+		ScopedTraceEvent trace_event("DirtyNodeCallback", "callback");
+
 		// Get material parser, material manager, and material handle from client data
 		wmr::MaterialParser::ShaderDirtyData *shader_dirty_shader = reinterpret_cast<wmr::MaterialParser::ShaderDirtyData*>(clientData);
 		wmr::MaterialParser * material_parser = shader_dirty_shader->material_parser;
@@ -99,6 +102,7 @@ namespace wmr
 		}
 
 		material->UpdateConstantBuffer();
+		material_parser->GetRenderer().MarkSceneChanged();
 	}
 } /* namespace wmr */
 
@@ -229,6 +233,7 @@ void wmr::MaterialParser::OnCreateSurfaceShader(MPlug & surface_shader)
 		auto& material_manager = m_renderer.GetMaterialManager();
 		auto& texture_manager = m_renderer.GetTextureManager();
 		InitialMaterialBuild(surface_shader, shader_type, relation->material_handle, material_manager, texture_manager);
+		m_renderer.MarkSceneChanged();
 	}
 }
 
@@ -236,6 +241,7 @@ void wmr::MaterialParser::OnRemoveSurfaceShader(MPlug & surface_shader)
 {
 	// Call material manager on remove
 	m_renderer.GetMaterialManager().OnRemoveSurfaceShader(surface_shader);
+	m_renderer.MarkSceneChanged();
 
 	// Remove callback from material parser
 	MObject surface_shader_object = surface_shader.node();
@@ -258,6 +264,7 @@ void wmr::MaterialParser::OnRemoveSurfaceShader(MPlug & surface_shader)
 void wmr::MaterialParser::ConnectShaderToShadingEngine(MPlug & surface_shader, MObject & shading_engine)
 {
 	m_renderer.GetMaterialManager().ConnectShaderToShadingEngine(surface_shader, shading_engine, true);
+	m_renderer.MarkSceneChanged();
 
 	// Find if shader has callback
 	MObject surface_shader_object = surface_shader.node();
@@ -267,16 +274,19 @@ void wmr::MaterialParser::ConnectShaderToShadingEngine(MPlug & surface_shader, M
 void wmr::MaterialParser::DisconnectShaderFromShadingEngine(MPlug & surface_shader, MObject & shading_engine)
 {
 	m_renderer.GetMaterialManager().DisconnectShaderFromShadingEngine(surface_shader, shading_engine);
+	m_renderer.MarkSceneChanged();
 }
 
 void wmr::MaterialParser::ConnectMeshToShadingEngine(MObject & mesh, MObject & shading_engine)
 {
 	m_renderer.GetMaterialManager().ConnectMeshToShadingEngine(mesh, shading_engine);
+	m_renderer.MarkSceneChanged();
 }
 
 void wmr::MaterialParser::DisconnectMeshFromShadingEngine(MObject & mesh, MObject & shading_engine)
 {
 	m_renderer.GetMaterialManager().DisconnectMeshFromShadingEngine(mesh, shading_engine);
+	m_renderer.MarkSceneChanged();
 }
 
 const wmr::detail::SurfaceShaderType wmr::MaterialParser::GetShaderType(const MObject& node)
@@ -583,13 +593,7 @@ void wmr::MaterialParser::ConfigureWispMaterial(const wmr::LambertShaderData & d
 	else
 	{
 		// Request new Wisp textures
-		auto albedo_texture = texture_manager.CreateTexture(data.diffuse_color_texture_path);
-
-		if (albedo_texture != nullptr) {
-			// Use this texture as the material albedo texture
-			material->SetTexture(wr::TextureType::ALBEDO, *albedo_texture);
-		}
-		else {
+		if (!texture_manager.RequestTexture(data.diffuse_color_texture_path, *material, wr::TextureType::ALBEDO)) {
 			// Set to default values if texture wasn't found
 			material->SetConstant<wr::MaterialConstant::COLOR>({ wmr::MayaMaterialProps::default_albedo[0], wmr::MayaMaterialProps::default_albedo[1], wmr::MayaMaterialProps::default_albedo[2] });
 		}
@@ -597,10 +601,7 @@ void wmr::MaterialParser::ConfigureWispMaterial(const wmr::LambertShaderData & d
 
 	if (strcmp(data.bump_map_texture_path, "") != 0)
 	{
-		auto bump = texture_manager.CreateTexture(data.bump_map_texture_path);
-		if (bump != nullptr) {
-			material->SetTexture(wr::TextureType::NORMAL, *bump);
-		}
+		texture_manager.RequestTexture(data.bump_map_texture_path, *material, wr::TextureType::NORMAL);
 	}
 
 	material->SetConstant<wr::MaterialConstant::METALLIC>(MayaMaterialProps::default_metallicness);
@@ -616,12 +617,7 @@ void wmr::MaterialParser::ConfigureWispMaterial(const wmr::PhongShaderData & dat
 	else
 	{
 		// Request new Wisp textures
-		auto albedo_texture = texture_manager.CreateTexture(data.diffuse_color_texture_path);
-		if (albedo_texture != nullptr) {
-			// Use this texture as the material albedo texture
-			material->SetTexture(wr::TextureType::ALBEDO, *albedo_texture);
-		}
-		else {
+		if (!texture_manager.RequestTexture(data.diffuse_color_texture_path, *material, wr::TextureType::ALBEDO)) {
 			// Set to default values if texture wasn't found
 			material->SetConstant<wr::MaterialConstant::COLOR>({ wmr::MayaMaterialProps::default_albedo[0], wmr::MayaMaterialProps::default_albedo[1], wmr::MayaMaterialProps::default_albedo[2] });
 		}
@@ -629,11 +625,8 @@ void wmr::MaterialParser::ConfigureWispMaterial(const wmr::PhongShaderData & dat
 
 	if (strcmp(data.bump_map_texture_path, "") != 0)
 	{
-		auto bump = texture_manager.CreateTexture(data.bump_map_texture_path);
 		// Don't set normal texture if it wasn't found
-		if (bump != nullptr) {
-			material->SetTexture(wr::TextureType::NORMAL, *bump);
-		}
+		texture_manager.RequestTexture(data.bump_map_texture_path, *material, wr::TextureType::NORMAL);
 	}
 
 	material->SetConstant<wr::MaterialConstant::METALLIC>(MayaMaterialProps::default_metallicness);
@@ -650,13 +643,7 @@ void wmr::MaterialParser::ConfigureWispMaterial(const wmr::ArnoldStandardSurface
 	else
 	{
 		// Request new Wisp textures
-		auto albedo_texture = texture_manager.CreateTexture(data.diffuse_color_texture_path);
-
-		if (albedo_texture != nullptr) {
-			// Use this texture as the material albedo texture
-			material->SetTexture(wr::TextureType::ALBEDO, *albedo_texture);
-		}
-		else {
+		if (!texture_manager.RequestTexture(data.diffuse_color_texture_path, *material, wr::TextureType::ALBEDO)) {
 			// Set to default values if texture wasn't found
 			material->SetConstant<wr::MaterialConstant::COLOR>({ wmr::MayaMaterialProps::default_albedo[0], wmr::MayaMaterialProps::default_albedo[1], wmr::MayaMaterialProps::default_albedo[2] });
 		}
@@ -670,13 +657,7 @@ void wmr::MaterialParser::ConfigureWispMaterial(const wmr::ArnoldStandardSurface
 	else
 	{
 		// Request new Wisp textures
-		auto roughness_texture = texture_manager.CreateTexture(data.roughness_texture_path);
-
-		if (roughness_texture != nullptr) {
-			// Use this texture as the material roughness texture
-			material->SetTexture(wr::TextureType::ROUGHNESS, *roughness_texture);
-		}
-		else {
+		if (!texture_manager.RequestTexture(data.roughness_texture_path, *material, wr::TextureType::ROUGHNESS)) {
 			// Set to default values if texture wasn't found
 			material->SetConstant<wr::MaterialConstant::ROUGHNESS>(wmr::MayaMaterialProps::default_roughness);
 		}
@@ -690,13 +671,7 @@ void wmr::MaterialParser::ConfigureWispMaterial(const wmr::ArnoldStandardSurface
 	else
 	{
 		// Request new Wisp textures
-		auto metalness_texture = texture_manager.CreateTexture(data.metalness_texture_path);
-
-		if (metalness_texture != nullptr) {
-			// Use this texture as the material albedo texture
-			material->SetTexture(wr::TextureType::METALLIC, *metalness_texture);
-		}
-		else {
+		if (!texture_manager.RequestTexture(data.metalness_texture_path, *material, wr::TextureType::METALLIC)) {
 			// Set to default values if texture wasn't found
 			material->SetConstant<wr::MaterialConstant::METALLIC>(wmr::MayaMaterialProps::default_metallicness);
 		}
@@ -705,10 +680,7 @@ void wmr::MaterialParser::ConfigureWispMaterial(const wmr::ArnoldStandardSurface
 	// Normal
 	if (strcmp(data.bump_map_texture_path, "") != 0)
 	{
-		auto bump = texture_manager.CreateTexture(data.bump_map_texture_path);
-		if (bump != nullptr) {
-			material->SetTexture(wr::TextureType::NORMAL, *bump);
-		}
+		texture_manager.RequestTexture(data.bump_map_texture_path, *material, wr::TextureType::NORMAL);
 	}
 
 	// Emissive weight
@@ -721,13 +693,7 @@ void wmr::MaterialParser::ConfigureWispMaterial(const wmr::ArnoldStandardSurface
 	if (!data.using_emission_color_value)
 	{
 		// Request new Wisp textures
-		auto emission_texture = texture_manager.CreateTexture(data.emission_color_texture_path);
-
-		if (emission_texture != nullptr)
-		{
-			// Use this texture as the material albedo texture
-			material->SetTexture(wr::TextureType::EMISSIVE, *emission_texture);
-		}
+		texture_manager.RequestTexture(data.emission_color_texture_path, *material, wr::TextureType::EMISSIVE);
 	}
 }
 
@@ -768,7 +734,7 @@ void wmr::MaterialParser::HandleArnoldChange(MFnDependencyNode & fn, MPlug & plu
 	ConfigureWispMaterial(data, &material, m_renderer.GetTextureManager());
 }
 
-const wmr::Renderer & wmr::MaterialParser::GetRenderer()
+wmr::Renderer & wmr::MaterialParser::GetRenderer()
 {
 	return m_renderer;
 }
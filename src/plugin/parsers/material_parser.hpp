@@ -95,7 +95,7 @@ namespace wmr
 		void HandlePhongChange(MFnDependencyNode &fn, MPlug & plug, MString & plug_name, wr::Material & material);
 		void HandleArnoldChange(MFnDependencyNode &fn, MPlug & plug, MString & plug_name, wr::Material & material);
 
-		const Renderer & GetRenderer();
+		Renderer & GetRenderer();
 		const detail::SurfaceShaderType GetShaderType(const MObject& node);
 
 		struct ShaderDirtyData
@@ -0,0 +1,330 @@
+// Copyright 2019 Breda University of Applied Sciences and Team Wisp (Viktor Zoutman, Emilio Laiso, Jens Hagen, Meine Zeinstra, Tahar Meijs, Koen Buitenhuis, Niels Brunekreef, Darius Bouma, Florian Schut)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mesh_converter.hpp"
+
+// C++ standard
+#include <algorithm>
+
+namespace wmr
+{
+	std::size_t MeshSource::GetTriangleCount() const noexcept
+	{
+		return m_corner_points.size() / 3;
+	}
+
+	std::size_t MeshSource::GetPointCount() const noexcept
+	{
+		return m_points.size() / 3;
+	}
+
+	bool MeshSource::IsValid() const noexcept
+	{
+		const auto corner_count = m_corner_points.size();
+
+		if (corner_count % 3 != 0 ||
+			m_corner_normals.size() != corner_count ||
+			m_corner_tangents.size() != corner_count ||
+			m_corner_uvs.size() != corner_count ||
+			m_bitangents.size() != m_normals.size() ||
+			m_u.size() != m_v.size())
+		{
+			return false;
+		}
+
+		auto in_range = [](const std::vector<std::int32_t>& corner_indices, std::size_t count) -> bool
+		{
+			for (auto index : corner_indices)
+			{
+				if (index < 0 || static_cast<std::size_t>(index) >= count)
+				{
+					return false;
+				}
+			}
+			return true;
+		};
+
+		return (in_range(m_corner_points, m_points.size() / 3) &&
+				in_range(m_corner_normals, m_normals.size() / 3) &&
+				in_range(m_corner_tangents, m_tangents.size() / 3) &&
+				in_range(m_corner_uvs, m_u.size()));
+	}
+
+	void ResolveTriangleCorners(const PolygonSource& polygons, MeshSource& source, ThreadPool* pool)
+	{
+		const auto polygon_count = polygons.m_polygon_vertex_counts.size();
+
+		// Offsets of the first face-vertex and the first triangle of every polygon
+		std::vector<std::size_t> face_vertex_offsets(polygon_count + 1, 0);
+		std::vector<std::size_t> triangle_offsets(polygon_count + 1, 0);
+
+		for (std::size_t polygon = 0; polygon < polygon_count; ++polygon)
+		{
+			face_vertex_offsets[polygon + 1] = face_vertex_offsets[polygon] + polygons.m_polygon_vertex_counts[polygon];
+			triangle_offsets[polygon + 1] = triangle_offsets[polygon] + polygons.m_polygon_triangle_counts[polygon];
+		}
+
+		const auto corner_count = triangle_offsets[polygon_count] * 3;
+		source.m_corner_points.resize(corner_count);
+		source.m_corner_normals.resize(corner_count);
+		source.m_corner_tangents.resize(corner_count);
+		source.m_corner_uvs.resize(corner_count);
+
+		// Face-relative indices: the face-vertex follows directly from the offset of the polygon
+		auto resolve_offsets = [&](std::size_t, std::size_t begin, std::size_t end)
+		{
+			for (std::size_t polygon = begin; polygon < end; ++polygon)
+			{
+				const auto first_face_vertex = face_vertex_offsets[polygon];
+
+				for (auto corner = triangle_offsets[polygon] * 3; corner < triangle_offsets[polygon + 1] * 3; ++corner)
+				{
+					const auto face_vertex = first_face_vertex + polygons.m_triangle_face_vertices[corner];
+
+					source.m_corner_points[corner] = polygons.m_face_vertex_points[face_vertex];
+					source.m_corner_normals[corner] = polygons.m_face_vertex_normals[face_vertex];
+					source.m_corner_tangents[corner] = polygons.m_face_vertex_tangents[face_vertex];
+					source.m_corner_uvs[corner] = polygons.m_face_vertex_uvs[face_vertex];
+				}
+			}
+		};
+
+		// Object-relative indices: search the face-vertices of the polygon for the point of the corner
+		auto resolve_points = [&](std::size_t, std::size_t begin, std::size_t end)
+		{
+			for (std::size_t polygon = begin; polygon < end; ++polygon)
+			{
+				const auto first_face_vertex = face_vertex_offsets[polygon];
+				const auto last_face_vertex = face_vertex_offsets[polygon + 1];
+
+				for (auto corner = triangle_offsets[polygon] * 3; corner < triangle_offsets[polygon + 1] * 3; ++corner)
+				{
+					const auto point = polygons.m_triangle_points[corner];
+
+					auto face_vertex = first_face_vertex;
+					for (auto i = first_face_vertex; i < last_face_vertex; ++i)
+					{
+						if (polygons.m_face_vertex_points[i] == point)
+						{
+							face_vertex = i;
+							break;
+						}
+					}
+
+					source.m_corner_points[corner] = point;
+					source.m_corner_normals[corner] = polygons.m_face_vertex_normals[face_vertex];
+					source.m_corner_tangents[corner] = polygons.m_face_vertex_tangents[face_vertex];
+					source.m_corner_uvs[corner] = polygons.m_face_vertex_uvs[face_vertex];
+				}
+			}
+		};
+
+		const auto chunk_count = GetConversionChunkCount(triangle_offsets[polygon_count], pool);
+
+		auto run = [&](const auto& resolve_polygons)
+		{
+			if (pool && chunk_count > 1)
+			{
+				pool->ParallelFor(polygon_count, chunk_count, resolve_polygons);
+			}
+			else
+			{
+				resolve_polygons(0, 0, polygon_count);
+			}
+		};
+
+		if (polygons.m_triangle_face_vertices.size() == corner_count)
+		{
+			run(resolve_offsets);
+		}
+		else
+		{
+			run(resolve_points);
+		}
+	}
+
+	MeshTopology GetMeshTopology(const MeshSource& source, const PolygonSource& polygons) noexcept
+	{
+		// FNV-1a over every index, the array sizes are hashed as well to separate the arrays
+		std::uint64_t hash = 0xcbf29ce484222325ull;
+
+		auto hash_array = [&hash](const std::vector<std::int32_t>& values)
+		{
+			hash = (hash ^ values.size()) * 0x100000001b3ull;
+
+			for (auto value : values)
+			{
+				hash = (hash ^ static_cast<std::uint32_t>(value)) * 0x100000001b3ull;
+			}
+		};
+
+		hash_array(polygons.m_polygon_vertex_counts);
+		hash_array(polygons.m_face_vertex_points);
+		hash_array(polygons.m_face_vertex_normals);
+		hash_array(polygons.m_face_vertex_uvs);
+
+		MeshTopology topology;
+		topology.m_point_count = source.m_points.size() / 3;
+		topology.m_normal_count = source.m_normals.size() / 3;
+		topology.m_tangent_count = source.m_tangents.size() / 3;
+		topology.m_uv_count = source.m_u.size();
+		topology.m_face_vertex_hash = hash;
+
+		return topology;
+	}
+
+	void BuildDirtyRanges(const std::vector<std::uint8_t>& dirty_flags, std::size_t max_clean_gap, std::vector<VertexRange>& ranges)
+	{
+		ranges.clear();
+
+		for (std::size_t i = 0; i < dirty_flags.size(); ++i)
+		{
+			if (!dirty_flags[i])
+			{
+				continue;
+			}
+
+			// Extend the previous range when the gap is small enough, uploading a few clean vertices is cheaper than
+			// issuing another copy
+			if (!ranges.empty() && i - (ranges.back().m_first + ranges.back().m_count) <= max_clean_gap)
+			{
+				ranges.back().m_count = i - ranges.back().m_first + 1;
+			}
+			else
+			{
+				ranges.push_back({ i, 1 });
+			}
+		}
+	}
+
+	std::size_t GetConversionChunkCount(std::size_t triangle_count, const ThreadPool* pool, std::size_t min_triangles_per_chunk) noexcept
+	{
+		if (!pool)
+		{
+			return 1;
+		}
+
+		// The calling thread processes a chunk as well
+		const auto max_chunk_count = pool->GetThreadCount() + 1;
+		const auto chunk_count = triangle_count / std::max<std::size_t>(min_triangles_per_chunk, 1);
+
+		return std::clamp<std::size_t>(chunk_count, 1, max_chunk_count);
+	}
+
+	void WeldCorners(const MeshSource& source, std::vector<FaceVertexKey>& unique_keys, std::vector<std::uint32_t>& indices)
+	{
+		const auto corner_count = source.m_corner_points.size();
+
+		// The number of points is usually a good estimate of the number of unique vertices
+		VertexWelder welder;
+		welder.Reserve(source.GetPointCount());
+
+		unique_keys.clear();
+		unique_keys.reserve(source.GetPointCount());
+
+		indices.resize(corner_count);
+
+		for (std::size_t corner = 0; corner < corner_count; ++corner)
+		{
+			FaceVertexKey key;
+			key.m_point = source.m_corner_points[corner];
+			key.m_normal = source.m_corner_normals[corner];
+			key.m_tangent = source.m_corner_tangents[corner];
+			key.m_uv = source.m_corner_uvs[corner];
+
+			bool is_new_vertex = false;
+			indices[corner] = welder.Weld(key, is_new_vertex);
+
+			if (is_new_vertex)
+			{
+				unique_keys.push_back(key);
+			}
+		}
+	}
+
+	void WeldCornersParallel(const MeshSource& source, std::vector<FaceVertexKey>& unique_keys, std::vector<std::uint32_t>& indices, ThreadPool& pool, std::size_t chunk_count)
+	{
+		const auto triangle_count = source.GetTriangleCount();
+
+		indices.resize(triangle_count * 3);
+
+		// Weld every chunk on its own, the indices are chunk-relative after this step
+		std::vector<std::vector<FaceVertexKey>> chunk_keys(chunk_count);
+
+		pool.ParallelFor(triangle_count, chunk_count, [&source, &indices, &chunk_keys](std::size_t chunk, std::size_t begin, std::size_t end)
+		{
+			VertexWelder welder;
+			welder.Reserve(end - begin);
+
+			auto& keys = chunk_keys[chunk];
+			keys.reserve(end - begin);
+
+			for (auto corner = begin * 3; corner < end * 3; ++corner)
+			{
+				FaceVertexKey key;
+				key.m_point = source.m_corner_points[corner];
+				key.m_normal = source.m_corner_normals[corner];
+				key.m_tangent = source.m_corner_tangents[corner];
+				key.m_uv = source.m_corner_uvs[corner];
+
+				bool is_new_vertex = false;
+				indices[corner] = welder.Weld(key, is_new_vertex);
+
+				if (is_new_vertex)
+				{
+					keys.push_back(key);
+				}
+			}
+		});
+
+		// Merge the chunks in order. A face-vertex gets the same output index as in the single-threaded weld, as it is
+		// first encountered in the earliest chunk that references it, at its first position within that chunk.
+		VertexWelder welder;
+		welder.Reserve(source.GetPointCount());
+
+		unique_keys.clear();
+		unique_keys.reserve(source.GetPointCount());
+
+		std::vector<std::vector<std::uint32_t>> chunk_remaps(chunk_count);
+
+		for (std::size_t chunk = 0; chunk < chunk_count; ++chunk)
+		{
+			const auto& keys = chunk_keys[chunk];
+			auto& remap = chunk_remaps[chunk];
+			remap.resize(keys.size());
+
+			for (std::size_t i = 0; i < keys.size(); ++i)
+			{
+				bool is_new_vertex = false;
+				remap[i] = welder.Weld(keys[i], is_new_vertex);
+
+				if (is_new_vertex)
+				{
+					unique_keys.push_back(keys[i]);
+				}
+			}
+		}
+
+		// Translate the chunk-relative indices into output indices (same chunk ranges as the first pass)
+		pool.ParallelFor(triangle_count, chunk_count, [&indices, &chunk_remaps](std::size_t chunk, std::size_t begin, std::size_t end)
+		{
+			const auto& remap = chunk_remaps[chunk];
+
+			for (auto corner = begin * 3; corner < end * 3; ++corner)
+			{
+				indices[corner] = remap[indices[corner]];
+			}
+		});
+	}
+}
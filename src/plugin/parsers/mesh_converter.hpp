@@ -0,0 +1,290 @@
+// Copyright 2019 Breda University of Applied Sciences and Team Wisp (Viktor Zoutman, Emilio Laiso, Jens Hagen, Meine Zeinstra, Tahar Meijs, Koen Buitenhuis, Niels Brunekreef, Darius Bouma, Florian Schut)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+// Wisp plug-in
+#include "miscellaneous/thread_pool.hpp"
+#include "plugin/parsers/vertex_welder.hpp"
+
+// C++ standard
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+//! Generic plug-in namespace (Wisp Maya Renderer)
+namespace wmr
+{
+	//! Meshes with fewer triangles per worker thread than this value are converted on the calling thread only
+	static const constexpr std::size_t MIN_TRIANGLES_PER_CONVERSION_CHUNK = 16384;
+
+	//! Dirty vertex ranges separated by no more than this number of clean vertices are merged into a single range
+	static const constexpr std::size_t MAX_CLEAN_VERTICES_IN_DIRTY_RANGE = 16;
+
+	//! Plain mesh data, as gathered from a Maya mesh
+	/*! This structure does not depend on the Maya API, which allows the mesh conversion to be tested and profiled
+	 *  without a Maya installation. All vectors (points, normals, tangents, and bitangents) are stored as tightly
+	 *  packed XYZ floats. Bitangents are indexed using the normal indices, just like Maya does.
+	 *
+	 *  Every triangle is described by three corners, and every corner stores the index of each attribute it uses. */
+	struct MeshSource
+	{
+		std::vector<float> m_points;			//!< XYZ per point
+		std::vector<float> m_normals;			//!< XYZ per normal
+		std::vector<float> m_tangents;			//!< XYZ per tangent
+		std::vector<float> m_bitangents;		//!< XYZ per bitangent (same count as the normals)
+		std::vector<float> m_u;					//!< U coordinate per UV
+		std::vector<float> m_v;					//!< V coordinate per UV
+
+		std::vector<std::int32_t> m_corner_points;		//!< Point index per triangle corner
+		std::vector<std::int32_t> m_corner_normals;		//!< Normal index per triangle corner
+		std::vector<std::int32_t> m_corner_tangents;	//!< Tangent index per triangle corner
+		std::vector<std::int32_t> m_corner_uvs;			//!< UV index per triangle corner
+
+		//! Number of triangles described by the corner arrays
+		std::size_t GetTriangleCount() const noexcept;
+
+		//! Number of unique points in the mesh
+		std::size_t GetPointCount() const noexcept;
+
+		//! Check whether every corner array has the same size and every index is in range
+		bool IsValid() const noexcept;
+	};
+
+	//! Polygon topology of a mesh, as returned by the bulk getters of MFnMesh
+	/*! Face-vertex arrays store one entry per polygon corner, in the order of MFnMesh::getVertices(). Triangle corners
+	 *  are described in one of two ways. The result of MFnMesh::getTriangleOffsets() gives face-relative vertex indices,
+	 *  which index the face-vertex arrays directly. The result of MFnMesh::getTriangles() gives object-relative point
+	 *  indices, which have to be looked up in the face-vertices of the polygon first. Fill either one of them. */
+	struct PolygonSource
+	{
+		std::vector<std::int32_t> m_polygon_vertex_counts;		//!< Number of face-vertices per polygon
+		std::vector<std::int32_t> m_polygon_triangle_counts;	//!< Number of triangles per polygon
+
+		std::vector<std::int32_t> m_face_vertex_points;			//!< Point index per face-vertex
+		std::vector<std::int32_t> m_face_vertex_normals;		//!< Normal index per face-vertex
+		std::vector<std::int32_t> m_face_vertex_tangents;		//!< Tangent index per face-vertex
+		std::vector<std::int32_t> m_face_vertex_uvs;			//!< UV index per face-vertex
+
+		std::vector<std::int32_t> m_triangle_face_vertices;		//!< Face-relative vertex index per triangle corner
+		std::vector<std::int32_t> m_triangle_points;			//!< Object-relative point index per triangle corner
+	};
+
+	//! Fill the corner arrays of a mesh source using the polygon topology
+	/*! The face-vertex of every triangle corner gives the point, normal, tangent, and UV index of the corner. When the
+	 *  face-relative triangle indices are available, the face-vertex is found using a flat offset table. Otherwise, every
+	 *  corner is matched to the face-vertex of its polygon that references the same point, which is a linear search
+	 *  per corner and gets slow on polygons with a lot of vertices.
+	 *
+	 *  \param polygons Polygon topology of the mesh.
+	 *  \param source Receives the triangle corner arrays, the attribute arrays are left untouched.
+	 *  \param pool Optional thread pool used to process the polygons in parallel. */
+	void ResolveTriangleCorners(const PolygonSource& polygons, MeshSource& source, ThreadPool* pool = nullptr);
+
+	//! Counts and index layout of a mesh, used to detect whether a cached conversion can still be patched
+	/*! Two meshes with the same topology produce the same index buffer and reference the same attribute indices from
+	 *  every output vertex. Only the values of the attributes (positions, normals, etc.) can differ. */
+	struct MeshTopology
+	{
+		std::size_t m_point_count = 0;			//!< Number of points
+		std::size_t m_normal_count = 0;			//!< Number of normals (and bitangents)
+		std::size_t m_tangent_count = 0;		//!< Number of tangents
+		std::size_t m_uv_count = 0;				//!< Number of UVs
+		std::uint64_t m_face_vertex_hash = 0;	//!< Hash of the polygon sizes and the point, normal, and UV index per face-vertex
+
+		bool operator==(const MeshTopology& rhs) const noexcept
+		{
+			return (m_point_count == rhs.m_point_count &&
+					m_normal_count == rhs.m_normal_count &&
+					m_tangent_count == rhs.m_tangent_count &&
+					m_uv_count == rhs.m_uv_count &&
+					m_face_vertex_hash == rhs.m_face_vertex_hash);
+		}
+	};
+
+	//! Range of vertices in a vertex buffer
+	struct VertexRange
+	{
+		std::size_t m_first;	//!< Index of the first vertex in the range
+		std::size_t m_count;	//!< Number of vertices in the range
+	};
+
+	//! Compute the topology of a mesh
+	/*! Tangent and triangle indices are not part of the hash, so they do not have to be gathered to check whether a
+	 *  mesh changed. Maya derives them from the face-vertex layout, which is part of the hash.
+	 *
+	 *  \param source Attribute arrays of the mesh (corner arrays are not used).
+	 *  \param polygons Polygon topology, only the vertex counts and the face-vertex points, normals, and UVs are used. */
+	MeshTopology GetMeshTopology(const MeshSource& source, const PolygonSource& polygons) noexcept;
+
+	//! Convert a per-vertex dirty flag array into a list of vertex ranges
+	/*! \param dirty_flags Non-zero for every vertex that changed.
+	 *  \param max_clean_gap Ranges separated by no more than this number of clean vertices are merged.
+	 *  \param ranges Receives the dirty ranges in ascending order (previous contents are discarded). */
+	void BuildDirtyRanges(const std::vector<std::uint8_t>& dirty_flags, std::size_t max_clean_gap, std::vector<VertexRange>& ranges);
+
+	//! Number of chunks to split a mesh conversion into
+	/*! \return One when the mesh should be converted on the calling thread only. */
+	std::size_t GetConversionChunkCount(std::size_t triangle_count, const ThreadPool* pool, std::size_t min_triangles_per_chunk = MIN_TRIANGLES_PER_CONVERSION_CHUNK) noexcept;
+
+	//! Merge all triangle corners of a mesh into unique face-vertices
+	/*! \param source Mesh to process.
+	 *  \param unique_keys Receives the attribute indices of every output vertex, in output order.
+	 *  \param indices Receives the index buffer (three indices per triangle). */
+	void WeldCorners(const MeshSource& source, std::vector<FaceVertexKey>& unique_keys, std::vector<std::uint32_t>& indices);
+
+	//! Merge all triangle corners of a mesh into unique face-vertices using multiple threads
+	/*! The triangles are split into chunks that are welded in parallel. Afterwards, the unique face-vertices of every
+	 *  chunk are merged in chunk order, so the output is identical to the output of the single-threaded WeldCorners().
+	 *  New vertices of a chunk end up after the new vertices of all previous chunks, so the output vertex offset of a
+	 *  chunk is the prefix sum of the new vertex counts of the chunks before it.
+	 *
+	 *  \param source Mesh to process.
+	 *  \param unique_keys Receives the attribute indices of every output vertex, in output order.
+	 *  \param indices Receives the index buffer (three indices per triangle).
+	 *  \param pool Thread pool used to process the chunks.
+	 *  \param chunk_count Number of chunks to split the triangles into. */
+	void WeldCornersParallel(const MeshSource& source, std::vector<FaceVertexKey>& unique_keys, std::vector<std::uint32_t>& indices, ThreadPool& pool, std::size_t chunk_count);
+
+	//! Build a single vertex from the attribute indices of a face-vertex
+	/*! TVertex needs the same members as wr::Vertex: m_pos, m_normal, m_tangent, m_bitangent, and m_uv. */
+	template<typename TVertex>
+	inline void BuildVertex(const MeshSource& source, const FaceVertexKey& key, TVertex& vertex) noexcept
+	{
+		const float* point = &source.m_points[key.m_point * 3];
+		const float* normal = &source.m_normals[key.m_normal * 3];
+		const float* tangent = &source.m_tangents[key.m_tangent * 3];
+		const float* bitangent = &source.m_bitangents[key.m_normal * 3];
+
+		for (std::size_t i = 0; i < 3; ++i)
+		{
+			vertex.m_pos[i] = point[i];
+			vertex.m_normal[i] = normal[i];
+			vertex.m_tangent[i] = tangent[i];
+			vertex.m_bitangent[i] = bitangent[i];
+		}
+
+		vertex.m_uv[0] = source.m_u[key.m_uv];
+		vertex.m_uv[1] = source.m_v[key.m_uv];
+	}
+
+	//! Whether two vertices have bitwise identical members
+	/*! Compared member by member, the padding of TVertex is never read. */
+	template<typename TVertex>
+	inline bool IsSameVertex(const TVertex& a, const TVertex& b) noexcept
+	{
+		return std::memcmp(a.m_pos, b.m_pos, sizeof(a.m_pos)) == 0 &&
+			std::memcmp(a.m_normal, b.m_normal, sizeof(a.m_normal)) == 0 &&
+			std::memcmp(a.m_tangent, b.m_tangent, sizeof(a.m_tangent)) == 0 &&
+			std::memcmp(a.m_bitangent, b.m_bitangent, sizeof(a.m_bitangent)) == 0 &&
+			std::memcmp(a.m_uv, b.m_uv, sizeof(a.m_uv)) == 0;
+	}
+
+	//! Convert plain mesh data into an indexed vertex buffer
+	/*! Triangle corners that share all attribute indices are welded into a single vertex. When a thread pool is
+	 *  passed and the mesh is large enough, the conversion is split over the threads of the pool. The output does not
+	 *  depend on the number of threads used.
+	 *
+	 *  \param source Mesh to convert.
+	 *  \param vertices Receives the unique vertices (previous contents are discarded).
+	 *  \param indices Receives the index buffer (previous contents are discarded).
+	 *  \param pool Optional thread pool used to convert the mesh in parallel.
+	 *  \param min_triangles_per_chunk Minimum amount of work per thread before the conversion is split up. */
+	template<typename TVertex>
+	inline void ConvertMesh(const MeshSource& source, std::vector<TVertex>& vertices, std::vector<std::uint32_t>& indices, ThreadPool* pool = nullptr, std::size_t min_triangles_per_chunk = MIN_TRIANGLES_PER_CONVERSION_CHUNK)
+	{
+		std::vector<FaceVertexKey> unique_keys;
+		ConvertMesh(source, vertices, indices, unique_keys, pool, min_triangles_per_chunk);
+	}
+
+	//! Convert plain mesh data into an indexed vertex buffer, and keep the attribute indices of every vertex
+	/*! Same as the function above. The unique keys can be passed to PatchVertices() later on, to update the vertices
+	 *  without converting the whole mesh again.
+	 *
+	 *  \param unique_keys Receives the attribute indices of every output vertex (previous contents are discarded). */
+	template<typename TVertex>
+	inline void ConvertMesh(const MeshSource& source, std::vector<TVertex>& vertices, std::vector<std::uint32_t>& indices, std::vector<FaceVertexKey>& unique_keys, ThreadPool* pool = nullptr, std::size_t min_triangles_per_chunk = MIN_TRIANGLES_PER_CONVERSION_CHUNK)
+	{
+		const auto chunk_count = GetConversionChunkCount(source.GetTriangleCount(), pool, min_triangles_per_chunk);
+
+		auto build_vertices = [&source, &unique_keys, &vertices](std::size_t, std::size_t begin, std::size_t end)
+		{
+			for (std::size_t i = begin; i < end; ++i)
+			{
+				BuildVertex(source, unique_keys[i], vertices[i]);
+			}
+		};
+
+		if (pool && chunk_count > 1)
+		{
+			WeldCornersParallel(source, unique_keys, indices, *pool, chunk_count);
+
+			vertices.resize(unique_keys.size());
+			pool->ParallelFor(unique_keys.size(), chunk_count, build_vertices);
+		}
+		else
+		{
+			WeldCorners(source, unique_keys, indices);
+
+			vertices.resize(unique_keys.size());
+			build_vertices(0, 0, unique_keys.size());
+		}
+	}
+
+	//! Rebuild the vertices of a previously converted mesh whose topology did not change
+	/*! Only the attribute values are read from the source, the corner arrays are not needed. Every vertex is rebuilt
+	 *  and compared to its previous value, so vertices affected by recomputed normals or tangents are detected as well.
+	 *
+	 *  \param source Attribute arrays of the mesh, with the same topology as during the conversion.
+	 *  \param unique_keys Attribute indices of every vertex, as returned by ConvertMesh().
+	 *  \param vertices Vertices of the previous conversion, changed vertices are overwritten.
+	 *  \param dirty_ranges Receives the ranges of vertices that changed (empty when nothing changed).
+	 *  \param pool Optional thread pool used to process the vertices in parallel. */
+	template<typename TVertex>
+	inline void PatchVertices(const MeshSource& source, const std::vector<FaceVertexKey>& unique_keys, std::vector<TVertex>& vertices, std::vector<VertexRange>& dirty_ranges, ThreadPool* pool = nullptr)
+	{
+		std::vector<std::uint8_t> dirty_flags(unique_keys.size(), 0);
+
+		auto patch_vertices = [&source, &unique_keys, &vertices, &dirty_flags](std::size_t, std::size_t begin, std::size_t end)
+		{
+			TVertex vertex{};
+
+			for (std::size_t i = begin; i < end; ++i)
+			{
+				BuildVertex(source, unique_keys[i], vertex);
+
+				if (!IsSameVertex(vertex, vertices[i]))
+				{
+					vertices[i] = vertex;
+					dirty_flags[i] = 1;
+				}
+			}
+		};
+
+		// Patching a vertex costs about as much as converting a triangle, so the same chunk size is used
+		const auto chunk_count = GetConversionChunkCount(unique_keys.size(), pool);
+
+		if (pool && chunk_count > 1)
+		{
+			pool->ParallelFor(unique_keys.size(), chunk_count, patch_vertices);
+		}
+		else
+		{
+			patch_vertices(0, 0, unique_keys.size());
+		}
+
+		BuildDirtyRanges(dirty_flags, MAX_CLEAN_VERTICES_IN_DIRTY_RANGE, dirty_ranges);
+	}
+}
@@ -15,6 +15,9 @@
 #include "model_parser.hpp"
 
 #include "plugin/callback_manager.hpp"
+#include "plugin/parsers/mesh_converter.hpp"
+#include "miscellaneous/thread_pool.hpp"
+#include "miscellaneous/trace_recorder.hpp"
 #include "plugin/viewport_renderer_override.hpp"
 #include "plugin/renderer/renderer.hpp"
 #include "plugin/renderer/model_manager.hpp"
@@ -39,7 +42,6 @@
 #include <maya/MFnTransform.h>
 #include <maya/MGlobal.h>
 #include <maya/MItDag.h>
-#include <maya/MItMeshPolygon.h>
 #include <maya/MPointArray.h>
 #include <maya/MQuaternion.h>
 #include <maya/MStatus.h>
@@ -50,71 +52,43 @@
 #include <maya/MViewport2Renderer.h>
 #include <maya/MUuid.h>
 #include <maya/MDGMessage.h>
+#include <maya/MDagMessage.h>
 
+#include <algorithm>
+#include <cstring>
 #include <string>
 
-// region for internally used functions, these functions cannot be use outside this cpp file
-#pragma region INTERNAL_FUNCTIONS
-static MIntArray GetLocalIndex( MIntArray & getVertices, MIntArray & getTriangle )
+namespace wmr
 {
-	// MItMeshPolygon::getTriangle() returns object-relative vertex indices
-	// BUT MItMeshPolygon::normalIndex() and ::getNormal() need face-relative vertex indices! 
-	// This helper function converts vertex indices from object-relative to face-relative.
-
-	assert( getTriangle.length() == 3 );    // We should always handle triangles and nothing else
-
-	MIntArray   localIndex( 3 );
-	unsigned    gv, gt;
-
-	for( gt = 0; gt < getTriangle.length(); gt++ )
+	//! Result of the last full conversion of a mesh
+	/*! Keeping the attribute indices of every vertex around allows point edits to be patched into the vertex buffer,
+	 *  without triangulating and welding the whole mesh again. The vertices are only kept once a mesh is edited, meshes
+	 *  that are never edited do not keep a CPU copy of their vertices. */
+	struct MeshCache
 	{
-		localIndex[gt] = -1;
-		for( gv = 0; gv < getVertices.length(); gv++ )
-		{
-			if( getTriangle[gt] == getVertices[gv] )
-			{
-				localIndex[gt] = gv;
-				break;
-			}
-		}
-	}
-	return localIndex;
+		MeshTopology m_topology;					//!< Topology of the mesh at the time of the conversion
+		std::vector<FaceVertexKey> m_unique_keys;	//!< Attribute indices per vertex (empty for the placeholder triangle)
+		std::vector<wr::Vertex> m_vertices;			//!< Vertices as last uploaded, empty until the mesh is edited
+	};
 }
 
-static MMatrix getParentWorldMatrix(MFnTransform& trans)
+// region for internally used functions, these functions cannot be use outside this cpp file
+#pragma region INTERNAL_FUNCTIONS
+static wmr::Matrix4 toHierarchyMatrix( const MMatrix& matrix )
 {
-	auto count = trans.parentCount();
-	if( count > 0 )
-	{
-		MFnDagNode dagnode = trans.parent( 0 );
-		MDagPath path;
-		dagnode.getPath( path );
-		auto parent = MFnTransform( path );
-		return parent.transformation().asMatrix() * getParentWorldMatrix( parent );
-	}
-	else
-	{
-		return MMatrix::identity;
-	}
+	wmr::Matrix4 result;
+	std::memcpy( result.data(), matrix.matrix, sizeof( result ) );
+	return result;
 }
 
-static void updateTransform( MFnTransform& transform, std::shared_ptr<wr::MeshNode> mesh_node )
+static void updateTransform( const wmr::Matrix4& world_matrix, std::shared_ptr<wr::MeshNode> mesh_node )
 {
-    MStatus status = MS::kSuccess;
-	MDagPath path;
-	MDagPath::getAPathTo( transform.object(), path );
-	MFnTransform good_trans( path, &status);
+	MStatus status = MS::kSuccess;
 
-	if (status != MS::kSuccess)
-	{
-		LOGC("Could not get a good transform when trying to update the transform.");
-	}
+	MMatrix maya_world_matrix;
+	std::memcpy( maya_world_matrix.matrix, world_matrix.data(), sizeof( world_matrix ) );
 
-	auto parent_matrix = getParentWorldMatrix( good_trans );
-	auto child_matrix = good_trans.transformationMatrix();
-	auto child_world_matrix = child_matrix * parent_matrix;
-	
-	MTransformationMatrix child_trans_matrix( child_world_matrix);
+	MTransformationMatrix child_trans_matrix( maya_world_matrix );
 
 	MVector pos = child_trans_matrix.translation(MSpace::kWorld);
 
@@ -129,38 +103,6 @@ static void updateTransform( MFnTransform& transform, std::shared_ptr<wr::MeshNo
 	mesh_node->SetScale( { static_cast< float >( scale[0] ), static_cast< float >( scale[1] ),static_cast< float >( scale[2] ) } );
 }
 
-auto getTransformFindAlgorithm( MFnTransform& transform )
-{
-	return [ &transform ]( std::pair<MObject, std::shared_ptr<wr::MeshNode>> pair ) -> bool
-	{
-		MStatus status;
-		MFnMesh fn_mesh( pair.first );
-		MFnDagNode dagnode = fn_mesh.parent( 0, &status );
-		MObject object = dagnode.object();
-		MFnTransform transform_rhs( dagnode.object(), &status );
-
-		assert( status == MS::kSuccess );
-
-		if( transform.object() == transform_rhs.object() )
-		{
-			return true;
-		}
-		return false;
-	};
-}
-
-auto getMeshObjectAlgorithm(MObject& maya_object)
-{
-	return [ &maya_object ]( std::pair<MObject, std::shared_ptr<wr::MeshNode>> pair ) -> bool
-	{
-		if( maya_object == pair.first )
-		{
-			return true;
-		}
-		return false;
-	};
-}
-
 void loadTriangle(wr::MeshData<wr::Vertex>& mesh_data)
 {
 	// Set up variables
@@ -187,16 +129,22 @@ void loadTriangle(wr::MeshData<wr::Vertex>& mesh_data)
 	}
 }
 
-void parseData( MFnMesh & fnmesh, wr::MeshData<wr::Vertex>& mesh_data )
+static void copyVectorArray( const MFloatVectorArray& source, std::vector<float>& destination )
 {
-	// Get all unique points of this mesh
-	MPointArray mesh_points;
-	fnmesh.getPoints(mesh_points, MSpace::kObject);
+	destination.resize( source.length() * 3 );
 
-	// Get all 'unique' normals of this mesh
-	MFloatVectorArray mesh_normals;
-	fnmesh.getNormals(mesh_normals);
+	for( unsigned int i = 0; i < source.length(); ++i )
+	{
+		destination[i * 3 + 0] = source[i].x;
+		destination[i * 3 + 1] = source[i].y;
+		destination[i * 3 + 2] = source[i].z;
+	}
+}
 
+// Gather the vertex attributes needed for the mesh conversion from Maya
+// Returns false if the mesh is not ready to be converted yet
+static bool gatherMeshSource( MFnMesh & fnmesh, wmr::MeshSource& source )
+{
 	// Get all UV sets of this mesh
 	MStringArray uv_sets;
 	MStatus status = fnmesh.getUVSetNames(uv_sets);
@@ -222,140 +170,167 @@ void parseData( MFnMesh & fnmesh, wr::MeshData<wr::Vertex>& mesh_data )
 		mesh_tangents.length()		<= 0 ||
 		mesh_bitangents.length()	<= 0) 
 	{
-		loadTriangle(mesh_data);
-		return;
+		return false;
 	}
 
-	// Reserve some space for the vertex buffer and index buffer
-	// Be aware that the space that is reserved will most likely not be equal to the final size
-	// Though, mesh_points usually has an accurate size to the final size of the unique vertex buffer
-	mesh_data.m_vertices.reserve(mesh_points.length());
-	mesh_data.m_indices = std::make_optional(std::vector<uint32_t>());
-	mesh_data.m_indices->reserve(mesh_points.length());
+	// Get all unique points of this mesh
+	MPointArray mesh_points;
+	fnmesh.getPoints(mesh_points, MSpace::kObject);
+
+	// Get all 'unique' normals of this mesh
+	MFloatVectorArray mesh_normals;
+	fnmesh.getNormals(mesh_normals);
+
+	// Copy the attributes into plain arrays
+	source.m_points.resize(mesh_points.length() * 3);
+	for (unsigned int i = 0; i < mesh_points.length(); ++i)
+	{
+		source.m_points[i * 3 + 0] = static_cast<float>(mesh_points[i].x);
+		source.m_points[i * 3 + 1] = static_cast<float>(mesh_points[i].y);
+		source.m_points[i * 3 + 2] = static_cast<float>(mesh_points[i].z);
+	}
 
-	// Get the iterator to loop over all mesh polygons
-	MItMeshPolygon polygon_it(fnmesh.object(), &status);
+	copyVectorArray(mesh_normals, source.m_normals);
+	copyVectorArray(mesh_tangents, source.m_tangents);
+	copyVectorArray(mesh_bitangents, source.m_bitangents);
 
-	// Initialize all temp/local variables so they don't allocate in the while loop (reduces allocations)
-	// Will contain object-relative indices for the vertices in this face
-	MIntArray polygon_vertices;
+	source.m_u.resize(u.length());
+	source.m_v.resize(v.length());
+	u.get(source.m_u.data());
+	v.get(source.m_v.data());
 
-	int32_t num_triangles = 0;
+	return true;
+}
 
-	// Needed for `getTriangles` function, but is never used
-	MPointArray non_tweaked;
+static void copyIntArray( const MIntArray& source, std::vector<std::int32_t>& destination )
+{
+	destination.resize( source.length() );
+	source.get( destination.data() );
+}
 
-	// Will contain object-relative vertex indices for each triangle
-	MIntArray triangle_indices;
+// Gather the polygon sizes and the point, normal, and UV index of every face-vertex using the bulk getters of MFnMesh
+// This is all that is needed to check whether the topology of a mesh changed
+static void gatherFaceVertexIds( MFnMesh & fnmesh, const MString & uv_set, wmr::PolygonSource& polygons )
+{
+	// Object-relative point indices per face-vertex
+	MIntArray polygon_vertex_counts, face_vertex_points;
+	fnmesh.getVertices( polygon_vertex_counts, face_vertex_points );
 
-	// Will contain face-relative vertex indices for each triangle
-	MIntArray local_index;
-	int32_t local_uv_index = 0;
+	// Normal indices per face-vertex
+	MIntArray normal_counts, face_vertex_normals;
+	fnmesh.getNormalIds( normal_counts, face_vertex_normals );
 
-	// Will contain face-relative vertex indices for each triangle
-	MIntArray triangle_vertex_indices;
-	triangle_vertex_indices.setLength(3);
+	// UV indices per face-vertex (faces without UVs are skipped by Maya)
+	MIntArray uv_counts, face_vertex_uvs;
+	fnmesh.getAssignedUVs( uv_counts, face_vertex_uvs, &uv_set );
 
-	// Used to temporary store the processed vertices
-	wr::Vertex vertex[3];
+	copyIntArray( polygon_vertex_counts, polygons.m_polygon_vertex_counts );
+	copyIntArray( face_vertex_points, polygons.m_face_vertex_points );
+	copyIntArray( face_vertex_normals, polygons.m_face_vertex_normals );
 
-	// Total vertex count. This is used for the indices.
-	uint32_t total_vertex_count = 0;
+	// Faces without UVs use the first UV of the set
+	polygons.m_face_vertex_uvs.resize( polygons.m_face_vertex_points.size() );
 
-	while (!polygon_it.isDone())
-	{
-		// Get object-relative indices for the vertices in this face
-		polygon_it.getVertices(polygon_vertices);
+	unsigned int face_vertex = 0;
+	unsigned int assigned_uv = 0;
 
-		// Get number of triangles in the mesh
-		polygon_it.numTriangles(num_triangles);
+	for( unsigned int polygon = 0; polygon < polygon_vertex_counts.length(); ++polygon )
+	{
+		const bool has_uvs = ( uv_counts[polygon] > 0 );
 
-		for (int32_t i = 0; i < num_triangles; ++i)
+		for( int local_index = 0; local_index < polygon_vertex_counts[polygon]; ++local_index, ++face_vertex )
 		{
-			status = polygon_it.getTriangles(non_tweaked,
-				triangle_indices,
-				MSpace::kObject);
+			polygons.m_face_vertex_uvs[face_vertex] = has_uvs ? face_vertex_uvs[assigned_uv++] : 0;
+		}
+	}
+}
 
-			if (status == MS::kSuccess)
-			{
-				// We're not using a for-loop to loop over the three vertices in the triangle
-				// This to make more use of caching
-				{
-					// Get the indices of the vertices in the triangle
-					triangle_vertex_indices[0] = triangle_indices[0 + 3 * i];
-					triangle_vertex_indices[1] = triangle_indices[1 + 3 * i];
-					triangle_vertex_indices[2] = triangle_indices[2 + 3 * i];
-
-					{ // Get the position values of the vertices in the triangle
-						vertex[0].m_pos[0] = static_cast<float>(mesh_points[triangle_vertex_indices[0]].x);
-						vertex[0].m_pos[1] = static_cast<float>(mesh_points[triangle_vertex_indices[0]].y);
-						vertex[0].m_pos[2] = static_cast<float>(mesh_points[triangle_vertex_indices[0]].z);
-
-						vertex[1].m_pos[0] = static_cast<float>(mesh_points[triangle_vertex_indices[1]].x);
-						vertex[1].m_pos[1] = static_cast<float>(mesh_points[triangle_vertex_indices[1]].y);
-						vertex[1].m_pos[2] = static_cast<float>(mesh_points[triangle_vertex_indices[1]].z);
-
-						vertex[2].m_pos[0] = static_cast<float>(mesh_points[triangle_vertex_indices[2]].x);
-						vertex[2].m_pos[1] = static_cast<float>(mesh_points[triangle_vertex_indices[2]].y);
-						vertex[2].m_pos[2] = static_cast<float>(mesh_points[triangle_vertex_indices[2]].z);
-					}
-
-					// Get the local indices of the normals, tangents, bittangents, and uv-coords
-					local_index = GetLocalIndex(polygon_vertices, triangle_vertex_indices);
-
-					{ // Get the normal values of the vertices in the triangle
-						memcpy(vertex[0].m_normal, &mesh_normals[polygon_it.normalIndex(local_index[0])], sizeof(float) * 3);
-						memcpy(vertex[1].m_normal, &mesh_normals[polygon_it.normalIndex(local_index[1])], sizeof(float) * 3);
-						memcpy(vertex[2].m_normal, &mesh_normals[polygon_it.normalIndex(local_index[2])], sizeof(float) * 3);
-					}
-
-					{ // Get the bitangent values of the vertices in the triangle
-						memcpy(vertex[0].m_tangent, &mesh_tangents[polygon_it.tangentIndex(local_index[0])], sizeof(float) * 3);
-						memcpy(vertex[1].m_tangent, &mesh_tangents[polygon_it.tangentIndex(local_index[1])], sizeof(float) * 3);
-						memcpy(vertex[2].m_tangent, &mesh_tangents[polygon_it.tangentIndex(local_index[2])], sizeof(float) * 3);
-					}
-
-					{ // Get the bitangent values of the vertices in the triangle
-						// Maya forces you to use ::normalIndex for binormals/bitangents
-						memcpy(vertex[0].m_bitangent, &mesh_bitangents[polygon_it.normalIndex(local_index[0])], sizeof(float) * 3);
-						memcpy(vertex[1].m_bitangent, &mesh_bitangents[polygon_it.normalIndex(local_index[1])], sizeof(float) * 3);
-						memcpy(vertex[2].m_bitangent, &mesh_bitangents[polygon_it.normalIndex(local_index[2])], sizeof(float) * 3);
-					}
-
-					{ // Get the UV values of the vertices in the triangle
-						polygon_it.getUVIndex(local_index[0], local_uv_index, &uv_sets[0]);
-						vertex[0].m_uv[0] = u[local_uv_index];
-						vertex[0].m_uv[1] = v[local_uv_index];
-
-						polygon_it.getUVIndex(local_index[1], local_uv_index, &uv_sets[0]);
-						vertex[1].m_uv[0] = u[local_uv_index];
-						vertex[1].m_uv[1] = v[local_uv_index];
-
-						polygon_it.getUVIndex(local_index[2], local_uv_index, &uv_sets[0]);
-						vertex[2].m_uv[0] = u[local_uv_index];
-						vertex[2].m_uv[1] = v[local_uv_index];
-					}
-
-					// Add vertices and indices to the buffer
-					mesh_data.m_vertices.push_back(vertex[0]);
-					mesh_data.m_vertices.push_back(vertex[1]);
-					mesh_data.m_vertices.push_back(vertex[2]);
-					mesh_data.m_indices->push_back(total_vertex_count++);
-					mesh_data.m_indices->push_back(total_vertex_count++);
-					mesh_data.m_indices->push_back(total_vertex_count++);
-
-				}
-			}
-			else
-			{
-				LOGC("Could not get the triangles.");
-			}
+// Gather the tangent index of every face-vertex and the triangulation of every polygon
+// Both are only needed when the mesh has to be triangulated again
+static void gatherTriangleCorners( MFnMesh & fnmesh, wmr::PolygonSource& polygons )
+{
+	// Face-relative vertex indices per triangle corner, these index the face-vertex arrays without any searching
+	MIntArray triangle_counts, triangle_face_vertices;
+	fnmesh.getTriangleOffsets( triangle_counts, triangle_face_vertices );
+
+	copyIntArray( triangle_counts, polygons.m_polygon_triangle_counts );
+	copyIntArray( triangle_face_vertices, polygons.m_triangle_face_vertices );
 
+	// MFnMesh has no bulk getter for the tangent indices, so those are queried per face-vertex
+	polygons.m_face_vertex_tangents.resize( polygons.m_face_vertex_points.size() );
+
+	std::size_t face_vertex = 0;
+
+	for( std::size_t polygon = 0; polygon < polygons.m_polygon_vertex_counts.size(); ++polygon )
+	{
+		for( int local_index = 0; local_index < polygons.m_polygon_vertex_counts[polygon]; ++local_index, ++face_vertex )
+		{
+			polygons.m_face_vertex_tangents[face_vertex] = fnmesh.getTangentId( static_cast<int>( polygon ), polygons.m_face_vertex_points[face_vertex] );
 		}
-		polygon_it.next();
 	}
 }
 
+// Convert a mesh into Wisp mesh data, the result is stored in the cache so later point edits can be patched in
+void parseData( MFnMesh & fnmesh, wmr::MeshCache& cache, wr::MeshData<wr::Vertex>& mesh_data, wmr::ThreadPool* pool )
+{
+	cache.m_unique_keys.clear();
+
+	wmr::MeshSource source;
+
+	if( !gatherMeshSource( fnmesh, source ) )
+	{
+		loadTriangle( mesh_data );
+		return;
+	}
+
+	// All Maya data is gathered up front, the conversion itself does not touch the Maya API
+	MStringArray uv_sets;
+	fnmesh.getUVSetNames( uv_sets );
+
+	wmr::PolygonSource polygons;
+	gatherFaceVertexIds( fnmesh, uv_sets[0], polygons );
+	gatherTriangleCorners( fnmesh, polygons );
+	wmr::ResolveTriangleCorners( polygons, source, pool );
+
+	cache.m_topology = wmr::GetMeshTopology( source, polygons );
+
+	mesh_data.m_indices = std::make_optional( std::vector<uint32_t>() );
+	wmr::ConvertMesh( source, mesh_data.m_vertices, mesh_data.m_indices.value(), cache.m_unique_keys, pool );
+}
+
+// Update the vertices of a previously converted mesh without triangulating it again
+// Returns false when the topology of the mesh changed, the mesh has to be parsed again in that case
+bool patchData( MFnMesh & fnmesh, wmr::MeshCache& cache, std::vector<wr::Vertex>& vertices, std::vector<wmr::VertexRange>& dirty_ranges, wmr::ThreadPool* pool )
+{
+	// Nothing to patch when a placeholder triangle was loaded
+	if( cache.m_unique_keys.empty() || cache.m_unique_keys.size() != vertices.size() )
+	{
+		return false;
+	}
+
+	wmr::MeshSource source;
+
+	if( !gatherMeshSource( fnmesh, source ) )
+	{
+		return false;
+	}
+
+	MStringArray uv_sets;
+	fnmesh.getUVSetNames( uv_sets );
+
+	wmr::PolygonSource polygons;
+	gatherFaceVertexIds( fnmesh, uv_sets[0], polygons );
+
+	if( !( wmr::GetMeshTopology( source, polygons ) == cache.m_topology ) )
+	{
+		return false;
+	}
+
+	wmr::PatchVertices( source, cache.m_unique_keys, vertices, dirty_ranges, pool );
+
+	return true;
+}
+
 #pragma endregion
 
 #pragma region callbacks
@@ -370,51 +345,58 @@ namespace wmr
 			return;
 		}
 
-		MStatus status = MS::kSuccess;
-		MFnTransform transform( plug.node(), &status );
-		if( status != MS::kSuccess )
-		{
-			MGlobal::displayInfo( status.errorString() );
-			return;
-		}
+		ScopedTraceEvent trace_event("AttributeMeshTransformCallback", "callback");
+
+		wmr::ModelParser* model_parser = reinterpret_cast< wmr::ModelParser* >( client_data );
+		++model_parser->m_transform_statistics.m_messages_received;
+
+		// A drag sends many messages per frame for the same transform, the transform is read once when the frame starts
+		model_parser->m_dirty_transforms.insert( MObjectHandle( plug.node() ) );
+		model_parser->m_renderer.MarkSceneChanged();
+	}
+
+	void DagParentAddedCallback( MDagPath &child, MDagPath &parent, void *client_data )
+	{
+		ScopedTraceEvent trace_event("DagParentAddedCallback", "callback");
+
 		wmr::ModelParser* model_parser = reinterpret_cast< wmr::ModelParser* >( client_data );
 
-		// specialized find_if algorithm
-		auto it = std::find_if( model_parser->m_object_transform_vector.begin(), model_parser->m_object_transform_vector.end(), getTransformFindAlgorithm( transform ) );
-		if( it == model_parser->m_object_transform_vector.end() )
+		MObject child_object = child.node();
+		auto it = model_parser->m_transform_entry_map.find( MObjectHandle( child_object ) );
+		if( it == model_parser->m_transform_entry_map.end() )
 		{
 			return;
 		}
-		MFnMesh fn_mesh( it->first );
-		MFnDagNode dagnode = fn_mesh.parent( 0, &status );
-		MObject object = dagnode.object();
-		MFnTransform transform_rhs( dagnode.object(), &status );
-		if( transform_rhs.object() != transform.object() )
-		{
-			return; // find_if returns last element even if it is not a positive result
-		}
 
-		updateTransform( transform, it->second );
+		auto& hierarchy = model_parser->m_transform_hierarchy;
+		const auto node = it->second.m_node;
+		const auto old_parent = hierarchy.GetParent( node );
 
-		auto child_count = transform.childCount();
-		if( child_count < 2 )
+		// Hold on to the new ancestors before the old ones are released, they might be shared
+		auto new_parent = wmr::TransformHierarchy::INVALID_NODE;
+		MObject parent_object = parent.node();
+		if( parent_object.hasFn( MFn::kTransform ) )
 		{
-			return;
+			new_parent = model_parser->AcquireTransform( parent_object );
 		}
-		for( unsigned int i = 0; i < child_count; ++i )
+
+		hierarchy.SetParent( node, new_parent );
+
+		if( old_parent != wmr::TransformHierarchy::INVALID_NODE )
 		{
-			status = MS::kSuccess;
-			MFnTransform child_transform(transform.child( i ), &status);
-			if( status == MS::kSuccess )
-			{
-				MPlug child_plug( child_transform.object(), plug.attribute() );
-				AttributeMeshTransformCallback( msg, child_plug , other_plug, client_data );
-			}
+			model_parser->ReleaseTransform( model_parser->m_hierarchy_transforms[ old_parent ] );
 		}
+
+		// Maya keeps the world position by default, which changes the local matrix
+		MFnTransform transform( child_object );
+		hierarchy.SetLocalMatrix( node, toHierarchyMatrix( transform.transformationMatrix() ) );
+		model_parser->m_renderer.MarkSceneChanged();
 	}
 
 	void AttributeMeshAddedCallback( MNodeMessage::AttributeMessage msg, MPlug &plug, MPlug &other_plug, void *client_data )
 	{
+		ScopedTraceEvent trace_event("AttributeMeshAddedCallback", "callback");
+
 		// Make an MObject from the plug node
 		MObject object( plug.node() );
 
@@ -484,7 +466,9 @@ namespace wmr
 		{
 			return;
 		}
-		
+
+		ScopedTraceEvent trace_event("attributeMeshChangedCallback", "callback");
+
 		MStatus status = MS::kSuccess;
 		
 		// Was the attribute a point?
@@ -510,6 +494,8 @@ namespace wmr
 		{
 			model_parser->m_changed_mesh_vector.push_back(object);
 		}
+
+		model_parser->m_renderer.MarkSceneChanged();
 	}
 }
 #pragma endregion
@@ -519,13 +505,71 @@ wmr::ModelParser::ModelParser() :
 		MHWRender::MRenderer::theRenderer()->findRenderOverride( settings::VIEWPORT_OVERRIDE_NAME )
 		)->GetRenderer() ),
 	m_mesh_added_callback_vector(),
-	m_object_transform_vector(),
-	m_changed_mesh_vector()
+	m_mesh_node_map(),
+	m_transform_mesh_map(),
+	m_changed_mesh_vector(),
+	m_conversion_pool( std::make_unique<ThreadPool>( std::max( std::thread::hardware_concurrency(), 2u ) - 1 ) )
 {
+	MStatus status = MS::kSuccess;
+
+	// Keep the transform hierarchy in sync when objects are parented to other objects
+	MCallbackId dag_callback_id = MDagMessage::addParentAddedCallback( DagParentAddedCallback, this, &status );
+	if( status != MS::kSuccess )
+	{
+		LOGC("Could not subscribe to DAG changes.");
+	}
+	CallbackManager::GetInstance().RegisterCallback( dag_callback_id );
+
+	// Models can be moved to another model pool page, the mesh nodes have to follow them
+	m_renderer.GetModelManager().SetModelRelocatedCallback( [ this ]( wr::Model* old_model, wr::Model* new_model )
+	{
+		for( auto& pair : m_mesh_node_map )
+		{
+			if( pair.second.m_mesh_node->m_model == old_model )
+			{
+				pair.second.m_mesh_node->m_model = new_model;
+			}
+		}
+	} );
+
+	// The model manager keeps no copy of the mesh data, a model that is moved to another page is converted again
+	m_renderer.GetModelManager().SetModelDataCallback( [ this ]( wr::Model* model, wr::MeshData<wr::Vertex>& mesh_data )
+	{
+		for( auto& pair : m_mesh_node_map )
+		{
+			if( pair.second.m_mesh_node->m_model != model )
+			{
+				continue;
+			}
+
+			MObject mesh_object = pair.first.object();
+			MStatus status = MS::kSuccess;
+			MFnMesh fn_mesh( mesh_object, &status );
+			if( status != MS::kSuccess )
+			{
+				return false;
+			}
+
+			MeshCache& cache = GetMeshCache( mesh_object );
+			parseData( fn_mesh, cache, mesh_data, m_conversion_pool.get() );
+
+			// The next point edit is patched against the vertices that are uploaded now
+			if( !cache.m_vertices.empty() )
+			{
+				cache.m_vertices = mesh_data.m_vertices;
+			}
+
+			return true;
+		}
+
+		return false;
+	} );
 }
 
 wmr::ModelParser::~ModelParser()
 {
+	m_renderer.GetModelManager().SetModelRelocatedCallback( nullptr );
+	m_renderer.GetModelManager().SetModelDataCallback( nullptr );
 }
 
 void wmr::ModelParser::SubscribeObject( MObject & maya_object )
@@ -570,45 +614,38 @@ void wmr::ModelParser::UnSubscribeObject( MObject & maya_object )
 {
 	MStatus status = MS::kSuccess;
 
-	MFnMesh fnmesh( maya_object );
-	
-	auto it = std::find_if( m_object_transform_vector.begin(), m_object_transform_vector.end(), getMeshObjectAlgorithm(maya_object) );
-	if( it == m_object_transform_vector.end() )
-	{
-		LOGC("Iterator past end of object transform vector.");
-		return; // find_if returns last element even if it is not a positive result
-	}
-	m_renderer.GetModelManager().DeleteModel(*it->second->m_model);
-	m_renderer.GetScenegraph().DestroyNode( it->second );
-
-	if (m_object_transform_vector.empty())
-	{
-		LOGC("Object transform vector is empty.");
-	}
-
-	auto it_end = --m_object_transform_vector.end();
+	MObjectHandle mesh_handle( maya_object );
 
-	if( it == it_end )
+	auto it = m_mesh_node_map.find( mesh_handle );
+	if( it == m_mesh_node_map.end() )
 	{
-		m_object_transform_vector.pop_back();
-	}
-	else
-	{
-		std::iter_swap( it, it_end );
-		m_object_transform_vector.pop_back();
+		LOGC("Mesh was never added to the model parser.");
+		return;
 	}
+	m_renderer.GetModelManager().DeleteModel(*it->second.m_mesh_node->m_model);
+	m_renderer.GetScenegraph().DestroyNode( it->second.m_mesh_node );
+	m_renderer.MarkSceneChanged();
 
+	UnlinkMeshFromTransform( maya_object, it->second.m_transform );
+	m_mesh_node_map.erase( it );
 
+	// The cached conversion is not needed anymore
+	m_mesh_cache_map.erase( mesh_handle );
 }
 
 void wmr::ModelParser::MeshAdded( MFnMesh & fnmesh )
 {
+	MObject mesh_object = fnmesh.object();
+	MeshCache& cache = GetMeshCache( mesh_object );
+
 	wr::MeshData<wr::Vertex> mesh_data;
-	
-	parseData( fnmesh, mesh_data );
+	parseData( fnmesh, cache, mesh_data, m_conversion_pool.get() );
+	cache.m_vertices.clear();
 
-	wr::Model* model = m_renderer.GetModelManager().AddModel({ mesh_data } );
-	m_renderer.GetD3D12Renderer().WaitForAllPreviousWork();
+	// Batched with all other scene changes of this frame, only the first change waits for the GPU
+	m_renderer.PrepareSceneUpdate();
+
+	wr::Model* model = m_renderer.GetModelManager().AddModel( std::move( mesh_data ) );
 	auto model_node = m_renderer.GetScenegraph().CreateChild<wr::MeshNode>( nullptr, model );
 	MStatus status;
 
@@ -625,19 +662,9 @@ void wmr::ModelParser::MeshAdded( MFnMesh & fnmesh )
 	MObject object = dagnode.object();
 
 
-	MFnTransform transform( dagnode.object(), &status );
-	if( status != MS::kSuccess )
-	{
-		LOGE("Could not get transform node function set.");
-		MGlobal::displayError( "Error: " + status.errorString() );
-	}
-
-	updateTransform( transform, model_node );
-
 	// Check if the mesh is already added
-	MObject mesh_object = fnmesh.object();
-	auto itt = std::find_if(m_object_transform_vector.begin(), m_object_transform_vector.end(), getMeshObjectAlgorithm(mesh_object));
-	if (itt != m_object_transform_vector.end())
+	auto itt = m_mesh_node_map.find(MObjectHandle(mesh_object));
+	if (itt != m_mesh_node_map.end())
 	{
 		// If it is, still add it to mesh changed vector
 		auto changed_itt = std::find(m_changed_mesh_vector.begin(), m_changed_mesh_vector.end(), mesh_object);
@@ -648,24 +675,31 @@ void wmr::ModelParser::MeshAdded( MFnMesh & fnmesh )
 		
 		// If the model is already in the vector, assume that it should be overwritten
 		// First remove it, then replace it
-		m_renderer.GetScenegraph().DestroyNode<wr::MeshNode>(itt->second);
-		itt->second = model_node;
+		m_renderer.GetScenegraph().DestroyNode<wr::MeshNode>(itt->second.m_mesh_node);
+		itt->second.m_mesh_node = model_node;
+
+		if (itt->second.m_transform != object)
+		{
+			UnlinkMeshFromTransform(mesh_object, itt->second.m_transform);
+			LinkMeshToTransform(mesh_object, object);
+			itt->second.m_transform = object;
+		}
 	}
 	else {
-		m_object_transform_vector.push_back(std::make_pair(mesh_object, model_node));
+		m_mesh_node_map.emplace(MObjectHandle(mesh_object), MeshNodeEntry{ object, model_node });
+		LinkMeshToTransform(mesh_object, object);
 	}
 
-	MCallbackId attributeId = MNodeMessage::addAttributeChangedCallback(
-		object,
-		AttributeMeshTransformCallback,
-		this,
-		&status
-	);
-	CallbackManager::GetInstance().RegisterCallback( attributeId );
+	// The hierarchy follows the transform from now on, the new node needs the current world matrix right away
+	auto transform_it = m_transform_entry_map.find(MObjectHandle(object));
+	if (transform_it != m_transform_entry_map.end())
+	{
+		updateTransform(m_transform_hierarchy.CalculateWorldMatrix(transform_it->second.m_node), model_node);
+	}
 
 	MObject mesh_obj = fnmesh.object();
 
-	attributeId = MNodeMessage::addAttributeChangedCallback(
+	MCallbackId attributeId = MNodeMessage::addAttributeChangedCallback(
 		mesh_obj,
 		attributeMeshChangedCallback,
 		this,
@@ -678,6 +712,12 @@ void wmr::ModelParser::MeshAdded( MFnMesh & fnmesh )
 
 void wmr::ModelParser::Update()
 {
+	ScopedTraceEvent trace_event("ModelParser::Update", "parser");
+
+	UpdateTransforms();
+
+	std::vector<VertexRange> dirty_ranges;
+
 	for( auto& object : m_changed_mesh_vector )
 	{
 		MStatus status = MS::kSuccess;
@@ -686,21 +726,203 @@ void wmr::ModelParser::Update()
 		{
 			continue;
 		}
-		wr::MeshData<wr::Vertex> mesh_data;
 
-		parseData( fn_mesh, mesh_data );
+		auto itt = m_mesh_node_map.find( MObjectHandle( object ) );
+		if( itt == m_mesh_node_map.end() )
+		{
+			continue;
+		}
+
+		wr::Model* model = itt->second.m_mesh_node->m_model;
+
+		MeshCache& cache = GetMeshCache( object );
+		auto& model_manager = m_renderer.GetModelManager();
+		const bool can_patch = model_manager.CanPatchVertices();
+
+		// Point edits (move tool, sculpting) keep the topology intact, only the changed vertices have to be updated.
+		// Ray tracing frame graphs need the model pool to refit the acceleration structures, the model is updated as a
+		// whole while one exists.
+		if( can_patch && patchData( fn_mesh, cache, cache.m_vertices, dirty_ranges, m_conversion_pool.get() ) )
+		{
+			model_manager.UpdateModelVertices( *model, cache.m_vertices, dirty_ranges );
+			continue;
+		}
+
+		wr::MeshData<wr::Vertex> mesh_data;
+		parseData( fn_mesh, cache, mesh_data, m_conversion_pool.get() );
 
-		auto itt = std::find_if( m_object_transform_vector.begin(), m_object_transform_vector.end(), getMeshObjectAlgorithm( object ) );
-		if( itt == m_object_transform_vector.end() )
+		// An edited mesh is likely to be edited again, its vertices are kept to patch the next edit
+		if( can_patch )
 		{
-			continue; // find_if returns last element even if it is not a positive result
+			cache.m_vertices = mesh_data.m_vertices;
+		}
+		else
+		{
+			cache.m_vertices.clear();
+			cache.m_vertices.shrink_to_fit();
 		}
 
-		m_renderer.GetModelManager().UpdateModel(*itt->second->m_model, mesh_data);
+		model_manager.UpdateModel( *model, std::move( mesh_data ) );
 	}
 	m_changed_mesh_vector.clear();
 }
 
+wmr::MeshCache& wmr::ModelParser::GetMeshCache( MObject& mesh_object )
+{
+	auto& cache = m_mesh_cache_map[ MObjectHandle( mesh_object ) ];
+
+	if( !cache )
+	{
+		cache = std::make_unique<MeshCache>();
+	}
+
+	return *cache;
+}
+
+void wmr::ModelParser::LinkMeshToTransform( const MObject& mesh_object, const MObject& transform_object )
+{
+	AcquireTransform( transform_object );
+	m_transform_mesh_map[ MObjectHandle( transform_object ) ].push_back( mesh_object );
+}
+
+void wmr::ModelParser::UnlinkMeshFromTransform( const MObject& mesh_object, const MObject& transform_object )
+{
+	auto it = m_transform_mesh_map.find( MObjectHandle( transform_object ) );
+	if( it == m_transform_mesh_map.end() )
+	{
+		return;
+	}
+
+	auto& meshes = it->second;
+	meshes.erase( std::remove( meshes.begin(), meshes.end(), mesh_object ), meshes.end() );
+
+	if( meshes.empty() )
+	{
+		m_transform_mesh_map.erase( it );
+	}
+
+	ReleaseTransform( transform_object );
+}
+
+wmr::TransformHierarchy::NodeId wmr::ModelParser::AcquireTransform( const MObject& transform_object )
+{
+	auto it = m_transform_entry_map.find( MObjectHandle( transform_object ) );
+	if( it != m_transform_entry_map.end() )
+	{
+		++it->second.m_reference_count;
+		return it->second.m_node;
+	}
+
+	MStatus status = MS::kSuccess;
+	MFnTransform transform( transform_object, &status );
+	if( status != MS::kSuccess )
+	{
+		LOGE("Could not get transform node function set.");
+		return TransformHierarchy::INVALID_NODE;
+	}
+
+	// Ancestors are part of the hierarchy as well, every transform holds a reference to its parent
+	auto parent_node = TransformHierarchy::INVALID_NODE;
+	if( transform.parentCount() > 0 )
+	{
+		MObject parent_object = transform.parent( 0 );
+		if( parent_object.hasFn( MFn::kTransform ) )
+		{
+			parent_node = AcquireTransform( parent_object );
+		}
+	}
+
+	const auto node = m_transform_hierarchy.AddNode( parent_node, toHierarchyMatrix( transform.transformationMatrix() ) );
+	if( node >= m_hierarchy_transforms.size() )
+	{
+		m_hierarchy_transforms.resize( node + 1 );
+	}
+	m_hierarchy_transforms[ node ] = transform_object;
+
+	MObject object = transform_object;
+	MCallbackId callback_id = MNodeMessage::addAttributeChangedCallback(
+		object,
+		AttributeMeshTransformCallback,
+		this,
+		&status
+	);
+	CallbackManager::GetInstance().RegisterCallback( callback_id );
+
+	m_transform_entry_map.emplace( MObjectHandle( transform_object ), TransformEntry{ node, callback_id, 1 } );
+
+	return node;
+}
+
+void wmr::ModelParser::ReleaseTransform( const MObject& transform_object )
+{
+	auto it = m_transform_entry_map.find( MObjectHandle( transform_object ) );
+	if( it == m_transform_entry_map.end() || --it->second.m_reference_count > 0 )
+	{
+		return;
+	}
+
+	const auto node = it->second.m_node;
+	const auto parent_node = m_transform_hierarchy.GetParent( node );
+
+	CallbackManager::GetInstance().UnregisterCallback( it->second.m_callback );
+	m_transform_entry_map.erase( it );
+
+	m_transform_hierarchy.RemoveNode( node );
+	m_hierarchy_transforms[ node ] = MObject::kNullObj;
+
+	if( parent_node != TransformHierarchy::INVALID_NODE )
+	{
+		ReleaseTransform( m_hierarchy_transforms[ parent_node ] );
+	}
+}
+
+void wmr::ModelParser::UpdateTransforms()
+{
+	for( auto& handle : m_dirty_transforms )
+	{
+		// Transforms can be removed after they changed
+		auto it = m_transform_entry_map.find( handle );
+		if( it == m_transform_entry_map.end() || !handle.isValid() )
+		{
+			continue;
+		}
+
+		MStatus status = MS::kSuccess;
+		MFnTransform transform( handle.object(), &status );
+		if( status != MS::kSuccess )
+		{
+			continue;
+		}
+
+		m_transform_hierarchy.SetLocalMatrix( it->second.m_node, toHierarchyMatrix( transform.transformationMatrix() ) );
+		++m_transform_statistics.m_updates_applied;
+	}
+	m_dirty_transforms.clear();
+
+	m_transform_hierarchy.Update( m_updated_transform_nodes );
+
+	for( auto node : m_updated_transform_nodes )
+	{
+		// Transforms that only group other transforms have no meshes of their own
+		auto it = m_transform_mesh_map.find( MObjectHandle( m_hierarchy_transforms[ node ] ) );
+		if( it == m_transform_mesh_map.end() )
+		{
+			continue;
+		}
+
+		const auto& world_matrix = m_transform_hierarchy.GetWorldMatrix( node );
+
+		for( auto& mesh_object : it->second )
+		{
+			auto mesh_it = m_mesh_node_map.find( MObjectHandle( mesh_object ) );
+			if( mesh_it != m_mesh_node_map.end() )
+			{
+				updateTransform( world_matrix, mesh_it->second.m_mesh_node );
+			}
+		}
+	}
+}
+
 void wmr::ModelParser::SetMeshAddCallback(std::function<void(MFnMesh&)> callback)
 {
 	if (mesh_add_callback != nullptr)
@@ -728,8 +950,8 @@ void wmr::ModelParser::ToggleMeshVisibility(MPlug & plug_mesh, bool hide)
 	MObject mesh_object = mesh.object();
 
 	// Get the itt of the given mesh object (from the standard meshes array)
-	auto itt_mesh = std::find_if(m_object_transform_vector.begin(), m_object_transform_vector.end(), getMeshObjectAlgorithm(mesh_object));
-	if (itt_mesh == m_object_transform_vector.end()) {
+	auto itt_mesh = m_mesh_node_map.find(MObjectHandle(mesh_object));
+	if (itt_mesh == m_mesh_node_map.end()) {
 		if (hide) {
 			LOG("Can't find the mesh to hide!");
 		}
@@ -740,23 +962,21 @@ void wmr::ModelParser::ToggleMeshVisibility(MPlug & plug_mesh, bool hide)
 	}
 
 	// Hide/show the model
-	itt_mesh->second->m_visible = !hide;
+	itt_mesh->second.m_mesh_node->m_visible = !hide;
+	m_renderer.MarkSceneChanged();
+}
+
+const wmr::TransformUpdateStatistics& wmr::ModelParser::GetTransformUpdateStatistics() const noexcept
+{
+	return m_transform_statistics;
 }
 
 std::shared_ptr<wr::MeshNode> wmr::ModelParser::GetWRModel(MObject & maya_object)
 {
-	auto findCallback = [&maya_object] (std::pair<MObject, std::shared_ptr<wr::MeshNode>> pair) -> bool
-	{
-		if (maya_object == pair.first)
-		{
-			return true;
-		}
-		return false;
-	};
-	auto it = std::find_if(m_object_transform_vector.begin(), m_object_transform_vector.end(), findCallback);
-	if (it != m_object_transform_vector.end())
+	auto it = m_mesh_node_map.find(MObjectHandle(maya_object));
+	if (it != m_mesh_node_map.end())
 	{
-		return it->second;
+		return it->second.m_mesh_node;
 	}
 	return nullptr;//std::make_shared<wr::MeshNode>();
 }
@@ -16,6 +16,12 @@
 #include <maya/MApiNamespace.h>
 #include <maya/MNodeMessage.h>
 
+#include <maya/MDagMessage.h>
+
+#include "plugin/parsers/object_map.hpp"
+#include "plugin/parsers/scene_graph_parser.hpp"
+#include "plugin/parsers/transform_hierarchy.hpp"
+
 #include <vector>
 #include <memory>
 
@@ -29,6 +35,8 @@ namespace wr
 namespace wmr
 {
 	class Renderer;
+	class ThreadPool;
+	struct MeshCache;
 	class ModelParser
 	{
 		
@@ -49,18 +57,65 @@ namespace wmr
 		// Show/Hide meshes
 		void ToggleMeshVisibility(MPlug & plug_mesh, bool hide);
 
+		const TransformUpdateStatistics& GetTransformUpdateStatistics() const noexcept;
+
 	private:
 		//callbacks that require private access and are part of the ModelParser.
 		friend void AttributeMeshTransformCallback( MNodeMessage::AttributeMessage msg, MPlug &plug, MPlug &otherPlug, void *clientData );
 		friend void AttributeMeshAddedCallback( MNodeMessage::AttributeMessage msg, MPlug &plug, MPlug &otherPlug, void *clientData );
 		friend void attributeMeshChangedCallback( MNodeMessage::AttributeMessage msg, MPlug &plug, MPlug &other_plug, void *client_data );
+		friend void DagParentAddedCallback( MDagPath &child, MDagPath &parent, void *client_data );
+
+		//! Wisp node of a Maya mesh and the transform the node follows
+		struct MeshNodeEntry
+		{
+			MObject m_transform;
+			std::shared_ptr<wr::MeshNode> m_mesh_node;
+		};
+
+		//! Transform node in the transform hierarchy
+		struct TransformEntry
+		{
+			TransformHierarchy::NodeId m_node;
+			MCallbackId m_callback;				// Attribute changed callback of the transform
+			std::uint32_t m_reference_count;	// Meshes and child transforms that depend on this transform
+		};
+
+		// Get the conversion cache of a mesh, an empty cache is created when the mesh has none yet
+		MeshCache& GetMeshCache( MObject& mesh_object );
 
-		std::vector<std::pair<MObject, std::shared_ptr<wr::MeshNode>>> m_object_transform_vector;
+		// Keep track of the meshes that follow a transform node
+		void LinkMeshToTransform( const MObject& mesh_object, const MObject& transform_object );
+		void UnlinkMeshFromTransform( const MObject& mesh_object, const MObject& transform_object );
+
+		// Add a transform and its ancestors to the transform hierarchy, or add a reference when it is part of it already
+		TransformHierarchy::NodeId AcquireTransform( const MObject& transform_object );
+		// Remove a reference, the transform leaves the hierarchy when nothing refers to it anymore
+		void ReleaseTransform( const MObject& transform_object );
+
+		// Read the local matrices of the transforms that changed this frame, recalculate the world matrices of their
+		// subtrees and apply them to the mesh nodes
+		void UpdateTransforms();
+
+		MObjectMap<MeshNodeEntry> m_mesh_node_map;						// Mesh to Wisp node
+		MObjectMap<std::vector<MObject>> m_transform_mesh_map;			// Transform to the meshes parented to it
 		std::vector<std::pair<MObject, MCallbackId>> m_mesh_added_callback_vector;
 		std::vector<MObject> m_changed_mesh_vector;
+		MObjectMap<std::unique_ptr<MeshCache>> m_mesh_cache_map;
+
+		TransformHierarchy m_transform_hierarchy;
+		MObjectMap<TransformEntry> m_transform_entry_map;				// Transform to hierarchy node
+		std::vector<MObject> m_hierarchy_transforms;					// Hierarchy node to transform
+		std::vector<TransformHierarchy::NodeId> m_updated_transform_nodes;
+		MObjectSet m_dirty_transforms;									// Transforms changed since the last update
+
+		TransformUpdateStatistics m_transform_statistics;
 
 		Renderer& m_renderer;
 
+		// Worker threads used to convert large meshes (the main thread helps out as well)
+		std::unique_ptr<ThreadPool> m_conversion_pool;
+
 		std::function<void(MFnMesh&)> mesh_add_callback;
 	};
 }
@@ -0,0 +1,46 @@
+// Copyright 2019 Breda University of Applied Sciences and Team Wisp (Viktor Zoutman, Emilio Laiso, Jens Hagen, Meine Zeinstra, Tahar Meijs, Koen Buitenhuis, Niels Brunekreef, Darius Bouma, Florian Schut)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+// Maya API
+#include <maya/MObjectHandle.h>
+
+// C++ standard
+#include <cstddef>
+#include <unordered_map>
+#include <unordered_set>
+
+//! Generic plug-in namespace (Wisp Maya Renderer)
+namespace wmr
+{
+	//! Hash function for Maya object handles
+	/*! The hash code of a handle stays the same for the lifetime of the Maya object, so it can be used to find the data
+	 *  that belongs to an object without constructing a function set for every candidate. */
+	struct MObjectHandleHash
+	{
+		std::size_t operator()(const MObjectHandle& handle) const noexcept
+		{
+			return static_cast<std::size_t>(handle.hashCode());
+		}
+	};
+
+	//! Hash map keyed by Maya object
+	/*! Keys are compared as full handles, two objects that happen to share a hash code never end up in the same entry. */
+	template<typename T>
+	using MObjectMap = std::unordered_map<MObjectHandle, T, MObjectHandleHash>;
+
+	//! Hash set of Maya objects, every object is stored once
+	using MObjectSet = std::unordered_set<MObjectHandle, MObjectHandleHash>;
+}
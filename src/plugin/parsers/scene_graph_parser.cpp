@@ -17,6 +17,7 @@
 #include "plugin/callback_manager.hpp"
 #include "plugin/renderer/renderer.hpp"
 #include "miscellaneous/settings.hpp"
+#include "miscellaneous/trace_recorder.hpp"
 #include "plugin/viewport_renderer_override.hpp"
 #include "plugin/parsers/model_parser.hpp"
 #include "plugin/parsers/material_parser.hpp"
@@ -59,6 +60,8 @@
 
 void MeshAddedCallback( MObject &node, void *client_data )
 {
+	wmr::ScopedTraceEvent trace_event("MeshAddedCallback", "callback");
+
 	if (node.apiType() != MFn::Type::kMesh)
 	{
 		LOGC("Trying to add mesh callback, but node type is not of \"kMesh\".");
@@ -74,6 +77,8 @@ void MeshAddedCallback( MObject &node, void *client_data )
 
 void MeshRemovedCallback( MObject& node, void* client_data )
 {
+	wmr::ScopedTraceEvent trace_event("MeshRemovedCallback", "callback");
+
 	if (node.apiType() != MFn::Type::kMesh)
 	{
 		LOGC("Trying to remove mesh callback, but node type is not of \"kMesh\", it is of type \"{}\".", node.apiTypeStr());
@@ -87,6 +92,8 @@ void MeshRemovedCallback( MObject& node, void* client_data )
 
 void LightAddedCallback( MObject &node, void *client_data )
 {
+	wmr::ScopedTraceEvent trace_event("LightAddedCallback", "callback");
+
 	if (!node.hasFn(MFn::Type::kLight))
 	{
 		LOGC("Trying to add light callback to {}, but node type is not of \"kLight\".", MFnLight(node).fullPathName().asChar());
@@ -100,6 +107,8 @@ void LightAddedCallback( MObject &node, void *client_data )
 
 void LightRemovedCallback( MObject& node, void* client_data )
 {
+	wmr::ScopedTraceEvent trace_event("LightRemovedCallback", "callback");
+
 	if (!node.hasFn(MFn::Type::kLight))
 	{
 		LOGC("Trying to remove light callback from \"{}\", but node type is not of \"kLight\".", MFnLight(node).fullPathName().asChar());
@@ -113,6 +122,8 @@ void LightRemovedCallback( MObject& node, void* client_data )
 
 void ConnectionAddedCallback(MPlug& src_plug, MPlug& dest_plug, bool made, void* client_data)
 {
+	wmr::ScopedTraceEvent trace_event("ConnectionAddedCallback", "callback");
+
  	auto* scenegraph_parser = reinterpret_cast<wmr::ScenegraphParser*>(client_data);
 	auto* material_parser = &scenegraph_parser->GetMaterialParser();
 	auto* model_parser = &scenegraph_parser->GetModelParser();
@@ -320,7 +331,11 @@ void wmr::ScenegraphParser::Initialize()
 
 void wmr::ScenegraphParser::Update()
 {
+	ScopedTraceEvent trace_event("ScenegraphParser::Update", "parser");
+
+	// Transform changes of this frame are applied right before the frame is rendered
 	m_model_parser->Update();
+	m_light_parser->Update();
 }
 
 void wmr::ScenegraphParser::AddCallbackValidation(MStatus status, MCallbackId id)
@@ -354,3 +369,15 @@ wmr::LightParser & wmr::ScenegraphParser::GetLightParser() const noexcept
 {
 	return *m_light_parser;
 }
+
+wmr::TransformUpdateStatistics wmr::ScenegraphParser::GetTransformUpdateStatistics() const noexcept
+{
+	const auto& model_statistics = m_model_parser->GetTransformUpdateStatistics();
+	const auto& light_statistics = m_light_parser->GetTransformUpdateStatistics();
+
+	TransformUpdateStatistics statistics;
+	statistics.m_messages_received = model_statistics.m_messages_received + light_statistics.m_messages_received;
+	statistics.m_updates_applied = model_statistics.m_updates_applied + light_statistics.m_updates_applied;
+
+	return statistics;
+}
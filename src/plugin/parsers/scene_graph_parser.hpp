@@ -18,6 +18,7 @@
 #include <maya/MApiNamespace.h>
 #include <maya/MMessage.h>
 
+#include <cstdint>
 #include <memory>
 
 namespace wr
@@ -36,6 +37,14 @@ namespace wmr
 	class ModelParser;
 	class Renderer;
 	class ViewportRendererOverride;
+
+	//! Number of transform change messages compared to the number of transform updates that were actually applied
+	/*! Transform changes are collected per frame, a node that changes several times in a frame is updated once. */
+	struct TransformUpdateStatistics
+	{
+		std::uint64_t m_messages_received = 0;
+		std::uint64_t m_updates_applied = 0;
+	};
 	
 	class ScenegraphParser
 	{
@@ -53,6 +62,9 @@ namespace wmr
 		CameraParser& GetCameraParser() const noexcept;
 		LightParser& GetLightParser() const noexcept;
 
+		//! Transform update statistics of all meshes and lights since the plug-in was loaded
+		TransformUpdateStatistics GetTransformUpdateStatistics() const noexcept;
+
 	private:
 		Renderer& m_render_system;
 		std::unique_ptr<LightParser> m_light_parser;
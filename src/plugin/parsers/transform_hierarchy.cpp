@@ -0,0 +1,307 @@
+// Copyright 2019 Breda University of Applied Sciences and Team Wisp (Viktor Zoutman, Emilio Laiso, Jens Hagen, Meine Zeinstra, Tahar Meijs, Koen Buitenhuis, Niels Brunekreef, Darius Bouma, Florian Schut)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "transform_hierarchy.hpp"
+
+// C++ standard
+#include <algorithm>
+
+namespace wmr
+{
+	Matrix4 Multiply(const Matrix4& lhs, const Matrix4& rhs) noexcept
+	{
+		Matrix4 result;
+
+		for (std::size_t row = 0; row < 4; ++row)
+		{
+			for (std::size_t column = 0; column < 4; ++column)
+			{
+				result[row * 4 + column] =
+					lhs[row * 4 + 0] * rhs[0 * 4 + column] +
+					lhs[row * 4 + 1] * rhs[1 * 4 + column] +
+					lhs[row * 4 + 2] * rhs[2 * 4 + column] +
+					lhs[row * 4 + 3] * rhs[3 * 4 + column];
+			}
+		}
+
+		return result;
+	}
+
+	TransformHierarchy::NodeId TransformHierarchy::AddNode(NodeId parent, const Matrix4& local_matrix)
+	{
+		NodeId node;
+
+		if (!m_free_nodes.empty())
+		{
+			node = m_free_nodes.back();
+			m_free_nodes.pop_back();
+			m_nodes[node] = Node();
+		}
+		else
+		{
+			node = static_cast<NodeId>(m_nodes.size());
+			m_nodes.emplace_back();
+		}
+
+		m_nodes[node].m_local_matrix = local_matrix;
+		m_nodes[node].m_active = true;
+		++m_node_count;
+
+		if (IsValid(parent))
+		{
+			Attach(node, parent);
+		}
+
+		MarkDirty(node);
+
+		return node;
+	}
+
+	void TransformHierarchy::RemoveNode(NodeId node)
+	{
+		if (!IsValid(node))
+		{
+			return;
+		}
+
+		// The children become root nodes
+		while (m_nodes[node].m_first_child != INVALID_NODE)
+		{
+			const auto child = m_nodes[node].m_first_child;
+
+			Detach(child);
+			UpdateDepth(child);
+			MarkDirty(child);
+		}
+
+		Detach(node);
+
+		m_nodes[node].m_active = false;
+		m_nodes[node].m_dirty = false;
+		m_free_nodes.push_back(node);
+		--m_node_count;
+	}
+
+	bool TransformHierarchy::SetParent(NodeId node, NodeId parent)
+	{
+		if (!IsValid(node))
+		{
+			return false;
+		}
+
+		// A node cannot become a child of its own subtree
+		for (auto ancestor = parent; IsValid(ancestor); ancestor = m_nodes[ancestor].m_parent)
+		{
+			if (ancestor == node)
+			{
+				return false;
+			}
+		}
+
+		Detach(node);
+
+		if (IsValid(parent))
+		{
+			Attach(node, parent);
+		}
+
+		UpdateDepth(node);
+		MarkDirty(node);
+
+		return true;
+	}
+
+	void TransformHierarchy::SetLocalMatrix(NodeId node, const Matrix4& local_matrix)
+	{
+		if (!IsValid(node))
+		{
+			return;
+		}
+
+		m_nodes[node].m_local_matrix = local_matrix;
+		MarkDirty(node);
+	}
+
+	void TransformHierarchy::Update(std::vector<NodeId>& updated_nodes)
+	{
+		updated_nodes.clear();
+
+		// Shallow nodes first: a dirty node is always reached through its dirty ancestors, if any
+		std::sort(m_dirty_nodes.begin(), m_dirty_nodes.end(), [this](NodeId lhs, NodeId rhs)
+		{
+			return m_nodes[lhs].m_depth < m_nodes[rhs].m_depth;
+		});
+
+		for (auto root : m_dirty_nodes)
+		{
+			// Removed, or recalculated as part of the subtree of an ancestor already
+			if (!m_nodes[root].m_active || !m_nodes[root].m_dirty)
+			{
+				continue;
+			}
+
+			m_traversal_stack.push_back(root);
+
+			while (!m_traversal_stack.empty())
+			{
+				const auto node = m_traversal_stack.back();
+				m_traversal_stack.pop_back();
+
+				auto& data = m_nodes[node];
+
+				data.m_world_matrix = (data.m_parent != INVALID_NODE) ?
+					Multiply(data.m_local_matrix, m_nodes[data.m_parent].m_world_matrix) :
+					data.m_local_matrix;
+				data.m_dirty = false;
+
+				updated_nodes.push_back(node);
+
+				for (auto child = data.m_first_child; child != INVALID_NODE; child = m_nodes[child].m_next_sibling)
+				{
+					m_traversal_stack.push_back(child);
+				}
+			}
+		}
+
+		m_dirty_nodes.clear();
+	}
+
+	Matrix4 TransformHierarchy::CalculateWorldMatrix(NodeId node) const noexcept
+	{
+		if (!IsValid(node))
+		{
+			return IDENTITY_MATRIX;
+		}
+
+		auto world_matrix = m_nodes[node].m_local_matrix;
+
+		for (auto ancestor = m_nodes[node].m_parent; ancestor != INVALID_NODE; ancestor = m_nodes[ancestor].m_parent)
+		{
+			world_matrix = Multiply(world_matrix, m_nodes[ancestor].m_local_matrix);
+		}
+
+		return world_matrix;
+	}
+
+	const Matrix4& TransformHierarchy::GetLocalMatrix(NodeId node) const noexcept
+	{
+		return m_nodes[node].m_local_matrix;
+	}
+
+	const Matrix4& TransformHierarchy::GetWorldMatrix(NodeId node) const noexcept
+	{
+		return m_nodes[node].m_world_matrix;
+	}
+
+	TransformHierarchy::NodeId TransformHierarchy::GetParent(NodeId node) const noexcept
+	{
+		return m_nodes[node].m_parent;
+	}
+
+	bool TransformHierarchy::IsDirty(NodeId node) const noexcept
+	{
+		return m_nodes[node].m_dirty;
+	}
+
+	bool TransformHierarchy::IsValid(NodeId node) const noexcept
+	{
+		return (node < m_nodes.size() && m_nodes[node].m_active);
+	}
+
+	bool TransformHierarchy::HasPendingChanges() const noexcept
+	{
+		return !m_dirty_nodes.empty();
+	}
+
+	std::size_t TransformHierarchy::GetNodeCount() const noexcept
+	{
+		return m_node_count;
+	}
+
+	void TransformHierarchy::Attach(NodeId node, NodeId parent)
+	{
+		auto& data = m_nodes[node];
+		auto& parent_data = m_nodes[parent];
+
+		data.m_parent = parent;
+		data.m_previous_sibling = INVALID_NODE;
+		data.m_next_sibling = parent_data.m_first_child;
+		data.m_depth = parent_data.m_depth + 1;
+
+		if (parent_data.m_first_child != INVALID_NODE)
+		{
+			m_nodes[parent_data.m_first_child].m_previous_sibling = node;
+		}
+
+		parent_data.m_first_child = node;
+	}
+
+	void TransformHierarchy::Detach(NodeId node)
+	{
+		auto& data = m_nodes[node];
+
+		if (data.m_parent == INVALID_NODE)
+		{
+			return;
+		}
+
+		if (data.m_previous_sibling != INVALID_NODE)
+		{
+			m_nodes[data.m_previous_sibling].m_next_sibling = data.m_next_sibling;
+		}
+		else
+		{
+			m_nodes[data.m_parent].m_first_child = data.m_next_sibling;
+		}
+
+		if (data.m_next_sibling != INVALID_NODE)
+		{
+			m_nodes[data.m_next_sibling].m_previous_sibling = data.m_previous_sibling;
+		}
+
+		data.m_parent = INVALID_NODE;
+		data.m_previous_sibling = INVALID_NODE;
+		data.m_next_sibling = INVALID_NODE;
+		data.m_depth = 0;
+	}
+
+	void TransformHierarchy::UpdateDepth(NodeId node)
+	{
+		m_traversal_stack.push_back(node);
+
+		while (!m_traversal_stack.empty())
+		{
+			const auto current = m_traversal_stack.back();
+			m_traversal_stack.pop_back();
+
+			auto& data = m_nodes[current];
+			data.m_depth = (data.m_parent != INVALID_NODE) ? m_nodes[data.m_parent].m_depth + 1 : 0;
+
+			for (auto child = data.m_first_child; child != INVALID_NODE; child = m_nodes[child].m_next_sibling)
+			{
+				m_traversal_stack.push_back(child);
+			}
+		}
+	}
+
+	void TransformHierarchy::MarkDirty(NodeId node)
+	{
+		// Nodes that are dirty already are in the list
+		if (!m_nodes[node].m_dirty)
+		{
+			m_nodes[node].m_dirty = true;
+			m_dirty_nodes.push_back(node);
+		}
+	}
+}
@@ -0,0 +1,145 @@
+// Copyright 2019 Breda University of Applied Sciences and Team Wisp (Viktor Zoutman, Emilio Laiso, Jens Hagen, Meine Zeinstra, Tahar Meijs, Koen Buitenhuis, Niels Brunekreef, Darius Bouma, Florian Schut)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+// C++ standard
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+//! Generic plug-in namespace (Wisp Maya Renderer)
+namespace wmr
+{
+	//! Row-major 4x4 matrix, laid out like a Maya MMatrix (row vectors, translation in the last row)
+	using Matrix4 = std::array<double, 16>;
+
+	//! Identity matrix
+	static const constexpr Matrix4 IDENTITY_MATRIX = {
+		1.0, 0.0, 0.0, 0.0,
+		0.0, 1.0, 0.0, 0.0,
+		0.0, 0.0, 1.0, 0.0,
+		0.0, 0.0, 0.0, 1.0 };
+
+	//! Multiply two matrices (lhs * rhs)
+	/*! With the Maya convention, the world matrix of a node is its local matrix multiplied by the world matrix of its
+	 *  parent: Multiply(local, parent_world). */
+	Matrix4 Multiply(const Matrix4& lhs, const Matrix4& rhs) noexcept;
+
+	//! Flattened transform hierarchy with cached world matrices
+	/*! Nodes are stored in flat arrays and refer to each other by index. Changing a local matrix only marks the node as
+	 *  dirty, Update() recomputes the world matrices of every dirty subtree top-down, once. Moving the root of a deep
+	 *  hierarchy therefore costs a single matrix multiplication per node in the subtree, no matter how many local
+	 *  matrices changed in between. Removed nodes leave a free slot that is reused by the next node added. */
+	class TransformHierarchy
+	{
+	public:
+		using NodeId = std::uint32_t;
+
+		//! Node index that does not refer to any node (used as the parent of root nodes)
+		static const constexpr NodeId INVALID_NODE = ~0u;
+
+		TransformHierarchy() = default;
+		~TransformHierarchy() = default;
+
+		//! Add a node to the hierarchy
+		/*! The world matrix of the new node is calculated by the next Update().
+		 *
+		 *  \param parent Parent node, or INVALID_NODE for a root node.
+		 *  \param local_matrix Local matrix of the node.
+		 *  \return Index of the new node. */
+		NodeId AddNode(NodeId parent = INVALID_NODE, const Matrix4& local_matrix = IDENTITY_MATRIX);
+
+		//! Remove a node from the hierarchy
+		/*! Children of the node become root nodes, their world matrices are recalculated by the next Update().
+		 *
+		 *  \param node Node to remove. */
+		void RemoveNode(NodeId node);
+
+		//! Attach a node to another parent
+		/*! \param node Node to move.
+		 *  \param parent New parent node, or INVALID_NODE to turn the node into a root node.
+		 *  \return False when the new parent is part of the subtree of the node, the hierarchy is left untouched. */
+		bool SetParent(NodeId node, NodeId parent);
+
+		//! Change the local matrix of a node, marks the subtree of the node as dirty
+		void SetLocalMatrix(NodeId node, const Matrix4& local_matrix);
+
+		//! Recalculate the world matrices of all dirty subtrees
+		/*! Parents are always processed before their children, every node is recalculated at most once.
+		 *
+		 *  \param updated_nodes Receives the nodes with a recalculated world matrix, in top-down order. */
+		void Update(std::vector<NodeId>& updated_nodes);
+
+		//! Calculate the world matrix of a node from the local matrices, without using the cache
+		/*! Useful when the world matrix of a single node is needed before the next Update(). */
+		Matrix4 CalculateWorldMatrix(NodeId node) const noexcept;
+
+		//! Local matrix of a node
+		const Matrix4& GetLocalMatrix(NodeId node) const noexcept;
+
+		//! Cached world matrix of a node, only up-to-date when the node is not dirty
+		const Matrix4& GetWorldMatrix(NodeId node) const noexcept;
+
+		//! Parent of a node, INVALID_NODE for root nodes
+		NodeId GetParent(NodeId node) const noexcept;
+
+		//! Whether the world matrix of a node still has to be recalculated (ignores dirty ancestors)
+		bool IsDirty(NodeId node) const noexcept;
+
+		//! Whether a node index refers to a node that has not been removed
+		bool IsValid(NodeId node) const noexcept;
+
+		//! Whether any world matrix has to be recalculated
+		bool HasPendingChanges() const noexcept;
+
+		//! Number of nodes in the hierarchy
+		std::size_t GetNodeCount() const noexcept;
+
+	private:
+		struct Node
+		{
+			Matrix4 m_local_matrix = IDENTITY_MATRIX;
+			Matrix4 m_world_matrix = IDENTITY_MATRIX;
+
+			NodeId m_parent = INVALID_NODE;
+			NodeId m_first_child = INVALID_NODE;
+			NodeId m_previous_sibling = INVALID_NODE;
+			NodeId m_next_sibling = INVALID_NODE;
+
+			std::uint32_t m_depth = 0;	//!< Number of ancestors
+			bool m_dirty = false;
+			bool m_active = false;
+		};
+
+		//! Link a node into the child list of its new parent (the node must not have a parent)
+		void Attach(NodeId node, NodeId parent);
+
+		//! Unlink a node from the child list of its parent
+		void Detach(NodeId node);
+
+		//! Update the depth of every node in a subtree, after the root of the subtree moved
+		void UpdateDepth(NodeId node);
+
+		//! Mark a node as dirty, its subtree is recalculated by the next Update()
+		void MarkDirty(NodeId node);
+
+		std::vector<Node> m_nodes;
+		std::vector<NodeId> m_free_nodes;
+		std::vector<NodeId> m_dirty_nodes;		//!< Roots of the dirty subtrees, may contain stale entries
+		std::vector<NodeId> m_traversal_stack;
+		std::size_t m_node_count = 0;
+	};
+}
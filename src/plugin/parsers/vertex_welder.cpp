@@ -0,0 +1,61 @@
+// Copyright 2019 Breda University of Applied Sciences and Team Wisp (Viktor Zoutman, Emilio Laiso, Jens Hagen, Meine Zeinstra, Tahar Meijs, Koen Buitenhuis, Niels Brunekreef, Darius Bouma, Florian Schut)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "vertex_welder.hpp"
+
+namespace wmr
+{
+	std::size_t FaceVertexKeyHash::operator()(const FaceVertexKey& key) const noexcept
+	{
+		// Pack the four indices into two 64-bit words and mix them (splitmix64 finalizer)
+		auto mix = [](std::uint64_t x) -> std::uint64_t
+		{
+			x ^= x >> 30;
+			x *= 0xbf58476d1ce4e5b9ull;
+			x ^= x >> 27;
+			x *= 0x94d049bb133111ebull;
+			x ^= x >> 31;
+			return x;
+		};
+
+		std::uint64_t a = (static_cast<std::uint64_t>(static_cast<std::uint32_t>(key.m_point)) << 32) | static_cast<std::uint32_t>(key.m_normal);
+		std::uint64_t b = (static_cast<std::uint64_t>(static_cast<std::uint32_t>(key.m_tangent)) << 32) | static_cast<std::uint32_t>(key.m_uv);
+
+		return static_cast<std::size_t>(mix(a ^ mix(b)));
+	}
+
+	void VertexWelder::Reserve(std::size_t vertex_count)
+	{
+		m_lookup.reserve(vertex_count);
+	}
+
+	std::uint32_t VertexWelder::Weld(const FaceVertexKey& key, bool& is_new)
+	{
+		// The next vertex index is always equal to the number of unique vertices seen so far
+		auto result = m_lookup.try_emplace(key, static_cast<std::uint32_t>(m_lookup.size()));
+		is_new = result.second;
+
+		return result.first->second;
+	}
+
+	std::size_t VertexWelder::GetUniqueVertexCount() const noexcept
+	{
+		return m_lookup.size();
+	}
+
+	void VertexWelder::Clear() noexcept
+	{
+		m_lookup.clear();
+	}
+}
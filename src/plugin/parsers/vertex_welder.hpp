@@ -0,0 +1,81 @@
+// Copyright 2019 Breda University of Applied Sciences and Team Wisp (Viktor Zoutman, Emilio Laiso, Jens Hagen, Meine Zeinstra, Tahar Meijs, Koen Buitenhuis, Niels Brunekreef, Darius Bouma, Florian Schut)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+// C++ standard
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+
+//! Generic plug-in namespace (Wisp Maya Renderer)
+namespace wmr
+{
+	//! Identifies a single face-vertex by the attribute indices it references
+	/*! Two face-vertices that reference the same point, normal, tangent, and UV coordinate produce the exact same
+	 *  Wisp vertex, so they can safely share a single entry in the vertex buffer. Bitangents are not part of the key,
+	 *  because Maya indexes them using the normal index. */
+	struct FaceVertexKey
+	{
+		std::int32_t m_point;	//!< Object-relative point (position) index
+		std::int32_t m_normal;	//!< Normal (and bitangent) index
+		std::int32_t m_tangent;	//!< Tangent index
+		std::int32_t m_uv;		//!< UV index in the first UV set
+
+		bool operator==(const FaceVertexKey& rhs) const noexcept
+		{
+			return (m_point == rhs.m_point &&
+					m_normal == rhs.m_normal &&
+					m_tangent == rhs.m_tangent &&
+					m_uv == rhs.m_uv);
+		}
+	};
+
+	//! Hash function for the face-vertex key
+	struct FaceVertexKeyHash
+	{
+		std::size_t operator()(const FaceVertexKey& key) const noexcept;
+	};
+
+	//! Merges face-vertices with identical attribute indices into shared vertices
+	/*! Feed the welder every triangle corner in order. For each corner it returns the index of the output vertex to
+	 *  use in the index buffer, and whether that vertex is new (in which case the caller has to append it to the
+	 *  vertex buffer). New vertices are numbered sequentially starting at zero. */
+	class VertexWelder
+	{
+	public:
+		VertexWelder() = default;
+		~VertexWelder() = default;
+
+		//! Reserve space for the expected number of unique vertices
+		/*! \param vertex_count Expected number of unique vertices (usually the number of points in the mesh). */
+		void Reserve(std::size_t vertex_count);
+
+		//! Look up or insert a face-vertex
+		/*! \param key Attribute indices of the face-vertex.
+		 *  \param is_new Set to true when the face-vertex was not seen before.
+		 *  \return Index of the output vertex. */
+		std::uint32_t Weld(const FaceVertexKey& key, bool& is_new);
+
+		//! Number of unique vertices emitted so far
+		std::size_t GetUniqueVertexCount() const noexcept;
+
+		//! Forget all vertices, keeps the allocated memory
+		void Clear() noexcept;
+
+	private:
+		//! Maps a face-vertex key to its output vertex index
+		std::unordered_map<FaceVertexKey, std::uint32_t, FaceVertexKeyHash> m_lookup;
+	};
+}
@@ -17,6 +17,7 @@
 // Wisp plug-in
 #include "miscellaneous/functions.hpp"
 #include "miscellaneous/settings.hpp"
+#include "miscellaneous/trace_recorder.hpp"
 #include "plugin/renderer/renderer.hpp"
 #include "plugin/viewport_renderer_override.hpp"
 #include "screen_render_operation.hpp"
@@ -138,6 +139,9 @@ namespace wmr
 
 	MStatus RendererCopyOperation::execute(const MDrawContext& draw_context)
 	{
+		ScopedCPUTimer timer(m_renderer.GetProfiler(), "cpu/renderer copy");
+		ScopedTraceEvent trace_event("RendererCopyOperation::execute", "render operation");
+
 		auto maya_renderer = MHWRender::MRenderer::theRenderer();
 
 		// Failed to retrieve the Maya renderer, cannot continue!
@@ -176,6 +180,12 @@ namespace wmr
 									 m_color_texture_desc.fHeight == wisp_output_height	&&
 									 m_depth_texture_desc.fHeight == wisp_output_height);
 
+		// Render-on-demand reused the last frame, the Maya textures hold that frame already
+		if (textures_exist && texture_size_matches && !m_renderer.HasNewRenderResult())
+		{
+			return MStatus::kSuccess;
+		}
+
 		// Flag indicating whether a new color / depth buffer has to be created
 		bool requires_new_textures = false;
 
@@ -43,6 +43,8 @@ namespace wmr
 
 	MStatus RendererDrawOperation::execute(const MDrawContext& draw_context)
 	{
+		ScopedCPUTimer timer(m_renderer.GetProfiler(), "cpu/renderer render");
+
 		// Render the scene using the Wisp rendering framework
 		m_renderer.Render();
 
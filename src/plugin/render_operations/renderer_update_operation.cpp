@@ -43,6 +43,8 @@ namespace wmr
 
 	MStatus RendererUpdateOperation::execute(const MDrawContext& draw_context)
 	{
+		ScopedCPUTimer timer(m_renderer.GetProfiler(), "cpu/renderer update");
+
 		// Update the Wisp rendering framework to prepare it for rendering
 		m_renderer.Update();
 
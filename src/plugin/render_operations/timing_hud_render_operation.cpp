@@ -0,0 +1,82 @@
+// Copyright 2019 Breda University of Applied Sciences and Team Wisp (Viktor Zoutman, Emilio Laiso, Jens Hagen, Meine Zeinstra, Tahar Meijs, Koen Buitenhuis, Niels Brunekreef, Darius Bouma, Florian Schut)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "timing_hud_render_operation.hpp"
+
+// Wisp plug-in
+#include "miscellaneous/settings.hpp"
+#include "plugin/renderer/renderer.hpp"
+#include "plugin/viewport_renderer_override.hpp"
+
+// Maya API
+#include <maya/MColor.h>
+#include <maya/MPoint.h>
+#include <maya/MString.h>
+#include <maya/MUIDrawManager.h>
+
+// C++ standard
+#include <cstdio>
+
+namespace wmr
+{
+	TimingHUDRenderOperation::TimingHUDRenderOperation()
+		: MHWRender::MHUDRender()
+		, m_renderer(dynamic_cast<const ViewportRendererOverride*>(MHWRender::MRenderer::theRenderer()->findRenderOverride(settings::VIEWPORT_OVERRIDE_NAME))->GetRenderer())
+	{
+	}
+
+	TimingHUDRenderOperation::~TimingHUDRenderOperation()
+	{
+	}
+
+	void TimingHUDRenderOperation::addUIDrawables(MHWRender::MUIDrawManager& draw_manager, const MHWRender::MFrameContext& frame_context)
+	{
+		if (!m_renderer.IsTimingHUDEnabled())
+		{
+			return;
+		}
+
+		int origin_x = 0, origin_y = 0, width = 0, height = 0;
+		frame_context.getViewportDimensions(origin_x, origin_y, width, height);
+
+		// Below the Maya heads-up display in the top left corner of the viewport
+		const double line_height = 14.0;
+		const double x = 10.0;
+		double y = static_cast<double>(height) - 80.0;
+
+		draw_manager.beginDrawable();
+		draw_manager.setColor(MColor(1.0f, 1.0f, 0.0f));
+		draw_manager.setFontSize(MHWRender::MUIDrawManager::kSmallFontSize);
+
+		draw_manager.text2d(MPoint(x, y), "Timer: min / avg / p95 (ms)", MHWRender::MUIDrawManager::kLeft);
+
+		for (const auto& [name, statistics] : m_renderer.GetProfiler().GetStatistics())
+		{
+			y -= line_height;
+
+			if (y < 0.0)
+			{
+				break;
+			}
+
+			char line[256];
+			std::snprintf(line, sizeof(line), "%s: %.2f / %.2f / %.2f", name.c_str(), statistics.m_min, statistics.m_average, statistics.m_p95);
+
+			draw_manager.text2d(MPoint(x, y), MString(line), MHWRender::MUIDrawManager::kLeft);
+		}
+
+		draw_manager.endDrawable();
+	}
+}
@@ -0,0 +1,40 @@
+// Copyright 2019 Breda University of Applied Sciences and Team Wisp (Viktor Zoutman, Emilio Laiso, Jens Hagen, Meine Zeinstra, Tahar Meijs, Koen Buitenhuis, Niels Brunekreef, Darius Bouma, Florian Schut)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <maya/MViewport2Renderer.h>
+
+namespace wmr
+{
+	// Forward declarations
+	class Renderer;
+
+	//! Maya heads-up display that draws the timing statistics of the profiler on top of the viewport
+	/*! Only draws the statistics when the timing HUD of the renderer is enabled, the regular Maya heads-up display is
+	 *  drawn either way. */
+	class TimingHUDRenderOperation final : public MHWRender::MHUDRender
+	{
+	public:
+		TimingHUDRenderOperation();
+		~TimingHUDRenderOperation();
+
+	private:
+		void addUIDrawables(MHWRender::MUIDrawManager& draw_manager, const MHWRender::MFrameContext& frame_context) override;
+
+	private:
+		Renderer& m_renderer;
+	};
+}
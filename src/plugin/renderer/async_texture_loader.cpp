@@ -0,0 +1,183 @@
+// Copyright 2019 Breda University of Applied Sciences and Team Wisp (Viktor Zoutman, Emilio Laiso, Jens Hagen, Meine Zeinstra, Tahar Meijs, Koen Buitenhuis, Niels Brunekreef, Darius Bouma, Florian Schut)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "async_texture_loader.hpp"
+
+// C++ standard
+#include <algorithm>
+#include <exception>
+#include <iterator>
+
+namespace wmr
+{
+	AsyncTextureLoader::AsyncTextureLoader(std::size_t thread_count, DecodeFunction decode, std::size_t latency_window)
+		: m_decode(std::move(decode))
+		, m_next_request_id(1)
+		, m_shutting_down(false)
+		, m_loaded(0)
+		, m_failed(0)
+		, m_cancelled_count(0)
+		, m_latency(latency_window)
+		, m_pool(thread_count)
+	{
+	}
+
+	AsyncTextureLoader::~AsyncTextureLoader()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_shutting_down = true;
+		}
+
+		// The thread pool joins its workers when it is destroyed, the queued requests return immediately
+		WaitForAll();
+	}
+
+	std::uint64_t AsyncTextureLoader::Request(const std::string& path, TextureRole role, std::uint32_t max_size)
+	{
+		std::uint64_t request_id = 0;
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			request_id = m_next_request_id++;
+			m_in_flight.insert(request_id);
+		}
+
+		const auto request_time = std::chrono::steady_clock::now();
+
+		m_pool.Enqueue([this, request_id, request = TextureLoadRequest{ path, role, max_size }, request_time]()
+		{
+			Load(request_id, request, request_time);
+		});
+
+		return request_id;
+	}
+
+	void AsyncTextureLoader::Cancel(std::uint64_t request_id)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		// Already decoded, drop the result
+		auto completed = std::find_if(m_completed.begin(), m_completed.end(), [request_id](const TextureLoadResult& result)
+		{
+			return result.m_request_id == request_id;
+		});
+
+		if (completed != m_completed.end())
+		{
+			m_completed.erase(completed);
+			++m_cancelled_count;
+			return;
+		}
+
+		// Still queued or decoding, Load() drops the result
+		if (m_in_flight.count(request_id) > 0 && m_cancelled.insert(request_id).second)
+		{
+			++m_cancelled_count;
+		}
+	}
+
+	std::vector<TextureLoadResult> AsyncTextureLoader::CollectCompleted(std::size_t max_count)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		const auto count = std::min(max_count, m_completed.size());
+
+		std::vector<TextureLoadResult> results(std::make_move_iterator(m_completed.begin()), std::make_move_iterator(m_completed.begin() + count));
+		m_completed.erase(m_completed.begin(), m_completed.begin() + count);
+
+		return results;
+	}
+
+	void AsyncTextureLoader::WaitForAll()
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_idle_condition.wait(lock, [this]() { return m_in_flight.empty(); });
+	}
+
+	TextureLoaderStatistics AsyncTextureLoader::GetStatistics() const
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		TextureLoaderStatistics statistics;
+		statistics.m_queue_depth = m_in_flight.size() - m_cancelled.size() + m_completed.size();
+		statistics.m_loaded = m_loaded;
+		statistics.m_failed = m_failed;
+		statistics.m_cancelled = m_cancelled_count;
+		statistics.m_latency = m_latency.GetStatistics();
+
+		return statistics;
+	}
+
+	void AsyncTextureLoader::Load(std::uint64_t request_id, const TextureLoadRequest& request, std::chrono::steady_clock::time_point request_time)
+	{
+		// Called with the mutex locked
+		auto finish = [this, request_id]()
+		{
+			m_in_flight.erase(request_id);
+			m_idle_condition.notify_all();
+		};
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+
+			// Skip requests that are not needed anymore, without touching the file
+			const bool cancelled = (m_cancelled.erase(request_id) > 0);
+
+			if (cancelled || m_shutting_down)
+			{
+				finish();
+				return;
+			}
+		}
+
+		TextureLoadResult result;
+		result.m_request_id = request_id;
+		result.m_path = request.m_path;
+
+		try
+		{
+			result.m_success = m_decode(request, result.m_texture, result.m_error);
+		}
+		catch (const std::exception& exception)
+		{
+			result.m_success = false;
+			result.m_error = exception.what();
+		}
+
+		const std::chrono::duration<double, std::milli> latency = std::chrono::steady_clock::now() - request_time;
+		result.m_latency = latency.count();
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		if (result.m_success)
+		{
+			++m_loaded;
+			m_latency.AddSample(result.m_latency);
+		}
+		else
+		{
+			++m_failed;
+		}
+
+		// Cancelled while decoding
+		if (m_cancelled.erase(request_id) == 0)
+		{
+			m_completed.push_back(std::move(result));
+		}
+
+		finish();
+	}
+}
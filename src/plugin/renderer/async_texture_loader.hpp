@@ -0,0 +1,155 @@
+// Copyright 2019 Breda University of Applied Sciences and Team Wisp (Viktor Zoutman, Emilio Laiso, Jens Hagen, Meine Zeinstra, Tahar Meijs, Koen Buitenhuis, Niels Brunekreef, Darius Bouma, Florian Schut)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+// Wisp plug-in
+#include "miscellaneous/profiler.hpp"
+#include "miscellaneous/thread_pool.hpp"
+
+// C++ standard
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+//! Generic plug-in namespace (Wisp Maya Renderer)
+namespace wmr
+{
+	//! Block compression of a cached texture
+	enum class CompressedTextureFormat
+	{
+		BC1,	//!< Opaque color, 4 bits per pixel
+		BC3,	//!< Color with alpha, 8 bits per pixel
+		BC5,	//!< Two channels (X and Y of a normal map), 8 bits per pixel
+		BC7		//!< High quality, used for data maps where BC1 banding would show up in the shading, 8 bits per pixel
+	};
+
+	//! What a texture is used for, decides how its cached copy is compressed
+	enum class TextureRole
+	{
+		COLOR,		//!< Albedo and emissive textures
+		NORMAL,		//!< Tangent-space normal maps
+		DATA		//!< Roughness, metallic, and ambient occlusion maps
+	};
+
+	//! Texture file to decode
+	struct TextureLoadRequest
+	{
+		std::string m_path;
+		TextureRole m_role = TextureRole::COLOR;
+		std::uint32_t m_max_size = 0;		//!< Maximum width and height, larger textures leave out their top mip levels
+	};
+
+	//! Decoded texture in CPU memory, tightly packed rows of 8-bit RGBA pixels
+	/*! Textures loaded from the texture cache have no pixels, they are uploaded straight from the cached file. */
+	struct DecodedTexture
+	{
+		std::vector<std::uint8_t> m_pixels;
+		std::uint32_t m_width = 0;						//!< Width of the top level
+		std::uint32_t m_height = 0;						//!< Height of the top level
+		std::uint32_t m_first_mip = 0;					//!< Number of top mip levels left out to fit the maximum size
+		std::string m_cached_path;						//!< Compressed copy of the texture in the texture cache, of the levels that fit the maximum size
+		std::optional<CompressedTextureFormat> m_compressed_format;	//!< Block compression of the cached copy
+		bool m_mip_chain = false;						//!< Whether the levels below the top level are included
+	};
+
+	//! Outcome of a texture load request
+	struct TextureLoadResult
+	{
+		std::uint64_t m_request_id = 0;
+		std::string m_path;
+		bool m_success = false;
+		std::string m_error;				//!< Reason the texture could not be decoded
+		DecodedTexture m_texture;
+		double m_latency = 0.0;				//!< Milliseconds from the request until the texture was decoded
+	};
+
+	//! Counters of the texture loader
+	struct TextureLoaderStatistics
+	{
+		std::size_t m_queue_depth = 0;		//!< Requests that have not been collected yet (queued, decoding, or decoded)
+		std::uint64_t m_loaded = 0;			//!< Textures decoded since the loader was created
+		std::uint64_t m_failed = 0;			//!< Textures that could not be decoded
+		std::uint64_t m_cancelled = 0;		//!< Requests cancelled before they were collected
+		TimingStatistics m_latency;			//!< Milliseconds from the request until the texture was decoded
+	};
+
+	//! Decodes texture files on worker threads
+	/*! The main thread requests textures and collects the decoded results once per frame, so the GPU upload happens on
+	 *  the thread that owns the texture pool. The decode function runs on the worker threads and must not call into
+	 *  the Maya API. */
+	class AsyncTextureLoader
+	{
+	public:
+		//! Decodes the requested file, returns false and sets the error when the file cannot be decoded
+		using DecodeFunction = std::function<bool(const TextureLoadRequest& request, DecodedTexture& texture, std::string& error)>;
+
+		//! \param thread_count Number of worker threads (at least one).
+		//! \param decode Called on the worker threads for every request.
+		//! \param latency_window Number of loads the latency statistics are computed over.
+		AsyncTextureLoader(std::size_t thread_count, DecodeFunction decode, std::size_t latency_window = 120);
+
+		//! Requests that have not started decoding are skipped, the worker threads finish their current texture
+		~AsyncTextureLoader();
+
+		AsyncTextureLoader(const AsyncTextureLoader&) = delete;
+		AsyncTextureLoader& operator=(const AsyncTextureLoader&) = delete;
+
+		//! Queue a texture file for decoding
+		/*! \return ID of the request, never zero. */
+		std::uint64_t Request(const std::string& path, TextureRole role = TextureRole::COLOR, std::uint32_t max_size = 0);
+
+		//! Discard a request, it is skipped when it has not started decoding yet and its result is never collected
+		void Cancel(std::uint64_t request_id);
+
+		//! Take the decoded (or failed) textures in the order in which they finished
+		/*! \param max_count Maximum number of results taken, the rest is collected by the next call. */
+		std::vector<TextureLoadResult> CollectCompleted(std::size_t max_count = std::numeric_limits<std::size_t>::max());
+
+		//! Block until every request has been decoded or skipped
+		void WaitForAll();
+
+		//! Queue depth, load counts, and load latency
+		TextureLoaderStatistics GetStatistics() const;
+
+	private:
+		//! Decode a single request on a worker thread
+		void Load(std::uint64_t request_id, const TextureLoadRequest& request, std::chrono::steady_clock::time_point request_time);
+
+		DecodeFunction m_decode;
+
+		mutable std::mutex m_mutex;						//!< Guards everything below
+		std::condition_variable m_idle_condition;		//!< Signalled when a worker finished a request
+		std::uint64_t m_next_request_id;
+		std::unordered_set<std::uint64_t> m_in_flight;	//!< Requests queued or decoding
+		std::unordered_set<std::uint64_t> m_cancelled;	//!< Cancelled requests that have not finished yet
+		std::vector<TextureLoadResult> m_completed;		//!< Finished requests that have not been collected
+		bool m_shutting_down;
+		std::uint64_t m_loaded;
+		std::uint64_t m_failed;
+		std::uint64_t m_cancelled_count;
+		RollingTimingStatistics m_latency;
+
+		//! Declared last, the workers are joined before the state above is destroyed
+		ThreadPool m_pool;
+	};
+}
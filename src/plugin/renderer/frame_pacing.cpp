@@ -0,0 +1,34 @@
+// Copyright 2019 Breda University of Applied Sciences and Team Wisp (Viktor Zoutman, Emilio Laiso, Jens Hagen, Meine Zeinstra, Tahar Meijs, Koen Buitenhuis, Niels Brunekreef, Darius Bouma, Florian Schut)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "frame_pacing.hpp"
+
+// C++ standard
+#include <algorithm>
+
+namespace wmr
+{
+	std::optional<std::uint32_t> GetFrameIndexToWaitFor(std::uint32_t current_frame_index, std::uint32_t back_buffer_count, std::uint32_t frames_in_flight) noexcept
+	{
+		frames_in_flight = std::clamp<std::uint32_t>(frames_in_flight, 1, std::max<std::uint32_t>(back_buffer_count, 1));
+
+		if (frames_in_flight >= back_buffer_count)
+		{
+			return std::nullopt;
+		}
+
+		return (current_frame_index + back_buffer_count - frames_in_flight) % back_buffer_count;
+	}
+}
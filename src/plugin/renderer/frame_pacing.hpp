@@ -0,0 +1,37 @@
+// Copyright 2019 Breda University of Applied Sciences and Team Wisp (Viktor Zoutman, Emilio Laiso, Jens Hagen, Meine Zeinstra, Tahar Meijs, Koen Buitenhuis, Niels Brunekreef, Darius Bouma, Florian Schut)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+// C++ standard
+#include <cstdint>
+#include <optional>
+
+//! Generic plug-in namespace (Wisp Maya Renderer)
+namespace wmr
+{
+	//! Frame index whose last frame has to finish before the next frame is recorded
+	/*! Wisp cycles through one frame index per back buffer, and waits for the last frame of the current frame index
+	 *  itself before it records a new frame on it. That wait alone allows as many frames in flight as there are back
+	 *  buffers. For fewer frames in flight, the frame submitted "frames in flight" frames ago has to be finished as well,
+	 *  which is the last frame of an earlier frame index.
+	 *
+	 *  \param current_frame_index Frame index of the frame that is about to be recorded.
+	 *  \param back_buffer_count Number of frame indices Wisp cycles through.
+	 *  \param frames_in_flight Maximum number of frames the GPU may work on (clamped to [1, back_buffer_count]).
+	 *  \return Frame index to wait for, or nothing when the wait of Wisp suffices. The current frame index is never
+	 *          returned, its fence has not been signaled for the new frame yet. */
+	std::optional<std::uint32_t> GetFrameIndexToWaitFor(std::uint32_t current_frame_index, std::uint32_t back_buffer_count, std::uint32_t frames_in_flight) noexcept;
+}
@@ -128,6 +128,7 @@ void wmr::MaterialManager::OnRemoveSurfaceShader(MPlug & surface_shader)
 
 		// Clear all textures
 		wr::Material* m = m_material_pool->GetMaterial(it->material_handle);
+		m_texture_manager->ReleaseMaterial(*m);
 		{
 			// Clear albedo texture
 			if (m->HasTexture(wr::TextureType::ALBEDO)) {
@@ -16,42 +16,312 @@
 
 // Wisp plug-in
 #include "miscellaneous/functions.hpp"
+#include "plugin/framegraph/frame_graph_manager.hpp"
+#include "plugin/parsers/mesh_converter.hpp"
 #include "plugin/viewport_renderer_override.hpp"
 #include "renderer.hpp"
 #include "settings.hpp"
 
 // Wisp rendering framework
+#include "d3d12/d3d12_functions.hpp"
+#include "d3d12/d3d12_model_pool.hpp"
 #include "d3d12/d3d12_renderer.hpp"
+#include "util/log.hpp"
+#include "wisp_render_tasks/d3d12_frame_fences.hpp"
+#include "wisp_render_tasks/d3d12_vertex_patch_upload.hpp"
 
 // Maya API
 #include <maya/MViewport2Renderer.h>
 
+// C++ standard
+#include <algorithm>
+
+wmr::ModelManager::ModelManager()
+	: m_models_changed( false )
+	, m_relocation_count( 0 )
+{
+}
+
 void wmr::ModelManager::Initialize()
 {
-	auto* maya_override = dynamic_cast< const ViewportRendererOverride* >( MHWRender::MRenderer::theRenderer()->findRenderOverride( settings::VIEWPORT_OVERRIDE_NAME ) );
-	m_model_pool = maya_override->GetRenderer().GetD3D12Renderer().CreateModelPool( settings::MAX_VERTEX_DATA_SIZE_MB, settings::MAX_INDEX_DATA_SIZE_MB ) ;
+	// Start with a single page, more pages are added on demand
+	AddPage( settings::MAX_VERTEX_DATA_SIZE_MB, settings::MAX_INDEX_DATA_SIZE_MB );
 }
 
-wr::Model* wmr::ModelManager::AddModel(const wr::MeshData<wr::Vertex>& data) noexcept
+wr::Model* wmr::ModelManager::AddModel(wr::MeshData<wr::Vertex> data) noexcept
 {
+	auto allocation = AllocateModel( data.m_vertices.size() * sizeof( wr::Vertex ), data.m_indices.value().size() * sizeof( std::uint32_t ), std::nullopt );
+
 	// Load a model using the new model data
-	auto model = m_model_pool->LoadCustom<wr::Vertex>({ data });
+	auto model = m_model_pools[allocation.m_vertices.m_page]->LoadCustom<wr::Vertex>({ data });
+
+	m_model_records[model] = { allocation };
+	m_models_changed = true;
 
 	// Just to avoid yet another call to "GetModelByName", the pointer is returned here already
 	return model;
 }
 
-void wmr::ModelManager::UpdateModel(wr::Model& model, const wr::MeshData<wr::Vertex>& data )
+void wmr::ModelManager::UpdateModel(wr::Model& model, wr::MeshData<wr::Vertex> data )
 {
-	m_model_pool->EditMesh( model.m_meshes[0].first, data.m_vertices, data.m_indices.value() );
+	auto record = m_model_records.find( &model );
+	if( record == m_model_records.end() )
+	{
+		LOGC( "Trying to update a model that is not managed by the model manager." );
+		return;
+	}
+
+	m_models_changed = true;
+
+	const auto vertex_size = data.m_vertices.size() * sizeof( wr::Vertex );
+	const auto index_size = data.m_indices.value().size() * sizeof( std::uint32_t );
+	const auto old_allocation = record->second.m_allocation;
+	const auto page = old_allocation.m_vertices.m_page;
+
+	// Keep the model in its page when the new data fits
+	m_allocator.Free( old_allocation );
+	auto allocation = m_allocator.AllocateInPage( page, vertex_size, index_size );
+
+	if( allocation )
+	{
+		record->second.m_allocation = *allocation;
+		m_model_pools[page]->EditMesh( model.m_meshes[0].first, data.m_vertices, data.m_indices.value() );
+		return;
+	}
+
+	// The old copy stays in its page until the GPU is done with it, its space is reserved again until then (the freed
+	// block can always hold the old sizes again)
+	record->second.m_allocation = *m_allocator.AllocateInPage( page, old_allocation.m_vertices.m_size, old_allocation.m_indices.m_size );
+
+	RelocateModel( &model, AllocateModel( vertex_size, index_size, page ), data );
+}
+
+void wmr::ModelManager::UpdateModelVertices( wr::Model& model, const std::vector<wr::Vertex>& vertices, const std::vector<VertexRange>& dirty_ranges )
+{
+	auto record = m_model_records.find( &model );
+	if( record == m_model_records.end() || dirty_ranges.empty() )
+	{
+		return;
+	}
+
+	// EditMesh() would upload the vertex and index buffers as a whole. Instead, only the dirty ranges are written into
+	// the upload heap of the page, and the vertex patch upload task at the start of the next frame copies just those
+	// ranges to the GPU. The index buffer is not touched at all.
+	auto* pool = static_cast<wr::D3D12ModelPool*>( m_model_pools[record->second.m_allocation.m_vertices.m_page].get() );
+	auto* mesh = static_cast<wr::internal::D3D12MeshInternal*>( pool->GetMeshData( model.m_meshes[0].first->id ) );
+	auto* vertex_buffer = pool->GetVertexStagingBuffer();
+
+	const auto first_vertex_offset = static_cast<std::uint64_t>( mesh->m_vertex_staging_buffer_offset ) * mesh->m_vertex_staging_buffer_stride;
+	auto& upload = GetRenderer().GetFrameGraph().GetVertexPatchUpload();
+
+	for( const auto& range : dirty_ranges )
+	{
+		const auto offset = first_vertex_offset + range.m_first * sizeof( wr::Vertex );
+		const auto size = range.m_count * sizeof( wr::Vertex );
+
+		wr::d3d12::UpdateStagingBuffer( vertex_buffer, &vertices[range.m_first], size, offset );
+		upload.Add( vertex_buffer, offset, size );
+	}
+}
+
+bool wmr::ModelManager::CanPatchVertices() const
+{
+	return !GetRenderer().GetFrameGraph().HasRayTracingPipeline();
 }
 
 void wmr::ModelManager::DeleteModel(wr::Model& model)
 {
-	m_model_pool->Destroy(&model);
+	auto record = m_model_records.find( &model );
+	if( record == m_model_records.end() )
+	{
+		LOGC( "Trying to delete a model that is not managed by the model manager." );
+		return;
+	}
+
+	// Frames in flight may still draw the model
+	RetireModel( &model, record->second.m_allocation );
+	m_model_records.erase( record );
+
+	m_models_changed = true;
+}
+
+bool wmr::ModelManager::Update()
+{
+	DestroyRetiredModels();
+
+	// Only compact in idle frames, so interactive edits never pay for it
+	if( m_models_changed )
+	{
+		m_models_changed = false;
+		return false;
+	}
+
+	auto page = m_allocator.FindSparsePage( settings::MODEL_POOL_COMPACTION_OCCUPANCY );
+	if( !page || !m_model_data_callback )
+	{
+		return false;
+	}
+
+	// Move a limited amount of models out of the sparse page, the rest follows in the next idle frames
+	std::vector<wr::Model*> page_models;
+	for( auto& record : m_model_records )
+	{
+		if( record.second.m_allocation.m_vertices.m_page == *page && page_models.size() < settings::MAX_MODEL_RELOCATIONS_PER_FRAME )
+		{
+			page_models.push_back( record.first );
+		}
+	}
+
+	bool relocated = false;
+	for( auto* model : page_models )
+	{
+		// No copy of the mesh data is kept, it is gathered again for the upload to the other page
+		wr::MeshData<wr::Vertex> data;
+		if( !m_model_data_callback( model, data ) )
+		{
+			continue;
+		}
+
+		// Never add a page while compacting, when the model does not fit anywhere else the page stays as it is
+		auto new_allocation = m_allocator.Allocate( data.m_vertices.size() * sizeof( wr::Vertex ), data.m_indices.value().size() * sizeof( std::uint32_t ), *page );
+		if( !new_allocation )
+		{
+			return relocated;
+		}
+
+		RelocateModel( model, *new_allocation, data );
+		relocated = true;
+	}
+
+	// Retired models keep their allocations until they are destroyed, so the page is only empty once the GPU is done
+	// with the models that were moved out of it
+	if( m_allocator.IsPageEmpty( *page ) )
+	{
+		GetRenderer().GetFrameGraph().GetVertexPatchUpload().Discard( static_cast<wr::D3D12ModelPool*>( m_model_pools[*page].get() )->GetVertexStagingBuffer() );
+
+		m_allocator.ReleasePage( *page );
+		m_model_pools[*page].reset();
+
+		auto statistics = GetStatistics();
+		LOG( "Released model pool page {}, {} page(s) left at an estimated {:.0f}% vertex occupancy.", *page, statistics.m_vertex_data.m_page_count, statistics.m_vertex_data.m_occupancy * 100.0f );
+	}
+
+	return relocated;
+}
+
+void wmr::ModelManager::SetModelRelocatedCallback( std::function<void( wr::Model* old_model, wr::Model* new_model )> callback )
+{
+	m_model_relocated_callback = callback;
+}
+
+void wmr::ModelManager::SetModelDataCallback( std::function<bool( wr::Model* model, wr::MeshData<wr::Vertex>& data )> callback )
+{
+	m_model_data_callback = callback;
+}
+
+wmr::ModelPoolStatistics wmr::ModelManager::GetStatistics() const noexcept
+{
+	ModelPoolStatistics statistics;
+	statistics.m_vertex_data = m_allocator.GetVertexStatistics();
+	statistics.m_index_data = m_allocator.GetIndexStatistics();
+	statistics.m_model_count = m_model_records.size();
+	statistics.m_relocation_count = m_relocation_count;
+
+	return statistics;
 }
 
 void wmr::ModelManager::Destroy() noexcept
 {
-	m_model_pool.reset();
+	// The retired models are destroyed along with their pools
+	m_retired_models.clear();
+	m_model_records.clear();
+	m_model_pools.clear();
+}
+
+wmr::ModelAllocation wmr::ModelManager::AllocateModel( std::size_t vertex_size, std::size_t index_size, std::optional<std::size_t> excluded_page )
+{
+	auto allocation = m_allocator.Allocate( vertex_size, index_size, excluded_page );
+	if( allocation )
+	{
+		return *allocation;
+	}
+
+	// No page has enough room left, add a page that is large enough for this model (rounded up to whole megabytes)
+	auto page_size = []( std::size_t size, std::size_t default_size ) -> std::size_t
+	{
+		return std::max<std::size_t>( ( ( size + 1MB - 1 ) / 1MB ) * 1MB, default_size );
+	};
+
+	auto page = AddPage( page_size( vertex_size, settings::MAX_VERTEX_DATA_SIZE_MB ), page_size( index_size, settings::MAX_INDEX_DATA_SIZE_MB ) );
+
+	return *m_allocator.AllocateInPage( page, vertex_size, index_size );
+}
+
+std::size_t wmr::ModelManager::AddPage( std::size_t vertex_capacity, std::size_t index_capacity )
+{
+	auto pool = GetRenderer().GetD3D12Renderer().CreateModelPool( vertex_capacity, index_capacity );
+
+	auto page = m_allocator.AddPage( vertex_capacity, index_capacity );
+	if( page >= m_model_pools.size() )
+	{
+		m_model_pools.resize( page + 1 );
+	}
+	m_model_pools[page] = pool;
+
+	auto statistics = GetStatistics();
+	LOG( "Added model pool page {} ({} bytes of vertex data, {} bytes of index data), {} page(s) in use.", page, vertex_capacity, index_capacity, statistics.m_vertex_data.m_page_count );
+
+	return page;
+}
+
+wmr::Renderer& wmr::ModelManager::GetRenderer() const
+{
+	auto* maya_override = dynamic_cast< const ViewportRendererOverride* >( MHWRender::MRenderer::theRenderer()->findRenderOverride( settings::VIEWPORT_OVERRIDE_NAME ) );
+	return maya_override->GetRenderer();
+}
+
+wr::Model* wmr::ModelManager::RelocateModel( wr::Model* model, const ModelAllocation& allocation, const wr::MeshData<wr::Vertex>& data )
+{
+	auto record = m_model_records.extract( model );
+
+	// Load the model into its new page, the old copy is destroyed once the frames in flight are done with it
+	auto new_model = m_model_pools[allocation.m_vertices.m_page]->LoadCustom<wr::Vertex>({ data });
+	RetireModel( model, record.mapped().m_allocation );
+
+	record.key() = new_model;
+	record.mapped().m_allocation = allocation;
+	m_model_records.insert( std::move( record ) );
+
+	++m_relocation_count;
+
+	if( m_model_relocated_callback )
+	{
+		m_model_relocated_callback( model, new_model );
+	}
+
+	return new_model;
+}
+
+void wmr::ModelManager::RetireModel( wr::Model* model, const ModelAllocation& allocation )
+{
+	m_retired_models.push_back( { model, allocation, wr::internal::GetLastSubmittedFrameFence( GetRenderer().GetD3D12Renderer() ) } );
+}
+
+void wmr::ModelManager::DestroyRetiredModels()
+{
+	auto& render_system = GetRenderer().GetD3D12Renderer();
+
+	auto destroy_if_finished = [this, &render_system]( const RetiredModel& retired ) -> bool
+	{
+		if( !wr::internal::IsFrameFenceComplete( render_system, retired.m_fence ) )
+		{
+			return false;
+		}
+
+		m_model_pools[retired.m_allocation.m_vertices.m_page]->Destroy( retired.m_model );
+		m_allocator.Free( retired.m_allocation );
+		return true;
+	};
+
+	m_retired_models.erase( std::remove_if( m_retired_models.begin(), m_retired_models.end(), destroy_if_finished ), m_retired_models.end() );
 }
@@ -14,13 +14,15 @@
 
 #pragma once
 
-// Wisp rendering framework
+// Wisp plug-in
+#include "plugin/renderer/pool_allocator.hpp"
+#include "wisp_render_tasks/readback_ring.hpp"
+
 #include "wisp.hpp"
 
-// Maya API
 #include <maya/MString.h>
 
-// C++ standard
+#include <functional>
 #include <memory>
 #include <unordered_map>
 #include <vector>
@@ -32,32 +34,126 @@ namespace wr
 
 namespace wmr
 {
+	struct VertexRange;
+	class Renderer;
+
+	//! Occupancy and fragmentation counters of the model pool pages
+	/*! The byte counts are estimates: they come from the plug-in's own bookkeeping of the requests it makes to the Wisp
+	 *  model pools (see ModelPoolAllocator), not from the Wisp allocator itself. */
+	struct ModelPoolStatistics
+	{
+		PoolStatistics m_vertex_data;			//!< Vertex data of all pages
+		PoolStatistics m_index_data;			//!< Index data of all pages
+		std::size_t m_model_count = 0;			//!< Number of models in the pool
+		std::size_t m_relocation_count = 0;		//!< Number of models moved to another page since the start
+	};
+
 	class ModelManager
 	{
 	public:
-		ModelManager() = default;
+		ModelManager();
 		~ModelManager() = default;
 
 		//! Create all required structures
 		void Initialize();
 
 		//! Request to load a model, if the model already exists
-		/*! Returns a pointer to the loaded model.
+		/*! Returns a pointer to the loaded model. Models are placed in the first page that can hold them, when no page
+		 *  has enough room left, a new page is added.
 		 *
+		 *  /param data Mesh data of the model.
 		 *  /return Pointer to the loaded model. */
-		wr::Model* AddModel(const wr::MeshData<wr::Vertex>& data) noexcept;
+		wr::Model* AddModel(wr::MeshData<wr::Vertex> data) noexcept;
 
 		//! Update existing mode data
-		void UpdateModel( wr::Model& model, const wr::MeshData<wr::Vertex>& data );
+		/*! When the new data does not fit in the page of the model anymore, the model is moved to another page and the
+		 *  model relocated callback is called. */
+		void UpdateModel( wr::Model& model, wr::MeshData<wr::Vertex> data );
+
+		//! Update the vertices of an existing model, the index buffer did not change
+		/*! Only the dirty ranges are uploaded, the GPU copy is recorded at the start of the next frame. Only call this
+		 *  when CanPatchVertices() returns true.
+		 *
+		 *  /param model Model to update.
+		 *  /param vertices All vertices of the model, the vertex count did not change.
+		 *  /param dirty_ranges Ranges of vertices that changed since the last update. */
+		void UpdateModelVertices( wr::Model& model, const std::vector<wr::Vertex>& vertices, const std::vector<VertexRange>& dirty_ranges );
+
+		//! Whether UpdateModelVertices() can be used, UpdateModel() has to be used otherwise
+		/*! Patched vertices bypass the model pool, so the acceleration structures of ray tracing frame graphs would not
+		 *  be updated. */
+		bool CanPatchVertices() const;
 
 		//! Delete Model from pool
 		void DeleteModel( wr::Model& model );
 
+		//! Compact the model pool pages when no models changed since the last call
+		/*! Call this once per frame. In idle frames, models are moved out of the least occupied page, so the page can be
+		 *  released once it is empty. Nothing is compacted until a model data callback is set.
+		 *
+		 *  \return True when models were moved to another page. */
+		bool Update();
+
+		//! Set the function to call when a model is moved to another page
+		/*! The model pointer of the old page becomes invalid, every scene graph node that uses it has to be updated. */
+		void SetModelRelocatedCallback( std::function<void( wr::Model* old_model, wr::Model* new_model )> callback );
+
+		//! Set the function that gathers the mesh data of a model again, to move the model to another page
+		/*! The model manager keeps no copy of the mesh data. When the function returns false, the model stays in its
+		 *  page. */
+		void SetModelDataCallback( std::function<bool( wr::Model* model, wr::MeshData<wr::Vertex>& data )> callback );
+
+		//! Estimated occupancy and fragmentation of the model pool pages
+		ModelPoolStatistics GetStatistics() const noexcept;
+
 		//! Deallocate used resources
 		void Destroy() noexcept;
 
 	private:
-		std::shared_ptr<wr::ModelPool> m_model_pool;		//! Wisp object for model loading
+		//! Bookkeeping of a single model
+		struct ModelRecord
+		{
+			ModelAllocation m_allocation;			//! Location of the model data in the pool pages
+		};
+
+		//! Model that was deleted or moved to another page, frames in flight may still draw it
+		struct RetiredModel
+		{
+			wr::Model* m_model;						//! Model in its old page
+			ModelAllocation m_allocation;			//! Kept in use until the model is destroyed
+			wr::ReadbackFence m_fence;				//! Signal at the end of the last frame that may draw the model
+		};
+
+		//! Find or add a page that can hold the model data
+		ModelAllocation AllocateModel( std::size_t vertex_size, std::size_t index_size, std::optional<std::size_t> excluded_page );
+
+		//! Create a new page with a Wisp model pool of the given size
+		/*! /return Index of the new page. */
+		std::size_t AddPage( std::size_t vertex_capacity, std::size_t index_capacity );
+
+		//! Renderer of the viewport override, owns the render system and the frame graphs
+		Renderer& GetRenderer() const;
+
+		//! Move a model into a new allocation in another page
+		/*! /return The model in its new page. */
+		wr::Model* RelocateModel( wr::Model* model, const ModelAllocation& allocation, const wr::MeshData<wr::Vertex>& data );
+
+		//! Destroy a model once the frames that have been submitted so far are finished
+		void RetireModel( wr::Model* model, const ModelAllocation& allocation );
+
+		//! Destroy the retired models the GPU is done with, and free their allocations
+		void DestroyRetiredModels();
+
+		std::vector<std::shared_ptr<wr::ModelPool>> m_model_pools;			//! Wisp object for model loading, one per page
+		ModelPoolAllocator m_allocator;										//! Tracks the usage of every page
+		std::unordered_map<wr::Model*, ModelRecord> m_model_records;		//! Bookkeeping of every loaded model
+		std::vector<RetiredModel> m_retired_models;							//! Models that are destroyed once the GPU is done with them
+
+		std::function<void( wr::Model*, wr::Model* )> m_model_relocated_callback;
+		std::function<bool( wr::Model*, wr::MeshData<wr::Vertex>& )> m_model_data_callback;
+
+		bool m_models_changed;				//! Set when a model was added, updated, or deleted since the last update
+		std::size_t m_relocation_count;		//! Number of models moved to another page
 	};
 
 }
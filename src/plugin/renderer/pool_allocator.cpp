@@ -0,0 +1,370 @@
+// Copyright 2019 Breda University of Applied Sciences and Team Wisp (Viktor Zoutman, Emilio Laiso, Jens Hagen, Meine Zeinstra, Tahar Meijs, Koen Buitenhuis, Niels Brunekreef, Darius Bouma, Florian Schut)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "pool_allocator.hpp"
+
+// C++ standard
+#include <algorithm>
+#include <cassert>
+
+namespace wmr
+{
+	PoolAllocator::PoolAllocator(std::size_t alignment)
+		: m_alignment(std::max<std::size_t>(alignment, 1))
+	{
+	}
+
+	std::size_t PoolAllocator::AddPage(std::size_t capacity)
+	{
+		// Reuse the slot of a released page if there is one
+		auto slot = std::find_if(m_pages.begin(), m_pages.end(), [](const Page& page) { return !page.m_active; });
+		if (slot == m_pages.end())
+		{
+			slot = m_pages.insert(m_pages.end(), Page());
+		}
+
+		slot->m_active = true;
+		slot->m_capacity = capacity;
+		slot->m_used = 0;
+
+		if (capacity > 0)
+		{
+			InsertFreeBlock(*slot, 0, capacity);
+		}
+
+		return static_cast<std::size_t>(slot - m_pages.begin());
+	}
+
+	void PoolAllocator::ReleasePage(std::size_t page)
+	{
+		assert(m_pages[page].m_used == 0);
+
+		m_pages[page] = Page();
+	}
+
+	std::optional<PoolAllocation> PoolAllocator::Allocate(std::size_t page, std::size_t size)
+	{
+		if (page >= m_pages.size() || !m_pages[page].m_active)
+		{
+			return std::nullopt;
+		}
+
+		auto& target = m_pages[page];
+		size = Align(size);
+
+		// Smallest free block that is large enough
+		auto best_fit = target.m_free_by_size.lower_bound(size);
+		if (best_fit == target.m_free_by_size.end())
+		{
+			return std::nullopt;
+		}
+
+		const auto block_size = best_fit->first;
+		const auto block_offset = best_fit->second;
+
+		EraseFreeBlock(target, block_offset, block_size);
+
+		// Return the remainder of the block to the free list
+		if (block_size > size)
+		{
+			InsertFreeBlock(target, block_offset + size, block_size - size);
+		}
+
+		target.m_used += size;
+
+		PoolAllocation allocation;
+		allocation.m_page = page;
+		allocation.m_offset = block_offset;
+		allocation.m_size = size;
+
+		return allocation;
+	}
+
+	void PoolAllocator::Free(const PoolAllocation& allocation)
+	{
+		auto& page = m_pages[allocation.m_page];
+
+		assert(page.m_active && page.m_used >= allocation.m_size);
+		page.m_used -= allocation.m_size;
+
+		auto offset = allocation.m_offset;
+		auto size = allocation.m_size;
+
+		// Merge with the free block after this one
+		auto next = page.m_free_by_offset.lower_bound(offset);
+		if (next != page.m_free_by_offset.end() && next->first == offset + size)
+		{
+			auto next_size = next->second;
+			EraseFreeBlock(page, next->first, next_size);
+			size += next_size;
+		}
+
+		// Merge with the free block before this one
+		auto previous = page.m_free_by_offset.lower_bound(offset);
+		if (previous != page.m_free_by_offset.begin())
+		{
+			--previous;
+			if (previous->first + previous->second == offset)
+			{
+				auto previous_offset = previous->first;
+				auto previous_size = previous->second;
+				EraseFreeBlock(page, previous_offset, previous_size);
+				offset = previous_offset;
+				size += previous_size;
+			}
+		}
+
+		InsertFreeBlock(page, offset, size);
+	}
+
+	std::optional<std::size_t> PoolAllocator::GetBestFitWaste(std::size_t page, std::size_t size) const
+	{
+		if (page >= m_pages.size() || !m_pages[page].m_active)
+		{
+			return std::nullopt;
+		}
+
+		size = Align(size);
+
+		auto best_fit = m_pages[page].m_free_by_size.lower_bound(size);
+		if (best_fit == m_pages[page].m_free_by_size.end())
+		{
+			return std::nullopt;
+		}
+
+		return best_fit->first - size;
+	}
+
+	std::size_t PoolAllocator::GetPageSlotCount() const noexcept
+	{
+		return m_pages.size();
+	}
+
+	bool PoolAllocator::IsPageActive(std::size_t page) const noexcept
+	{
+		return (page < m_pages.size() && m_pages[page].m_active);
+	}
+
+	std::size_t PoolAllocator::GetPageCapacity(std::size_t page) const noexcept
+	{
+		return m_pages[page].m_capacity;
+	}
+
+	std::size_t PoolAllocator::GetPageUsedSize(std::size_t page) const noexcept
+	{
+		return m_pages[page].m_used;
+	}
+
+	std::size_t PoolAllocator::GetPageLargestFreeBlock(std::size_t page) const noexcept
+	{
+		const auto& free_by_size = m_pages[page].m_free_by_size;
+		return free_by_size.empty() ? 0 : free_by_size.rbegin()->first;
+	}
+
+	std::size_t PoolAllocator::Align(std::size_t size) const noexcept
+	{
+		// Empty allocations still take up one unit, so every allocation has a unique offset
+		size = std::max<std::size_t>(size, 1);
+		return ((size + m_alignment - 1) / m_alignment) * m_alignment;
+	}
+
+	PoolStatistics PoolAllocator::GetStatistics() const noexcept
+	{
+		PoolStatistics statistics;
+		std::size_t largest_free_blocks = 0;
+
+		for (std::size_t page = 0; page < m_pages.size(); ++page)
+		{
+			if (!m_pages[page].m_active)
+			{
+				continue;
+			}
+
+			const auto largest_free_block = GetPageLargestFreeBlock(page);
+
+			++statistics.m_page_count;
+			statistics.m_capacity += m_pages[page].m_capacity;
+			statistics.m_used += m_pages[page].m_used;
+			statistics.m_largest_free_block = std::max(statistics.m_largest_free_block, largest_free_block);
+			largest_free_blocks += largest_free_block;
+		}
+
+		const auto free_size = statistics.m_capacity - statistics.m_used;
+
+		if (statistics.m_capacity > 0)
+		{
+			statistics.m_occupancy = static_cast<float>(statistics.m_used) / statistics.m_capacity;
+		}
+
+		if (free_size > 0)
+		{
+			statistics.m_fragmentation = 1.0f - static_cast<float>(largest_free_blocks) / free_size;
+		}
+
+		return statistics;
+	}
+
+	void PoolAllocator::InsertFreeBlock(Page& page, std::size_t offset, std::size_t size)
+	{
+		page.m_free_by_offset.emplace(offset, size);
+		page.m_free_by_size.emplace(size, offset);
+	}
+
+	void PoolAllocator::EraseFreeBlock(Page& page, std::size_t offset, std::size_t size)
+	{
+		page.m_free_by_offset.erase(offset);
+
+		auto range = page.m_free_by_size.equal_range(size);
+		for (auto it = range.first; it != range.second; ++it)
+		{
+			if (it->second == offset)
+			{
+				page.m_free_by_size.erase(it);
+				break;
+			}
+		}
+	}
+
+	ModelPoolAllocator::ModelPoolAllocator(std::size_t alignment)
+		: m_vertex_allocator(alignment)
+		, m_index_allocator(alignment)
+	{
+	}
+
+	std::size_t ModelPoolAllocator::AddPage(std::size_t vertex_capacity, std::size_t index_capacity)
+	{
+		// Both allocators release and reuse slots in the same order, so their page indices always match
+		auto page = m_vertex_allocator.AddPage(vertex_capacity);
+		auto index_page = m_index_allocator.AddPage(index_capacity);
+		assert(page == index_page);
+		(void)index_page;
+
+		return page;
+	}
+
+	void ModelPoolAllocator::ReleasePage(std::size_t page)
+	{
+		m_vertex_allocator.ReleasePage(page);
+		m_index_allocator.ReleasePage(page);
+	}
+
+	std::optional<ModelAllocation> ModelPoolAllocator::Allocate(std::size_t vertex_size, std::size_t index_size, std::optional<std::size_t> excluded_page)
+	{
+		// Pick the page that leaves the least amount of space behind in its best fitting blocks
+		std::optional<std::size_t> best_page;
+		std::size_t best_waste = 0;
+
+		for (std::size_t page = 0; page < m_vertex_allocator.GetPageSlotCount(); ++page)
+		{
+			if (page == excluded_page)
+			{
+				continue;
+			}
+
+			auto vertex_waste = m_vertex_allocator.GetBestFitWaste(page, vertex_size);
+			auto index_waste = m_index_allocator.GetBestFitWaste(page, index_size);
+
+			if (!vertex_waste || !index_waste)
+			{
+				continue;
+			}
+
+			auto waste = *vertex_waste + *index_waste;
+			if (!best_page || waste < best_waste)
+			{
+				best_page = page;
+				best_waste = waste;
+			}
+		}
+
+		if (!best_page)
+		{
+			return std::nullopt;
+		}
+
+		return AllocateInPage(*best_page, vertex_size, index_size);
+	}
+
+	std::optional<ModelAllocation> ModelPoolAllocator::AllocateInPage(std::size_t page, std::size_t vertex_size, std::size_t index_size)
+	{
+		if (!m_vertex_allocator.GetBestFitWaste(page, vertex_size) || !m_index_allocator.GetBestFitWaste(page, index_size))
+		{
+			return std::nullopt;
+		}
+
+		ModelAllocation allocation;
+		allocation.m_vertices = *m_vertex_allocator.Allocate(page, vertex_size);
+		allocation.m_indices = *m_index_allocator.Allocate(page, index_size);
+
+		return allocation;
+	}
+
+	void ModelPoolAllocator::Free(const ModelAllocation& allocation)
+	{
+		m_vertex_allocator.Free(allocation.m_vertices);
+		m_index_allocator.Free(allocation.m_indices);
+	}
+
+	std::optional<std::size_t> ModelPoolAllocator::FindSparsePage(float max_occupancy) const noexcept
+	{
+		std::optional<std::size_t> sparse_page;
+		float sparse_occupancy = max_occupancy;
+		std::size_t active_page_count = 0;
+
+		for (std::size_t page = 0; page < m_vertex_allocator.GetPageSlotCount(); ++page)
+		{
+			if (!m_vertex_allocator.IsPageActive(page))
+			{
+				continue;
+			}
+
+			++active_page_count;
+
+			auto occupancy = [page](const PoolAllocator& allocator) -> float
+			{
+				auto capacity = allocator.GetPageCapacity(page);
+				return capacity > 0 ? static_cast<float>(allocator.GetPageUsedSize(page)) / capacity : 0.0f;
+			};
+
+			auto page_occupancy = std::max(occupancy(m_vertex_allocator), occupancy(m_index_allocator));
+			if (page_occupancy < sparse_occupancy)
+			{
+				sparse_page = page;
+				sparse_occupancy = page_occupancy;
+			}
+		}
+
+		if (active_page_count < 2)
+		{
+			return std::nullopt;
+		}
+
+		return sparse_page;
+	}
+
+	bool ModelPoolAllocator::IsPageEmpty(std::size_t page) const noexcept
+	{
+		return (m_vertex_allocator.GetPageUsedSize(page) == 0 && m_index_allocator.GetPageUsedSize(page) == 0);
+	}
+
+	PoolStatistics ModelPoolAllocator::GetVertexStatistics() const noexcept
+	{
+		return m_vertex_allocator.GetStatistics();
+	}
+
+	PoolStatistics ModelPoolAllocator::GetIndexStatistics() const noexcept
+	{
+		return m_index_allocator.GetStatistics();
+	}
+}
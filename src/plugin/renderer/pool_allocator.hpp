@@ -0,0 +1,178 @@
+// Copyright 2019 Breda University of Applied Sciences and Team Wisp (Viktor Zoutman, Emilio Laiso, Jens Hagen, Meine Zeinstra, Tahar Meijs, Koen Buitenhuis, Niels Brunekreef, Darius Bouma, Florian Schut)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+// C++ standard
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <vector>
+
+//! Generic plug-in namespace (Wisp Maya Renderer)
+namespace wmr
+{
+	//! Block of memory handed out by the pool allocator
+	struct PoolAllocation
+	{
+		std::size_t m_page = 0;		//!< Page the block lives in
+		std::size_t m_offset = 0;	//!< Offset of the block in bytes, relative to the start of the page
+		std::size_t m_size = 0;		//!< Size of the block in bytes (aligned)
+	};
+
+	//! Usage counters of a pool allocator
+	struct PoolStatistics
+	{
+		std::size_t m_page_count = 0;			//!< Number of active pages
+		std::size_t m_capacity = 0;				//!< Total size of all active pages in bytes
+		std::size_t m_used = 0;					//!< Number of allocated bytes
+		std::size_t m_largest_free_block = 0;	//!< Largest block that can be allocated without adding a page
+		float m_occupancy = 0.0f;				//!< Used bytes divided by the capacity
+		float m_fragmentation = 0.0f;			//!< Share of the free bytes that is not part of the largest free block of its page
+	};
+
+	//! Best-fit free-list allocator that manages a set of pages
+	/*! The allocator does not own any memory, it only keeps track of which ranges of each page are in use. Free blocks
+	 *  are kept sorted by offset (to merge neighbours when a block is freed) and by size (to find the best fit).
+	 *  Pages can be added at any time. Released pages leave an empty slot behind, which is reused by the next page, so
+	 *  page indices of existing allocations never change. */
+	class PoolAllocator
+	{
+	public:
+		//! \param alignment Every allocation size is rounded up to a multiple of this value.
+		explicit PoolAllocator(std::size_t alignment = 1);
+		~PoolAllocator() = default;
+
+		//! Add a page to the allocator
+		/*! \param capacity Size of the page in bytes.
+		 *  \return Index of the new page. */
+		std::size_t AddPage(std::size_t capacity);
+
+		//! Remove an empty page from the allocator
+		void ReleasePage(std::size_t page);
+
+		//! Allocate a block in a specific page
+		/*! The smallest free block that can hold the requested size is used.
+		 *  \return The allocation, or nothing when the page does not have a large enough free block. */
+		std::optional<PoolAllocation> Allocate(std::size_t page, std::size_t size);
+
+		//! Return a block to its page
+		void Free(const PoolAllocation& allocation);
+
+		//! Number of bytes that would be left over in the best fitting free block of a page
+		/*! \return Nothing when the page cannot hold the requested size. */
+		std::optional<std::size_t> GetBestFitWaste(std::size_t page, std::size_t size) const;
+
+		//! Number of page slots, including the slots of released pages
+		std::size_t GetPageSlotCount() const noexcept;
+
+		//! Whether a page slot holds a page that has not been released
+		bool IsPageActive(std::size_t page) const noexcept;
+
+		//! Size of a page in bytes
+		std::size_t GetPageCapacity(std::size_t page) const noexcept;
+
+		//! Number of allocated bytes in a page
+		std::size_t GetPageUsedSize(std::size_t page) const noexcept;
+
+		//! Size of the largest free block in a page
+		std::size_t GetPageLargestFreeBlock(std::size_t page) const noexcept;
+
+		//! Round a size up to the alignment of this allocator
+		std::size_t Align(std::size_t size) const noexcept;
+
+		//! Usage counters over all active pages
+		PoolStatistics GetStatistics() const noexcept;
+
+	private:
+		struct Page
+		{
+			bool m_active = false;
+			std::size_t m_capacity = 0;
+			std::size_t m_used = 0;
+
+			std::map<std::size_t, std::size_t> m_free_by_offset;		//!< Offset to size of every free block
+			std::multimap<std::size_t, std::size_t> m_free_by_size;		//!< Size to offset of every free block
+		};
+
+		//! Add a free block to both lookup tables
+		static void InsertFreeBlock(Page& page, std::size_t offset, std::size_t size);
+
+		//! Remove a free block from both lookup tables
+		static void EraseFreeBlock(Page& page, std::size_t offset, std::size_t size);
+
+		std::vector<Page> m_pages;
+		std::size_t m_alignment;
+	};
+
+	//! Vertex and index allocation of a single model
+	struct ModelAllocation
+	{
+		PoolAllocation m_vertices;	//!< Vertex data of the model
+		PoolAllocation m_indices;	//!< Index data of the model (always in the same page as the vertex data)
+	};
+
+	//! Keeps track of the vertex and index data of the pages of a growable model pool
+	/*! Every page is backed by a model pool of the Wisp rendering framework, with separate vertex and index buffers.
+	 *  A model always has its vertex and index data in the same page.
+	 *
+	 *  The Wisp model pools place the data themselves and do not expose their free lists, so this is a shadow copy of
+	 *  the allocations: it decides which page a model goes to, but the offsets, the fragmentation, and the best-fit
+	 *  waste are estimates of what the Wisp allocator does. The used byte counts match the requested sizes. */
+	class ModelPoolAllocator
+	{
+	public:
+		//! \param alignment Alignment of every vertex and index allocation.
+		explicit ModelPoolAllocator(std::size_t alignment = 1);
+		~ModelPoolAllocator() = default;
+
+		//! Add a page to the allocator
+		/*! \return Index of the new page. */
+		std::size_t AddPage(std::size_t vertex_capacity, std::size_t index_capacity);
+
+		//! Remove an empty page from the allocator
+		void ReleasePage(std::size_t page);
+
+		//! Allocate the data of a model in the page that fits it best
+		/*! \param excluded_page Page that should not be used (used to move models out of a page).
+		 *  \return The allocation, or nothing when no page can hold the model (add a page and try again). */
+		std::optional<ModelAllocation> Allocate(std::size_t vertex_size, std::size_t index_size, std::optional<std::size_t> excluded_page = std::nullopt);
+
+		//! Allocate the data of a model in a specific page
+		/*! \return The allocation, or nothing when the page cannot hold the model. */
+		std::optional<ModelAllocation> AllocateInPage(std::size_t page, std::size_t vertex_size, std::size_t index_size);
+
+		//! Free the data of a model
+		void Free(const ModelAllocation& allocation);
+
+		//! Find the active page with the lowest occupancy, when it is below the threshold
+		/*! Pages are only considered when there is more than one active page, as the last page is never compacted.
+		 *  The occupancy of a page is the highest of its vertex and index occupancy. */
+		std::optional<std::size_t> FindSparsePage(float max_occupancy) const noexcept;
+
+		//! Whether a page has no allocations left
+		bool IsPageEmpty(std::size_t page) const noexcept;
+
+		//! Usage counters of the vertex data
+		PoolStatistics GetVertexStatistics() const noexcept;
+
+		//! Usage counters of the index data
+		PoolStatistics GetIndexStatistics() const noexcept;
+
+	private:
+		PoolAllocator m_vertex_allocator;
+		PoolAllocator m_index_allocator;
+	};
+}
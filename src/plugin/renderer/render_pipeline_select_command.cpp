@@ -20,9 +20,13 @@
 // Wisp plug-in
 #include "miscellaneous/maya_popup.hpp"
 #include "miscellaneous/render_settings.hpp"
+#include "miscellaneous/settings.hpp"
+#include "miscellaneous/trace_recorder.hpp"
 #include "plugin/framegraph/frame_graph_manager.hpp"
+#include "plugin/parsers/scene_graph_parser.hpp"
 #include "plugin/viewport_renderer_override.hpp"
 #include "plugin/renderer/renderer.hpp"
+#include "plugin/renderer/texture_manager.hpp"
 #include "render_pipeline_select_command.hpp"
 
 // Maya API
@@ -56,25 +60,179 @@ MStatus wmr::RenderPipelineSelectCommand::doIt(const MArgList& args)
 	// Camera so we can set depth of field data
 	auto camera = renderer.GetScenegraph().GetActiveCamera();
 
-	// Bloom settings for all frame graphs
-	auto bloom_settings_deferred = GetRenderSettings<wr::BloomSettings>(frame_graph.GetSpecifiedFramegraph(RendererFrameGraphType::DEFERRED));
-	auto bloom_settings_hybrid = GetRenderSettings<wr::BloomSettings>(frame_graph.GetSpecifiedFramegraph(RendererFrameGraphType::HYBRID_RAY_TRACING));
+	// Render settings are stored per pipeline, so they reach pipelines that have not been created yet and tasks that
+	// are pruned right now once the frame graphs are (re)built
+	auto& deferred_settings = frame_graph.GetPipelineRenderSettings(RendererFrameGraphType::DEFERRED);
+	auto& hybrid_settings = frame_graph.GetPipelineRenderSettings(RendererFrameGraphType::HYBRID_RAY_TRACING);
 
-	// NVIDIA HBAO settings
-	auto hbao_settings = GetRenderSettings<wr::HBAOSettings>(frame_graph.GetSpecifiedFramegraph(RendererFrameGraphType::DEFERRED));
-
-	// RTX AO settings
-	auto rtao_settings = GetRenderSettings<wr::RTAOSettings>(frame_graph.GetSpecifiedFramegraph(RendererFrameGraphType::HYBRID_RAY_TRACING));
+	// Settings of a task the pipeline description does not have cannot be applied
+	auto task_settings = [&frame_graph](RendererFrameGraphType type, const char* task_name, auto& settings) -> decltype(&*settings)
+	{
+		if (!frame_graph.PipelineHasTask(type, task_name))
+		{
+			LOGE("The rendering pipeline does not have a \"{}\" task, its settings cannot be changed.", task_name);
+			return nullptr;
+		}
 
-	// Acceleration structure settings
-	auto as_build_settings = GetRenderSettings<wr::ASBuildSettings>(frame_graph.GetSpecifiedFramegraph(RendererFrameGraphType::HYBRID_RAY_TRACING));
+		// Wisp defaults, the task has not been part of a frame graph yet
+		if (!settings.has_value())
+		{
+			settings.emplace();
+		}
 
-	// RT shadow settings
-	auto rt_shadow_settings = GetRenderSettings<wr::RTShadowSettings>(frame_graph.GetSpecifiedFramegraph(RendererFrameGraphType::HYBRID_RAY_TRACING));
-	auto rt_shadow_denoiser_settings = GetRenderSettings<wr::ShadowDenoiserSettings>(frame_graph.GetSpecifiedFramegraph(RendererFrameGraphType::HYBRID_RAY_TRACING));
+		return &settings.value();
+	};
+
+	// Every flag except the statistics queries changes a setting, which has to show up in the next frame
+	if (!arg_data.isFlagSet(TRANSFORM_UPDATE_STATISTICS_SHORT_FLAG) &&
+		!arg_data.isFlagSet(RENDER_ON_DEMAND_STATISTICS_SHORT_FLAG) &&
+		!arg_data.isFlagSet(TIMING_STATISTICS_SHORT_FLAG) &&
+		!arg_data.isFlagSet(TRACE_SHORT_FLAG) &&
+		!arg_data.isFlagSet(TEXTURE_LOADING_STATISTICS_SHORT_FLAG) &&
+		!arg_data.isFlagSet(TEXTURE_CACHE_STATISTICS_SHORT_FLAG) &&
+		!arg_data.isFlagSet(TEXTURE_MEMORY_STATISTICS_SHORT_FLAG) &&
+		!arg_data.isFlagSet(PROGRESSIVE_ACCUMULATION_STATE_SHORT_FLAG) &&
+		!arg_data.isFlagSet(DYNAMIC_RESOLUTION_STATE_SHORT_FLAG))
+	{
+		renderer.MarkSceneChanged();
+	}
 
 	//#TODO: Refactor this, it is a real mess...
-	if (arg_data.isFlagSet(PIPELINE_SHORT_FLAG))
+	if (arg_data.isFlagSet(TRANSFORM_UPDATE_STATISTICS_SHORT_FLAG))
+	{
+		// Returns { transform messages received, transform updates applied }
+		auto statistics = viewport_override->GetSceneGraphParser().GetTransformUpdateStatistics();
+		appendToResult(static_cast<int>(statistics.m_messages_received));
+		appendToResult(static_cast<int>(statistics.m_updates_applied));
+
+		return MStatus::kSuccess;
+	}
+	else if (arg_data.isFlagSet(RENDER_ON_DEMAND_STATISTICS_SHORT_FLAG))
+	{
+		// Returns { frames rendered, frames skipped }
+		auto statistics = renderer.GetRenderOnDemandStatistics();
+		appendToResult(static_cast<int>(statistics.m_frames_rendered));
+		appendToResult(static_cast<int>(statistics.m_frames_skipped));
+
+		return MStatus::kSuccess;
+	}
+	else if (arg_data.isFlagSet(TIMING_STATISTICS_SHORT_FLAG))
+	{
+		// Returns { timer name, min (ms), average (ms), 95th percentile (ms) } for every timer, as strings
+		for (const auto& [name, statistics] : renderer.GetProfiler().GetStatistics())
+		{
+			appendToResult(MString(name.c_str()));
+			appendToResult(MString() + statistics.m_min);
+			appendToResult(MString() + statistics.m_average);
+			appendToResult(MString() + statistics.m_p95);
+		}
+
+		return MStatus::kSuccess;
+	}
+	else if (arg_data.isFlagSet(TEXTURE_LOADING_STATISTICS_SHORT_FLAG))
+	{
+		// Returns { queue depth, loaded, failed, cancelled, latency min (ms), latency average (ms), latency 95th percentile (ms) }
+		auto statistics = renderer.GetTextureManager().GetTextureLoaderStatistics();
+		appendToResult(static_cast<int>(statistics.m_queue_depth));
+		appendToResult(static_cast<int>(statistics.m_loaded));
+		appendToResult(static_cast<int>(statistics.m_failed));
+		appendToResult(static_cast<int>(statistics.m_cancelled));
+		appendToResult(statistics.m_latency.m_min);
+		appendToResult(statistics.m_latency.m_average);
+		appendToResult(statistics.m_latency.m_p95);
+
+		return MStatus::kSuccess;
+	}
+	else if (arg_data.isFlagSet(TEXTURE_CACHE_STATISTICS_SHORT_FLAG))
+	{
+		// Returns { hits, misses, builds pending, builds completed, builds failed }
+		auto statistics = renderer.GetTextureManager().GetTextureCacheStatistics();
+		appendToResult(static_cast<int>(statistics.m_hits));
+		appendToResult(static_cast<int>(statistics.m_misses));
+		appendToResult(static_cast<int>(statistics.m_builds_pending));
+		appendToResult(static_cast<int>(statistics.m_builds_completed));
+		appendToResult(static_cast<int>(statistics.m_builds_failed));
+
+		return MStatus::kSuccess;
+	}
+	else if (arg_data.isFlagSet(TEXTURE_MEMORY_STATISTICS_SHORT_FLAG))
+	{
+		// Returns { budget (MB), used (MB), textures, reduced textures, evicted mips, evicted (MB), restorations }
+		auto statistics = renderer.GetTextureManager().GetTextureResidencyStatistics();
+		appendToResult(static_cast<double>(statistics.m_budget) / (1024.0 * 1024.0));
+		appendToResult(static_cast<double>(statistics.m_used) / (1024.0 * 1024.0));
+		appendToResult(static_cast<int>(statistics.m_texture_count));
+		appendToResult(static_cast<int>(statistics.m_reduced_texture_count));
+		appendToResult(static_cast<int>(statistics.m_evicted_mips));
+		appendToResult(static_cast<double>(statistics.m_evicted_bytes) / (1024.0 * 1024.0));
+		appendToResult(static_cast<int>(statistics.m_restorations));
+
+		return MStatus::kSuccess;
+	}
+	else if (arg_data.isFlagSet(TRACE_SHORT_FLAG))
+	{
+		auto& trace_recorder = TraceRecorder::GetInstance();
+
+		if (arg_data.flagArgumentBool(TRACE_SHORT_FLAG, 0))
+		{
+			trace_recorder.Start();
+			LOG("Started recording a trace.");
+			return MStatus::kSuccess;
+		}
+
+		if (!trace_recorder.IsRecording())
+		{
+			return MStatus::kSuccess;
+		}
+
+		trace_recorder.Stop();
+
+		// Returns the path of the trace file
+		if (!trace_recorder.WriteJSONFile(settings::TRACE_FILE_PATH))
+		{
+			LOGE("Failed to write the trace to \"{}\".", settings::TRACE_FILE_PATH);
+			return MStatus::kFailure;
+		}
+
+		LOG("Wrote a trace of {} events to \"{}\" ({} events dropped).", trace_recorder.GetEventCount(), settings::TRACE_FILE_PATH, trace_recorder.GetDroppedEventCount());
+		appendToResult(settings::TRACE_FILE_PATH);
+
+		return MStatus::kSuccess;
+	}
+	else if (arg_data.isFlagSet(TIMING_HUD_SHORT_FLAG))
+	{
+		renderer.SetTimingHUD(arg_data.flagArgumentBool(TIMING_HUD_SHORT_FLAG, 0));
+		return MStatus::kSuccess;
+	}
+	else if (arg_data.isFlagSet(GPU_TASK_TIMING_SHORT_FLAG))
+	{
+		// The frame graphs are rebuilt with or without the timestamp tasks the next time they are used
+		frame_graph.SetGPUTaskTiming(arg_data.flagArgumentBool(GPU_TASK_TIMING_SHORT_FLAG, 0));
+		return MStatus::kSuccess;
+	}
+	else if (arg_data.isFlagSet(PROGRESSIVE_ACCUMULATION_STATE_SHORT_FLAG))
+	{
+		// Returns { accumulated samples per pixel, target samples per pixel, converged }
+		auto state = renderer.GetProgressiveAccumulationState();
+		appendToResult(static_cast<int>(state.m_sample_count));
+		appendToResult(static_cast<int>(state.m_target_sample_count));
+		appendToResult(state.m_converged);
+
+		return MStatus::kSuccess;
+	}
+	else if (arg_data.isFlagSet(DYNAMIC_RESOLUTION_STATE_SHORT_FLAG))
+	{
+		// Returns { enabled, render scale, GPU frame time budget (ms), average GPU frame time (ms), resolution changes }
+		auto state = renderer.GetDynamicResolutionState();
+		appendToResult(state.m_enabled);
+		appendToResult(state.m_scale);
+		appendToResult(state.m_frame_time_budget);
+		appendToResult(state.m_average_frame_time);
+		appendToResult(static_cast<int>(state.m_scale_changes));
+
+		return MStatus::kSuccess;
+	}
+	else if (arg_data.isFlagSet(PIPELINE_SHORT_FLAG))
 	{
 		auto param_0 = arg_data.flagArgumentInt(PIPELINE_SHORT_FLAG, 0);
 
@@ -105,6 +263,39 @@ MStatus wmr::RenderPipelineSelectCommand::doIt(const MArgList& args)
 			return MStatus::kSuccess;
 		}
 	}
+	else if (arg_data.isFlagSet(LOW_END_PIPELINE_SHORT_FLAG))
+	{
+		// The deferred frame graph is rebuilt from the other description the next time it is used
+		frame_graph.SetLowEndDeferredPipeline(arg_data.flagArgumentBool(LOW_END_PIPELINE_SHORT_FLAG, 0));
+		return MStatus::kSuccess;
+	}
+	else if (arg_data.isFlagSet(FRAMES_IN_FLIGHT_SHORT_FLAG))
+	{
+		renderer.SetMaxFramesInFlight(arg_data.flagArgumentInt(FRAMES_IN_FLIGHT_SHORT_FLAG, 0));
+		return MStatus::kSuccess;
+	}
+	else if (arg_data.isFlagSet(TEXTURE_MEMORY_BUDGET_SHORT_FLAG))
+	{
+		// Budget in MB
+		const auto budget_mb = static_cast<std::uint64_t>(arg_data.flagArgumentInt(TEXTURE_MEMORY_BUDGET_SHORT_FLAG, 0));
+		renderer.GetTextureManager().SetTextureMemoryBudget(budget_mb * 1024 * 1024);
+		return MStatus::kSuccess;
+	}
+	else if (arg_data.isFlagSet(PROGRESSIVE_ACCUMULATION_SHORT_FLAG))
+	{
+		renderer.SetProgressiveAccumulation(arg_data.flagArgumentBool(PROGRESSIVE_ACCUMULATION_SHORT_FLAG, 0));
+		return MStatus::kSuccess;
+	}
+	else if (arg_data.isFlagSet(DYNAMIC_RESOLUTION_SHORT_FLAG))
+	{
+		renderer.SetDynamicResolution(arg_data.flagArgumentBool(DYNAMIC_RESOLUTION_SHORT_FLAG, 0));
+		return MStatus::kSuccess;
+	}
+	else if (arg_data.isFlagSet(DYNAMIC_RESOLUTION_BUDGET_SHORT_FLAG))
+	{
+		renderer.SetGPUFrameTimeBudget(arg_data.flagArgumentDouble(DYNAMIC_RESOLUTION_BUDGET_SHORT_FLAG, 0));
+		return MStatus::kSuccess;
+	}
 	else if (arg_data.isFlagSet(SKYBOX_SHORT_FLAG))
 	{
 		auto param_0 = arg_data.flagArgumentString(SKYBOX_SHORT_FLAG, 0);
@@ -131,118 +322,207 @@ MStatus wmr::RenderPipelineSelectCommand::doIt(const MArgList& args)
 	}
 	else if (arg_data.isFlagSet(BLOOM_ENABLE_SHORT_FLAG))
 	{
-		bool state = arg_data.flagArgumentBool(BLOOM_ENABLE_SHORT_FLAG, 0);
-		bloom_settings_deferred->m_runtime.m_enable_bloom = state;
-		bloom_settings_hybrid->m_runtime.m_enable_bloom = state;
+		// Disabling the bloom prunes its tasks from the frame graphs, so it does not cost any GPU time or memory
+		frame_graph.SetTaskChainEnabled(BLOOM_TASK_CHAIN, arg_data.flagArgumentBool(BLOOM_ENABLE_SHORT_FLAG, 0));
+	}
+	else if (arg_data.isFlagSet(DOF_ENABLE_SHORT_FLAG))
+	{
+		frame_graph.SetTaskChainEnabled(DOF_TASK_CHAIN, arg_data.flagArgumentBool(DOF_ENABLE_SHORT_FLAG, 0));
+	}
+	else if (arg_data.isFlagSet(HBAO_ENABLE_SHORT_FLAG))
+	{
+		frame_graph.SetTaskChainEnabled(HBAO_TASK_CHAIN, arg_data.flagArgumentBool(HBAO_ENABLE_SHORT_FLAG, 0));
 	}
 	else if (arg_data.isFlagSet(HBAO_METERS_TO_UNITS_SHORT_FLAG))
 	{
+		auto* hbao_settings = task_settings(RendererFrameGraphType::DEFERRED, "hbao", deferred_settings.m_hbao);
+
+		if (!hbao_settings)
+		{
+			return MStatus::kFailure;
+		}
+
 		hbao_settings->m_runtime.m_meters_to_view_space_units = arg_data.flagArgumentDouble(HBAO_METERS_TO_UNITS_SHORT_FLAG, 0);
 	}
 	else if (arg_data.isFlagSet(HBAO_RADIUS_SHORT_FLAG))
 	{
+		auto* hbao_settings = task_settings(RendererFrameGraphType::DEFERRED, "hbao", deferred_settings.m_hbao);
+
+		if (!hbao_settings)
+		{
+			return MStatus::kFailure;
+		}
+
 		hbao_settings->m_runtime.m_radius = arg_data.flagArgumentDouble(HBAO_RADIUS_SHORT_FLAG, 0);
 	}
 	else if (arg_data.isFlagSet(HBAO_BIAS_SHORT_FLAG))
 	{
+		auto* hbao_settings = task_settings(RendererFrameGraphType::DEFERRED, "hbao", deferred_settings.m_hbao);
+
+		if (!hbao_settings)
+		{
+			return MStatus::kFailure;
+		}
+
 		hbao_settings->m_runtime.m_bias = arg_data.flagArgumentDouble(HBAO_BIAS_SHORT_FLAG, 0);
 	}
 	else if (arg_data.isFlagSet(HBAO_POWER_SHORT_FLAG))
 	{
+		auto* hbao_settings = task_settings(RendererFrameGraphType::DEFERRED, "hbao", deferred_settings.m_hbao);
+
+		if (!hbao_settings)
+		{
+			return MStatus::kFailure;
+		}
+
 		hbao_settings->m_runtime.m_power_exp = arg_data.flagArgumentDouble(HBAO_POWER_SHORT_FLAG, 0);
 	}
 	else if (arg_data.isFlagSet(HBAO_BLUR_SHORT_FLAG))
 	{
+		auto* hbao_settings = task_settings(RendererFrameGraphType::DEFERRED, "hbao", deferred_settings.m_hbao);
+
+		if (!hbao_settings)
+		{
+			return MStatus::kFailure;
+		}
+
 		hbao_settings->m_runtime.m_enable_blur = arg_data.flagArgumentBool(HBAO_BLUR_SHORT_FLAG, 0);
 	}
 	else if (arg_data.isFlagSet(HBAO_BLUR_SHARPNESS_SHORT_FLAG))
 	{
+		auto* hbao_settings = task_settings(RendererFrameGraphType::DEFERRED, "hbao", deferred_settings.m_hbao);
+
+		if (!hbao_settings)
+		{
+			return MStatus::kFailure;
+		}
+
 		hbao_settings->m_runtime.m_blur_sharpness = arg_data.flagArgumentDouble(HBAO_BLUR_SHARPNESS_SHORT_FLAG, 0);
 	}
 	else if (arg_data.isFlagSet(RTAO_BIAS_SHORT_FLAG))
 	{
+		auto* rtao_settings = task_settings(RendererFrameGraphType::HYBRID_RAY_TRACING, "rtao", hybrid_settings.m_rtao);
+
+		if (!rtao_settings)
+		{
+			return MStatus::kFailure;
+		}
+
 		rtao_settings->m_runtime.bias = arg_data.flagArgumentDouble(RTAO_BIAS_SHORT_FLAG, 0);
 	}
 	else if (arg_data.isFlagSet(RTAO_RADIUS_SHORT_FLAG))
 	{
+		auto* rtao_settings = task_settings(RendererFrameGraphType::HYBRID_RAY_TRACING, "rtao", hybrid_settings.m_rtao);
+
+		if (!rtao_settings)
+		{
+			return MStatus::kFailure;
+		}
+
 		rtao_settings->m_runtime.radius = arg_data.flagArgumentDouble(RTAO_RADIUS_SHORT_FLAG, 0);
 	}
 	else if (arg_data.isFlagSet(RTAO_POWER_SHORT_FLAG))
 	{
+		auto* rtao_settings = task_settings(RendererFrameGraphType::HYBRID_RAY_TRACING, "rtao", hybrid_settings.m_rtao);
+
+		if (!rtao_settings)
+		{
+			return MStatus::kFailure;
+		}
+
 		rtao_settings->m_runtime.power = arg_data.flagArgumentDouble(RTAO_POWER_SHORT_FLAG, 0);
 	}
 	else if (arg_data.isFlagSet(RTAO_SAMPLES_PER_PIXEL_SHORT_FLAG))
 	{
+		auto* rtao_settings = task_settings(RendererFrameGraphType::HYBRID_RAY_TRACING, "rtao", hybrid_settings.m_rtao);
+
+		if (!rtao_settings)
+		{
+			return MStatus::kFailure;
+		}
+
 		rtao_settings->m_runtime.sample_count = arg_data.flagArgumentDouble(RTAO_SAMPLES_PER_PIXEL_SHORT_FLAG, 0);
 	}
 	else if (arg_data.isFlagSet(RT_SHADOWS_EPSILON_SHORT_FLAG))
 	{
+		auto* rt_shadow_settings = task_settings(RendererFrameGraphType::HYBRID_RAY_TRACING, "rt_shadow", hybrid_settings.m_rt_shadow);
+
+		if (!rt_shadow_settings)
+		{
+			return MStatus::kFailure;
+		}
+
 		rt_shadow_settings->m_runtime.m_epsilon = arg_data.flagArgumentDouble(RT_SHADOWS_EPSILON_SHORT_FLAG, 0);
 	}
 	else if (arg_data.isFlagSet(RT_SHADOWS_SAMPLES_PER_PIXEL_SHORT_FLAG))
 	{
+		auto* rt_shadow_settings = task_settings(RendererFrameGraphType::HYBRID_RAY_TRACING, "rt_shadow", hybrid_settings.m_rt_shadow);
+
+		if (!rt_shadow_settings)
+		{
+			return MStatus::kFailure;
+		}
+
 		rt_shadow_settings->m_runtime.m_sample_count = arg_data.flagArgumentInt(RT_SHADOWS_SAMPLES_PER_PIXEL_SHORT_FLAG, 0);
 	}
 	else if (arg_data.isFlagSet(RT_SHADOWS_DENOISER_ALPHA_SHORT_FLAG))
 	{
+		auto* rt_shadow_denoiser_settings = task_settings(RendererFrameGraphType::HYBRID_RAY_TRACING, "shadow_denoiser", hybrid_settings.m_shadow_denoiser);
+
+		if (!rt_shadow_denoiser_settings)
+		{
+			return MStatus::kFailure;
+		}
+
 		rt_shadow_denoiser_settings->m_runtime.m_alpha = arg_data.flagArgumentDouble(RT_SHADOWS_DENOISER_ALPHA_SHORT_FLAG, 0);
 	}
 	else if (arg_data.isFlagSet(RT_SHADOWS_DENOISER_MOMENTS_ALPHA_SHORT_FLAG))
 	{
+		auto* rt_shadow_denoiser_settings = task_settings(RendererFrameGraphType::HYBRID_RAY_TRACING, "shadow_denoiser", hybrid_settings.m_shadow_denoiser);
+
+		if (!rt_shadow_denoiser_settings)
+		{
+			return MStatus::kFailure;
+		}
+
 		rt_shadow_denoiser_settings->m_runtime.m_moments_alpha = arg_data.flagArgumentDouble(RT_SHADOWS_DENOISER_MOMENTS_ALPHA_SHORT_FLAG, 0);
 	}
 	else if (arg_data.isFlagSet(RT_SHADOWS_DENOISER_L_PHI_SHORT_FLAG))
 	{
+		auto* rt_shadow_denoiser_settings = task_settings(RendererFrameGraphType::HYBRID_RAY_TRACING, "shadow_denoiser", hybrid_settings.m_shadow_denoiser);
+
+		if (!rt_shadow_denoiser_settings)
+		{
+			return MStatus::kFailure;
+		}
+
 		rt_shadow_denoiser_settings->m_runtime.m_l_phi = arg_data.flagArgumentDouble(RT_SHADOWS_DENOISER_L_PHI_SHORT_FLAG, 0);
 	}
 	else if (arg_data.isFlagSet(RT_SHADOWS_DENOISER_N_PHI_SHORT_FLAG))
 	{
-		rt_shadow_denoiser_settings->m_runtime.m_n_phi = arg_data.flagArgumentDouble(RT_SHADOWS_DENOISER_L_PHI_SHORT_FLAG, 0);
-	}
-	else if (arg_data.isFlagSet(RT_SHADOWS_DENOISER_Z_PHI_SHORT_FLAG))
-	{
-		rt_shadow_denoiser_settings->m_runtime.m_z_phi = arg_data.flagArgumentDouble(RT_SHADOWS_DENOISER_L_PHI_SHORT_FLAG, 0);
-	}
+		auto* rt_shadow_denoiser_settings = task_settings(RendererFrameGraphType::HYBRID_RAY_TRACING, "shadow_denoiser", hybrid_settings.m_shadow_denoiser);
 
-	// Save bloom settings
-	if (bloom_settings_deferred.has_value())
-	{
-		SetRenderSettings<wr::BloomSettings>(frame_graph.GetSpecifiedFramegraph(RendererFrameGraphType::DEFERRED), bloom_settings_deferred.value());
-	}
-	
-	if (bloom_settings_hybrid.has_value())
-	{
-		SetRenderSettings<wr::BloomSettings>(frame_graph.GetSpecifiedFramegraph(RendererFrameGraphType::HYBRID_RAY_TRACING), bloom_settings_hybrid.value());
-	}
+		if (!rt_shadow_denoiser_settings)
+		{
+			return MStatus::kFailure;
+		}
 
-	// Save AO settings
-	if (hbao_settings.has_value())
-	{
-		SetRenderSettings<wr::HBAOSettings>(frame_graph.GetSpecifiedFramegraph(RendererFrameGraphType::DEFERRED), hbao_settings.value());
+		rt_shadow_denoiser_settings->m_runtime.m_n_phi = arg_data.flagArgumentDouble(RT_SHADOWS_DENOISER_N_PHI_SHORT_FLAG, 0);
 	}
-	
-	if (rtao_settings.has_value())
+	else if (arg_data.isFlagSet(RT_SHADOWS_DENOISER_Z_PHI_SHORT_FLAG))
 	{
-		SetRenderSettings<wr::RTAOSettings>(frame_graph.GetSpecifiedFramegraph(RendererFrameGraphType::HYBRID_RAY_TRACING), rtao_settings.value());
-	}
+		auto* rt_shadow_denoiser_settings = task_settings(RendererFrameGraphType::HYBRID_RAY_TRACING, "shadow_denoiser", hybrid_settings.m_shadow_denoiser);
 
-	// Save acceleration structure settings
-	if (as_build_settings.has_value())
-	{
-		SetRenderSettings<wr::ASBuildSettings>(frame_graph.GetSpecifiedFramegraph(RendererFrameGraphType::HYBRID_RAY_TRACING), as_build_settings.value());
-	}
+		if (!rt_shadow_denoiser_settings)
+		{
+			return MStatus::kFailure;
+		}
 
-	// Save shadow settings
-	if (rt_shadow_settings.has_value())
-	{
-		SetRenderSettings<wr::RTShadowSettings>(frame_graph.GetSpecifiedFramegraph(RendererFrameGraphType::HYBRID_RAY_TRACING), rt_shadow_settings.value());
+		rt_shadow_denoiser_settings->m_runtime.m_z_phi = arg_data.flagArgumentDouble(RT_SHADOWS_DENOISER_Z_PHI_SHORT_FLAG, 0);
 	}
 
-	// Save shadow denoiser settings
-	if (rt_shadow_denoiser_settings.has_value())
-	{
-		SetRenderSettings<wr::ShadowDenoiserSettings>(frame_graph.GetSpecifiedFramegraph(RendererFrameGraphType::HYBRID_RAY_TRACING), rt_shadow_denoiser_settings.value());
-	}
+	// Push the changed settings to the frame graphs that exist
+	frame_graph.ApplyPipelineRenderSettings();
 
 	// Auto-focus enabled
 	if (arg_data.flagArgumentBool(DOF_AUTO_FOCUS_SHORT_FLAG, 1))
@@ -257,10 +537,22 @@ MSyntax wmr::RenderPipelineSelectCommand::create_syntax()
 {
 	MSyntax syntax;
 
+	// No arguments
+	syntax.addFlag(TRANSFORM_UPDATE_STATISTICS_SHORT_FLAG, TRANSFORM_UPDATE_STATISTICS_LONG_FLAG, MSyntax::kNoArg);
+	syntax.addFlag(RENDER_ON_DEMAND_STATISTICS_SHORT_FLAG, RENDER_ON_DEMAND_STATISTICS_LONG_FLAG, MSyntax::kNoArg);
+	syntax.addFlag(TIMING_STATISTICS_SHORT_FLAG, TIMING_STATISTICS_LONG_FLAG, MSyntax::kNoArg);
+	syntax.addFlag(TEXTURE_LOADING_STATISTICS_SHORT_FLAG, TEXTURE_LOADING_STATISTICS_LONG_FLAG, MSyntax::kNoArg);
+	syntax.addFlag(TEXTURE_CACHE_STATISTICS_SHORT_FLAG, TEXTURE_CACHE_STATISTICS_LONG_FLAG, MSyntax::kNoArg);
+	syntax.addFlag(TEXTURE_MEMORY_STATISTICS_SHORT_FLAG, TEXTURE_MEMORY_STATISTICS_LONG_FLAG, MSyntax::kNoArg);
+	syntax.addFlag(PROGRESSIVE_ACCUMULATION_STATE_SHORT_FLAG, PROGRESSIVE_ACCUMULATION_STATE_LONG_FLAG, MSyntax::kNoArg);
+	syntax.addFlag(DYNAMIC_RESOLUTION_STATE_SHORT_FLAG, DYNAMIC_RESOLUTION_STATE_LONG_FLAG, MSyntax::kNoArg);
+
 	// Unsigned integers
 	syntax.addFlag(PIPELINE_SHORT_FLAG, PIPELINE_LONG_FLAG, MSyntax::kUnsigned);
 	syntax.addFlag(DOF_APERTURE_BLADE_COUNT_SHORT_FLAG, DOF_APERTURE_BLADE_COUNT_LONG_FLAG, MSyntax::kUnsigned);
+	syntax.addFlag(FRAMES_IN_FLIGHT_SHORT_FLAG, FRAMES_IN_FLIGHT_LONG_FLAG, MSyntax::kUnsigned);
 	syntax.addFlag(RT_SHADOWS_SAMPLES_PER_PIXEL_SHORT_FLAG, RT_SHADOWS_SAMPLES_PER_PIXEL_LONG_FLAG, MSyntax::kUnsigned);
+	syntax.addFlag(TEXTURE_MEMORY_BUDGET_SHORT_FLAG, TEXTURE_MEMORY_BUDGET_LONG_FLAG, MSyntax::kUnsigned);
 
 	// Strings
 	syntax.addFlag(SKYBOX_SHORT_FLAG, SKYBOX_LONG_FLAG, MSyntax::kString);
@@ -268,11 +560,20 @@ MSyntax wmr::RenderPipelineSelectCommand::create_syntax()
 	// Booleans
 	syntax.addFlag(DOF_AUTO_FOCUS_SHORT_FLAG, DOF_AUTO_FOCUS_LONG_FLAG, MSyntax::kBoolean);
 	syntax.addFlag(BLOOM_ENABLE_SHORT_FLAG, BLOOM_ENABLE_LONG_FLAG, MSyntax::kBoolean);
+	syntax.addFlag(DOF_ENABLE_SHORT_FLAG, DOF_ENABLE_LONG_FLAG, MSyntax::kBoolean);
+	syntax.addFlag(HBAO_ENABLE_SHORT_FLAG, HBAO_ENABLE_LONG_FLAG, MSyntax::kBoolean);
 	syntax.addFlag(HBAO_BLUR_SHORT_FLAG, HBAO_BLUR_LONG_FLAG, MSyntax::kBoolean);
 	syntax.addFlag(AS_DISABLE_REBUILD_SHORT_FLAG, AS_DISABLE_REBUILD_LONG_FLAG, MSyntax::kBoolean);
+	syntax.addFlag(PROGRESSIVE_ACCUMULATION_SHORT_FLAG, PROGRESSIVE_ACCUMULATION_LONG_FLAG, MSyntax::kBoolean);
+	syntax.addFlag(DYNAMIC_RESOLUTION_SHORT_FLAG, DYNAMIC_RESOLUTION_LONG_FLAG, MSyntax::kBoolean);
+	syntax.addFlag(LOW_END_PIPELINE_SHORT_FLAG, LOW_END_PIPELINE_LONG_FLAG, MSyntax::kBoolean);
+	syntax.addFlag(GPU_TASK_TIMING_SHORT_FLAG, GPU_TASK_TIMING_LONG_FLAG, MSyntax::kBoolean);
+	syntax.addFlag(TIMING_HUD_SHORT_FLAG, TIMING_HUD_LONG_FLAG, MSyntax::kBoolean);
+	syntax.addFlag(TRACE_SHORT_FLAG, TRACE_LONG_FLAG, MSyntax::kBoolean);
 
 	// Doubles
 	syntax.addFlag(DOF_FILM_SIZE_SHORT_FLAG, DOF_FILM_SIZE_LONG_FLAG, MSyntax::kDouble);
+	syntax.addFlag(DYNAMIC_RESOLUTION_BUDGET_SHORT_FLAG, DYNAMIC_RESOLUTION_BUDGET_LONG_FLAG, MSyntax::kDouble);
 	syntax.addFlag(DOF_BOKEH_SHAPE_SIZE_SHORT_FLAG, DOF_BOKEH_SHAPE_SIZE_LONG_FLAG, MSyntax::kDouble);
 	syntax.addFlag(HBAO_METERS_TO_UNITS_SHORT_FLAG, HBAO_METERS_TO_UNITS_LONG_FLAG, MSyntax::kDouble);
 	syntax.addFlag(HBAO_RADIUS_SHORT_FLAG, HBAO_RADIUS_LONG_FLAG, MSyntax::kDouble);
@@ -20,9 +20,11 @@ namespace wmr
 {
 	// Generic
 	const constexpr char* PIPELINE_SHORT_FLAG = "-p";
+	const constexpr char* LOW_END_PIPELINE_SHORT_FLAG = "-lep";
 	const constexpr char* SKYBOX_SHORT_FLAG = "-sb";
 
 	const constexpr char* PIPELINE_LONG_FLAG = "-pipeline";
+	const constexpr char* LOW_END_PIPELINE_LONG_FLAG = "-low_end_pipeline";
 	const constexpr char* SKYBOX_LONG_FLAG = "-skybox";
 	
 	// Depth of field
@@ -30,17 +32,20 @@ namespace wmr
 	const constexpr char* DOF_BOKEH_SHAPE_SIZE_SHORT_FLAG = "-bss";
 	const constexpr char* DOF_APERTURE_BLADE_COUNT_SHORT_FLAG = "-abc";
 	const constexpr char* DOF_AUTO_FOCUS_SHORT_FLAG = "-af";
+	const constexpr char* DOF_ENABLE_SHORT_FLAG = "-de";
 
 	const constexpr char* DOF_FILM_SIZE_LONG_FLAG = "-dof_film_size";
 	const constexpr char* DOF_BOKEH_SHAPE_SIZE_LONG_FLAG = "-dof_bokeh_shape_size";
 	const constexpr char* DOF_APERTURE_BLADE_COUNT_LONG_FLAG = "-dof_aperature_blade_count";
 	const constexpr char* DOF_AUTO_FOCUS_LONG_FLAG = "-dof_auto_focus";
+	const constexpr char* DOF_ENABLE_LONG_FLAG = "-enable_dof";
 	
 	// Bloom
 	const constexpr char* BLOOM_ENABLE_SHORT_FLAG = "-be";
 	const constexpr char* BLOOM_ENABLE_LONG_FLAG = "-enable_bloom";
 	
 	// NVIDIA HBAO
+	const constexpr char* HBAO_ENABLE_SHORT_FLAG = "-he";
 	const constexpr char* HBAO_METERS_TO_UNITS_SHORT_FLAG = "-hmu";
 	const constexpr char* HBAO_RADIUS_SHORT_FLAG = "-hr";
 	const constexpr char* HBAO_BIAS_SHORT_FLAG = "-hbi";
@@ -48,6 +53,7 @@ namespace wmr
 	const constexpr char* HBAO_BLUR_SHORT_FLAG = "-hbl";
 	const constexpr char* HBAO_BLUR_SHARPNESS_SHORT_FLAG = "-hbs";
 
+	const constexpr char* HBAO_ENABLE_LONG_FLAG = "-enable_hbao";
 	const constexpr char* HBAO_METERS_TO_UNITS_LONG_FLAG = "-hbao_meters_to_units";
 	const constexpr char* HBAO_RADIUS_LONG_FLAG = "-hbao_radius";
 	const constexpr char* HBAO_BIAS_LONG_FLAG = "-hbao_bias";
@@ -83,6 +89,55 @@ namespace wmr
 	const constexpr char* RT_SHADOWS_DENOISER_N_PHI_LONG_FLAG = "-rt_shadows_denoise_n_phi";
 	const constexpr char* RT_SHADOWS_DENOISER_Z_PHI_LONG_FLAG = "-rt_shadows_denoise_z_phi";
 
+	// Frame pacing
+	const constexpr char* FRAMES_IN_FLIGHT_SHORT_FLAG = "-fif";
+	const constexpr char* FRAMES_IN_FLIGHT_LONG_FLAG = "-frames_in_flight";
+
+	// Progressive accumulation
+	const constexpr char* PROGRESSIVE_ACCUMULATION_SHORT_FLAG = "-pa";
+	const constexpr char* PROGRESSIVE_ACCUMULATION_STATE_SHORT_FLAG = "-pas";
+
+	const constexpr char* PROGRESSIVE_ACCUMULATION_LONG_FLAG = "-progressive_accumulation";
+	const constexpr char* PROGRESSIVE_ACCUMULATION_STATE_LONG_FLAG = "-progressive_accumulation_state";
+
+	// Dynamic resolution
+	const constexpr char* DYNAMIC_RESOLUTION_SHORT_FLAG = "-dyr";
+	const constexpr char* DYNAMIC_RESOLUTION_BUDGET_SHORT_FLAG = "-dyb";
+	const constexpr char* DYNAMIC_RESOLUTION_STATE_SHORT_FLAG = "-dys";
+
+	const constexpr char* DYNAMIC_RESOLUTION_LONG_FLAG = "-dynamic_resolution";
+	const constexpr char* DYNAMIC_RESOLUTION_BUDGET_LONG_FLAG = "-dynamic_resolution_budget";
+	const constexpr char* DYNAMIC_RESOLUTION_STATE_LONG_FLAG = "-dynamic_resolution_state";
+
+	// Statistics
+	const constexpr char* TRANSFORM_UPDATE_STATISTICS_SHORT_FLAG = "-tus";
+	const constexpr char* TRANSFORM_UPDATE_STATISTICS_LONG_FLAG = "-transform_update_statistics";
+	const constexpr char* RENDER_ON_DEMAND_STATISTICS_SHORT_FLAG = "-rds";
+	const constexpr char* RENDER_ON_DEMAND_STATISTICS_LONG_FLAG = "-render_on_demand_statistics";
+	const constexpr char* TIMING_STATISTICS_SHORT_FLAG = "-ts";
+	const constexpr char* TIMING_STATISTICS_LONG_FLAG = "-timing_statistics";
+	const constexpr char* TEXTURE_LOADING_STATISTICS_SHORT_FLAG = "-tls";
+	const constexpr char* TEXTURE_LOADING_STATISTICS_LONG_FLAG = "-texture_loading_statistics";
+	const constexpr char* TEXTURE_CACHE_STATISTICS_SHORT_FLAG = "-tcs";
+	const constexpr char* TEXTURE_CACHE_STATISTICS_LONG_FLAG = "-texture_cache_statistics";
+	const constexpr char* TEXTURE_MEMORY_STATISTICS_SHORT_FLAG = "-tms";
+	const constexpr char* TEXTURE_MEMORY_STATISTICS_LONG_FLAG = "-texture_memory_statistics";
+
+	// Texture streaming
+	const constexpr char* TEXTURE_MEMORY_BUDGET_SHORT_FLAG = "-tmb";
+	const constexpr char* TEXTURE_MEMORY_BUDGET_LONG_FLAG = "-texture_memory_budget";
+
+	// Timing
+	const constexpr char* GPU_TASK_TIMING_SHORT_FLAG = "-gtt";
+	const constexpr char* TIMING_HUD_SHORT_FLAG = "-th";
+
+	const constexpr char* GPU_TASK_TIMING_LONG_FLAG = "-gpu_task_timing";
+	const constexpr char* TIMING_HUD_LONG_FLAG = "-timing_hud";
+
+	// Tracing
+	const constexpr char* TRACE_SHORT_FLAG = "-tr";
+	const constexpr char* TRACE_LONG_FLAG = "-trace";
+
 	// Acceleration structure
 	const constexpr char* AS_DISABLE_REBUILD_SHORT_FLAG = "-dr";
 	const constexpr char* AS_DISABLE_REBUILD_LONG_FLAG = "-disable_acceleration_structure_rebuilding";
@@ -16,20 +16,53 @@
 
 //wisp plug-in
 #include "plugin/framegraph/frame_graph_manager.hpp"
+#include "plugin/renderer/frame_pacing.hpp"
 #include "plugin/renderer/model_manager.hpp"
 #include "plugin/renderer/texture_manager.hpp"
 #include "plugin/renderer/material_manager.hpp"
+#include "miscellaneous/settings.hpp"
+#include "miscellaneous/trace_recorder.hpp"
 
 // Wisp rendering framework
 #include "frame_graph/frame_graph.hpp"
+#include "wisp_render_tasks/d3d12_frame_fences.hpp"
+#include "wisp_render_tasks/d3d12_gpu_frame_timer.hpp"
 #include "scene_graph/camera_node.hpp"
+#include "scene_graph/mesh_node.hpp"
 #include "scene_graph/scene_graph.hpp"
 #include "d3d12/d3d12_renderer.hpp"
+#include "d3d12/d3d12_functions.hpp"
 #include "wisp.hpp"
 
+// C++ standard
+#include <algorithm>
+#include <unordered_set>
+#include <utility>
+
+static_assert(wmr::settings::MAX_FRAMES_IN_FLIGHT <= wr::d3d12::settings::num_back_buffers, "Wisp cannot have more frames in flight than it has back buffers.");
+
 wmr::Renderer::Renderer()
 	: m_frame_index(0)
+	, m_gpu_idle(true)
+	, m_pending_scene_updates(0)
+	, m_max_frames_in_flight(settings::DEFAULT_FRAMES_IN_FLIGHT)
+	, m_scene_revision(1)
+	, m_rendered_revision(0)
+	, m_settle_frames(0)
+	, m_rendered_last_frame(false)
+	, m_progressive_accumulation(settings::DEFAULT_PROGRESSIVE_ACCUMULATION)
+	, m_accumulated_samples(0)
+	, m_dynamic_resolution(settings::DEFAULT_DYNAMIC_RESOLUTION)
+	, m_measured_gpu_frames(0)
+	, m_profiler(settings::TIMING_STATISTICS_WINDOW)
+	, m_timing_hud(settings::DEFAULT_TIMING_HUD)
+	, m_profiled_gpu_frames(static_cast<std::size_t>(RendererFrameGraphType::RENDERING_PIPELINE_TYPE_COUNT), 0)
 {
+	ResolutionScaleSettings resolution_scale_settings;
+	resolution_scale_settings.m_target_frame_time = settings::DEFAULT_GPU_FRAME_TIME_BUDGET;
+	resolution_scale_settings.m_min_scale = settings::DYNAMIC_RESOLUTION_MIN_SCALE;
+	m_resolution_scale_controller = ResolutionScaleController(resolution_scale_settings);
+
 	LOG("Starting object creation.");
 
 	m_render_system			= std::make_unique<wr::D3D12RenderSystem>();
@@ -70,12 +103,323 @@ void wmr::Renderer::Initialize() noexcept
 void wmr::Renderer::Update()
 {
 	m_frame_index = m_render_system->GetFrameIdx();
+
+	// Moving models between model pool pages has to reach the GPU as well
+	if (m_model_manager->Update())
+	{
+		MarkSceneChanged();
+	}
+
+	// Swap decoded textures in for the placeholders of their materials
+	if (m_texture_manager->Update())
+	{
+		MarkSceneChanged();
+	}
 }
 
 void wmr::Renderer::Render()
 {
-	m_render_system->WaitForAllPreviousWork();
-	m_result_textures = m_render_system->Render(*m_scenegraph , *m_framegraph_manager->Get());
+	ScopedTraceEvent trace_event("Renderer::Render", "renderer");
+
+	if (!RequiresRefresh())
+	{
+		// Nothing changed, the output of the last rendered frame is still valid
+		m_rendered_last_frame = false;
+		++m_render_on_demand_statistics.m_frames_skipped;
+		return;
+	}
+
+	auto frame_graph_type = m_framegraph_manager->GetType();
+	bool accumulate = false;
+
+	if (m_rendered_revision != m_scene_revision)
+	{
+		// A frame shows up in the output once the frame submitted "frames in flight" frames later waited for it
+		m_rendered_revision = m_scene_revision;
+		m_settle_frames = m_max_frames_in_flight;
+
+		// Any change invalidates the accumulated samples
+		m_accumulated_samples = 0;
+	}
+	else if (m_settle_frames > 0)
+	{
+		--m_settle_frames;
+	}
+	else
+	{
+		// The latest revision is on screen, refine it using the path tracer
+		frame_graph_type = RendererFrameGraphType::PROGRESSIVE_PATH_TRACING;
+		accumulate = true;
+
+		if (m_accumulated_samples == 0)
+		{
+			m_render_system->clear_path = true;
+		}
+
+		++m_accumulated_samples;
+	}
+
+	// Frame graphs that were inactive during the last resize are resized now
+	auto* frame_graph = m_framegraph_manager->Activate(frame_graph_type, *m_render_system);
+
+	// The pipeline description is broken, the frame graph manager logged why
+	if (!frame_graph)
+	{
+		m_rendered_last_frame = false;
+		return;
+	}
+
+	// Scene updates in this frame waited for the GPU already
+	if (!m_gpu_idle)
+	{
+		// The readbacks of the oldest frame in flight become available once this wait returns
+		ScopedTraceEvent wait_event("Wait for the oldest frame in flight", "wait");
+
+		if (m_max_frames_in_flight <= 1)
+		{
+			m_render_system->WaitForAllPreviousWork();
+		}
+		else if (auto frame_index = GetFrameIndexToWaitFor(static_cast<std::uint32_t>(m_render_system->GetFrameIdx()), wr::d3d12::settings::num_back_buffers, m_max_frames_in_flight))
+		{
+			// Wisp waits for the back buffer it is about to reuse by itself, the frame submitted "frames in flight"
+			// frames ago has to be finished as well when fewer frames in flight than back buffers are requested. The
+			// fence values are left alone, Wisp pairs every wait on a fence with its own signal.
+			wr::internal::WaitForFrameFence(*m_render_system, wr::internal::GetLastFrameFence(*m_render_system, *frame_index));
+		}
+	}
+
+	if (m_pending_scene_updates > 1)
+	{
+		LOG("Committed {} scene updates in a single batch.", m_pending_scene_updates);
+	}
+
+	TouchDrawnTextures();
+
+	wr::CPUTextures result_textures;
+	{
+		ScopedTraceEvent render_event("D3D12RenderSystem::Render", "renderer");
+		result_textures = m_render_system->Render(*m_scenegraph, *frame_graph);
+	}
+
+	// The path tracing frame graph still outputs the last accumulation (of an older scene) until the first samples of
+	// this accumulation are out of flight, keep showing the output of the selected pipeline until then
+	m_rendered_last_frame = (!accumulate || m_accumulated_samples > m_max_frames_in_flight);
+
+	// After a resize or a rebuild of the frame graph the read-back rings have not published a frame yet, keep the
+	// previous result until they have
+	if (m_rendered_last_frame && result_textures.pixel_data.has_value() && result_textures.depth_data.has_value())
+	{
+		m_result_textures = std::move(result_textures);
+	}
+
+	m_gpu_idle = false;
+	m_pending_scene_updates = 0;
+
+	ProfileGPUFrame(static_cast<std::size_t>(frame_graph_type));
+
+	// Only the selected pipeline drives the resolution, the path tracer renders at whatever resolution is current
+	if (m_dynamic_resolution && !accumulate)
+	{
+		const auto& gpu_frame_timer = m_framegraph_manager->GetGPUFrameTimer(m_framegraph_manager->GetType());
+
+		if (gpu_frame_timer.measured_frame_count != m_measured_gpu_frames)
+		{
+			m_measured_gpu_frames = gpu_frame_timer.measured_frame_count;
+
+			if (m_resolution_scale_controller.AddFrameTime(gpu_frame_timer.frame_time))
+			{
+				LOG("Dynamic resolution: rendering at {:.0f}% of the viewport resolution ({:.2f} ms average GPU frame time).", m_resolution_scale_controller.GetScale() * 100.0, m_resolution_scale_controller.GetAverageFrameTime());
+
+				// The viewport resizes the frame graphs before the next frame
+				MarkSceneChanged();
+			}
+		}
+	}
+
+	++m_render_on_demand_statistics.m_frames_rendered;
+}
+
+void wmr::Renderer::PrepareSceneUpdate()
+{
+	if (!m_gpu_idle)
+	{
+		ScopedTraceEvent wait_event("Wait for the GPU before a scene update", "wait");
+
+		m_render_system->WaitForAllPreviousWork();
+		m_gpu_idle = true;
+	}
+
+	++m_pending_scene_updates;
+
+	MarkSceneChanged();
+}
+
+void wmr::Renderer::MarkSceneChanged() noexcept
+{
+	++m_scene_revision;
+}
+
+std::uint64_t wmr::Renderer::GetSceneRevision() const noexcept
+{
+	return m_scene_revision;
+}
+
+bool wmr::Renderer::HasNewRenderResult() const noexcept
+{
+	return m_rendered_last_frame;
+}
+
+bool wmr::Renderer::RequiresRefresh() const noexcept
+{
+	if (m_rendered_revision != m_scene_revision || m_settle_frames > 0)
+	{
+		return true;
+	}
+
+	// Keep accumulating samples until the image converged
+	return (m_progressive_accumulation &&
+			m_render_system->m_device->m_dxr_support &&
+			m_accumulated_samples < settings::PROGRESSIVE_ACCUMULATION_TARGET_SAMPLE_COUNT);
+}
+
+void wmr::Renderer::SetProgressiveAccumulation(bool enabled) noexcept
+{
+	m_progressive_accumulation = enabled;
+
+	if (enabled && !m_render_system->m_device->m_dxr_support)
+	{
+		LOGW("Progressive accumulation requires a device that supports DXR.");
+	}
+
+	MarkSceneChanged();
+}
+
+void wmr::Renderer::SetDynamicResolution(bool enabled) noexcept
+{
+	m_dynamic_resolution = enabled;
+
+	// Start at full resolution, the controller scales down within a few frames when needed
+	m_resolution_scale_controller.Reset();
+
+	LOG("Dynamic resolution {}.", enabled ? "enabled" : "disabled");
+
+	MarkSceneChanged();
+}
+
+void wmr::Renderer::SetGPUFrameTimeBudget(double budget) noexcept
+{
+	m_resolution_scale_controller.SetTargetFrameTime(budget);
+
+	LOG("GPU frame time budget set to {:.2f} ms.", m_resolution_scale_controller.GetSettings().m_target_frame_time);
+}
+
+double wmr::Renderer::GetRenderScale() const noexcept
+{
+	return (m_dynamic_resolution ? m_resolution_scale_controller.GetScale() : 1.0);
+}
+
+wmr::DynamicResolutionState wmr::Renderer::GetDynamicResolutionState() const noexcept
+{
+	DynamicResolutionState state;
+	state.m_enabled = m_dynamic_resolution;
+	state.m_scale = GetRenderScale();
+	state.m_frame_time_budget = m_resolution_scale_controller.GetSettings().m_target_frame_time;
+	state.m_average_frame_time = m_resolution_scale_controller.GetAverageFrameTime();
+	state.m_scale_changes = m_resolution_scale_controller.GetScaleChangeCount();
+
+	return state;
+}
+
+wmr::ProgressiveAccumulationState wmr::Renderer::GetProgressiveAccumulationState() const noexcept
+{
+	ProgressiveAccumulationState state;
+	state.m_sample_count = m_accumulated_samples;
+	state.m_target_sample_count = settings::PROGRESSIVE_ACCUMULATION_TARGET_SAMPLE_COUNT;
+	state.m_converged = (m_accumulated_samples >= settings::PROGRESSIVE_ACCUMULATION_TARGET_SAMPLE_COUNT);
+
+	return state;
+}
+
+wmr::RenderOnDemandStatistics wmr::Renderer::GetRenderOnDemandStatistics() const noexcept
+{
+	return m_render_on_demand_statistics;
+}
+
+wmr::Profiler& wmr::Renderer::GetProfiler() noexcept
+{
+	return m_profiler;
+}
+
+void wmr::Renderer::SetTimingHUD(bool enabled) noexcept
+{
+	m_timing_hud = enabled;
+}
+
+bool wmr::Renderer::IsTimingHUDEnabled() const noexcept
+{
+	return m_timing_hud;
+}
+
+void wmr::Renderer::ProfileGPUFrame(std::size_t frame_graph_index)
+{
+	const auto& gpu_frame_timer = m_framegraph_manager->GetGPUFrameTimer(static_cast<RendererFrameGraphType>(frame_graph_index));
+
+	// The timer publishes a frame a few frames after it was submitted, every frame is profiled once
+	if (gpu_frame_timer.measured_frame_count == m_profiled_gpu_frames[frame_graph_index])
+	{
+		return;
+	}
+
+	m_profiled_gpu_frames[frame_graph_index] = gpu_frame_timer.measured_frame_count;
+
+	const auto prefix = "gpu/" + gpu_frame_timer.name + "/";
+
+	m_profiler.AddSample(prefix + "frame", gpu_frame_timer.frame_time);
+
+	const auto section_count = std::min(gpu_frame_timer.section_times.size(), gpu_frame_timer.section_names.size());
+
+	for (std::size_t section = 0; section < section_count; ++section)
+	{
+		m_profiler.AddSample(prefix + gpu_frame_timer.section_names[section], gpu_frame_timer.section_times[section]);
+	}
+}
+
+void wmr::Renderer::TouchDrawnTextures()
+{
+	// The plug-in does not know which models are inside the view frustum, every model that is not hidden is drawn
+	std::unordered_set<const wr::Material*> materials;
+
+	for (const auto& mesh_node : m_scenegraph->GetMeshNodes())
+	{
+		if (!mesh_node->m_visible || !mesh_node->m_model)
+		{
+			continue;
+		}
+
+		for (auto& mesh : mesh_node->m_model->m_meshes)
+		{
+			if (auto* material = m_material_manager->GetWispMaterial(mesh.second))
+			{
+				materials.insert(material);
+			}
+		}
+	}
+
+	m_texture_manager->TouchMaterialTextures(materials);
+}
+
+void wmr::Renderer::SetMaxFramesInFlight(std::uint32_t count) noexcept
+{
+	m_max_frames_in_flight = std::clamp<std::uint32_t>(count, 1, settings::MAX_FRAMES_IN_FLIGHT);
+
+	LOG("Rendering with {} frame(s) in flight.", m_max_frames_in_flight);
+
+	MarkSceneChanged();
+}
+
+std::uint32_t wmr::Renderer::GetMaxFramesInFlight() const noexcept
+{
+	return m_max_frames_in_flight;
 }
 
 void wmr::Renderer::Destroy()
@@ -91,6 +435,8 @@ void wmr::Renderer::Destroy()
 void wmr::Renderer::UpdateSkybox(const std::string& path) noexcept
 {
 	m_scenegraph->UpdateSkyboxNode(m_scenegraph->GetCurrentSkybox(), *m_texture_manager->CreateTexture(path.c_str()));
+
+	MarkSceneChanged();
 }
 
 const wr::CPUTextures wmr::Renderer::GetRenderResult()
@@ -16,6 +16,8 @@
 #include <memory>
 
 #include "frame_graph/frame_graph.hpp"
+#include "plugin/renderer/resolution_scale_controller.hpp"
+#include "miscellaneous/profiler.hpp"
 
 namespace wr
 {
@@ -33,6 +35,31 @@ namespace wmr
 	class TextureManager;
 	class FrameGraphManager;
 
+	//! Number of viewport refreshes that rendered a new frame compared to the refreshes that reused the last frame
+	struct RenderOnDemandStatistics
+	{
+		std::uint64_t m_frames_rendered = 0;
+		std::uint64_t m_frames_skipped = 0;
+	};
+
+	//! Progress of the path tracer accumulation while the scene and camera are static
+	struct ProgressiveAccumulationState
+	{
+		std::uint32_t m_sample_count = 0;			//!< Samples per pixel accumulated since the last change
+		std::uint32_t m_target_sample_count = 0;	//!< Samples per pixel after which accumulation stops
+		bool m_converged = false;					//!< The target sample count has been reached
+	};
+
+	//! State of the dynamic resolution
+	struct DynamicResolutionState
+	{
+		bool m_enabled = false;
+		double m_scale = 1.0;					//!< Fraction of the viewport resolution that is rendered
+		double m_frame_time_budget = 0.0;		//!< GPU frame time budget in milliseconds
+		double m_average_frame_time = 0.0;		//!< Average GPU frame time of the last measurement window in milliseconds
+		std::uint32_t m_scale_changes = 0;		//!< Number of resolution changes since the dynamic resolution was enabled
+	};
+
 	class Renderer
 	{
 	public:
@@ -42,12 +69,84 @@ namespace wmr
 		//! Initialize all renderer systems
 		void Initialize() noexcept;
 
-		//! Update the frame index
+		//! Update the frame index and compact the model pool in idle frames
 		void Update();
 
 		//! Request the Wisp renderer to render a frame
+		/*! Nothing is rendered when the scene revision did not change since the last rendered frame, the output of the
+		 *  last rendered frame is reused instead. With progressive accumulation enabled, the path tracer keeps adding
+		 *  samples to the image until it converged, a new revision switches back to the selected pipeline. */
 		void Render();
 
+		//! Bump the scene revision, so the next call to Render() renders a new frame
+		/*! Call this for every change that affects the rendered image: scene changes, camera changes, and settings. */
+		void MarkSceneChanged() noexcept;
+
+		//! Revision of the scene, bumped by every call to MarkSceneChanged()
+		std::uint64_t GetSceneRevision() const noexcept;
+
+		//! Whether the last call to Render() rendered a new frame (false when the last frame was reused)
+		bool HasNewRenderResult() const noexcept;
+
+		//! Whether the next frame has to be rendered even though the scene did not change
+		/*! The render result lags behind when more than one frame is in flight, so a few frames are rendered after the
+		 *  last change. Progressive accumulation renders until the image converged. The viewport has to keep
+		 *  refreshing while this returns true. */
+		bool RequiresRefresh() const noexcept;
+
+		//! Accumulate path traced samples while the scene and camera are static
+		/*! Only has an effect on devices that support DXR. */
+		void SetProgressiveAccumulation(bool enabled) noexcept;
+
+		//! Sample count and convergence of the progressive accumulation
+		ProgressiveAccumulationState GetProgressiveAccumulationState() const noexcept;
+
+		//! Render at a fraction of the viewport resolution that keeps the GPU frame time within the budget
+		/*! The blit operation upscales the render result to the viewport. */
+		void SetDynamicResolution(bool enabled) noexcept;
+
+		//! GPU frame time budget of the dynamic resolution in milliseconds
+		void SetGPUFrameTimeBudget(double budget) noexcept;
+
+		//! Fraction of the viewport resolution to render at (1 when the dynamic resolution is disabled)
+		double GetRenderScale() const noexcept;
+
+		//! Scale, budget, and measured frame time of the dynamic resolution
+		DynamicResolutionState GetDynamicResolutionState() const noexcept;
+
+		//! Rendered and skipped frames since the plug-in was loaded
+		RenderOnDemandStatistics GetRenderOnDemandStatistics() const noexcept;
+
+		//! CPU timings of the render operations and parsers, and GPU timings of the frame graphs
+		/*! GPU timers are named "gpu/<pipeline>/frame", and "gpu/<pipeline>/<task>" when the GPU task timing of the
+		 *  frame graph manager is enabled. CPU timers are named "cpu/<operation>". */
+		Profiler& GetProfiler() noexcept;
+
+		//! Draw the timing statistics on top of the viewport
+		void SetTimingHUD(bool enabled) noexcept;
+
+		//! Whether the timing statistics are drawn on top of the viewport
+		bool IsTimingHUDEnabled() const noexcept;
+
+		//! Wait for the GPU before the scene is modified
+		/*! Scene graph nodes and model pool data can still be in use by frames that have been submitted already. Only the
+		 *  first call after a frame has been submitted waits for the GPU, every following call returns immediately until
+		 *  the next frame is submitted. All scene changes made in between end up in a single batch, so adding thousands
+		 *  of objects (e.g. when a scene is opened) costs a single wait instead of one wait per object. */
+		void PrepareSceneUpdate();
+
+		//! Set the number of frames the GPU may work on while the CPU prepares the next frame
+		/*! With a single frame in flight, every frame waits until the GPU finished the previous frame (lowest latency).
+		 *  With two or three frames in flight, CPU scene parsing, GPU rendering, and the Maya texture upload overlap, and
+		 *  the CPU only waits for the frame that used the resources that are about to be reused (highest throughput, the
+		 *  viewport lags one or two frames behind).
+		 *
+		 *  /param count Number of frames in flight, clamped to [1, settings::MAX_FRAMES_IN_FLIGHT]. */
+		void SetMaxFramesInFlight(std::uint32_t count) noexcept;
+
+		//! Number of frames the GPU may work on while the CPU prepares the next frame
+		std::uint32_t GetMaxFramesInFlight() const noexcept;
+
 		//! Destroy all resources allocated by the renderer
 		void Destroy();
 
@@ -82,6 +181,12 @@ namespace wmr
 		std::shared_ptr<wr::CameraNode> GetCamera() const;
 
 	private:
+		//! Add the GPU times of the newest completed frame of a frame graph to the profiler, once per measured frame
+		void ProfileGPUFrame(std::size_t frame_graph_index);
+
+		//! Mark the textures of the materials of the visible models as used in this frame, for the texture memory budget
+		void TouchDrawnTextures();
+
 		std::unique_ptr<FrameGraphManager>		m_framegraph_manager;
 		std::unique_ptr<MaterialManager>		m_material_manager;
 		std::unique_ptr<ModelManager>			m_model_manager;
@@ -95,5 +200,25 @@ namespace wmr
 		wr::CPUTextures							m_result_textures;
 
 		std::uint64_t m_frame_index;
+
+		bool m_gpu_idle;							//! No frame has been submitted since the last wait for the GPU
+		std::uint32_t m_pending_scene_updates;		//! Number of scene updates in the current batch
+		std::uint32_t m_max_frames_in_flight;		//! Latency / throughput trade-off, see SetMaxFramesInFlight()
+
+		std::uint64_t m_scene_revision;				//! Bumped by every change that affects the rendered image
+		std::uint64_t m_rendered_revision;			//! Scene revision of the last rendered frame
+		std::uint32_t m_settle_frames;				//! Frames to render until the rendered revision reaches the output
+		bool m_rendered_last_frame;					//! The last call to Render() rendered a new frame
+		bool m_progressive_accumulation;			//! Path trace while nothing changes, see SetProgressiveAccumulation()
+		std::uint32_t m_accumulated_samples;		//! Path tracer frames rendered since the last change
+
+		bool m_dynamic_resolution;					//! Render scale follows the GPU frame time, see SetDynamicResolution()
+		ResolutionScaleController m_resolution_scale_controller;
+		std::uint64_t m_measured_gpu_frames;		//! GPU frame timer count of the last frame fed to the controller
+		RenderOnDemandStatistics m_render_on_demand_statistics;
+
+		Profiler m_profiler;
+		bool m_timing_hud;							//! Draw the timing statistics, see SetTimingHUD()
+		std::vector<std::uint64_t> m_profiled_gpu_frames;	//! GPU frame timer count of the last frame profiled, per frame graph
 	};
 }
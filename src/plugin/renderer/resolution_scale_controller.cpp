@@ -0,0 +1,131 @@
+// Copyright 2019 Breda University of Applied Sciences and Team Wisp (Viktor Zoutman, Emilio Laiso, Jens Hagen, Meine Zeinstra, Tahar Meijs, Koen Buitenhuis, Niels Brunekreef, Darius Bouma, Florian Schut)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "resolution_scale_controller.hpp"
+
+// C++ standard
+#include <algorithm>
+#include <cmath>
+
+namespace wmr
+{
+	ResolutionScaleController::ResolutionScaleController(const ResolutionScaleSettings& settings)
+		: m_settings(settings)
+	{
+		Reset();
+	}
+
+	bool ResolutionScaleController::AddFrameTime(double gpu_frame_time)
+	{
+		// Frames right after a resize are not representative
+		if (m_cooldown > 0)
+		{
+			--m_cooldown;
+			return false;
+		}
+
+		m_window_sum += gpu_frame_time;
+		++m_window_size;
+
+		if (m_window_size < std::max<std::uint32_t>(m_settings.m_sample_window, 1))
+		{
+			return false;
+		}
+
+		m_average_frame_time = m_window_sum / m_window_size;
+		m_window_sum = 0.0;
+		m_window_size = 0;
+
+		const auto occupancy = m_average_frame_time / m_settings.m_target_frame_time;
+
+		// Inside the dead band, the current scale is good enough
+		if (occupancy <= m_settings.m_downscale_threshold && occupancy >= m_settings.m_upscale_threshold)
+		{
+			return false;
+		}
+
+		// Pixel count scales with the square of the scale
+		const auto new_scale = QuantizeScale(m_scale * std::sqrt(m_settings.m_target_occupancy / std::max(occupancy, 1e-6)));
+
+		if (std::abs(new_scale - m_scale) < m_settings.m_scale_step * 0.5)
+		{
+			return false;
+		}
+
+		m_scale = new_scale;
+		m_cooldown = m_settings.m_cooldown_frames;
+		++m_scale_change_count;
+
+		return true;
+	}
+
+	double ResolutionScaleController::GetScale() const noexcept
+	{
+		return m_scale;
+	}
+
+	double ResolutionScaleController::GetAverageFrameTime() const noexcept
+	{
+		return m_average_frame_time;
+	}
+
+	std::uint32_t ResolutionScaleController::GetScaleChangeCount() const noexcept
+	{
+		return m_scale_change_count;
+	}
+
+	void ResolutionScaleController::SetTargetFrameTime(double target_frame_time) noexcept
+	{
+		m_settings.m_target_frame_time = std::max(target_frame_time, 1e-3);
+
+		// Measurements against the old budget are meaningless
+		m_window_sum = 0.0;
+		m_window_size = 0;
+	}
+
+	const ResolutionScaleSettings& ResolutionScaleController::GetSettings() const noexcept
+	{
+		return m_settings;
+	}
+
+	void ResolutionScaleController::Reset() noexcept
+	{
+		m_scale = QuantizeScale(m_settings.m_max_scale);
+		m_window_sum = 0.0;
+		m_average_frame_time = 0.0;
+		m_window_size = 0;
+		m_cooldown = 0;
+		m_scale_change_count = 0;
+	}
+
+	double ResolutionScaleController::QuantizeScale(double scale) const noexcept
+	{
+		if (m_settings.m_scale_step > 0.0)
+		{
+			// The epsilon keeps exact multiples from being rounded down a step
+			scale = std::floor(scale / m_settings.m_scale_step + 1e-6) * m_settings.m_scale_step;
+		}
+
+		return std::clamp(scale, m_settings.m_min_scale, m_settings.m_max_scale);
+	}
+
+	std::pair<std::uint32_t, std::uint32_t> ScaleResolution(std::uint32_t width, std::uint32_t height, double scale) noexcept
+	{
+		const auto scaled_width = static_cast<std::uint32_t>(std::lround(width * scale));
+		const auto scaled_height = static_cast<std::uint32_t>(std::lround(height * scale));
+
+		return { std::max<std::uint32_t>(scaled_width, 1), std::max<std::uint32_t>(scaled_height, 1) };
+	}
+}
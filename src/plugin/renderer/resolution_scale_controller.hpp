@@ -0,0 +1,90 @@
+// Copyright 2019 Breda University of Applied Sciences and Team Wisp (Viktor Zoutman, Emilio Laiso, Jens Hagen, Meine Zeinstra, Tahar Meijs, Koen Buitenhuis, Niels Brunekreef, Darius Bouma, Florian Schut)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+// C++ standard
+#include <cstdint>
+#include <utility>
+
+//! Generic plug-in namespace (Wisp Maya Renderer)
+namespace wmr
+{
+	//! Tuning of the dynamic resolution controller
+	struct ResolutionScaleSettings
+	{
+		double m_target_frame_time = 16.6;		//!< GPU frame time budget in milliseconds
+		double m_min_scale = 0.5;				//!< Lowest fraction of the panel resolution
+		double m_max_scale = 1.0;				//!< Highest fraction of the panel resolution
+		double m_scale_step = 0.05;				//!< Scales are multiples of this step, small changes never cause a resize
+		double m_target_occupancy = 0.9;		//!< New scales aim for this fraction of the budget, leaving some headroom
+		double m_upscale_threshold = 0.75;		//!< Scale up when the average frame time drops below this fraction of the budget
+		double m_downscale_threshold = 1.05;	//!< Scale down when the average frame time exceeds this fraction of the budget
+		std::uint32_t m_sample_window = 8;		//!< Number of frames averaged before a decision is made
+		std::uint32_t m_cooldown_frames = 8;	//!< Frames ignored after a scale change (resize hitch, pipeline refill)
+	};
+
+	//! Chooses the fraction of the panel resolution to render at, based on the measured GPU frame time
+	/*! The GPU cost of a frame is assumed to be proportional to the number of pixels, so the scale that fits the budget
+	 *  follows from the square root of the budget divided by the measured frame time. Decisions are made once per window
+	 *  of frames, the scale is quantized, and the thresholds leave a dead band around the budget, so a frame time that
+	 *  hovers around the budget does not resize the frame graphs every few frames. */
+	class ResolutionScaleController
+	{
+	public:
+		explicit ResolutionScaleController(const ResolutionScaleSettings& settings = ResolutionScaleSettings());
+		~ResolutionScaleController() = default;
+
+		//! Feed the GPU time of a rendered frame
+		/*! \param gpu_frame_time GPU frame time in milliseconds.
+		 *  \return True when the scale changed, the frame graphs have to be resized. */
+		bool AddFrameTime(double gpu_frame_time);
+
+		//! Fraction of the panel resolution to render at
+		double GetScale() const noexcept;
+
+		//! Average GPU frame time of the last complete window in milliseconds, zero before the first window
+		double GetAverageFrameTime() const noexcept;
+
+		//! Number of scale changes since the controller was created or reset
+		std::uint32_t GetScaleChangeCount() const noexcept;
+
+		//! Change the GPU frame time budget in milliseconds
+		void SetTargetFrameTime(double target_frame_time) noexcept;
+
+		//! Tuning of the controller
+		const ResolutionScaleSettings& GetSettings() const noexcept;
+
+		//! Go back to the maximum scale and forget all measurements
+		void Reset() noexcept;
+
+	private:
+		//! Round a scale down to a multiple of the scale step and clamp it to the scale range
+		double QuantizeScale(double scale) const noexcept;
+
+		ResolutionScaleSettings m_settings;
+
+		double m_scale;
+		double m_window_sum;
+		double m_average_frame_time;
+		std::uint32_t m_window_size;
+		std::uint32_t m_cooldown;
+		std::uint32_t m_scale_change_count;
+	};
+
+	//! Resolution of the render target for a panel resolution and scale
+	/*! Never returns a dimension of zero. */
+	std::pair<std::uint32_t, std::uint32_t> ScaleResolution(std::uint32_t width, std::uint32_t height, double scale) noexcept;
+}
@@ -0,0 +1,279 @@
+// Copyright 2019 Breda University of Applied Sciences and Team Wisp (Viktor Zoutman, Emilio Laiso, Jens Hagen, Meine Zeinstra, Tahar Meijs, Koen Buitenhuis, Niels Brunekreef, Darius Bouma, Florian Schut)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "texture_cache.hpp"
+
+// Wisp plug-in
+#include "plugin/renderer/texture_registry.hpp"
+
+// C++ standard
+#include <cstdio>
+#include <exception>
+#include <system_error>
+
+namespace wmr
+{
+	namespace
+	{
+		//! Part of every cache key, increase it when the way cached copies are built changes
+		const constexpr std::uint32_t TEXTURE_CACHE_VERSION = 1;
+	}
+
+	CompressedTextureFormat SelectCompressedTextureFormat(TextureRole role, bool has_transparent_pixels) noexcept
+	{
+		switch (role)
+		{
+		case TextureRole::NORMAL:
+			return CompressedTextureFormat::BC5;
+		case TextureRole::DATA:
+			return CompressedTextureFormat::BC7;
+		case TextureRole::COLOR:
+		default:
+			return has_transparent_pixels ? CompressedTextureFormat::BC3 : CompressedTextureFormat::BC1;
+		}
+	}
+
+	bool HasTransparentPixels(const DecodedTexture& texture) noexcept
+	{
+		for (std::size_t i = 3; i < texture.m_pixels.size(); i += 4)
+		{
+			if (texture.m_pixels[i] != 255)
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	std::string GetReducedCachePath(const std::string& cache_path, std::uint32_t first_mip)
+	{
+		if (first_mip == 0)
+		{
+			return cache_path;
+		}
+
+		auto path = std::filesystem::path(cache_path);
+		path.replace_extension(".mip" + std::to_string(first_mip) + ".dds");
+
+		return path.string();
+	}
+
+	TextureCache::TextureCache(const std::string& directory, DecodeFunction decode, BuildFunction build, std::size_t max_pending_builds, std::size_t thread_count)
+		: m_directory(directory)
+		, m_decode(std::move(decode))
+		, m_build(std::move(build))
+		, m_max_pending_builds(max_pending_builds)
+		, m_shutting_down(false)
+		, m_hits(0)
+		, m_misses(0)
+		, m_builds_completed(0)
+		, m_builds_failed(0)
+		, m_pool(thread_count)
+	{
+	}
+
+	TextureCache::~TextureCache()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_shutting_down = true;
+		}
+
+		WaitForBuilds();
+	}
+
+	std::string TextureCache::GetCachePath(const std::string& source_path, TextureRole role) const
+	{
+		std::error_code error;
+		const auto modification_time = std::filesystem::last_write_time(source_path, error);
+
+		if (error)
+		{
+			return {};
+		}
+
+		const auto size = std::filesystem::file_size(source_path, error);
+
+		if (error)
+		{
+			return {};
+		}
+
+		const auto key = source_path + '\n' +
+			std::to_string(modification_time.time_since_epoch().count()) + '\n' +
+			std::to_string(size) + '\n' +
+			std::to_string(static_cast<int>(role)) + '\n' +
+			std::to_string(TEXTURE_CACHE_VERSION);
+
+		char file_name[21];
+		std::snprintf(file_name, sizeof(file_name), "%016llx.dds", static_cast<unsigned long long>(HashTexturePath(key)));
+
+		return (m_directory / file_name).string();
+	}
+
+	std::optional<std::string> TextureCache::Find(const std::string& source_path, TextureRole role)
+	{
+		auto cache_path = GetCachePath(source_path, role);
+
+		std::error_code error;
+		const bool exists = (!cache_path.empty() && std::filesystem::is_regular_file(cache_path, error));
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		if (!exists || m_building.count(cache_path) > 0)
+		{
+			++m_misses;
+			return std::nullopt;
+		}
+
+		++m_hits;
+		return cache_path;
+	}
+
+	bool TextureCache::Build(const std::string& source_path, TextureRole role)
+	{
+		auto cache_path = GetCachePath(source_path, role);
+
+		if (cache_path.empty())
+		{
+			return false;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+
+			if (m_shutting_down || m_building.size() >= m_max_pending_builds || !m_building.insert(cache_path).second)
+			{
+				return false;
+			}
+		}
+
+		m_pool.Enqueue([this, source_path, cache_path, role]()
+		{
+			BuildCopy(source_path, cache_path, role);
+		});
+
+		return true;
+	}
+
+	void TextureCache::Invalidate(const std::string& cache_path)
+	{
+		std::error_code error;
+		std::filesystem::remove(cache_path, error);
+
+		// The reduced copies were made from the unreadable copy, they would be loaded again otherwise
+		const auto path = std::filesystem::path(cache_path);
+		const auto reduced_prefix = path.stem().string() + ".mip";
+
+		for (auto entry = std::filesystem::directory_iterator(path.parent_path(), error); !error && entry != std::filesystem::directory_iterator(); entry.increment(error))
+		{
+			const auto file_name = entry->path().filename().string();
+
+			if (file_name.compare(0, reduced_prefix.size(), reduced_prefix) == 0)
+			{
+				std::filesystem::remove(entry->path(), error);
+				error.clear();
+			}
+		}
+	}
+
+	void TextureCache::WaitForBuilds()
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_idle_condition.wait(lock, [this]() { return m_building.empty(); });
+	}
+
+	TextureCacheStatistics TextureCache::GetStatistics() const
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		TextureCacheStatistics statistics;
+		statistics.m_hits = m_hits;
+		statistics.m_misses = m_misses;
+		statistics.m_builds_pending = m_building.size();
+		statistics.m_builds_completed = m_builds_completed;
+		statistics.m_builds_failed = m_builds_failed;
+
+		return statistics;
+	}
+
+	void TextureCache::BuildCopy(const std::string& source_path, const std::string& cache_path, TextureRole role)
+	{
+		bool skip = false;
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			skip = m_shutting_down;
+		}
+
+		bool success = false;
+
+		if (!skip)
+		{
+			// Written under a temporary name, a copy is only found once it is complete
+			const auto temporary_path = cache_path + ".tmp";
+			std::string build_error;
+			std::error_code error;
+
+			std::filesystem::create_directories(m_directory, error);
+
+			try
+			{
+				// Only a single decoded texture per background thread is in memory at a time
+				DecodedTexture texture;
+				success = m_decode(source_path, texture, build_error);
+
+				// The source file changed after the copy was queued, the new contents belong to another copy
+				success = success && GetCachePath(source_path, role) == cache_path;
+
+				if (success)
+				{
+					const auto format = SelectCompressedTextureFormat(role, HasTransparentPixels(texture));
+					success = m_build(texture, format, temporary_path, build_error);
+				}
+			}
+			catch (const std::exception&)
+			{
+				success = false;
+			}
+
+			if (success)
+			{
+				std::filesystem::rename(temporary_path, cache_path, error);
+				success = !error;
+			}
+
+			if (!success)
+			{
+				std::filesystem::remove(temporary_path, error);
+			}
+		}
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		if (success)
+		{
+			++m_builds_completed;
+		}
+		else if (!skip)
+		{
+			++m_builds_failed;
+		}
+
+		m_building.erase(cache_path);
+		m_idle_condition.notify_all();
+	}
+}
@@ -0,0 +1,130 @@
+// Copyright 2019 Breda University of Applied Sciences and Team Wisp (Viktor Zoutman, Emilio Laiso, Jens Hagen, Meine Zeinstra, Tahar Meijs, Koen Buitenhuis, Niels Brunekreef, Darius Bouma, Florian Schut)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+// Wisp plug-in
+#include "miscellaneous/thread_pool.hpp"
+#include "plugin/renderer/async_texture_loader.hpp"
+
+// C++ standard
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_set>
+
+//! Generic plug-in namespace (Wisp Maya Renderer)
+namespace wmr
+{
+	//! Pick the block compression of the cached copy of a texture
+	CompressedTextureFormat SelectCompressedTextureFormat(TextureRole role, bool has_transparent_pixels) noexcept;
+
+	//! Whether any pixel of a decoded texture has an alpha value below 255
+	bool HasTransparentPixels(const DecodedTexture& texture) noexcept;
+
+	//! Path the mip levels of a cached copy that start at a lower level are stored at, next to the cached copy
+	/*! Derived from the path of the cached copy, so it changes along with it when the source file is edited.
+	 *  \param first_mip Number of top levels left out, zero returns the path of the cached copy itself. */
+	std::string GetReducedCachePath(const std::string& cache_path, std::uint32_t first_mip);
+
+	//! Counters of the texture cache
+	struct TextureCacheStatistics
+	{
+		std::uint64_t m_hits = 0;				//!< Textures loaded from the cache
+		std::uint64_t m_misses = 0;				//!< Textures that had to be decoded from their source file
+		std::size_t m_builds_pending = 0;		//!< Cached copies that are queued or being built
+		std::uint64_t m_builds_completed = 0;	//!< Cached copies written since the cache was created
+		std::uint64_t m_builds_failed = 0;		//!< Cached copies that could not be built
+	};
+
+	//! Directory of block-compressed, mip-mapped copies of texture files
+	/*! A cached copy is identified by the path, modification time, and size of its source file, and by the role of the
+	 *  texture. Editing a source file therefore never loads an outdated copy. Copies are built on a background thread
+	 *  and written under a temporary name first, so a partially written copy is never found. The background threads
+	 *  decode the source files themselves, a queued copy only holds the path of its source file. Outdated copies are
+	 *  not deleted, clear the directory to reclaim the disk space. */
+	class TextureCache
+	{
+	public:
+		//! Compresses and mip-maps a texture into a DDS file, returns false and sets the error on failure
+		using BuildFunction = std::function<bool(const DecodedTexture& texture, CompressedTextureFormat format, const std::string& output_path, std::string& error)>;
+
+		//! Decodes a source file into 8-bit RGBA pixels, returns false and sets the error on failure
+		using DecodeFunction = std::function<bool(const std::string& source_path, DecodedTexture& texture, std::string& error)>;
+
+		//! \param directory Directory the cached copies are stored in, created when the first copy is built.
+		//! \param decode Called on the background threads for the source file of every copy.
+		//! \param build Called on the background threads for every copy.
+		//! \param max_pending_builds Number of copies that can be queued or being built at once.
+		//! \param thread_count Number of background threads building copies.
+		TextureCache(const std::string& directory, DecodeFunction decode, BuildFunction build, std::size_t max_pending_builds, std::size_t thread_count = 1);
+
+		//! Builds that have not started are skipped, the background threads finish their current copy
+		~TextureCache();
+
+		TextureCache(const TextureCache&) = delete;
+		TextureCache& operator=(const TextureCache&) = delete;
+
+		//! Path the cached copy of a texture is stored at
+		/*! \return Empty when the source file cannot be found. */
+		std::string GetCachePath(const std::string& source_path, TextureRole role) const;
+
+		//! Look up the cached copy of a texture, counts as a hit or a miss
+		/*! Thread-safe.
+		 *  \return Path of the cached copy, or nothing when it has not been built (yet). */
+		std::optional<std::string> Find(const std::string& source_path, TextureRole role);
+
+		//! Queue building the cached copy of a texture, the source file is decoded again on a background thread
+		/*! Thread-safe, does nothing when the copy is being built already or when the maximum number of copies is
+		 *  pending. A skipped copy is queued again the next time it is missed.
+		 *  \return Whether the copy was queued. */
+		bool Build(const std::string& source_path, TextureRole role);
+
+		//! Delete a cached copy that turned out to be unreadable, it is built again the next time it is missed
+		/*! The reduced copies stored next to it (GetReducedCachePath()) are deleted as well. */
+		void Invalidate(const std::string& cache_path);
+
+		//! Block until every queued copy has been built or skipped
+		void WaitForBuilds();
+
+		//! Hits, misses, and builds
+		TextureCacheStatistics GetStatistics() const;
+
+	private:
+		//! Build a single copy on a background thread
+		void BuildCopy(const std::string& source_path, const std::string& cache_path, TextureRole role);
+
+		std::filesystem::path m_directory;
+		DecodeFunction m_decode;
+		BuildFunction m_build;
+		std::size_t m_max_pending_builds;
+
+		mutable std::mutex m_mutex;						//!< Guards everything below
+		std::condition_variable m_idle_condition;		//!< Signalled when a build finished
+		std::unordered_set<std::string> m_building;		//!< Cache paths of the copies queued or being built
+		bool m_shutting_down;
+		std::uint64_t m_hits;
+		std::uint64_t m_misses;
+		std::uint64_t m_builds_completed;
+		std::uint64_t m_builds_failed;
+
+		//! Declared last, the workers are joined before the state above is destroyed
+		ThreadPool m_pool;
+	};
+}
@@ -0,0 +1,357 @@
+// Copyright 2019 Breda University of Applied Sciences and Team Wisp (Viktor Zoutman, Emilio Laiso, Jens Hagen, Meine Zeinstra, Tahar Meijs, Koen Buitenhuis, Niels Brunekreef, Darius Bouma, Florian Schut)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "texture_decoder.hpp"
+
+// Wisp plug-in
+#include "plugin/renderer/texture_residency.hpp"
+
+// DirectXTex (part of the Wisp rendering framework)
+#include <DirectXTex.h>
+
+// C++ standard
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <filesystem>
+#include <sstream>
+#include <thread>
+
+namespace wmr
+{
+	namespace
+	{
+		// WIC needs COM on every thread that decodes
+		bool InitializeCOM()
+		{
+			thread_local const bool initialized = SUCCEEDED(CoInitializeEx(nullptr, COINIT_MULTITHREADED));
+			return initialized;
+		}
+
+		std::string GetLowerCaseExtension(const std::filesystem::path& path)
+		{
+			auto extension = path.extension().string();
+			std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char character)
+			{
+				return static_cast<char>(std::tolower(character));
+			});
+
+			return extension;
+		}
+
+		DXGI_FORMAT GetDXGIFormat(CompressedTextureFormat format)
+		{
+			switch (format)
+			{
+			case CompressedTextureFormat::BC1:
+				return DXGI_FORMAT_BC1_UNORM;
+			case CompressedTextureFormat::BC3:
+				return DXGI_FORMAT_BC3_UNORM;
+			case CompressedTextureFormat::BC5:
+				return DXGI_FORMAT_BC5_UNORM;
+			case CompressedTextureFormat::BC7:
+			default:
+				return DXGI_FORMAT_BC7_UNORM;
+			}
+		}
+
+		std::optional<CompressedTextureFormat> GetCompressedTextureFormat(DXGI_FORMAT format)
+		{
+			switch (format)
+			{
+			case DXGI_FORMAT_BC1_UNORM:
+			case DXGI_FORMAT_BC1_UNORM_SRGB:
+				return CompressedTextureFormat::BC1;
+			case DXGI_FORMAT_BC3_UNORM:
+			case DXGI_FORMAT_BC3_UNORM_SRGB:
+				return CompressedTextureFormat::BC3;
+			case DXGI_FORMAT_BC5_UNORM:
+				return CompressedTextureFormat::BC5;
+			default:
+				// Every other block-compressed format uses 16 bytes per block, like BC7
+				return DirectX::IsCompressed(format) ? std::optional<CompressedTextureFormat>(CompressedTextureFormat::BC7) : std::nullopt;
+			}
+		}
+	}
+
+	bool DecodeTextureFile(const std::string& path, DecodedTexture& texture, std::string& error)
+	{
+		const std::filesystem::path file_path(path);
+		const auto extension = GetLowerCaseExtension(file_path);
+		const auto wide_path = file_path.wstring();
+
+		DirectX::TexMetadata metadata = {};
+		DirectX::ScratchImage image;
+		HRESULT result = S_OK;
+
+		if (extension == ".dds")
+		{
+			result = DirectX::LoadFromDDSFile(wide_path.c_str(), DirectX::DDS_FLAGS_NONE, &metadata, image);
+		}
+		else if (extension == ".tga")
+		{
+			result = DirectX::LoadFromTGAFile(wide_path.c_str(), &metadata, image);
+		}
+		else if (extension == ".hdr")
+		{
+			result = DirectX::LoadFromHDRFile(wide_path.c_str(), &metadata, image);
+		}
+		else
+		{
+			if (!InitializeCOM())
+			{
+				error = "COM could not be initialized on the texture loader thread";
+				return false;
+			}
+
+			result = DirectX::LoadFromWICFile(wide_path.c_str(), DirectX::WIC_FLAGS_NONE, &metadata, image);
+		}
+
+		if (FAILED(result))
+		{
+			error = "the file could not be decoded (HRESULT " + std::to_string(static_cast<long>(result)) + ")";
+			return false;
+		}
+
+		// Every texture is uploaded as 8-bit RGBA
+		const auto target_format = DXGI_FORMAT_R8G8B8A8_UNORM;
+
+		if (DirectX::IsCompressed(metadata.format))
+		{
+			DirectX::ScratchImage decompressed;
+			result = DirectX::Decompress(*image.GetImage(0, 0, 0), target_format, decompressed);
+			image = std::move(decompressed);
+		}
+		else if (metadata.format != target_format)
+		{
+			DirectX::ScratchImage converted;
+			result = DirectX::Convert(*image.GetImage(0, 0, 0), target_format, DirectX::TEX_FILTER_DEFAULT, DirectX::TEX_THRESHOLD_DEFAULT, converted);
+			image = std::move(converted);
+		}
+
+		if (FAILED(result))
+		{
+			error = "the pixel format could not be converted to 8-bit RGBA";
+			return false;
+		}
+
+		// Only the top mip level, the rows of the image can be padded
+		const auto* top_level = image.GetImage(0, 0, 0);
+		const auto row_size = static_cast<std::size_t>(top_level->width) * 4;
+
+		texture.m_width = static_cast<std::uint32_t>(top_level->width);
+		texture.m_height = static_cast<std::uint32_t>(top_level->height);
+		texture.m_pixels.resize(row_size * top_level->height);
+
+		for (std::size_t row = 0; row < top_level->height; ++row)
+		{
+			std::memcpy(texture.m_pixels.data() + row * row_size, top_level->pixels + row * top_level->rowPitch, row_size);
+		}
+
+		return true;
+	}
+
+	bool BuildCompressedTexture(const DecodedTexture& texture, CompressedTextureFormat format, const std::string& output_path, std::string& error)
+	{
+		if (texture.m_width == 0 || texture.m_height == 0 || texture.m_pixels.size() < static_cast<std::size_t>(texture.m_width) * texture.m_height * 4)
+		{
+			error = "the texture has no pixels";
+			return false;
+		}
+
+		DirectX::Image image = {};
+		image.width = texture.m_width;
+		image.height = texture.m_height;
+		image.format = DXGI_FORMAT_R8G8B8A8_UNORM;
+		image.rowPitch = static_cast<std::size_t>(texture.m_width) * 4;
+		image.slicePitch = image.rowPitch * texture.m_height;
+		image.pixels = const_cast<std::uint8_t*>(texture.m_pixels.data());
+
+		HRESULT result = S_OK;
+
+		// Block-compressed textures have to be a multiple of four pixels wide and high
+		const auto width = (image.width + 3) & ~static_cast<std::size_t>(3);
+		const auto height = (image.height + 3) & ~static_cast<std::size_t>(3);
+
+		DirectX::ScratchImage resized;
+		const DirectX::Image* top_level = &image;
+
+		if (width != image.width || height != image.height)
+		{
+			result = DirectX::Resize(image, width, height, DirectX::TEX_FILTER_DEFAULT, resized);
+
+			if (FAILED(result))
+			{
+				error = "the texture could not be resized to a multiple of four pixels";
+				return false;
+			}
+
+			top_level = resized.GetImage(0, 0, 0);
+		}
+
+		DirectX::ScratchImage mip_chain;
+		result = DirectX::GenerateMipMaps(*top_level, DirectX::TEX_FILTER_DEFAULT, 0, mip_chain);
+
+		if (FAILED(result))
+		{
+			error = "the mip chain could not be generated";
+			return false;
+		}
+
+		// The cache builds on a background thread already, compressing a single texture on more threads would compete
+		// with the texture loader
+		DirectX::ScratchImage compressed;
+		result = DirectX::Compress(mip_chain.GetImages(), mip_chain.GetImageCount(), mip_chain.GetMetadata(), GetDXGIFormat(format), DirectX::TEX_COMPRESS_DEFAULT, DirectX::TEX_THRESHOLD_DEFAULT, compressed);
+
+		if (FAILED(result))
+		{
+			error = "the texture could not be block-compressed";
+			return false;
+		}
+
+		const auto wide_path = std::filesystem::path(output_path).wstring();
+		result = DirectX::SaveToDDSFile(compressed.GetImages(), compressed.GetImageCount(), compressed.GetMetadata(), DirectX::DDS_FLAGS_NONE, wide_path.c_str());
+
+		if (FAILED(result))
+		{
+			error = "the DDS file could not be written (HRESULT " + std::to_string(static_cast<long>(result)) + ")";
+			return false;
+		}
+
+		return true;
+	}
+
+	bool LoadCachedTexture(const std::string& cache_path, std::uint32_t max_size, DecodedTexture& texture, std::string& error)
+	{
+		const auto wide_path = std::filesystem::path(cache_path).wstring();
+
+		DirectX::TexMetadata metadata = {};
+		HRESULT result = DirectX::GetMetadataFromDDSFile(wide_path.c_str(), DirectX::DDS_FLAGS_NONE, metadata);
+
+		if (FAILED(result) || metadata.dimension != DirectX::TEX_DIMENSION_TEXTURE2D)
+		{
+			error = "the cached copy could not be read";
+			return false;
+		}
+
+		const auto width = static_cast<std::uint32_t>(metadata.width);
+		const auto height = static_cast<std::uint32_t>(metadata.height);
+		const auto first_mip = SelectFirstMip(width, height, DirectX::IsCompressed(metadata.format), max_size, static_cast<std::uint32_t>(metadata.mipLevels));
+
+		texture.m_cached_path = cache_path;
+		texture.m_compressed_format = GetCompressedTextureFormat(metadata.format);
+		texture.m_mip_chain = (metadata.mipLevels > 1);
+		texture.m_first_mip = first_mip;
+		texture.m_width = std::max(width >> first_mip, 1u);
+		texture.m_height = std::max(height >> first_mip, 1u);
+
+		// The whole file is uploaded
+		if (first_mip == 0)
+		{
+			return true;
+		}
+
+		// The levels that fit are stored next to the cached copy, so they are uploaded from a file as well
+		const auto reduced_path = GetReducedCachePath(cache_path, first_mip);
+		texture.m_cached_path = reduced_path;
+
+		std::error_code file_error;
+
+		if (std::filesystem::is_regular_file(reduced_path, file_error))
+		{
+			return true;
+		}
+
+		DirectX::ScratchImage image;
+		result = DirectX::LoadFromDDSFile(wide_path.c_str(), DirectX::DDS_FLAGS_NONE, &metadata, image);
+
+		if (FAILED(result))
+		{
+			error = "the cached copy could not be read";
+			return false;
+		}
+
+		// A texture of the remaining levels, the images of a single 2D texture are stored in mip order
+		auto reduced_metadata = metadata;
+		reduced_metadata.width = texture.m_width;
+		reduced_metadata.height = texture.m_height;
+		reduced_metadata.mipLevels = metadata.mipLevels - first_mip;
+
+		// Written under a name of this thread first, another thread may be writing the same levels
+		std::ostringstream temporary_path;
+		temporary_path << reduced_path << '.' << std::this_thread::get_id() << ".tmp";
+
+		const auto wide_temporary_path = std::filesystem::path(temporary_path.str()).wstring();
+		result = DirectX::SaveToDDSFile(image.GetImages() + first_mip, reduced_metadata.mipLevels, reduced_metadata, DirectX::DDS_FLAGS_NONE, wide_temporary_path.c_str());
+
+		if (SUCCEEDED(result))
+		{
+			std::filesystem::rename(temporary_path.str(), reduced_path, file_error);
+		}
+
+		if (FAILED(result) || file_error)
+		{
+			std::filesystem::remove(temporary_path.str(), file_error);
+
+			// Another thread may have written the same levels first
+			if (!std::filesystem::is_regular_file(reduced_path, file_error))
+			{
+				error = "the mip levels of the cached copy could not be extracted";
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	bool ShrinkDecodedTexture(DecodedTexture& texture, std::uint32_t max_size, std::string& error)
+	{
+		const auto first_mip = SelectFirstMip(texture.m_width, texture.m_height, false, max_size, GetMipCount(texture.m_width, texture.m_height));
+
+		if (first_mip == 0)
+		{
+			return true;
+		}
+
+		DirectX::Image image = {};
+		image.width = texture.m_width;
+		image.height = texture.m_height;
+		image.format = DXGI_FORMAT_R8G8B8A8_UNORM;
+		image.rowPitch = static_cast<std::size_t>(texture.m_width) * 4;
+		image.slicePitch = image.rowPitch * texture.m_height;
+		image.pixels = texture.m_pixels.data();
+
+		const auto width = std::max(texture.m_width >> first_mip, 1u);
+		const auto height = std::max(texture.m_height >> first_mip, 1u);
+
+		DirectX::ScratchImage resized;
+		HRESULT result = DirectX::Resize(image, width, height, DirectX::TEX_FILTER_DEFAULT, resized);
+
+		if (FAILED(result))
+		{
+			error = "the texture could not be scaled down";
+			return false;
+		}
+
+		// Resized images are tightly packed
+		const auto* pixels = resized.GetImage(0, 0, 0)->pixels;
+		texture.m_pixels.assign(pixels, pixels + static_cast<std::size_t>(width) * height * 4);
+		texture.m_width = width;
+		texture.m_height = height;
+		texture.m_first_mip = first_mip;
+
+		return true;
+	}
+}
@@ -0,0 +1,55 @@
+// Copyright 2019 Breda University of Applied Sciences and Team Wisp (Viktor Zoutman, Emilio Laiso, Jens Hagen, Meine Zeinstra, Tahar Meijs, Koen Buitenhuis, Niels Brunekreef, Darius Bouma, Florian Schut)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+// Wisp plug-in
+#include "plugin/renderer/async_texture_loader.hpp"
+#include "plugin/renderer/texture_cache.hpp"
+
+// C++ standard
+#include <cstdint>
+#include <string>
+
+//! Generic plug-in namespace (Wisp Maya Renderer)
+namespace wmr
+{
+	//! Decode an image file (PNG, JPG, TIFF, BMP, TGA, HDR, or DDS) into 8-bit RGBA pixels
+	/*! Thread-safe, this is the decode function of the asynchronous texture loader. Block-compressed and floating point
+	 *  images are converted, so every texture is uploaded the same way.
+	 *
+	 *  /return False when the file cannot be decoded, the error describes why. */
+	bool DecodeTextureFile(const std::string& path, DecodedTexture& texture, std::string& error);
+
+	//! Write a block-compressed DDS file with a full mip chain of a decoded texture
+	/*! Thread-safe, this is the build function of the texture cache. Textures are resized to a multiple of four pixels
+	 *  first, as Direct3D 12 requires that of block-compressed textures.
+	 *
+	 *  /return False when the texture cannot be compressed or written, the error describes why. */
+	bool BuildCompressedTexture(const DecodedTexture& texture, CompressedTextureFormat format, const std::string& output_path, std::string& error);
+
+	//! Read the mip levels of a cached copy that fit in a maximum size
+	/*! Thread-safe. Only the header is read when every level fits, the texture is uploaded straight from the file in
+	 *  that case. Otherwise the levels that fit are written to a DDS file next to the cached copy the first time they
+	 *  are needed (GetReducedCachePath()), and the texture is uploaded from that file.
+	 *
+	 *  /param max_size Maximum width and height of the top level, zero keeps every level.
+	 *  /return False when the cached copy cannot be read, the error describes why. */
+	bool LoadCachedTexture(const std::string& cache_path, std::uint32_t max_size, DecodedTexture& texture, std::string& error);
+
+	//! Scale decoded pixels down to the first mip level that fits in a maximum size
+	/*! /return False when the pixels cannot be resized, the error describes why. */
+	bool ShrinkDecodedTexture(DecodedTexture& texture, std::uint32_t max_size, std::string& error);
+}
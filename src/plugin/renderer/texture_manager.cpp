@@ -16,6 +16,8 @@
 
 // Wisp plug-in
 #include "miscellaneous/functions.hpp"
+#include "miscellaneous/trace_recorder.hpp"
+#include "plugin/renderer/texture_decoder.hpp"
 #include "plugin/viewport_renderer_override.hpp"
 #include "renderer.hpp"
 #include "settings.hpp"
@@ -26,11 +28,65 @@
 
 // C++ standard
 #include <algorithm>
+#include <array>
+#include <filesystem>
+#include <optional>
+#include <thread>
 
 namespace wmr
 {
+	namespace
+	{
+		//! Decides how the cached copy of a material texture is compressed
+		TextureRole GetTextureRole(wr::TextureType type)
+		{
+			switch (type)
+			{
+			case wr::TextureType::NORMAL:
+				return TextureRole::NORMAL;
+			case wr::TextureType::ROUGHNESS:
+			case wr::TextureType::METALLIC:
+			case wr::TextureType::AO:
+				return TextureRole::DATA;
+			default:
+				return TextureRole::COLOR;
+			}
+		}
+
+		//! Every texture slot of a material
+		const constexpr std::array<wr::TextureType, 6> MATERIAL_TEXTURE_TYPES =
+		{
+			wr::TextureType::ALBEDO,
+			wr::TextureType::NORMAL,
+			wr::TextureType::ROUGHNESS,
+			wr::TextureType::METALLIC,
+			wr::TextureType::EMISSIVE,
+			wr::TextureType::AO
+		};
+
+		//! GPU memory layout of a loaded texture
+		TextureResidencyDesc GetResidencyDesc(const DecodedTexture& texture)
+		{
+			TextureResidencyDesc desc;
+			desc.m_width = texture.m_width << texture.m_first_mip;
+			desc.m_height = texture.m_height << texture.m_first_mip;
+			desc.m_format = texture.m_compressed_format;
+			desc.m_mip_chain = texture.m_mip_chain;
+
+			return desc;
+		}
+
+		bool IsValidTexture(const wr::TextureHandle& texture_handle)
+		{
+			return (texture_handle.m_pool != wr::TextureHandle().m_pool);
+		}
+	}
+
 	TextureManager::TextureManager(Renderer* renderer)
 		: m_renderer(*renderer)
+		, m_residency(static_cast<std::uint64_t>(settings::DEFAULT_TEXTURE_MEMORY_BUDGET_MB) * 1024 * 1024, settings::MIN_STREAMED_TEXTURE_SIZE)
+		, m_reloads_in_flight(0)
+		, m_residency_frame(0)
 	{}
 	
 	void TextureManager::Initialize() noexcept
@@ -44,35 +100,505 @@ namespace wmr
 		
 		// The default texture needs to be loaded at all times
 		m_default_texture = m_texture_pool->LoadFromFile("./resources/textures/wisp_default_skybox.png", false, false);
+
+		m_placeholder_texture = m_texture_pool->LoadFromFile(settings::PLACEHOLDER_TEXTURE_PATH, false, false);
+		m_placeholder_normal_texture = m_texture_pool->LoadFromFile(settings::PLACEHOLDER_NORMAL_TEXTURE_PATH, false, false);
+
+		// Compressed copies are built on a single thread, the textures are already shown while it is busy
+		m_texture_cache = std::make_unique<TextureCache>(settings::TEXTURE_CACHE_DIRECTORY, DecodeTextureFile, BuildCompressedTexture, settings::MAX_PENDING_TEXTURE_CACHE_BUILDS);
+
+		// Loads the cached copy of a texture when it has one, otherwise the source file is decoded and a cached copy is
+		// built for the next time
+		auto decode = [cache = m_texture_cache.get()](const TextureLoadRequest& request, DecodedTexture& texture, std::string& error)
+		{
+			if (auto cached_path = cache->Find(request.m_path, request.m_role))
+			{
+				if (LoadCachedTexture(*cached_path, request.m_max_size, texture, error))
+				{
+					return true;
+				}
+
+				// Unreadable, decode the source file and build the copy again
+				cache->Invalidate(*cached_path);
+				texture = DecodedTexture();
+			}
+
+			if (!DecodeTextureFile(request.m_path, texture, error))
+			{
+				return false;
+			}
+
+			// The cached copy keeps every level, even when this load leaves out the top levels. It decodes the source
+			// file again, so the pixels of this load are not held by the queue of the cache.
+			cache->Build(request.m_path, request.m_role);
+
+			return ShrinkDecodedTexture(texture, request.m_max_size, error);
+		};
+
+		// Half of the cores, the other half converts meshes while a scene is opened
+		m_texture_loader = std::make_unique<AsyncTextureLoader>(std::max(std::thread::hardware_concurrency() / 2, 1u), decode);
 	}
 
 	void TextureManager::Destroy() noexcept
 	{
+		// Skips the queued textures and waits for the textures that are being decoded, the loader uses the cache
+		m_texture_loader.reset();
+		m_texture_cache.reset();
+		m_pending_textures.clear();
+		m_reloads_in_flight = 0;
+
+		m_texture_container.clear();
+		m_texture_registry.Clear();
+		m_texture_usage.clear();
+		m_residency = TextureResidency(m_residency.GetStatistics().m_budget, settings::MIN_STREAMED_TEXTURE_SIZE);
+
 		m_texture_pool.reset();
 	}
 
 	const std::shared_ptr<wr::TextureHandle> TextureManager::CreateTexture(const char* path) noexcept
 	{
-		auto hash = func::HashCString(path);
+		auto canonical_path = CanonicalizeTexturePath(path);
 
 		// Does the texture exist?
-		auto it = std::find_if(m_texture_container.begin(), m_texture_container.end(), [&hash](const std::unordered_map<size_t, std::shared_ptr<wr::TextureHandle>>::value_type& vt) {
-			return (vt.first == hash);
-		});
+		if (auto texture = FindTexture(canonical_path))
+		{
+			return texture;
+		}
 
-		if (it == m_texture_container.end())
+		// Texture does not exist yet
+		wr::TextureHandle texture_handle = m_texture_pool->LoadFromFile(canonical_path, false, false);
+		// Return an invalid shared_ptr if the texture couldn't be loaded
+		if (texture_handle.m_pool == (wr::TextureHandle()).m_pool) {
+			return std::shared_ptr<wr::TextureHandle>(nullptr);
+		}
+
+		return AddTexture(canonical_path, texture_handle);
+	}
+
+	bool TextureManager::RequestTexture(const char* path, wr::Material& material, wr::TextureType type) noexcept
+	{
+		// The slot shows the newest request, even when an older request finishes later
+		RemovePendingBinding(material, type);
+
+		// Released once the slot shows something else, when this was the last slot it was bound to
+		std::optional<wr::TextureHandle> previous_texture;
+
+		if (material.HasTexture(type))
+		{
+			previous_texture = material.GetTexture(type);
+		}
+
+		UnbindTexture(material, type);
+
+		auto canonical_path = CanonicalizeTexturePath(path);
+
+		if (auto texture = FindTexture(canonical_path))
+		{
+			BindTexture(canonical_path, GetTextureRole(type), *texture, material, type);
+
+			if (previous_texture)
+			{
+				MarkTextureUnused(*previous_texture);
+			}
+
+			return true;
+		}
+
+		std::error_code error;
+		if (!std::filesystem::is_regular_file(canonical_path, error))
+		{
+			return false;
+		}
+
+		auto pending = m_pending_textures.find(canonical_path);
+
+		if (pending == m_pending_textures.end())
+		{
+			// Textures that exceed the memory budget leave out the levels the viewport cannot show
+			const auto max_size = m_residency.GetMaxNewTextureSize(GetOnScreenSize());
+			const auto role = GetTextureRole(type);
+
+			pending = m_pending_textures.emplace(canonical_path, PendingTexture{ m_texture_loader->Request(canonical_path, role, max_size), role, {} }).first;
+		}
+
+		pending->second.m_bindings.push_back({ &material, type });
+
+		material.SetTexture(type, (type == wr::TextureType::NORMAL) ? m_placeholder_normal_texture : m_placeholder_texture);
+
+		if (previous_texture)
 		{
-			wr::TextureHandle texture_handle;
-			// Texture does not exist yet
-			texture_handle = m_texture_pool->LoadFromFile(path, false, false);
-			// Return an invalid shared_ptr if the texture couldn't be loaded
-			if (texture_handle.m_pool == (wr::TextureHandle()).m_pool) {
-				return std::shared_ptr<wr::TextureHandle>(nullptr);
+			MarkTextureUnused(*previous_texture);
+		}
+
+		return true;
+	}
+
+	void TextureManager::ReleaseMaterial(wr::Material& material) noexcept
+	{
+		for (auto type : MATERIAL_TEXTURE_TYPES)
+		{
+			UnbindTexture(material, type);
+		}
+
+		for (auto pending = m_pending_textures.begin(); pending != m_pending_textures.end();)
+		{
+			auto& bindings = pending->second.m_bindings;
+
+			bindings.erase(std::remove_if(bindings.begin(), bindings.end(), [&material](const TextureBinding& binding)
+			{
+				return binding.m_material == &material;
+			}), bindings.end());
+
+			if (bindings.empty())
+			{
+				m_texture_loader->Cancel(pending->second.m_request_id);
+				pending = m_pending_textures.erase(pending);
+			}
+			else
+			{
+				++pending;
+			}
+		}
+	}
+
+	void TextureManager::RemovePendingBinding(const wr::Material& material, wr::TextureType type) noexcept
+	{
+		for (auto pending = m_pending_textures.begin(); pending != m_pending_textures.end(); ++pending)
+		{
+			auto& bindings = pending->second.m_bindings;
+
+			auto binding = std::find_if(bindings.begin(), bindings.end(), [&material, type](const TextureBinding& binding)
+			{
+				return (binding.m_material == &material && binding.m_type == type);
+			});
+
+			if (binding == bindings.end())
+			{
+				continue;
+			}
+
+			// A slot waits for a single texture at most
+			bindings.erase(binding);
+
+			if (bindings.empty())
+			{
+				m_texture_loader->Cancel(pending->second.m_request_id);
+				m_pending_textures.erase(pending);
+			}
+
+			return;
+		}
+	}
+
+	bool TextureManager::Update() noexcept
+	{
+		bool bound_texture = false;
+
+		if (!m_pending_textures.empty() || m_reloads_in_flight > 0)
+		{
+			auto results = m_texture_loader->CollectCompleted(settings::MAX_TEXTURE_UPLOADS_PER_FRAME);
+
+			if (!results.empty())
+			{
+				ScopedTraceEvent trace_event("TextureManager::Update", "renderer");
+
+				for (auto& result : results)
+				{
+					if (m_pending_textures.count(result.m_path) > 0)
+					{
+						bound_texture |= BindLoadedTexture(result);
+					}
+					else
+					{
+						bound_texture |= ApplyReload(result);
+					}
+				}
+			}
+		}
+
+		UpdateResidency();
+
+		return bound_texture;
+	}
+
+	bool TextureManager::BindLoadedTexture(TextureLoadResult& result) noexcept
+	{
+		auto pending = m_pending_textures.find(result.m_path);
+
+		// Cancelled while it was decoded
+		if (pending->second.m_request_id != result.m_request_id)
+		{
+			return false;
+		}
+
+		auto bindings = std::move(pending->second.m_bindings);
+		const auto role = pending->second.m_role;
+		m_pending_textures.erase(pending);
+
+		if (!result.m_success)
+		{
+			// The placeholder stays bound
+			LOGW("Failed to load texture \"{}\": {}.", result.m_path, result.m_error);
+			return false;
+		}
+
+		// The texture may have been loaded synchronously by CreateTexture() in the meantime
+		auto texture = FindTexture(result.m_path);
+		auto& decoded = result.m_texture;
+
+		if (!texture)
+		{
+			auto texture_handle = UploadTexture(decoded);
+
+			if (!IsValidTexture(texture_handle))
+			{
+				// The placeholder stays bound, the copy is built again the next time the texture is loaded
+				LOGW("Failed to upload texture \"{}\".", result.m_path);
+				return false;
 			}
-			m_texture_container[hash] = std::make_shared<wr::TextureHandle>(texture_handle);
+
+			texture = AddTexture(result.m_path, texture_handle);
+			m_residency.Add(result.m_path, GetResidencyDesc(decoded), decoded.m_first_mip, m_residency_frame);
+		}
+
+		for (const auto& binding : bindings)
+		{
+			BindTexture(result.m_path, role, *texture, *binding.m_material, binding.m_type);
+			binding.m_material->UpdateConstantBuffer();
+		}
+
+		if (decoded.m_cached_path.empty())
+		{
+			LOG("Loaded texture \"{}\" ({}x{}) in {:.1f} ms.", result.m_path, decoded.m_width, decoded.m_height, result.m_latency);
+		}
+		else
+		{
+			LOG("Loaded texture \"{}\" ({}x{}) from the texture cache in {:.1f} ms.", result.m_path, decoded.m_width, decoded.m_height, result.m_latency);
 		}
 
-		return m_texture_container[hash];
+		return true;
+	}
+
+	bool TextureManager::ApplyReload(TextureLoadResult& result) noexcept
+	{
+		auto usage = m_texture_usage.find(result.m_path);
+
+		// Unloaded while it was decoded
+		if (usage == m_texture_usage.end() || usage->second.m_reload_request_id != result.m_request_id)
+		{
+			return false;
+		}
+
+		usage->second.m_reload_request_id = 0;
+		--m_reloads_in_flight;
+
+		auto texture = FindTexture(result.m_path);
+		auto& decoded = result.m_texture;
+
+		wr::TextureHandle texture_handle;
+
+		if (result.m_success)
+		{
+			texture_handle = UploadTexture(decoded);
+		}
+
+		if (!texture || !IsValidTexture(texture_handle))
+		{
+			// The current levels stay resident
+			LOGW("Failed to change the resident mip levels of texture \"{}\".", result.m_path);
+			m_residency.CancelChange(result.m_path);
+			return false;
+		}
+
+		// Everyone holding the shared handle sees the new texture, only the ID changes
+		const auto old_texture_handle = *texture;
+		*texture = texture_handle;
+
+		m_texture_container.erase(old_texture_handle.m_id);
+		m_texture_container[texture_handle.m_id] = texture;
+		m_texture_registry.Remove(old_texture_handle.m_id);
+		m_texture_registry.Add(result.m_path, texture_handle.m_id);
+
+		for (const auto& binding : usage->second.m_bindings)
+		{
+			auto& material = *binding.m_material;
+
+			if (material.HasTexture(binding.m_type) && material.GetTexture(binding.m_type).m_id == old_texture_handle.m_id)
+			{
+				material.SetTexture(binding.m_type, texture_handle);
+				material.UpdateConstantBuffer();
+			}
+		}
+
+		m_texture_pool->MarkForUnload(old_texture_handle, m_renderer.GetFrameIndex());
+		m_residency.Reload(result.m_path, GetResidencyDesc(decoded), decoded.m_first_mip);
+
+		return true;
+	}
+
+	void TextureManager::UpdateResidency() noexcept
+	{
+		for (const auto& change : m_residency.Plan(GetOnScreenSize(), settings::MAX_TEXTURE_RESIDENCY_CHANGES_PER_FRAME))
+		{
+			auto usage = m_texture_usage.find(change.m_key);
+
+			if (usage == m_texture_usage.end() || usage->second.m_reload_request_id != 0)
+			{
+				m_residency.CancelChange(change.m_key);
+				continue;
+			}
+
+			usage->second.m_reload_request_id = m_texture_loader->Request(change.m_key, usage->second.m_role, change.m_max_size);
+			++m_reloads_in_flight;
+		}
+	}
+
+	void TextureManager::TouchMaterialTextures(const std::unordered_set<const wr::Material*>& materials) noexcept
+	{
+		// The frame index of the renderer is the index of a back buffer, it does not tell which frame is more recent
+		++m_residency_frame;
+
+		for (const auto& [path, usage] : m_texture_usage)
+		{
+			const auto drawn = std::any_of(usage.m_bindings.begin(), usage.m_bindings.end(), [&materials](const TextureBinding& binding)
+			{
+				return (materials.count(binding.m_material) > 0);
+			});
+
+			if (drawn)
+			{
+				m_residency.Touch(path, m_residency_frame);
+			}
+		}
+	}
+
+	bool TextureManager::HasPendingTextures() const noexcept
+	{
+		return (!m_pending_textures.empty() || m_reloads_in_flight > 0);
+	}
+
+	TextureLoaderStatistics TextureManager::GetTextureLoaderStatistics() const
+	{
+		return m_texture_loader ? m_texture_loader->GetStatistics() : TextureLoaderStatistics();
+	}
+
+	TextureCacheStatistics TextureManager::GetTextureCacheStatistics() const
+	{
+		return m_texture_cache ? m_texture_cache->GetStatistics() : TextureCacheStatistics();
+	}
+
+	void TextureManager::SetTextureMemoryBudget(std::uint64_t budget) noexcept
+	{
+		m_residency.SetBudget(budget);
+	}
+
+	TextureResidencyStatistics TextureManager::GetTextureResidencyStatistics() const noexcept
+	{
+		return m_residency.GetStatistics();
+	}
+
+	void TextureManager::BindTexture(const std::string& canonical_path, TextureRole role, const wr::TextureHandle& texture_handle, wr::Material& material, wr::TextureType type) noexcept
+	{
+		material.SetTexture(type, texture_handle);
+
+		auto& usage = m_texture_usage[canonical_path];
+
+		if (usage.m_bindings.empty())
+		{
+			usage.m_role = role;
+		}
+
+		usage.m_bindings.push_back({ &material, type });
+
+		// Counts as drawn until the renderer touches the textures of the drawn materials
+		m_residency.Touch(canonical_path, m_residency_frame);
+	}
+
+	void TextureManager::UnbindTexture(wr::Material& material, wr::TextureType type) noexcept
+	{
+		if (!material.HasTexture(type))
+		{
+			return;
+		}
+
+		// Placeholders are not registered
+		auto path = m_texture_registry.FindPath(material.GetTexture(type).m_id);
+
+		if (!path)
+		{
+			return;
+		}
+
+		auto usage = m_texture_usage.find(*path);
+
+		if (usage == m_texture_usage.end())
+		{
+			return;
+		}
+
+		auto& bindings = usage->second.m_bindings;
+		bindings.erase(std::remove_if(bindings.begin(), bindings.end(), [&material, type](const TextureBinding& binding)
+		{
+			return (binding.m_material == &material && binding.m_type == type);
+		}), bindings.end());
+	}
+
+	wr::TextureHandle TextureManager::UploadTexture(DecodedTexture& texture) noexcept
+	{
+		wr::TextureHandle texture_handle;
+
+		if (!texture.m_cached_path.empty())
+		{
+			// Already compressed and mip-mapped, reduced mip chains are stored as files of their own
+			texture_handle = m_texture_pool->LoadFromFile(texture.m_cached_path, false, false);
+		}
+		else
+		{
+			texture_handle = m_texture_pool->LoadFromMemory(reinterpret_cast<char*>(texture.m_pixels.data()), texture.m_width, texture.m_height, wr::TextureFormat::RAW, false, false);
+		}
+
+		if (!IsValidTexture(texture_handle) && !texture.m_cached_path.empty())
+		{
+			// Built again the next time the texture is loaded
+			m_texture_cache->Invalidate(texture.m_cached_path);
+		}
+
+		return texture_handle;
+	}
+
+	std::uint32_t TextureManager::GetOnScreenSize() const noexcept
+	{
+		auto viewport_override = dynamic_cast<const ViewportRendererOverride*>(MHWRender::MRenderer::theRenderer()->findRenderOverride(settings::VIEWPORT_OVERRIDE_NAME));
+
+		if (!viewport_override)
+		{
+			return 0;
+		}
+
+		const auto [width, height] = viewport_override->GetViewportSize();
+		return std::max(width, height);
+	}
+
+	std::shared_ptr<wr::TextureHandle> TextureManager::FindTexture(const std::string& canonical_path) const noexcept
+	{
+		auto id = m_texture_registry.FindID(canonical_path);
+
+		if (!id)
+		{
+			return nullptr;
+		}
+
+		return m_texture_container.at(*id);
+	}
+
+	std::shared_ptr<wr::TextureHandle> TextureManager::AddTexture(const std::string& canonical_path, const wr::TextureHandle& texture_handle)
+	{
+		auto texture = std::make_shared<wr::TextureHandle>(texture_handle);
+
+		m_texture_container[texture_handle.m_id] = texture;
+		m_texture_registry.Add(canonical_path, texture_handle.m_id);
+
+		return texture;
 	}
 
 	const wr::TextureHandle TextureManager::GetDefaultSkybox() const noexcept
@@ -83,9 +609,7 @@ namespace wmr
 	const std::shared_ptr<wr::TextureHandle> TextureManager::GetTexture(const wr::TextureHandle& texture_handle) noexcept
 	{
 		// Does the texture exist?
-		auto it = std::find_if(m_texture_container.begin(), m_texture_container.end(), [&texture_handle](const std::unordered_map<size_t, std::shared_ptr<wr::TextureHandle>>::value_type& vt) {
-			return (vt.second->m_id == texture_handle.m_id);
-		});
+		auto it = m_texture_container.find(texture_handle.m_id);
 
 		if (it == m_texture_container.end())
 		{
@@ -105,9 +629,7 @@ namespace wmr
 	bool TextureManager::MarkTextureUnused(const wr::TextureHandle& texture_handle) noexcept
 	{
 		// Does the texture exist?
-		auto it = std::find_if(m_texture_container.begin(), m_texture_container.end(), [&texture_handle](const std::unordered_map<size_t, std::shared_ptr<wr::TextureHandle>>::value_type& vt) {
-			return (vt.second->m_id == texture_handle.m_id);
-		});
+		auto it = m_texture_container.find(texture_handle.m_id);
 
 		if (it == m_texture_container.end())
 		{
@@ -118,11 +640,35 @@ namespace wmr
 		//// Find the current number of objects that use this texture
 		auto ref_count = it->second.use_count();
 
+		// Material slots hold the handle by value, they are counted separately
+		auto path = m_texture_registry.FindPath(it->first);
+		auto usage = path ? m_texture_usage.find(*path) : m_texture_usage.end();
+
+		if (usage != m_texture_usage.end() && !usage->second.m_bindings.empty())
+		{
+			return false;
+		}
+
 		if (ref_count == 1)
 		{
 			// Only reference left to this texture is the one that's in the unordered_map,
 			// so the texture can be deleted.
 			m_texture_pool->MarkForUnload(*it->second, m_renderer.GetFrameIndex());
+
+			if (usage != m_texture_usage.end())
+			{
+				// A reload that is in progress is dropped once it finishes
+				if (usage->second.m_reload_request_id != 0)
+				{
+					m_texture_loader->Cancel(usage->second.m_reload_request_id);
+					--m_reloads_in_flight;
+				}
+
+				m_residency.Remove(usage->first);
+				m_texture_usage.erase(usage);
+			}
+
+			m_texture_registry.Remove(it->first);
 			m_texture_container.erase(it);
 			
 			// Removed the texture from the texture pool
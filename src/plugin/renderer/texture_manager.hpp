@@ -14,12 +14,23 @@
 
 #pragma once
 
+// Wisp plug-in
+#include "plugin/renderer/async_texture_loader.hpp"
+#include "plugin/renderer/texture_cache.hpp"
+#include "plugin/renderer/texture_residency.hpp"
+#include "plugin/renderer/texture_registry.hpp"
+
 // Wisp rendering framework
+#include "material_pool.hpp"
 #include "structs.hpp"
 
 // C++ standard
+#include <cstdint>
 #include <memory>
+#include <string>
 #include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 #include <maya/MGlobal.h>
 
@@ -46,8 +57,52 @@ namespace wmr
 		void Destroy() noexcept;
 
 		//! Create a new texture
+		/*! Different spellings of the path to the same file share a single texture. Loads the file on the calling thread when the texture is not loaded yet, prefer RequestTexture() for
+		 *  material textures. */
 		const std::shared_ptr<wr::TextureHandle> CreateTexture(const char* path) noexcept;
 
+		//! Bind a texture to a material, the texture is decoded on a worker thread when it is not loaded yet
+		/*! The compressed copy from the texture cache is loaded instead of the file when there is one. A placeholder (white, or a flat normal map for normal textures) is bound until the texture has been decoded,
+		 *  Update() binds the texture once it is ready. A new request for the same material slot replaces the previous
+		 *  one.
+		 *
+		 *  /return False when the file does not exist, nothing is bound in that case. */
+		bool RequestTexture(const char* path, wr::Material& material, wr::TextureType type) noexcept;
+
+		//! Forget the texture slots of a material, call this before the material is destroyed
+		/*! Textures that are still loading are not bound to the material anymore, and textures that are loaded again
+		 *  with different mip levels are not swapped into it. */
+		void ReleaseMaterial(wr::Material& material) noexcept;
+
+		//! Upload the textures that finished decoding and bind them to the materials that requested them
+		/*! At most settings::MAX_TEXTURE_UPLOADS_PER_FRAME textures are uploaded per call. Textures are loaded again
+		 *  with fewer or more mip levels to keep them within the texture memory budget.
+		 *
+		 *  /return True when a texture was bound, the scene has to be rendered again. */
+		bool Update() noexcept;
+
+		//! Record that the textures bound to materials are drawn in the current frame
+		/*! Textures that have not been drawn for the longest time lose their top mip levels first when the textures
+		 *  exceed the texture memory budget. Call this every rendered frame with the materials of the visible models. */
+		void TouchMaterialTextures(const std::unordered_set<const wr::Material*>& materials) noexcept;
+
+		//! Whether textures are still being decoded or waiting for Update() to bind or swap them in
+		bool HasPendingTextures() const noexcept;
+
+		//! Queue depth and load latency of the background texture loading
+		TextureLoaderStatistics GetTextureLoaderStatistics() const;
+
+		//! Hits, misses, and builds of the on-disk cache of compressed textures
+		TextureCacheStatistics GetTextureCacheStatistics() const;
+
+		//! Change the GPU memory material textures should fit in, in bytes
+		/*! The top mip levels of the least recently used textures are dropped until the textures fit, and restored
+		 *  once there is room again. */
+		void SetTextureMemoryBudget(std::uint64_t budget) noexcept;
+
+		//! Budget use and eviction counts of the material textures
+		TextureResidencyStatistics GetTextureResidencyStatistics() const noexcept;
+
 		//! Get a texture handle to the fall-back texture
 		const wr::TextureHandle GetDefaultSkybox() const noexcept;
 
@@ -65,9 +120,70 @@ namespace wmr
 		bool MarkTextureUnused(const wr::TextureHandle& texture_handle) noexcept;
 
 	private:
-		//! Holds all texture handles of the texture manager
+		//! Material slot waiting for a texture
+		struct TextureBinding
+		{
+			wr::Material* m_material;
+			wr::TextureType m_type;
+		};
+
+		//! Texture that is being decoded, and the material slots it is bound to once it is ready
+		struct PendingTexture
+		{
+			std::uint64_t m_request_id;
+			TextureRole m_role;
+			std::vector<TextureBinding> m_bindings;
+		};
+
+		//! Material slots a loaded texture is bound to
+		struct TextureUsage
+		{
+			TextureRole m_role = TextureRole::COLOR;
+			std::uint64_t m_reload_request_id = 0;	//!< Load with different mip levels in progress, zero when there is none
+			std::vector<TextureBinding> m_bindings;
+		};
+
+		//! Remove a material slot from the pending textures, cancels textures that are not bound anywhere anymore
+		void RemovePendingBinding(const wr::Material& material, wr::TextureType type) noexcept;
+
+		//! Find a loaded texture by its path
+		/*! /param canonical_path Path returned by CanonicalizeTexturePath().
+		 *  /return Null when the texture is not loaded. */
+		std::shared_ptr<wr::TextureHandle> FindTexture(const std::string& canonical_path) const noexcept;
+
+		//! Add a loaded texture to the container and the registry
+		std::shared_ptr<wr::TextureHandle> AddTexture(const std::string& canonical_path, const wr::TextureHandle& texture_handle);
+
+		//! Bind a newly loaded texture to the material slots that requested it
+		/*! /return True when the texture was bound. */
+		bool BindLoadedTexture(TextureLoadResult& result) noexcept;
+
+		//! Swap a texture that was loaded again with different mip levels into its material slots
+		/*! /return True when the texture was swapped. */
+		bool ApplyReload(TextureLoadResult& result) noexcept;
+
+		//! Load textures again with fewer or more mip levels, as planned by the texture residency
+		void UpdateResidency() noexcept;
+
+		//! Bind a loaded texture to a material slot and remember the slot
+		void BindTexture(const std::string& canonical_path, TextureRole role, const wr::TextureHandle& texture_handle, wr::Material& material, wr::TextureType type) noexcept;
+
+		//! Forget the texture bound to a material slot, the texture stays bound
+		void UnbindTexture(wr::Material& material, wr::TextureType type) noexcept;
+
+		//! Upload a decoded texture to the texture pool
+		/*! /return An invalid handle when the upload failed. */
+		wr::TextureHandle UploadTexture(DecodedTexture& texture) noexcept;
+
+		//! Largest dimension of the viewport
+		std::uint32_t GetOnScreenSize() const noexcept;
+
+		//! Holds all texture handles of the texture manager, by texture ID
 		// Texture manager keeps refs and automatically gets rid of the texture once the ref count equals 1
-		std::unordered_map<size_t, std::shared_ptr<wr::TextureHandle>> m_texture_container;
+		std::unordered_map<std::uint64_t, std::shared_ptr<wr::TextureHandle>> m_texture_container;
+
+		//! Canonical path of every texture in the container, and the other way around
+		TextureRegistry m_texture_registry;
 
 		//! Default texture that can always be used (our Wisp skybox texture)
 		wr::TextureHandle m_default_texture;
@@ -77,5 +193,30 @@ namespace wmr
 
 		//! Wisp texture pool
 		std::shared_ptr<wr::TexturePool> m_texture_pool;
+
+		//! Bound to material slots while their textures are loading
+		wr::TextureHandle m_placeholder_texture;
+		wr::TextureHandle m_placeholder_normal_texture;
+
+		//! Block-compressed, mip-mapped copies of the texture files, used by the texture loader
+		std::unique_ptr<TextureCache> m_texture_cache;
+
+		//! Decodes texture files on worker threads
+		std::unique_ptr<AsyncTextureLoader> m_texture_loader;
+
+		//! Textures that are being decoded, by canonical path
+		std::unordered_map<std::string, PendingTexture> m_pending_textures;
+
+		//! Material slots of the loaded textures, by canonical path
+		std::unordered_map<std::string, TextureUsage, TexturePathHash> m_texture_usage;
+
+		//! Keeps the material textures within the texture memory budget
+		TextureResidency m_residency;
+
+		//! Number of textures that are being loaded again with different mip levels
+		std::size_t m_reloads_in_flight;
+
+		//! Frames in which the drawn textures were touched, the texture residency orders the textures by it
+		std::uint64_t m_residency_frame;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,154 @@
+// Copyright 2019 Breda University of Applied Sciences and Team Wisp (Viktor Zoutman, Emilio Laiso, Jens Hagen, Meine Zeinstra, Tahar Meijs, Koen Buitenhuis, Niels Brunekreef, Darius Bouma, Florian Schut)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "texture_registry.hpp"
+
+// C++ standard
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <filesystem>
+#include <system_error>
+
+namespace wmr
+{
+	std::uint64_t HashTexturePath(std::string_view path) noexcept
+	{
+		const std::uint64_t m = 0xc6a4a7935bd1e995ull;
+		const int r = 47;
+
+		std::uint64_t h = 0x8445d61a4e774912ull ^ (path.size() * m);
+
+		const auto block_count = path.size() / 8;
+
+		for (std::size_t i = 0; i < block_count; ++i)
+		{
+			std::uint64_t k;
+			std::memcpy(&k, path.data() + i * 8, sizeof(k));
+
+			k *= m;
+			k ^= k >> r;
+			k *= m;
+
+			h ^= k;
+			h *= m;
+		}
+
+		// Remaining bytes
+		const auto tail = path.data() + block_count * 8;
+		const auto tail_size = path.size() & 7;
+
+		if (tail_size > 0)
+		{
+			for (auto i = tail_size; i > 0; --i)
+			{
+				h ^= static_cast<std::uint64_t>(static_cast<unsigned char>(tail[i - 1])) << (8 * (i - 1));
+			}
+			h *= m;
+		}
+
+		h ^= h >> r;
+		h *= m;
+		h ^= h >> r;
+
+		return h;
+	}
+
+	std::size_t TexturePathHash::operator()(const std::string& path) const noexcept
+	{
+		return static_cast<std::size_t>(HashTexturePath(path));
+	}
+
+	std::string CanonicalizeTexturePath(const std::string& path)
+	{
+		std::error_code error;
+		auto absolute_path = std::filesystem::absolute(path, error);
+
+		if (error)
+		{
+			absolute_path = path;
+		}
+
+		auto canonical_path = std::filesystem::weakly_canonical(absolute_path, error);
+
+		if (error)
+		{
+			// Resolve the path without touching the file system
+			canonical_path = absolute_path.lexically_normal();
+		}
+
+		auto result = canonical_path.make_preferred().string();
+
+#if defined(_WIN32)
+		std::transform(result.begin(), result.end(), result.begin(), [](unsigned char c)
+		{
+			return static_cast<char>(std::tolower(c));
+		});
+#endif
+
+		return result;
+	}
+
+	bool TextureRegistry::Add(const std::string& canonical_path, std::uint64_t id)
+	{
+		if (m_ids.find(canonical_path) != m_ids.end() || m_paths.find(id) != m_paths.end())
+		{
+			return false;
+		}
+
+		m_ids.emplace(canonical_path, id);
+		m_paths.emplace(id, canonical_path);
+
+		return true;
+	}
+
+	bool TextureRegistry::Remove(std::uint64_t id)
+	{
+		auto path = m_paths.find(id);
+
+		if (path == m_paths.end())
+		{
+			return false;
+		}
+
+		m_ids.erase(path->second);
+		m_paths.erase(path);
+
+		return true;
+	}
+
+	const std::uint64_t* TextureRegistry::FindID(const std::string& canonical_path) const noexcept
+	{
+		auto id = m_ids.find(canonical_path);
+		return (id != m_ids.end()) ? &id->second : nullptr;
+	}
+
+	const std::string* TextureRegistry::FindPath(std::uint64_t id) const noexcept
+	{
+		auto path = m_paths.find(id);
+		return (path != m_paths.end()) ? &path->second : nullptr;
+	}
+
+	std::size_t TextureRegistry::GetSize() const noexcept
+	{
+		return m_ids.size();
+	}
+
+	void TextureRegistry::Clear() noexcept
+	{
+		m_ids.clear();
+		m_paths.clear();
+	}
+}
@@ -0,0 +1,83 @@
+// Copyright 2019 Breda University of Applied Sciences and Team Wisp (Viktor Zoutman, Emilio Laiso, Jens Hagen, Meine Zeinstra, Tahar Meijs, Koen Buitenhuis, Niels Brunekreef, Darius Bouma, Florian Schut)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+// C++ standard
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+//! Generic plug-in namespace (Wisp Maya Renderer)
+namespace wmr
+{
+	//! 64-bit hash of a texture path (MurmurHash64A)
+	/*! Only used to pick a bucket, lookups always compare the full path as well, so colliding paths never alias. */
+	std::uint64_t HashTexturePath(std::string_view path) noexcept;
+
+	//! Hash function for canonical texture paths
+	struct TexturePathHash
+	{
+		std::size_t operator()(const std::string& path) const noexcept;
+	};
+
+	//! Turn a texture path into the key it is registered under
+	/*! The path is made absolute, "." and ".." are resolved, symbolic links are followed when the file exists, and
+	 *  separators are made uniform. Paths are lowercased on Windows, as its file system is case-insensitive. Different
+	 *  spellings of the path to the same file therefore result in the same key. */
+	std::string CanonicalizeTexturePath(const std::string& path);
+
+	//! Two-way index between canonical texture paths and texture IDs
+	/*! Both directions are hash map lookups, so finding, adding, and removing a texture does not depend on the number of
+	 *  registered textures. */
+	class TextureRegistry
+	{
+	public:
+		TextureRegistry() = default;
+		~TextureRegistry() = default;
+
+		//! Register a texture
+		/*! \param canonical_path Path returned by CanonicalizeTexturePath().
+		 *  \return False when either the path or the ID is registered already, nothing changes in that case. */
+		bool Add(const std::string& canonical_path, std::uint64_t id);
+
+		//! Unregister a texture by its ID
+		/*! \return False when the ID is not registered. */
+		bool Remove(std::uint64_t id);
+
+		//! Find the ID of the texture registered under a path
+		/*! \return Null when no texture is registered under the path. */
+		const std::uint64_t* FindID(const std::string& canonical_path) const noexcept;
+
+		//! Find the path a texture is registered under
+		/*! \return Null when the ID is not registered. */
+		const std::string* FindPath(std::uint64_t id) const noexcept;
+
+		//! Number of registered textures
+		std::size_t GetSize() const noexcept;
+
+		//! Unregister all textures
+		void Clear() noexcept;
+
+	private:
+		//! Canonical path to texture ID
+		std::unordered_map<std::string, std::uint64_t, TexturePathHash> m_ids;
+
+		//! Texture ID to canonical path (reverse index)
+		std::unordered_map<std::uint64_t, std::string> m_paths;
+	};
+}
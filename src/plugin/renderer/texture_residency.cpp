@@ -0,0 +1,369 @@
+// Copyright 2019 Breda University of Applied Sciences and Team Wisp (Viktor Zoutman, Emilio Laiso, Jens Hagen, Meine Zeinstra, Tahar Meijs, Koen Buitenhuis, Niels Brunekreef, Darius Bouma, Florian Schut)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "texture_residency.hpp"
+
+// C++ standard
+#include <algorithm>
+
+namespace wmr
+{
+	std::uint32_t GetMipCount(std::uint32_t width, std::uint32_t height) noexcept
+	{
+		std::uint32_t mip_count = 1;
+
+		for (auto size = std::max(width, height); size > 1; size >>= 1)
+		{
+			++mip_count;
+		}
+
+		return mip_count;
+	}
+
+	std::uint64_t GetTextureMemorySize(const TextureResidencyDesc& desc, std::uint32_t first_mip) noexcept
+	{
+		const auto mip_count = GetMipCount(desc.m_width, desc.m_height);
+		first_mip = std::min(first_mip, mip_count - 1);
+
+		const auto last_mip = desc.m_mip_chain ? mip_count : first_mip + 1;
+		std::uint64_t size = 0;
+
+		for (auto mip = first_mip; mip < last_mip; ++mip)
+		{
+			const std::uint64_t width = std::max(desc.m_width >> mip, 1u);
+			const std::uint64_t height = std::max(desc.m_height >> mip, 1u);
+
+			if (!desc.m_format)
+			{
+				size += width * height * 4;
+				continue;
+			}
+
+			// 4x4 pixel blocks of 8 (BC1) or 16 bytes
+			const auto block_size = (*desc.m_format == CompressedTextureFormat::BC1) ? 8 : 16;
+			size += ((width + 3) / 4) * ((height + 3) / 4) * block_size;
+		}
+
+		return size;
+	}
+
+	std::uint32_t SelectFirstMip(std::uint32_t width, std::uint32_t height, bool compressed, std::uint32_t max_size, std::uint32_t mip_count) noexcept
+	{
+		std::uint32_t first_mip = 0;
+
+		for (std::uint32_t mip = 0; mip < mip_count; ++mip)
+		{
+			const auto mip_width = width >> mip;
+			const auto mip_height = height >> mip;
+
+			// Once a level is not a multiple of four, none of the levels below it are
+			if (mip > 0 && (mip_width == 0 || mip_height == 0 || (compressed && (mip_width % 4 != 0 || mip_height % 4 != 0))))
+			{
+				break;
+			}
+
+			first_mip = mip;
+
+			if (max_size == 0 || std::max(mip_width, mip_height) <= max_size)
+			{
+				break;
+			}
+		}
+
+		return first_mip;
+	}
+
+	TextureResidency::TextureResidency(std::uint64_t budget, std::uint32_t min_size)
+		: m_budget(budget)
+		, m_min_size(min_size)
+		, m_used(0)
+		, m_reduced_texture_count(0)
+		, m_evicted_mips(0)
+		, m_evicted_bytes(0)
+		, m_restorations(0)
+	{
+	}
+
+	void TextureResidency::SetBudget(std::uint64_t budget) noexcept
+	{
+		m_budget = budget;
+	}
+
+	void TextureResidency::Add(const std::string& key, const TextureResidencyDesc& desc, std::uint32_t first_mip, std::uint64_t frame)
+	{
+		Remove(key);
+
+		Texture texture;
+		texture.m_desc = desc;
+		texture.m_first_mip = first_mip;
+		texture.m_last_used_frame = frame;
+
+		m_used += GetTextureMemorySize(desc, first_mip);
+		m_reduced_texture_count += (first_mip > 0) ? 1 : 0;
+
+		m_textures.emplace(key, texture);
+	}
+
+	void TextureResidency::Remove(const std::string& key)
+	{
+		auto texture = m_textures.find(key);
+
+		if (texture == m_textures.end())
+		{
+			return;
+		}
+
+		m_used -= GetTextureMemorySize(texture->second.m_desc, texture->second.m_first_mip);
+		m_reduced_texture_count -= (texture->second.m_first_mip > 0) ? 1 : 0;
+
+		m_textures.erase(texture);
+	}
+
+	void TextureResidency::Touch(const std::string& key, std::uint64_t frame)
+	{
+		auto texture = m_textures.find(key);
+
+		if (texture != m_textures.end())
+		{
+			texture->second.m_last_used_frame = std::max(texture->second.m_last_used_frame, frame);
+		}
+	}
+
+	void TextureResidency::Reload(const std::string& key, const TextureResidencyDesc& desc, std::uint32_t first_mip)
+	{
+		auto texture = m_textures.find(key);
+
+		if (texture == m_textures.end())
+		{
+			return;
+		}
+
+		auto& entry = texture->second;
+		const auto old_size = GetTextureMemorySize(entry.m_desc, entry.m_first_mip);
+		const auto new_size = GetTextureMemorySize(desc, first_mip);
+
+		if (first_mip > entry.m_first_mip)
+		{
+			m_evicted_mips += first_mip - entry.m_first_mip;
+			m_evicted_bytes += (old_size > new_size) ? (old_size - new_size) : 0;
+		}
+		else if (first_mip < entry.m_first_mip)
+		{
+			++m_restorations;
+		}
+
+		m_reduced_texture_count -= (entry.m_first_mip > 0) ? 1 : 0;
+		m_reduced_texture_count += (first_mip > 0) ? 1 : 0;
+		m_used = m_used - old_size + new_size;
+
+		entry.m_desc = desc;
+		entry.m_first_mip = first_mip;
+		entry.m_planned_first_mip.reset();
+	}
+
+	void TextureResidency::CancelChange(const std::string& key)
+	{
+		auto texture = m_textures.find(key);
+
+		if (texture != m_textures.end())
+		{
+			texture->second.m_planned_first_mip.reset();
+		}
+	}
+
+	std::vector<TextureResidencyChange> TextureResidency::Plan(std::uint32_t on_screen_size, std::size_t max_changes)
+	{
+		std::vector<TextureResidencyChange> changes;
+
+		// Nothing to evict and nothing to restore
+		if (max_changes == 0 || (m_used <= m_budget && m_reduced_texture_count == 0))
+		{
+			return changes;
+		}
+
+		const auto on_screen_limit = GetOnScreenLimit(on_screen_size);
+
+		// Memory use once the changes in progress have been loaded
+		std::uint64_t expected = 0;
+
+		struct Candidate
+		{
+			const std::string* m_key;
+			Texture* m_texture;
+			std::uint32_t m_first_mip;
+		};
+
+		std::vector<Candidate> candidates;
+		candidates.reserve(m_textures.size());
+
+		for (auto& [key, texture] : m_textures)
+		{
+			expected += GetTextureMemorySize(texture.m_desc, texture.m_planned_first_mip.value_or(texture.m_first_mip));
+
+			if (!texture.m_planned_first_mip)
+			{
+				candidates.push_back({ &key, &texture, texture.m_first_mip });
+			}
+		}
+
+		// Least recently used first
+		std::sort(candidates.begin(), candidates.end(), [](const Candidate& lhs, const Candidate& rhs)
+		{
+			return lhs.m_texture->m_last_used_frame < rhs.m_texture->m_last_used_frame;
+		});
+
+		auto change_size = [&expected](const Candidate& candidate, std::uint32_t first_mip)
+		{
+			expected -= GetTextureMemorySize(candidate.m_texture->m_desc, candidate.m_first_mip);
+			expected += GetTextureMemorySize(candidate.m_texture->m_desc, first_mip);
+		};
+
+		if (expected > m_budget)
+		{
+			// Drop the levels the viewport cannot show first
+			for (auto& candidate : candidates)
+			{
+				if (expected <= m_budget)
+				{
+					break;
+				}
+
+				const auto first_mip = std::max(candidate.m_first_mip, GetOnScreenFirstMip(*candidate.m_texture, on_screen_limit));
+				change_size(candidate, first_mip);
+				candidate.m_first_mip = first_mip;
+			}
+
+			// Then drop visible levels, the textures that have not been used for the longest time first
+			for (auto& candidate : candidates)
+			{
+				const auto lowest_first_mip = GetLowestFirstMip(*candidate.m_texture);
+
+				while (expected > m_budget && candidate.m_first_mip < lowest_first_mip)
+				{
+					change_size(candidate, candidate.m_first_mip + 1);
+					++candidate.m_first_mip;
+				}
+			}
+		}
+		else
+		{
+			// Restore the most recently used textures while they fit, at full size or at the size the viewport can show
+			for (auto candidate = candidates.rbegin(); candidate != candidates.rend(); ++candidate)
+			{
+				const auto current_first_mip = candidate->m_first_mip;
+
+				for (auto first_mip : { 0u, GetOnScreenFirstMip(*candidate->m_texture, on_screen_limit) })
+				{
+					if (first_mip >= current_first_mip)
+					{
+						continue;
+					}
+
+					const auto growth = GetTextureMemorySize(candidate->m_texture->m_desc, first_mip) - GetTextureMemorySize(candidate->m_texture->m_desc, current_first_mip);
+
+					if (expected + growth <= m_budget)
+					{
+						expected += growth;
+						candidate->m_first_mip = first_mip;
+						break;
+					}
+				}
+			}
+		}
+
+		for (const auto& candidate : candidates)
+		{
+			if (changes.size() >= max_changes)
+			{
+				break;
+			}
+
+			auto& texture = *candidate.m_texture;
+
+			if (candidate.m_first_mip == texture.m_first_mip)
+			{
+				continue;
+			}
+
+			texture.m_planned_first_mip = candidate.m_first_mip;
+
+			const auto max_size = std::max(std::max(texture.m_desc.m_width, texture.m_desc.m_height) >> candidate.m_first_mip, 1u);
+			changes.push_back({ *candidate.m_key, candidate.m_first_mip, max_size });
+		}
+
+		return changes;
+	}
+
+	std::uint32_t TextureResidency::GetMaxNewTextureSize(std::uint32_t on_screen_size) const noexcept
+	{
+		if (m_used < m_budget)
+		{
+			return 0;
+		}
+
+		return std::max(GetOnScreenLimit(on_screen_size), m_min_size);
+	}
+
+	TextureResidencyStatistics TextureResidency::GetStatistics() const noexcept
+	{
+		TextureResidencyStatistics statistics;
+		statistics.m_budget = m_budget;
+		statistics.m_used = m_used;
+		statistics.m_texture_count = m_textures.size();
+		statistics.m_reduced_texture_count = m_reduced_texture_count;
+		statistics.m_evicted_mips = m_evicted_mips;
+		statistics.m_evicted_bytes = m_evicted_bytes;
+		statistics.m_restorations = m_restorations;
+
+		return statistics;
+	}
+
+	std::uint32_t TextureResidency::GetOnScreenLimit(std::uint32_t on_screen_size) noexcept
+	{
+		if (on_screen_size == 0)
+		{
+			return 0;
+		}
+
+		// A power of two, so square power-of-two textures keep the level that matches the viewport
+		std::uint32_t limit = 1;
+
+		while (limit < on_screen_size && limit < (1u << 31))
+		{
+			limit <<= 1;
+		}
+
+		return limit;
+	}
+
+	std::uint32_t TextureResidency::GetLowestFirstMip(const Texture& texture) const noexcept
+	{
+		const auto& desc = texture.m_desc;
+		return SelectFirstMip(desc.m_width, desc.m_height, desc.m_format.has_value(), m_min_size, GetMipCount(desc.m_width, desc.m_height));
+	}
+
+	std::uint32_t TextureResidency::GetOnScreenFirstMip(const Texture& texture, std::uint32_t on_screen_limit) const noexcept
+	{
+		if (on_screen_limit == 0)
+		{
+			return 0;
+		}
+
+		const auto& desc = texture.m_desc;
+		const auto first_mip = SelectFirstMip(desc.m_width, desc.m_height, desc.m_format.has_value(), on_screen_limit, GetMipCount(desc.m_width, desc.m_height));
+
+		return std::min(first_mip, GetLowestFirstMip(texture));
+	}
+}
@@ -0,0 +1,151 @@
+// Copyright 2019 Breda University of Applied Sciences and Team Wisp (Viktor Zoutman, Emilio Laiso, Jens Hagen, Meine Zeinstra, Tahar Meijs, Koen Buitenhuis, Niels Brunekreef, Darius Bouma, Florian Schut)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+// Wisp plug-in
+#include "plugin/renderer/texture_cache.hpp"
+#include "plugin/renderer/texture_registry.hpp"
+
+// C++ standard
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+//! Generic plug-in namespace (Wisp Maya Renderer)
+namespace wmr
+{
+	//! Layout of a texture in GPU memory
+	struct TextureResidencyDesc
+	{
+		std::uint32_t m_width = 0;								//!< Width of mip level zero
+		std::uint32_t m_height = 0;								//!< Height of mip level zero
+		std::optional<CompressedTextureFormat> m_format;		//!< Block compression, 8-bit RGBA when empty
+		bool m_mip_chain = false;								//!< Whether the levels below the top level are resident as well
+	};
+
+	//! Number of mip levels of a full mip chain
+	std::uint32_t GetMipCount(std::uint32_t width, std::uint32_t height) noexcept;
+
+	//! GPU memory used by a texture in bytes, when the first mip levels are not resident
+	std::uint64_t GetTextureMemorySize(const TextureResidencyDesc& desc, std::uint32_t first_mip) noexcept;
+
+	//! Pick the first resident mip level of a texture that has to fit in a maximum size
+	/*! Block-compressed textures can only start at a level that is a multiple of four pixels wide and high, as Direct3D
+	 *  12 requires that of the top level of a block-compressed texture.
+	 *
+	 *  \param max_size Maximum width and height of the top level, zero keeps every level.
+	 *  \param mip_count Number of available mip levels.
+	 *  \return The first level that fits, or the smallest level that can be the top level when none fits. */
+	std::uint32_t SelectFirstMip(std::uint32_t width, std::uint32_t height, bool compressed, std::uint32_t max_size, std::uint32_t mip_count) noexcept;
+
+	//! Texture that has to be loaded again with a different number of top mip levels left out
+	struct TextureResidencyChange
+	{
+		std::string m_key;
+		std::uint32_t m_first_mip = 0;		//!< First mip level that should be resident
+		std::uint32_t m_max_size = 0;		//!< Maximum width and height of the new top level
+	};
+
+	//! Memory use of the tracked textures
+	struct TextureResidencyStatistics
+	{
+		std::uint64_t m_budget = 0;					//!< Bytes the textures should fit in
+		std::uint64_t m_used = 0;					//!< Bytes used by the resident mip levels
+		std::size_t m_texture_count = 0;			//!< Tracked textures
+		std::size_t m_reduced_texture_count = 0;	//!< Textures of which the top mip levels are not resident
+		std::uint64_t m_evicted_mips = 0;			//!< Top mip levels dropped to stay within the budget
+		std::uint64_t m_evicted_bytes = 0;			//!< Bytes freed by dropping top mip levels
+		std::uint64_t m_restorations = 0;			//!< Textures of which dropped levels were loaded again
+	};
+
+	//! Keeps the resident mip levels of textures within a memory budget
+	/*! Textures are identified by a key (their canonical path). Every texture remembers the frame it was last used in.
+	 *  While the textures exceed the budget, Plan() drops top mip levels, first of textures that are larger than the
+	 *  viewport, then of the least recently used textures, down to a minimum size. Once there is room again, the
+	 *  dropped levels of the most recently used textures are restored. Dropping and restoring levels means loading the
+	 *  texture again, the owner reports the outcome through Reload() or CancelChange(). */
+	class TextureResidency
+	{
+	public:
+		//! \param budget Bytes the textures should fit in.
+		//! \param min_size Levels are never dropped below this width or height.
+		TextureResidency(std::uint64_t budget, std::uint32_t min_size);
+		~TextureResidency() = default;
+
+		//! Change the memory budget, the next Plan() evicts or restores levels to match
+		void SetBudget(std::uint64_t budget) noexcept;
+
+		//! Start tracking a texture that has just been loaded
+		void Add(const std::string& key, const TextureResidencyDesc& desc, std::uint32_t first_mip, std::uint64_t frame);
+
+		//! Stop tracking a texture that has been unloaded
+		void Remove(const std::string& key);
+
+		//! Record that a texture is used in a frame
+		void Touch(const std::string& key, std::uint64_t frame);
+
+		//! Record that a texture has been loaded again after a change of Plan()
+		/*! Counts as an eviction when fewer levels are resident than before, and as a restoration when more are. */
+		void Reload(const std::string& key, const TextureResidencyDesc& desc, std::uint32_t first_mip);
+
+		//! Forget a planned change that could not be loaded, the texture can be planned again
+		void CancelChange(const std::string& key);
+
+		//! Decide which textures to load again with fewer or more mip levels
+		/*! Textures with a change in progress are skipped and count at their planned size.
+		 *
+		 *  \param on_screen_size Largest dimension of the viewport, textures are never restored beyond it.
+		 *  \param max_changes Maximum number of changes returned, the rest is planned by the next call. */
+		std::vector<TextureResidencyChange> Plan(std::uint32_t on_screen_size, std::size_t max_changes);
+
+		//! Maximum size to load a new texture at, so it does not push the textures further over the budget
+		/*! \return Zero when the textures are within the budget, the full texture can be loaded in that case. */
+		std::uint32_t GetMaxNewTextureSize(std::uint32_t on_screen_size) const noexcept;
+
+		//! Budget use and eviction counts
+		TextureResidencyStatistics GetStatistics() const noexcept;
+
+	private:
+		struct Texture
+		{
+			TextureResidencyDesc m_desc;
+			std::uint32_t m_first_mip = 0;
+			std::optional<std::uint32_t> m_planned_first_mip;	//!< Change that is being loaded
+			std::uint64_t m_last_used_frame = 0;
+		};
+
+		//! Smallest texture size that keeps every level needed to fill the viewport, zero when there is no viewport
+		static std::uint32_t GetOnScreenLimit(std::uint32_t on_screen_size) noexcept;
+
+		//! Lowest level the texture may drop to (its smallest allowed top level)
+		std::uint32_t GetLowestFirstMip(const Texture& texture) const noexcept;
+
+		//! Level that keeps the texture within the on-screen limit, never below the lowest allowed level
+		std::uint32_t GetOnScreenFirstMip(const Texture& texture, std::uint32_t on_screen_limit) const noexcept;
+
+		std::unordered_map<std::string, Texture, TexturePathHash> m_textures;
+		std::uint64_t m_budget;
+		std::uint32_t m_min_size;
+		std::uint64_t m_used;
+		std::size_t m_reduced_texture_count;
+		std::uint64_t m_evicted_mips;
+		std::uint64_t m_evicted_bytes;
+		std::uint64_t m_restorations;
+	};
+}
@@ -18,6 +18,7 @@
 #include "framegraph/frame_graph_manager.hpp"
 #include "miscellaneous/functions.hpp"
 #include "miscellaneous/settings.hpp"
+#include "miscellaneous/trace_recorder.hpp"
 #include "parsers/camera_parser.hpp"
 #include "parsers/scene_graph_parser.hpp"
 #include "render_operations/gizmo_render_operation.hpp"
@@ -25,6 +26,7 @@
 #include "render_operations/renderer_draw_operation.hpp"
 #include "render_operations/renderer_update_operation.hpp"
 #include "render_operations/screen_render_operation.hpp"
+#include "render_operations/timing_hud_render_operation.hpp"
 #include "renderer/renderer.hpp"
 #include "miscellaneous/maya_popup.hpp"
 
@@ -77,6 +79,9 @@ namespace wmr
 		, m_current_render_operation(-1)
 		, m_viewport_width(1)
 		, m_viewport_height(1)
+		, m_resized_viewport_size(0, 0)
+		, m_pending_viewport_size(0, 0)
+		, m_is_resize_pending(false)
 		, m_is_initialized(false)
 	{
 		LOG("Starting viewport renderer override initialization.");
@@ -140,7 +145,7 @@ namespace wmr
 			m_render_operations[2] = std::make_unique<RendererCopyOperation>	(settings::RENDER_OPERATION_NAMES[2], *screen_render_operation );
 			m_render_operations[3] = std::move(screen_render_operation);
 			m_render_operations[4] = std::make_unique<GizmoRenderOperation>		(settings::RENDER_OPERATION_NAMES[4]);
-			m_render_operations[5] = std::make_unique<MHWRender::MHUDRender>	();
+			m_render_operations[5] = std::make_unique<TimingHUDRenderOperation>	();
 			m_render_operations[6] = std::make_unique<MHWRender::MPresentTarget>(settings::RENDER_OPERATION_NAMES[5]);
 		}
 	}
@@ -185,12 +190,26 @@ namespace wmr
 
 	MStatus ViewportRendererOverride::setup(const MString& destination)
 	{
+		m_frame_start_time = std::chrono::steady_clock::now();
+
+		ScopedTraceEvent trace_event("ViewportRendererOverride::setup", "render operation");
+
+		auto& profiler = m_renderer->GetProfiler();
+
 		// Update the viewport camera(s)
-		m_scenegraph_parser->Update();
-		m_scenegraph_parser->GetCameraParser().UpdateViewportCamera(destination);
+		{
+			ScopedCPUTimer timer(profiler, "cpu/parser update");
+
+			m_scenegraph_parser->Update();
+			m_scenegraph_parser->GetCameraParser().UpdateViewportCamera(destination);
+		}
 
 		// Check if the viewport has been resized
-		HandleViewportResize(destination);
+		{
+			ScopedCPUTimer timer(profiler, "cpu/viewport resize");
+
+			HandleViewportResize(destination);
+		}
 
 		auto* const maya_renderer = MHWRender::MRenderer::theRenderer();
 
@@ -247,13 +266,44 @@ namespace wmr
 		// Size of the current frame graph
 		const auto current_frame_graph_size = m_renderer->GetFrameGraph().GetCurrentDimensions();
 
-		// Wisp <==> Maya viewport resolutions do not match
-		if ((current_frame_graph_size.first != m_viewport_width) ||
-			(current_frame_graph_size.second != m_viewport_height))
+		// The dynamic resolution renders at a fraction of the viewport size, the blit operation upscales the result
+		const auto render_size = ScaleResolution(m_viewport_width, m_viewport_height, m_renderer->GetRenderScale());
+
+		// Wisp <==> Maya viewport resolutions match
+		if (current_frame_graph_size == render_size)
 		{
-			// Resize the frame graph
-			m_renderer->GetFrameGraph().Resize(m_viewport_width, m_viewport_height, m_renderer->GetD3D12Renderer());
+			m_is_resize_pending = false;
+			return;
 		}
+
+		const std::pair<std::uint32_t, std::uint32_t> viewport_size(m_viewport_width, m_viewport_height);
+		const auto now = std::chrono::steady_clock::now();
+
+		// Apply the very first size and render scale changes right away, only the viewport size is debounced
+		if (m_resized_viewport_size != std::pair<std::uint32_t, std::uint32_t>(0, 0) && viewport_size != m_resized_viewport_size)
+		{
+			if (!m_is_resize_pending || viewport_size != m_pending_viewport_size)
+			{
+				// The viewport is (still) being resized, restart the interval
+				m_pending_viewport_size = viewport_size;
+				m_pending_viewport_size_time = now;
+				m_is_resize_pending = true;
+				return;
+			}
+
+			if (now - m_pending_viewport_size_time < std::chrono::milliseconds(settings::VIEWPORT_RESIZE_DEBOUNCE_INTERVAL_MS))
+			{
+				return;
+			}
+		}
+
+		// Resize the frame graph
+		m_renderer->GetFrameGraph().Resize(render_size.first, render_size.second, m_renderer->GetD3D12Renderer());
+		m_resized_viewport_size = viewport_size;
+		m_is_resize_pending = false;
+
+		// The last frame was rendered at the old size
+		m_renderer->MarkSceneChanged();
 	}
 
 	bool ViewportRendererOverride::AreAllRenderOperationsSetCorrectly() const
@@ -274,6 +324,19 @@ namespace wmr
 	MStatus ViewportRendererOverride::cleanup()
 	{
 		m_current_render_operation = -1;
+
+		// CPU time of the entire refresh, from setup() up to here
+		const std::chrono::duration<double, std::milli> frame_time = std::chrono::steady_clock::now() - m_frame_start_time;
+		m_renderer->GetProfiler().AddSample("cpu/viewport frame", frame_time.count());
+
+		// Maya stops refreshing once the scene stops changing, the frames still in flight have to reach the viewport and
+		// a pending resize has to be applied once the debounce interval passed, and textures still being decoded have to
+		// be swapped in once they are ready
+		if (m_renderer->RequiresRefresh() || m_is_resize_pending || m_renderer->GetTextureManager().HasPendingTextures())
+		{
+			M3dView::scheduleRefreshAllViews();
+		}
+
 		return MStatus::kSuccess;
 	}
 
@@ -22,7 +22,9 @@
 
 // C++ standard
 #include <array>
+#include <chrono>
 #include <memory>
+#include <utility>
 
 //! Wisp rendering framework namespace (Wisp Renderer)
 namespace wr
@@ -131,7 +133,12 @@ namespace wmr
 		MStatus setup(const MString& destination) override;
 
 		//! Updates application state when viewport has been resized
-		/*! /param panel_name The name of the current viewport panel function. */
+		/*! A new viewport size is only applied to the frame graphs once it stayed the same for
+		 *  settings::VIEWPORT_RESIZE_DEBOUNCE_INTERVAL_MS, so dragging a panel does not resize the frame graphs every
+		 *  refresh. Until then the renderer keeps rendering at the old size. A render scale change of the dynamic
+		 *  resolution is applied right away.
+		 *
+		 *  /param panel_name The name of the current viewport panel function. */
 		void HandleViewportResize(const MString& panel_name) noexcept;
 
 		//! A simple check that checks whether all render operations are valid (no nullptr)
@@ -170,6 +177,13 @@ namespace wmr
 		uint32_t m_viewport_width;
 		uint32_t m_viewport_height;
 
+		std::pair<std::uint32_t, std::uint32_t> m_resized_viewport_size; //!< Viewport size the frame graphs were last resized for
+		std::pair<std::uint32_t, std::uint32_t> m_pending_viewport_size; //!< Viewport size waiting for the debounce interval
+		std::chrono::steady_clock::time_point m_pending_viewport_size_time; //!< Time the pending viewport size was first seen
+		bool m_is_resize_pending; //!< The viewport size differs from the size of the frame graphs
+
+		std::chrono::steady_clock::time_point m_frame_start_time; //!< Time setup() was called for the current refresh
+
 		bool m_is_initialized;
 	};
 }
\ No newline at end of file
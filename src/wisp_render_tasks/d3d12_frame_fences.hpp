@@ -0,0 +1,72 @@
+// Copyright 2019 Breda University of Applied Sciences and Team Wisp (Viktor Zoutman, Emilio Laiso, Jens Hagen, Meine Zeinstra, Tahar Meijs, Koen Buitenhuis, Niels Brunekreef, Darius Bouma, Florian Schut)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include "d3d12/d3d12_defines.hpp"
+#include "d3d12/d3d12_renderer.hpp"
+#include "d3d12/d3d12_settings.hpp"
+
+#include "readback_ring.hpp"
+
+namespace wr
+{
+	namespace internal
+	{
+		//! Fence signal at the end of the last frame that was submitted
+		/*! Only valid between two calls to D3D12RenderSystem::Render(). Wisp has one fence per frame index, it raises
+		 *  the value of a fence when it starts a frame on that index and signals the new value at the end of the frame.
+		 *  Between frames, the fence of the previous frame index therefore holds the value of the last submission. The
+		 *  GPU executes the frames in submission order, so every earlier frame has finished once this signal arrives. */
+		inline ReadbackFence GetLastSubmittedFrameFence(D3D12RenderSystem& render_system)
+		{
+			const auto back_buffer_count = d3d12::settings::num_back_buffers;
+			const auto frame_index = static_cast<std::uint32_t>((render_system.GetFrameIdx() + back_buffer_count - 1) % back_buffer_count);
+
+			return { frame_index, render_system.m_fences[frame_index]->m_fence_value };
+		}
+
+		//! Fence signal at the end of the last frame that used a frame index
+		/*! Only valid between two calls to D3D12RenderSystem::Render(), see GetLastSubmittedFrameFence(). */
+		inline ReadbackFence GetLastFrameFence(D3D12RenderSystem& render_system, std::uint32_t frame_index)
+		{
+			return { frame_index, render_system.m_fences[frame_index]->m_fence_value };
+		}
+
+		//! Whether the GPU reached a fence signal
+		inline bool IsFrameFenceComplete(D3D12RenderSystem& render_system, const ReadbackFence& fence)
+		{
+			return render_system.m_fences[fence.m_fence_index]->m_native->GetCompletedValue() >= fence.m_value;
+		}
+
+		//! Block until the GPU reached a fence signal
+		/*! Unlike d3d12::WaitFor(), the fence value is left alone. Wisp pairs every WaitFor() with a Signal() of the
+		 *  raised value, waiting on a fence of Wisp from the outside has to keep that bookkeeping intact. */
+		inline void WaitForFrameFence(D3D12RenderSystem& render_system, const ReadbackFence& fence)
+		{
+			if (IsFrameFenceComplete(render_system, fence))
+			{
+				return;
+			}
+
+			auto event = CreateEventW(nullptr, FALSE, FALSE, nullptr);
+
+			TRY_M(render_system.m_fences[fence.m_fence_index]->m_native->SetEventOnCompletion(fence.m_value, event), "Failed to set a fence event.");
+			WaitForSingleObject(event, INFINITE);
+
+			CloseHandle(event);
+		}
+	} /* internal */
+} /* wr */
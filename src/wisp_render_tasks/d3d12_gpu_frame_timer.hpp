@@ -0,0 +1,262 @@
+// Copyright 2019 Breda University of Applied Sciences and Team Wisp (Viktor Zoutman, Emilio Laiso, Jens Hagen, Meine Zeinstra, Tahar Meijs, Koen Buitenhuis, Niels Brunekreef, Darius Bouma, Florian Schut)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include "d3d12/d3d12_enums.hpp"
+#include "d3d12/d3d12_defines.hpp"
+#include "d3d12/d3d12_functions.hpp"
+#include "d3d12/d3d12_renderer.hpp"
+#include "d3d12/d3d12_structs.hpp"
+#include "frame_graph/frame_graph.hpp"
+
+#include "d3d12_readback_ring.hpp"
+
+// C++ standard
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace wr
+{
+	// Shared by the timer tasks of a frame graph, the owner of the frame graph reads the measured times
+	struct GPUFrameTimerData
+	{
+		// Set by the owner before the frame graph is set up: name of the frame graph, and the names of the sections
+		// between the timestamp tasks. Without sections only the entire frame is measured.
+		std::string name;
+		std::vector<std::string> section_names;
+
+		// Timestamps of a frame: the begin, one between every two sections, and the end
+		std::uint32_t timestamps_per_frame = 2;
+
+		// One set of timestamps per readback slot
+		ID3D12QueryHeap* query_heap = nullptr;
+		d3d12::ReadbackBufferResource* readback_buffer = nullptr;
+		const std::uint64_t* timestamps = nullptr;
+
+		// Decides which pair of timestamps is written and which one is read
+		ReadbackRing readback_ring = ReadbackRing(internal::READBACK_SLOT_COUNT);
+		std::uint32_t write_slot = 0;
+		std::optional<std::uint32_t> last_read_slot;
+
+		// Ticks per second of the direct queue
+		std::uint64_t timestamp_frequency = 1;
+
+		// GPU time of the newest completed frame and of its sections in milliseconds, and the number of frames measured
+		double frame_time = 0.0;
+		std::vector<double> section_times;
+		std::uint64_t measured_frame_count = 0;
+	};
+
+	// The timer tasks keep their state in the shared timer data
+	struct GPUFrameTimerBeginTaskData {};
+	struct GPUFrameTimerEndTaskData {};
+	struct GPUTimestampTaskData {};
+
+	namespace internal
+	{
+		inline double TimestampsToMilliseconds(std::uint64_t begin, std::uint64_t end, std::uint64_t frequency)
+		{
+			return (end >= begin) ? static_cast<double>(end - begin) * 1000.0 / static_cast<double>(frequency) : 0.0;
+		}
+
+		inline void SetupGPUFrameTimer(RenderSystem& rs, GPUFrameTimerData& timer, bool resize)
+		{
+			// The queries do not depend on the resolution
+			if (resize)
+			{
+				return;
+			}
+
+			auto& dx12_render_system = static_cast<D3D12RenderSystem&>(rs);
+
+			timer.timestamps_per_frame = static_cast<std::uint32_t>(std::max<std::size_t>(timer.section_names.size(), 1) + 1);
+			timer.section_times.assign(timer.section_names.size(), 0.0);
+
+			const auto query_count = READBACK_SLOT_COUNT * timer.timestamps_per_frame;
+
+			D3D12_QUERY_HEAP_DESC heap_desc = {};
+			heap_desc.Type = D3D12_QUERY_HEAP_TYPE_TIMESTAMP;
+			heap_desc.Count = query_count;
+			TRY_M(dx12_render_system.m_device->m_native->CreateQueryHeap(&heap_desc, IID_PPV_ARGS(&timer.query_heap)), "Failed to create the GPU frame timer query heap.");
+
+			const auto buffer_size = static_cast<std::uint32_t>(query_count * sizeof(std::uint64_t));
+			timer.readback_buffer = d3d12::CreateReadbackBuffer(dx12_render_system.m_device, buffer_size);
+			d3d12::SetName(timer.readback_buffer, L"GPU frame timer read back buffer");
+
+			// Keep the read back buffer mapped for the duration of the entire application
+			timer.timestamps = reinterpret_cast<const std::uint64_t*>(MapReadbackBuffer(timer.readback_buffer, buffer_size));
+
+			dx12_render_system.m_direct_queue->m_native->GetTimestampFrequency(&timer.timestamp_frequency);
+
+			timer.readback_ring.Reset();
+			timer.last_read_slot.reset();
+		}
+
+		inline void ExecuteGPUFrameTimerBegin(RenderSystem& rs, FrameGraph& fg, RenderTaskHandle handle, GPUFrameTimerData& timer)
+		{
+			auto& dx12_render_system = static_cast<D3D12RenderSystem&>(rs);
+			auto command_list = fg.GetCommandList<d3d12::CommandList>(handle);
+
+			// Read the timestamps of the newest completed frame, a slot is only read once
+			auto published_slot = timer.readback_ring.PublishNewestCompleted(internal::GetReadbackFenceQuery(dx12_render_system));
+
+			if (published_slot.has_value() && published_slot != timer.last_read_slot)
+			{
+				const auto* timestamps = timer.timestamps + published_slot.value() * timer.timestamps_per_frame;
+
+				timer.frame_time = TimestampsToMilliseconds(timestamps[0], timestamps[timer.timestamps_per_frame - 1], timer.timestamp_frequency);
+
+				for (std::size_t section = 0; section < timer.section_times.size(); ++section)
+				{
+					timer.section_times[section] = TimestampsToMilliseconds(timestamps[section], timestamps[section + 1], timer.timestamp_frequency);
+				}
+
+				++timer.measured_frame_count;
+				timer.last_read_slot = published_slot;
+			}
+
+			timer.write_slot = timer.readback_ring.AcquireWriteSlot();
+			command_list->m_native->EndQuery(timer.query_heap, D3D12_QUERY_TYPE_TIMESTAMP, timer.write_slot * timer.timestamps_per_frame);
+		}
+
+		inline void ExecuteGPUTimestamp(FrameGraph& fg, RenderTaskHandle handle, GPUFrameTimerData& timer, std::uint32_t timestamp_index)
+		{
+			auto command_list = fg.GetCommandList<d3d12::CommandList>(handle);
+
+			command_list->m_native->EndQuery(timer.query_heap, D3D12_QUERY_TYPE_TIMESTAMP, timer.write_slot * timer.timestamps_per_frame + timestamp_index);
+		}
+
+		inline void ExecuteGPUFrameTimerEnd(RenderSystem& rs, FrameGraph& fg, RenderTaskHandle handle, GPUFrameTimerData& timer)
+		{
+			auto& dx12_render_system = static_cast<D3D12RenderSystem&>(rs);
+			auto command_list = fg.GetCommandList<d3d12::CommandList>(handle);
+
+			const auto first_query = timer.write_slot * timer.timestamps_per_frame;
+
+			command_list->m_native->EndQuery(timer.query_heap, D3D12_QUERY_TYPE_TIMESTAMP, first_query + timer.timestamps_per_frame - 1);
+			command_list->m_native->ResolveQueryData(timer.query_heap, D3D12_QUERY_TYPE_TIMESTAMP, first_query, timer.timestamps_per_frame, timer.readback_buffer->m_resource, first_query * sizeof(std::uint64_t));
+
+			timer.readback_ring.Submit(timer.write_slot, internal::GetCurrentReadbackFence(dx12_render_system));
+		}
+
+		inline void DestroyGPUFrameTimer(GPUFrameTimerData& timer, bool resize)
+		{
+			if (resize)
+			{
+				return;
+			}
+
+			if (timer.readback_buffer)
+			{
+				UnmapReadbackBuffer(timer.readback_buffer);
+				Destroy(timer.readback_buffer);
+				timer.readback_buffer = nullptr;
+				timer.timestamps = nullptr;
+			}
+
+			if (timer.query_heap)
+			{
+				timer.query_heap->Release();
+				timer.query_heap = nullptr;
+			}
+		}
+
+		inline RenderTaskDesc GetGPUFrameTimerTaskDescription()
+		{
+			RenderTaskDesc timer_task_description;
+
+			// Only records queries, there is no render target
+			timer_task_description.m_properties = std::nullopt;
+			timer_task_description.m_type = RenderTaskType::DIRECT;
+			timer_task_description.m_allow_multithreading = false;
+
+			return timer_task_description;
+		}
+
+	} /* internal */
+
+	//! Write the timestamp at the start of the frame, add this task before all other tasks
+	/*! The timer is shared with AddGPUFrameTimerEndTask(), which has to be added after all other tasks. */
+	inline void AddGPUFrameTimerBeginTask(FrameGraph& frame_graph, std::shared_ptr<GPUFrameTimerData> timer)
+	{
+		auto timer_task_description = internal::GetGPUFrameTimerTaskDescription();
+
+		// Set-up
+		timer_task_description.m_setup_func = [timer](RenderSystem& render_system, FrameGraph&, RenderTaskHandle, bool resize) {
+			internal::SetupGPUFrameTimer(render_system, *timer, resize);
+		};
+
+		// Execution
+		timer_task_description.m_execute_func = [timer](RenderSystem& render_system, FrameGraph& frame_graph, SceneGraph&, RenderTaskHandle handle) {
+			internal::ExecuteGPUFrameTimerBegin(render_system, frame_graph, handle, *timer);
+		};
+
+		// Destruction and clean-up
+		timer_task_description.m_destroy_func = [timer](FrameGraph&, RenderTaskHandle, bool resize) {
+			internal::DestroyGPUFrameTimer(*timer, resize);
+		};
+
+		// Save this task to the frame graph system
+		frame_graph.AddTask<GPUFrameTimerBeginTaskData>(timer_task_description, L"GPU Frame Timer Begin");
+	}
+
+	//! Write the timestamp that ends a section and starts the next one, add this task between two timed tasks
+	/*! \param timestamp_index Index of the timestamp within the frame, from 1 (end of the first section) up to the
+	 *  number of sections minus one. The end of the last section is written by the end task. */
+	inline void AddGPUTimestampTask(FrameGraph& frame_graph, std::shared_ptr<GPUFrameTimerData> timer, std::uint32_t timestamp_index)
+	{
+		auto timer_task_description = internal::GetGPUFrameTimerTaskDescription();
+
+		// Set-up, the begin task owns the queries
+		timer_task_description.m_setup_func = [](RenderSystem&, FrameGraph&, RenderTaskHandle, bool) {};
+
+		// Execution
+		timer_task_description.m_execute_func = [timer, timestamp_index](RenderSystem&, FrameGraph& frame_graph, SceneGraph&, RenderTaskHandle handle) {
+			internal::ExecuteGPUTimestamp(frame_graph, handle, *timer, timestamp_index);
+		};
+
+		// Destruction and clean-up
+		timer_task_description.m_destroy_func = [](FrameGraph&, RenderTaskHandle, bool) {};
+
+		// Save this task to the frame graph system, every timestamp task shares the same (empty) data type
+		frame_graph.AddTask<GPUTimestampTaskData>(timer_task_description, L"GPU Timestamp");
+	}
+
+	//! Write the timestamp at the end of the frame and copy all timestamps to the CPU, add this task after all other tasks
+	inline void AddGPUFrameTimerEndTask(FrameGraph& frame_graph, std::shared_ptr<GPUFrameTimerData> timer)
+	{
+		auto timer_task_description = internal::GetGPUFrameTimerTaskDescription();
+
+		// Set-up, the begin task owns the queries
+		timer_task_description.m_setup_func = [](RenderSystem&, FrameGraph&, RenderTaskHandle, bool) {};
+
+		// Execution
+		timer_task_description.m_execute_func = [timer](RenderSystem& render_system, FrameGraph& frame_graph, SceneGraph&, RenderTaskHandle handle) {
+			internal::ExecuteGPUFrameTimerEnd(render_system, frame_graph, handle, *timer);
+		};
+
+		// Destruction and clean-up
+		timer_task_description.m_destroy_func = [](FrameGraph&, RenderTaskHandle, bool) {};
+
+		// Save this task to the frame graph system
+		frame_graph.AddTask<GPUFrameTimerEndTaskData>(timer_task_description, L"GPU Frame Timer End");
+	}
+
+} /* wr */
@@ -21,6 +21,11 @@
 #include "d3d12/d3d12_structs.hpp"
 #include "frame_graph/frame_graph.hpp"
 
+#include "d3d12_readback_ring.hpp"
+
+// C++ standard
+#include <array>
+
 namespace wr
 {
 	struct PixelReadbackTaskData
@@ -28,11 +33,15 @@ namespace wr
 		// Render target of the previous render task (should be the output from the composition task
 		d3d12::RenderTarget* predecessor_render_target = nullptr;
 
-		// Read back buffer used to retrieve the depth data on the GPU
-		d3d12::ReadbackBufferResource* readback_buffer = nullptr;
+		// Read back buffers used to retrieve the depth data on the GPU, the GPU copies into one buffer while the
+		// CPU reads from the newest completed one
+		std::array<d3d12::ReadbackBufferResource*, internal::READBACK_SLOT_COUNT> readback_buffers = {};
+
+		// Decides which read back buffer is written and which one is read
+		ReadbackRing readback_ring = ReadbackRing(internal::READBACK_SLOT_COUNT);
 
-		// Stores the final depth data
-		CPUTexture cpu_texture_output;
+		// Stores the final depth data, one texture per read back buffer
+		std::array<CPUTexture, internal::READBACK_SLOT_COUNT> cpu_texture_outputs;
 	};
 
 	namespace internal
@@ -57,15 +66,22 @@ namespace wr
 			unsigned int rt_height = d3d12::GetRenderTargetHeight(data.predecessor_render_target);
 			std::uint32_t aligned_buffer_size = SizeAlignTwoPower(rt_width * bytesPerPixel, 256) * rt_height;
 
-			// Create the actual read back buffer
-			data.readback_buffer = d3d12::CreateReadbackBuffer(dx12_render_system.m_device, aligned_buffer_size);
-			d3d12::SetName(data.readback_buffer, L"Pixel data read back render pass");
-
-			// Keep the read back buffer mapped for the duration of the entire application
-			data.cpu_texture_output.m_data = reinterpret_cast<float*>(MapReadbackBuffer(data.readback_buffer, aligned_buffer_size));
-			data.cpu_texture_output.m_buffer_width = rt_width;
-			data.cpu_texture_output.m_buffer_height = rt_height;
-			data.cpu_texture_output.m_bytes_per_pixel = bytesPerPixel;
+			for (std::uint32_t slot = 0; slot < internal::READBACK_SLOT_COUNT; ++slot)
+			{
+				// Create the actual read back buffer
+				data.readback_buffers[slot] = d3d12::CreateReadbackBuffer(dx12_render_system.m_device, aligned_buffer_size);
+				d3d12::SetName(data.readback_buffers[slot], L"Pixel data read back render pass");
+
+				// Keep the read back buffer mapped for the duration of the entire application
+				auto& cpu_texture_output = data.cpu_texture_outputs[slot];
+				cpu_texture_output.m_data = reinterpret_cast<float*>(MapReadbackBuffer(data.readback_buffers[slot], aligned_buffer_size));
+				cpu_texture_output.m_buffer_width = rt_width;
+				cpu_texture_output.m_buffer_height = rt_height;
+				cpu_texture_output.m_bytes_per_pixel = bytesPerPixel;
+			}
+
+			// The buffers are new, none of them holds a completed copy
+			data.readback_ring.Reset();
  		}
 
 		inline void ExecutePixelDataReadBackTask(RenderSystem& render_system, FrameGraph& frame_graph, SceneGraph& scene_graph, RenderTaskHandle handle)
@@ -74,8 +90,12 @@ namespace wr
 			auto& data = frame_graph.GetData<PixelReadbackTaskData>(handle);
 			auto command_list = frame_graph.GetCommandList<d3d12::CommandList>(handle);
 
+			// The CPU reads the newest completed copy, the copy of this frame goes into another buffer
+			auto published_slot = data.readback_ring.PublishNewestCompleted(internal::GetReadbackFenceQuery(dx12_render_system));
+			auto write_slot = data.readback_ring.AcquireWriteSlot();
+
 			D3D12_TEXTURE_COPY_LOCATION destination = {};
-			destination.pResource = data.readback_buffer->m_resource;
+			destination.pResource = data.readback_buffers[write_slot]->m_resource;
 			destination.Type = D3D12_TEXTURE_COPY_TYPE::D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
 			destination.SubresourceIndex = 0;
 			destination.PlacedFootprint.Footprint.Format = static_cast<DXGI_FORMAT>(data.predecessor_render_target->m_create_info.m_rtv_formats[0]);
@@ -96,8 +116,13 @@ namespace wr
 			// Copy pixel data
 			command_list->m_native->CopyTextureRegion(&destination, 0, 0, 0, &source, nullptr);
 
+			data.readback_ring.Submit(write_slot, internal::GetCurrentReadbackFence(dx12_render_system));
+
 			// Update the frame graph output texture (allows the renderer to access this data)
-			frame_graph.SetOutputTexture(data.cpu_texture_output, CPUTextureType::PIXEL_DATA);
+			if (published_slot.has_value())
+			{
+				frame_graph.SetOutputTexture(data.cpu_texture_outputs[published_slot.value()], CPUTextureType::PIXEL_DATA);
+			}
 		}
 		
 		inline void DestroyPixelDataReadBackTask(FrameGraph& fg, RenderTaskHandle handle)
@@ -105,9 +130,13 @@ namespace wr
 			// Data used for this render task
 			auto& data = fg.GetData<PixelReadbackTaskData>(handle);
 
-			// Clean up the read back buffer
-			UnmapReadbackBuffer(data.readback_buffer);
-			Destroy(data.readback_buffer);
+			// Clean up the read back buffers
+			for (auto& readback_buffer : data.readback_buffers)
+			{
+				UnmapReadbackBuffer(readback_buffer);
+				Destroy(readback_buffer);
+				readback_buffer = nullptr;
+			}
 		}
 
 	} /* internal */
@@ -0,0 +1,49 @@
+// Copyright 2019 Breda University of Applied Sciences and Team Wisp (Viktor Zoutman, Emilio Laiso, Jens Hagen, Meine Zeinstra, Tahar Meijs, Koen Buitenhuis, Niels Brunekreef, Darius Bouma, Florian Schut)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "d3d12/d3d12_functions.hpp"
+#include "d3d12/d3d12_renderer.hpp"
+#include "d3d12/d3d12_settings.hpp"
+
+#include "readback_ring.hpp"
+
+namespace wr
+{
+	namespace internal
+	{
+		//! Number of readback buffers per readback task, enough for the maximum number of frames in flight
+		static const constexpr std::uint32_t READBACK_SLOT_COUNT = d3d12::settings::num_back_buffers;
+
+		//! Fence signal at the end of the frame that is being recorded
+		/*! Wisp has one fence per frame index, the fence of the current frame index reaches its current value once the
+		 *  command lists of this frame have been executed. */
+		inline ReadbackFence GetCurrentReadbackFence(D3D12RenderSystem& render_system)
+		{
+			const auto frame_index = static_cast<std::uint32_t>(render_system.GetFrameIdx());
+
+			return { frame_index, render_system.m_fences[frame_index]->m_fence_value };
+		}
+
+		//! Fence query for the readback ring
+		inline ReadbackRing::IsFenceComplete GetReadbackFenceQuery(D3D12RenderSystem& render_system)
+		{
+			return [&render_system](const ReadbackFence& fence)
+			{
+				return render_system.m_fences[fence.m_fence_index]->m_native->GetCompletedValue() >= fence.m_value;
+			};
+		}
+	} /* internal */
+} /* wr */
@@ -0,0 +1,120 @@
+// Copyright 2019 Breda University of Applied Sciences and Team Wisp (Viktor Zoutman, Emilio Laiso, Jens Hagen, Meine Zeinstra, Tahar Meijs, Koen Buitenhuis, Niels Brunekreef, Darius Bouma, Florian Schut)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include "d3d12/d3d12_functions.hpp"
+#include "d3d12/d3d12_renderer.hpp"
+#include "d3d12/d3d12_structs.hpp"
+#include "frame_graph/frame_graph.hpp"
+
+// C++ standard
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace wr
+{
+	// Byte ranges of model pool staging buffers whose CPU copy changed, the owner of the model pools queues them
+	struct VertexPatchUploadData
+	{
+		struct Region
+		{
+			d3d12::StagingBuffer* buffer = nullptr;
+			std::uint64_t offset = 0;
+			std::uint64_t size = 0;
+		};
+
+		std::vector<Region> regions;
+
+		// Queue a range that was written using d3d12::UpdateStagingBuffer, it is copied to the GPU in the next frame
+		void Add(d3d12::StagingBuffer* buffer, std::uint64_t offset, std::uint64_t size)
+		{
+			regions.push_back({ buffer, offset, size });
+		}
+
+		// Forget the ranges of a staging buffer that is about to be destroyed
+		void Discard(const d3d12::StagingBuffer* buffer)
+		{
+			regions.erase(std::remove_if(regions.begin(), regions.end(), [buffer](const Region& region) { return region.buffer == buffer; }), regions.end());
+		}
+	};
+
+	// The upload task keeps its state in the shared upload data
+	struct VertexPatchUploadTaskData {};
+
+	namespace internal
+	{
+		inline void ExecuteVertexPatchUpload(FrameGraph& fg, RenderTaskHandle handle, VertexPatchUploadData& upload)
+		{
+			auto command_list = fg.GetCommandList<d3d12::CommandList>(handle);
+
+			// Every buffer is transitioned once, however many of its ranges changed
+			std::stable_sort(upload.regions.begin(), upload.regions.end(), [](const VertexPatchUploadData::Region& a, const VertexPatchUploadData::Region& b)
+			{
+				return std::less<d3d12::StagingBuffer*>()(a.buffer, b.buffer);
+			});
+
+			for (auto first = upload.regions.begin(); first != upload.regions.end();)
+			{
+				auto* buffer = first->buffer;
+				const auto last = std::find_if(first, upload.regions.end(), [buffer](const VertexPatchUploadData::Region& region) { return region.buffer != buffer; });
+
+				// Copies the ranges from the upload heap into the vertex buffer, the rest of the buffer is left alone
+				d3d12::Transition(command_list, buffer, ResourceState::VERTEX_AND_CONSTANT_BUFFER, ResourceState::COPY_DEST);
+
+				for (auto region = first; region != last; ++region)
+				{
+					d3d12::StageBufferRegion(buffer, region->size, region->offset, command_list);
+				}
+
+				d3d12::Transition(command_list, buffer, ResourceState::COPY_DEST, ResourceState::VERTEX_AND_CONSTANT_BUFFER);
+
+				first = last;
+			}
+
+			upload.regions.clear();
+		}
+	} /* internal */
+
+	//! Copy the patched vertex ranges of the model pools to the GPU, add this task before all other tasks
+	inline void AddVertexPatchUploadTask(FrameGraph& frame_graph, std::shared_ptr<VertexPatchUploadData> upload)
+	{
+		RenderTaskDesc upload_task_description;
+
+		// Only records copies, there is no render target
+		upload_task_description.m_properties = std::nullopt;
+		upload_task_description.m_type = RenderTaskType::DIRECT;
+		upload_task_description.m_allow_multithreading = false;
+
+		// Set-up
+		upload_task_description.m_setup_func = [](RenderSystem&, FrameGraph&, RenderTaskHandle, bool) {};
+
+		// Execution
+		upload_task_description.m_execute_func = [upload](RenderSystem&, FrameGraph& frame_graph, SceneGraph&, RenderTaskHandle handle) {
+			internal::ExecuteVertexPatchUpload(frame_graph, handle, *upload);
+		};
+
+		// Destruction and clean-up
+		upload_task_description.m_destroy_func = [](FrameGraph&, RenderTaskHandle, bool) {};
+
+		// Save this task to the frame graph system
+		frame_graph.AddTask<VertexPatchUploadTaskData>(upload_task_description, L"Vertex Patch Upload");
+	}
+
+} /* wr */
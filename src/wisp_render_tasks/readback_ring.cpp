@@ -0,0 +1,90 @@
+// Copyright 2019 Breda University of Applied Sciences and Team Wisp (Viktor Zoutman, Emilio Laiso, Jens Hagen, Meine Zeinstra, Tahar Meijs, Koen Buitenhuis, Niels Brunekreef, Darius Bouma, Florian Schut)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "readback_ring.hpp"
+
+// C++ standard
+#include <algorithm>
+
+namespace wr
+{
+	ReadbackRing::ReadbackRing(std::uint32_t slot_count)
+		: m_slots(std::max<std::uint32_t>(slot_count, 1))
+		, m_submission_count(0)
+	{
+	}
+
+	std::uint32_t ReadbackRing::AcquireWriteSlot() const noexcept
+	{
+		std::optional<std::uint32_t> oldest_slot;
+
+		for (std::uint32_t slot = 0; slot < m_slots.size(); ++slot)
+		{
+			// The CPU is reading from this slot
+			if (slot == m_published_slot && m_slots.size() > 1)
+			{
+				continue;
+			}
+
+			if (!oldest_slot || m_slots[slot].m_submission < m_slots[*oldest_slot].m_submission)
+			{
+				oldest_slot = slot;
+			}
+		}
+
+		return oldest_slot.value_or(0);
+	}
+
+	void ReadbackRing::Submit(std::uint32_t slot, const ReadbackFence& fence)
+	{
+		m_slots[slot].m_fence = fence;
+		m_slots[slot].m_submission = ++m_submission_count;
+	}
+
+	std::optional<std::uint32_t> ReadbackRing::PublishNewestCompleted(const IsFenceComplete& is_fence_complete)
+	{
+		// Slots with a newer submission than the published slot are the only candidates
+		std::uint64_t newest_submission = m_published_slot ? m_slots[*m_published_slot].m_submission : 0;
+
+		for (std::uint32_t slot = 0; slot < m_slots.size(); ++slot)
+		{
+			const auto& data = m_slots[slot];
+
+			if (data.m_submission > newest_submission && is_fence_complete(data.m_fence))
+			{
+				newest_submission = data.m_submission;
+				m_published_slot = slot;
+			}
+		}
+
+		return m_published_slot;
+	}
+
+	std::optional<std::uint32_t> ReadbackRing::GetPublishedSlot() const noexcept
+	{
+		return m_published_slot;
+	}
+
+	std::uint32_t ReadbackRing::GetSlotCount() const noexcept
+	{
+		return static_cast<std::uint32_t>(m_slots.size());
+	}
+
+	void ReadbackRing::Reset() noexcept
+	{
+		std::fill(m_slots.begin(), m_slots.end(), Slot());
+		m_submission_count = 0;
+		m_published_slot.reset();
+	}
+}
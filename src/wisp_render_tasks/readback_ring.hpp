@@ -0,0 +1,86 @@
+// Copyright 2019 Breda University of Applied Sciences and Team Wisp (Viktor Zoutman, Emilio Laiso, Jens Hagen, Meine Zeinstra, Tahar Meijs, Koen Buitenhuis, Niels Brunekreef, Darius Bouma, Florian Schut)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+// C++ standard
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <vector>
+
+namespace wr
+{
+	//! Fence signal that marks the end of a GPU copy into a readback slot
+	struct ReadbackFence
+	{
+		std::uint32_t m_fence_index = 0;	//!< Fence that is signaled (Wisp has one fence per frame index)
+		std::uint64_t m_value = 0;			//!< Value the fence reaches once the copy has finished
+	};
+
+	//! Slot selection for a ring of readback buffers
+	/*! A single readback buffer is overwritten by the GPU every frame, so the CPU has to wait for the GPU before it can
+	 *  read it. With a ring of buffers the GPU copies into one slot while the CPU reads the newest slot that has been
+	 *  completed. This class only decides which slot to use, it does not own any GPU resources, so it can be tested
+	 *  without a device.
+	 *
+	 *  Every frame: call PublishNewestCompleted() to pick the slot the CPU reads, AcquireWriteSlot() to pick the slot the
+	 *  GPU copies into (never the published one), and Submit() with the fence that signals the end of that copy. */
+	class ReadbackRing
+	{
+	public:
+		//! Returns true when the GPU reached the fence value
+		using IsFenceComplete = std::function<bool(const ReadbackFence&)>;
+
+		//! \param slot_count Number of readback buffers, at least two are needed to overlap GPU and CPU work.
+		explicit ReadbackRing(std::uint32_t slot_count);
+		~ReadbackRing() = default;
+
+		//! Pick the slot the GPU writes to in the frame that is being recorded
+		/*! The slot published to the CPU is never returned, the slot with the oldest submission is reused otherwise.
+		 *  Reusing a slot with a pending copy is safe, as GPU copies are executed in submission order. */
+		std::uint32_t AcquireWriteSlot() const noexcept;
+
+		//! Record a copy into a slot
+		/*! \param slot Slot returned by AcquireWriteSlot().
+		 *  \param fence Fence signal that marks the end of the copy. */
+		void Submit(std::uint32_t slot, const ReadbackFence& fence);
+
+		//! Publish the slot with the newest completed copy to the CPU
+		/*! \param is_fence_complete Fence query of the device.
+		 *  \return The published slot, which is the previously published slot when no newer copy has completed, or
+		 *          nothing when no copy has ever completed. */
+		std::optional<std::uint32_t> PublishNewestCompleted(const IsFenceComplete& is_fence_complete);
+
+		//! Slot the CPU reads from, if any
+		std::optional<std::uint32_t> GetPublishedSlot() const noexcept;
+
+		//! Number of slots in the ring
+		std::uint32_t GetSlotCount() const noexcept;
+
+		//! Forget all submissions (e.g. after the readback buffers have been recreated)
+		void Reset() noexcept;
+
+	private:
+		struct Slot
+		{
+			ReadbackFence m_fence;
+			std::uint64_t m_submission = 0;		//!< Submission number, zero when the slot was never written
+		};
+
+		std::vector<Slot> m_slots;
+		std::uint64_t m_submission_count;
+		std::optional<std::uint32_t> m_published_slot;
+	};
+}
@@ -0,0 +1,172 @@
+// Copyright 2019 Breda University of Applied Sciences and Team Wisp (Viktor Zoutman, Emilio Laiso, Jens Hagen, Meine Zeinstra, Tahar Meijs, Koen Buitenhuis, Niels Brunekreef, Darius Bouma, Florian Schut)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Measures the throughput of the Maya-independent mesh conversion on synthetic meshes.
+// Usage: WispForMayaBenchmark [--max-triangles <count>] [--max-threads <count>]
+// The first table uses a single thread, the second table shows how the conversion scales with the number of threads.
+// The last table compares the two ways of resolving triangle corners on meshes with high-valence caps.
+
+#include "synthetic_meshes.hpp"
+
+// C++ standard
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <thread>
+
+namespace
+{
+	struct MeshGenerator
+	{
+		const char* m_name;
+		std::function<wmr::MeshSource(std::size_t)> m_generate;
+	};
+
+	// Run the conversion until enough time has passed to get a stable measurement
+	// Pass a null pool to measure the single-threaded conversion
+	double MeasureSecondsPerConversion( const wmr::MeshSource& source, wmr::ThreadPool* pool, std::size_t& vertex_count )
+	{
+		using clock = std::chrono::steady_clock;
+
+		std::vector<synthetic::Vertex> vertices;
+		std::vector<std::uint32_t> indices;
+
+		std::size_t iterations = 0;
+		double total_seconds = 0.0;
+
+		do
+		{
+			auto start = clock::now();
+			wmr::ConvertMesh( source, vertices, indices, pool );
+			total_seconds += std::chrono::duration<double>( clock::now() - start ).count();
+			++iterations;
+		} while( total_seconds < 0.25 && iterations < 1000 );
+
+		vertex_count = vertices.size();
+		return total_seconds / iterations;
+	}
+
+	// Same as above, for resolving the triangle corners of a polygon mesh
+	double MeasureSecondsPerResolve( const wmr::PolygonSource& polygons )
+	{
+		using clock = std::chrono::steady_clock;
+
+		wmr::MeshSource source;
+
+		std::size_t iterations = 0;
+		double total_seconds = 0.0;
+
+		do
+		{
+			auto start = clock::now();
+			wmr::ResolveTriangleCorners( polygons, source );
+			total_seconds += std::chrono::duration<double>( clock::now() - start ).count();
+			++iterations;
+		} while( total_seconds < 0.25 && iterations < 1000 );
+
+		return total_seconds / iterations;
+	}
+}
+
+int main( int argc, char** argv )
+{
+	std::size_t max_triangles = 10'000'000;
+	std::size_t max_threads = std::max( std::thread::hardware_concurrency(), 1u );
+
+	for( int i = 1; i < argc; ++i )
+	{
+		if( std::strcmp( argv[i], "--max-triangles" ) == 0 && i + 1 < argc )
+		{
+			max_triangles = std::strtoull( argv[++i], nullptr, 10 );
+		}
+		else if( std::strcmp( argv[i], "--max-threads" ) == 0 && i + 1 < argc )
+		{
+			max_threads = std::max<std::size_t>( std::strtoull( argv[++i], nullptr, 10 ), 1 );
+		}
+	}
+
+	const MeshGenerator generators[] = {
+		{ "grid", synthetic::MakeGridWithTriangles },
+		{ "sphere", synthetic::MakeSphereWithTriangles },
+		{ "scan", []( std::size_t triangles ) { return synthetic::MakeScan( triangles ); } }
+	};
+
+	std::printf( "%-8s %12s %12s %12s %16s\n", "mesh", "triangles", "vertices", "ms", "triangles/sec" );
+
+	for( const auto& generator : generators )
+	{
+		for( std::size_t target = 1000; target <= max_triangles; target *= 10 )
+		{
+			auto source = generator.m_generate( target );
+			std::size_t vertex_count = 0;
+
+			double seconds = MeasureSecondsPerConversion( source, nullptr, vertex_count );
+			double triangles_per_second = source.GetTriangleCount() / seconds;
+
+			std::printf( "%-8s %12zu %12zu %12.3f %16.0f\n", generator.m_name, source.GetTriangleCount(), vertex_count, seconds * 1000.0, triangles_per_second );
+		}
+	}
+
+	// Thread scaling on the largest meshes (powers of two and the maximum), the calling thread counts as one of the threads
+	std::vector<std::size_t> thread_counts;
+	for( std::size_t threads = 1; threads < max_threads; threads *= 2 )
+	{
+		thread_counts.push_back( threads );
+	}
+	thread_counts.push_back( max_threads );
+
+	std::printf( "\n%-8s %12s %8s %12s %16s %8s\n", "mesh", "triangles", "threads", "ms", "triangles/sec", "speedup" );
+
+	for( const auto& generator : generators )
+	{
+		auto source = generator.m_generate( max_triangles );
+		std::size_t vertex_count = 0;
+
+		double single_threaded_seconds = MeasureSecondsPerConversion( source, nullptr, vertex_count );
+
+		for( auto threads : thread_counts )
+		{
+			double seconds = single_threaded_seconds;
+
+			if( threads > 1 )
+			{
+				wmr::ThreadPool pool( threads - 1 );
+				seconds = MeasureSecondsPerConversion( source, &pool, vertex_count );
+			}
+
+			std::printf( "%-8s %12zu %8zu %12.3f %16.0f %8.2f\n", generator.m_name, source.GetTriangleCount(), threads, seconds * 1000.0, source.GetTriangleCount() / seconds, single_threaded_seconds / seconds );
+		}
+	}
+
+	// Face-relative offsets versus searching the polygon for every corner, with increasingly large caps
+	std::printf( "\n%-8s %12s %12s %14s %14s\n", "segments", "triangles", "cap tris", "search ms", "offsets ms" );
+
+	for( std::uint32_t segments = 16; segments <= 16384; segments *= 4 )
+	{
+		auto polygons = synthetic::MakeCappedCylinderPolygons( segments, 4 );
+		auto point_polygons = polygons;
+		point_polygons.m_triangle_face_vertices.clear();
+
+		double search_seconds = MeasureSecondsPerResolve( point_polygons );
+		double offset_seconds = MeasureSecondsPerResolve( polygons );
+
+		std::printf( "%-8u %12zu %12u %14.3f %14.3f\n", segments, polygons.m_triangle_points.size() / 3, ( segments - 2 ) * 2, search_seconds * 1000.0, offset_seconds * 1000.0 );
+	}
+
+	return EXIT_SUCCESS;
+}
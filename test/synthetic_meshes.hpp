@@ -0,0 +1,326 @@
+// Copyright 2019 Breda University of Applied Sciences and Team Wisp (Viktor Zoutman, Emilio Laiso, Jens Hagen, Meine Zeinstra, Tahar Meijs, Koen Buitenhuis, Niels Brunekreef, Darius Bouma, Florian Schut)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+// Wisp plug-in
+#include "plugin/parsers/mesh_converter.hpp"
+
+// C++ standard
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+//! Procedurally generated meshes for the mesh conversion tests and benchmarks
+namespace synthetic
+{
+	//! Same layout as wr::Vertex, so the tests do not need the Wisp rendering framework
+	struct Vertex
+	{
+		float m_pos[3];
+		float m_uv[2];
+		float m_normal[3];
+		float m_tangent[3];
+		float m_bitangent[3];
+	};
+
+	namespace detail
+	{
+		inline void PushVector(std::vector<float>& target, float x, float y, float z)
+		{
+			target.push_back(x);
+			target.push_back(y);
+			target.push_back(z);
+		}
+
+		inline void PushCorner(wmr::MeshSource& mesh, std::int32_t point, std::int32_t normal, std::int32_t tangent, std::int32_t uv)
+		{
+			mesh.m_corner_points.push_back(point);
+			mesh.m_corner_normals.push_back(normal);
+			mesh.m_corner_tangents.push_back(tangent);
+			mesh.m_corner_uvs.push_back(uv);
+		}
+
+		// Small deterministic generator, std::rand differs between platforms
+		inline std::uint32_t NextRandom(std::uint32_t& state)
+		{
+			state ^= state << 13;
+			state ^= state >> 17;
+			state ^= state << 5;
+			return state;
+		}
+	}
+
+	//! Flat, smooth-shaded grid of quads with a single UV shell
+	/*! Every point has exactly one normal, tangent, and UV, so the converted mesh has one vertex per point. */
+	inline wmr::MeshSource MakeGrid(std::uint32_t quads_x, std::uint32_t quads_y)
+	{
+		wmr::MeshSource mesh;
+		const std::uint32_t points_x = quads_x + 1;
+
+		for (std::uint32_t y = 0; y <= quads_y; ++y)
+		{
+			for (std::uint32_t x = 0; x <= quads_x; ++x)
+			{
+				float u = static_cast<float>(x) / quads_x;
+				float v = static_cast<float>(y) / quads_y;
+
+				detail::PushVector(mesh.m_points, u, 0.0f, v);
+				detail::PushVector(mesh.m_normals, 0.0f, 1.0f, 0.0f);
+				detail::PushVector(mesh.m_bitangents, 0.0f, 0.0f, 1.0f);
+				detail::PushVector(mesh.m_tangents, 1.0f, 0.0f, 0.0f);
+				mesh.m_u.push_back(u);
+				mesh.m_v.push_back(v);
+			}
+		}
+
+		for (std::uint32_t y = 0; y < quads_y; ++y)
+		{
+			for (std::uint32_t x = 0; x < quads_x; ++x)
+			{
+				std::int32_t p0 = y * points_x + x;
+				std::int32_t p1 = p0 + 1;
+				std::int32_t p2 = p0 + points_x + 1;
+				std::int32_t p3 = p0 + points_x;
+
+				for (auto p : { p0, p1, p2, p0, p2, p3 })
+				{
+					detail::PushCorner(mesh, p, p, p, p);
+				}
+			}
+		}
+
+		return mesh;
+	}
+
+	//! Grid with approximately the requested number of triangles
+	inline wmr::MeshSource MakeGridWithTriangles(std::size_t triangle_count)
+	{
+		auto quads_x = static_cast<std::uint32_t>(std::max(1.0, std::sqrt(triangle_count / 2.0)));
+		auto quads_y = static_cast<std::uint32_t>(std::max<std::size_t>(1, triangle_count / (2 * quads_x)));
+		return MakeGrid(quads_x, quads_y);
+	}
+
+	//! Smooth UV sphere with a single UV seam
+	inline wmr::MeshSource MakeSphere(std::uint32_t segments, std::uint32_t rings)
+	{
+		const float pi = 3.14159265358979f;
+		wmr::MeshSource mesh;
+
+		// The points of the first column are duplicated in UV space only (seam), so there are
+		// "segments" points per ring, but "segments + 1" UVs per ring
+		for (std::uint32_t ring = 0; ring <= rings; ++ring)
+		{
+			float theta = pi * ring / rings;
+
+			for (std::uint32_t segment = 0; segment <= segments; ++segment)
+			{
+				float phi = 2.0f * pi * segment / segments;
+
+				if (segment < segments)
+				{
+					float x = std::sin(theta) * std::cos(phi);
+					float y = std::cos(theta);
+					float z = std::sin(theta) * std::sin(phi);
+
+					detail::PushVector(mesh.m_points, x, y, z);
+					detail::PushVector(mesh.m_normals, x, y, z);
+					detail::PushVector(mesh.m_tangents, -std::sin(phi), 0.0f, std::cos(phi));
+					detail::PushVector(mesh.m_bitangents, std::cos(theta) * std::cos(phi), -std::sin(theta), std::cos(theta) * std::sin(phi));
+				}
+
+				mesh.m_u.push_back(static_cast<float>(segment) / segments);
+				mesh.m_v.push_back(static_cast<float>(ring) / rings);
+			}
+		}
+
+		auto point = [segments](std::uint32_t ring, std::uint32_t segment) -> std::int32_t
+		{
+			return static_cast<std::int32_t>(ring * segments + (segment % segments));
+		};
+
+		auto uv = [segments](std::uint32_t ring, std::uint32_t segment) -> std::int32_t
+		{
+			return static_cast<std::int32_t>(ring * (segments + 1) + segment);
+		};
+
+		for (std::uint32_t ring = 0; ring < rings; ++ring)
+		{
+			for (std::uint32_t segment = 0; segment < segments; ++segment)
+			{
+				const std::uint32_t corners[6][2] = {
+					{ ring, segment }, { ring + 1, segment }, { ring + 1, segment + 1 },
+					{ ring, segment }, { ring + 1, segment + 1 }, { ring, segment + 1 }
+				};
+
+				for (const auto& corner : corners)
+				{
+					auto p = point(corner[0], corner[1]);
+					detail::PushCorner(mesh, p, p, p, uv(corner[0], corner[1]));
+				}
+			}
+		}
+
+		return mesh;
+	}
+
+	//! Sphere with approximately the requested number of triangles
+	inline wmr::MeshSource MakeSphereWithTriangles(std::size_t triangle_count)
+	{
+		auto rings = static_cast<std::uint32_t>(std::max(2.0, std::sqrt(triangle_count / 4.0)));
+		auto segments = static_cast<std::uint32_t>(std::max<std::size_t>(3, triangle_count / (2 * rings)));
+		return MakeSphere(segments, rings);
+	}
+
+	//! Mesh that resembles a photogrammetry scan
+	/*! Jittered points, randomly flipped quad diagonals, and a UV atlas made out of small charts. The chart borders
+	 *  result in a lot of UV seams, so fewer corners get welded than on a clean model. */
+	inline wmr::MeshSource MakeScan(std::size_t triangle_count, std::uint32_t chart_size = 4, std::uint32_t seed = 0x9e3779b9u)
+	{
+		wmr::MeshSource mesh;
+		std::uint32_t random = seed;
+
+		auto quads_x = static_cast<std::uint32_t>(std::max(1.0, std::sqrt(triangle_count / 2.0)));
+		auto quads_y = static_cast<std::uint32_t>(std::max<std::size_t>(1, triangle_count / (2 * quads_x)));
+		const std::uint32_t points_x = quads_x + 1;
+
+		auto jitter = [&random]() -> float
+		{
+			return (static_cast<float>(detail::NextRandom(random) & 0xffff) / 65535.0f - 0.5f) * 0.25f;
+		};
+
+		for (std::uint32_t y = 0; y <= quads_y; ++y)
+		{
+			for (std::uint32_t x = 0; x <= quads_x; ++x)
+			{
+				detail::PushVector(mesh.m_points, x + jitter(), jitter(), y + jitter());
+				detail::PushVector(mesh.m_normals, jitter(), 1.0f, jitter());
+				detail::PushVector(mesh.m_tangents, 1.0f, jitter(), jitter());
+				detail::PushVector(mesh.m_bitangents, 0.0f, jitter(), 1.0f);
+			}
+		}
+
+		// UVs are unique per chart, charts do not share their border UVs
+		const std::uint32_t chart_points = chart_size + 1;
+		auto uv_index = [&](std::uint32_t x, std::uint32_t y, std::uint32_t chart_x, std::uint32_t chart_y) -> std::int32_t
+		{
+			auto charts_x = (quads_x + chart_size - 1) / chart_size;
+			auto chart = chart_y * charts_x + chart_x;
+			auto local_x = x - chart_x * chart_size;
+			auto local_y = y - chart_y * chart_size;
+			return static_cast<std::int32_t>(chart * chart_points * chart_points + local_y * chart_points + local_x);
+		};
+
+		auto charts_x = (quads_x + chart_size - 1) / chart_size;
+		auto charts_y = (quads_y + chart_size - 1) / chart_size;
+		mesh.m_u.resize(static_cast<std::size_t>(charts_x) * charts_y * chart_points * chart_points);
+		mesh.m_v.resize(mesh.m_u.size());
+		for (std::size_t i = 0; i < mesh.m_u.size(); ++i)
+		{
+			mesh.m_u[i] = static_cast<float>(i % chart_points) / chart_size;
+			mesh.m_v[i] = static_cast<float>((i / chart_points) % chart_points) / chart_size;
+		}
+
+		for (std::uint32_t y = 0; y < quads_y; ++y)
+		{
+			for (std::uint32_t x = 0; x < quads_x; ++x)
+			{
+				std::uint32_t chart_x = x / chart_size;
+				std::uint32_t chart_y = y / chart_size;
+
+				const std::uint32_t quad[4][2] = { { x, y }, { x + 1, y }, { x + 1, y + 1 }, { x, y + 1 } };
+				const bool flip = (detail::NextRandom(random) & 1) != 0;
+				const std::uint32_t triangles[2][3] = {
+					{ 0, 1, flip ? 3u : 2u },
+					{ flip ? 1u : 0u, 2, 3 }
+				};
+
+				for (const auto& triangle : triangles)
+				{
+					for (auto corner : triangle)
+					{
+						auto px = quad[corner][0];
+						auto py = quad[corner][1];
+						auto p = static_cast<std::int32_t>(py * points_x + px);
+
+						detail::PushCorner(mesh, p, p, p, uv_index(px, py, chart_x, chart_y));
+					}
+				}
+			}
+		}
+
+		return mesh;
+	}
+
+	//! Polygon topology of an open cylinder with an n-gon cap on both ends
+	/*! The sides are quads, the caps are single polygons with one vertex per segment, like the caps of a lot of
+	 *  modelled props. Every face-vertex has its own normal, tangent, and UV index. Both the face-relative and the
+	 *  object-relative triangle indices are filled, using a fan triangulation. */
+	inline wmr::PolygonSource MakeCappedCylinderPolygons(std::uint32_t segments, std::uint32_t rings)
+	{
+		wmr::PolygonSource polygons;
+
+		auto add_polygon = [&polygons](const std::vector<std::int32_t>& points)
+		{
+			const auto first_id = static_cast<std::int32_t>(polygons.m_face_vertex_points.size());
+			const auto vertex_count = static_cast<std::int32_t>(points.size());
+
+			polygons.m_polygon_vertex_counts.push_back(vertex_count);
+			polygons.m_polygon_triangle_counts.push_back(vertex_count - 2);
+
+			for (std::int32_t i = 0; i < vertex_count; ++i)
+			{
+				polygons.m_face_vertex_points.push_back(points[i]);
+				polygons.m_face_vertex_normals.push_back(first_id + i);
+				polygons.m_face_vertex_tangents.push_back(first_id + i);
+				polygons.m_face_vertex_uvs.push_back(first_id + i);
+			}
+
+			for (std::int32_t i = 1; i + 1 < vertex_count; ++i)
+			{
+				for (auto local : { 0, i, i + 1 })
+				{
+					polygons.m_triangle_face_vertices.push_back(local);
+					polygons.m_triangle_points.push_back(points[local]);
+				}
+			}
+		};
+
+		auto point = [segments](std::uint32_t ring, std::uint32_t segment) -> std::int32_t
+		{
+			return static_cast<std::int32_t>(ring * segments + (segment % segments));
+		};
+
+		for (std::uint32_t ring = 0; ring < rings; ++ring)
+		{
+			for (std::uint32_t segment = 0; segment < segments; ++segment)
+			{
+				add_polygon({ point(ring, segment), point(ring, segment + 1), point(ring + 1, segment + 1), point(ring + 1, segment) });
+			}
+		}
+
+		std::vector<std::int32_t> bottom_cap, top_cap;
+		for (std::uint32_t segment = 0; segment < segments; ++segment)
+		{
+			bottom_cap.push_back(point(0, segments - segment));
+			top_cap.push_back(point(rings, segment));
+		}
+
+		add_polygon(bottom_cap);
+		add_polygon(top_cap);
+
+		return polygons;
+	}
+}
@@ -0,0 +1,176 @@
+// Copyright 2019 Breda University of Applied Sciences and Team Wisp (Viktor Zoutman, Emilio Laiso, Jens Hagen, Meine Zeinstra, Tahar Meijs, Koen Buitenhuis, Niels Brunekreef, Darius Bouma, Florian Schut)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "plugin/renderer/async_texture_loader.hpp"
+
+#include <gtest/gtest.h>
+
+// C++ standard
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <string>
+#include <thread>
+
+namespace
+{
+	// Decodes "<width>x<height>" into a texture of that size, every other path fails
+	bool DecodeSize( const wmr::TextureLoadRequest& request, wmr::DecodedTexture& texture, std::string& error )
+	{
+		const auto& path = request.m_path;
+		const auto separator = path.find( 'x' );
+
+		if ( separator == std::string::npos )
+		{
+			error = "not a size";
+			return false;
+		}
+
+		texture.m_width = static_cast<std::uint32_t>( std::stoul( path.substr( 0, separator ) ) );
+		texture.m_height = static_cast<std::uint32_t>( std::stoul( path.substr( separator + 1 ) ) );
+		texture.m_pixels.assign( static_cast<std::size_t>( texture.m_width ) * texture.m_height * 4, 0xff );
+
+		return true;
+	}
+}
+
+TEST( AsyncTextureLoader, DecodesOnWorkerThreads )
+{
+	const auto main_thread = std::this_thread::get_id();
+	std::atomic<bool> decoded_on_main_thread = false;
+	std::atomic<int> normal_map_count = 0;
+
+	wmr::AsyncTextureLoader loader( 2, [&]( const wmr::TextureLoadRequest& request, wmr::DecodedTexture& texture, std::string& error )
+	{
+		decoded_on_main_thread = decoded_on_main_thread || ( std::this_thread::get_id() == main_thread );
+		normal_map_count += ( request.m_role == wmr::TextureRole::NORMAL ) ? 1 : 0;
+		return DecodeSize( request, texture, error );
+	} );
+
+	const auto first = loader.Request( "4x2" );
+	const auto second = loader.Request( "8x8", wmr::TextureRole::NORMAL );
+	EXPECT_NE( first, second );
+
+	loader.WaitForAll();
+	auto results = loader.CollectCompleted();
+
+	ASSERT_EQ( results.size(), 2u );
+	EXPECT_FALSE( decoded_on_main_thread );
+	EXPECT_EQ( normal_map_count, 1 );
+
+	for ( const auto& result : results )
+	{
+		EXPECT_TRUE( result.m_success );
+		EXPECT_EQ( result.m_texture.m_pixels.size(), static_cast<std::size_t>( result.m_texture.m_width ) * result.m_texture.m_height * 4 );
+
+		if ( result.m_request_id == first )
+		{
+			EXPECT_EQ( result.m_path, "4x2" );
+			EXPECT_EQ( result.m_texture.m_width, 4u );
+			EXPECT_EQ( result.m_texture.m_height, 2u );
+		}
+	}
+
+	// Results are collected once
+	EXPECT_TRUE( loader.CollectCompleted().empty() );
+}
+
+TEST( AsyncTextureLoader, ReportsFailures )
+{
+	wmr::AsyncTextureLoader loader( 1, DecodeSize );
+
+	loader.Request( "missing.png" );
+	loader.WaitForAll();
+
+	auto results = loader.CollectCompleted();
+	ASSERT_EQ( results.size(), 1u );
+	EXPECT_FALSE( results[ 0 ].m_success );
+	EXPECT_EQ( results[ 0 ].m_error, "not a size" );
+
+	const auto statistics = loader.GetStatistics();
+	EXPECT_EQ( statistics.m_loaded, 0u );
+	EXPECT_EQ( statistics.m_failed, 1u );
+}
+
+TEST( AsyncTextureLoader, CollectsAtMostTheRequestedCount )
+{
+	wmr::AsyncTextureLoader loader( 2, DecodeSize );
+
+	for ( int i = 0; i < 5; ++i )
+	{
+		loader.Request( "1x1" );
+	}
+
+	loader.WaitForAll();
+
+	EXPECT_EQ( loader.GetStatistics().m_queue_depth, 5u );
+	EXPECT_EQ( loader.CollectCompleted( 2 ).size(), 2u );
+	EXPECT_EQ( loader.GetStatistics().m_queue_depth, 3u );
+	EXPECT_EQ( loader.CollectCompleted().size(), 3u );
+	EXPECT_EQ( loader.GetStatistics().m_queue_depth, 0u );
+}
+
+TEST( AsyncTextureLoader, CancelledRequestsAreNotCollected )
+{
+	std::promise<void> release_worker;
+	auto worker_released = release_worker.get_future().share();
+	std::atomic<int> decode_count = 0;
+
+	// The single worker blocks on the first request, so the second one is still queued when it is cancelled
+	wmr::AsyncTextureLoader loader( 1, [&]( const wmr::TextureLoadRequest& request, wmr::DecodedTexture& texture, std::string& error )
+	{
+		++decode_count;
+		worker_released.wait();
+		return DecodeSize( request, texture, error );
+	} );
+
+	const auto decoding = loader.Request( "1x1" );
+	const auto queued = loader.Request( "2x2" );
+
+	loader.Cancel( queued );
+	loader.Cancel( decoding );
+	EXPECT_EQ( loader.GetStatistics().m_queue_depth, 0u );
+
+	release_worker.set_value();
+	loader.WaitForAll();
+
+	EXPECT_TRUE( loader.CollectCompleted().empty() );
+	EXPECT_LE( decode_count, 1 );
+
+	const auto statistics = loader.GetStatistics();
+	EXPECT_EQ( statistics.m_cancelled, 2u );
+	EXPECT_EQ( statistics.m_queue_depth, 0u );
+}
+
+TEST( AsyncTextureLoader, MeasuresLatency )
+{
+	wmr::AsyncTextureLoader loader( 1, []( const wmr::TextureLoadRequest& request, wmr::DecodedTexture& texture, std::string& error )
+	{
+		std::this_thread::sleep_for( std::chrono::milliseconds( 5 ) );
+		return DecodeSize( request, texture, error );
+	} );
+
+	loader.Request( "1x1" );
+	loader.Request( "1x1" );
+	loader.WaitForAll();
+
+	const auto statistics = loader.GetStatistics();
+	EXPECT_EQ( statistics.m_loaded, 2u );
+	EXPECT_EQ( statistics.m_latency.m_sample_count, 2u );
+	EXPECT_GE( statistics.m_latency.m_min, 5.0 );
+
+	// The second request waited for the first one on the single worker
+	EXPECT_GE( statistics.m_latency.m_p95, 10.0 );
+}
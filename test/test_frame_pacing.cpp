@@ -0,0 +1,98 @@
+// Copyright 2019 Breda University of Applied Sciences and Team Wisp (Viktor Zoutman, Emilio Laiso, Jens Hagen, Meine Zeinstra, Tahar Meijs, Koen Buitenhuis, Niels Brunekreef, Darius Bouma, Florian Schut)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "plugin/renderer/frame_pacing.hpp"
+
+#include <gtest/gtest.h>
+
+// C++ standard
+#include <cstdint>
+#include <deque>
+
+TEST( frame_pacing, three_frames_in_flight_rely_on_the_wait_of_wisp )
+{
+	// With as many frames in flight as back buffers, the only frame to wait for uses the current frame index
+	for( std::uint32_t frame_index = 0; frame_index < 3; ++frame_index )
+	{
+		EXPECT_FALSE( wmr::GetFrameIndexToWaitFor( frame_index, 3, 3 ).has_value() );
+	}
+}
+
+TEST( frame_pacing, never_waits_for_the_current_frame_index )
+{
+	for( std::uint32_t back_buffer_count = 1; back_buffer_count <= 4; ++back_buffer_count )
+	{
+		for( std::uint32_t frames_in_flight = 0; frames_in_flight <= back_buffer_count + 1; ++frames_in_flight )
+		{
+			for( std::uint32_t frame_index = 0; frame_index < back_buffer_count; ++frame_index )
+			{
+				auto wait_index = wmr::GetFrameIndexToWaitFor( frame_index, back_buffer_count, frames_in_flight );
+
+				if( wait_index.has_value() )
+				{
+					EXPECT_NE( *wait_index, frame_index );
+					EXPECT_LT( *wait_index, back_buffer_count );
+				}
+			}
+		}
+	}
+}
+
+TEST( frame_pacing, limits_the_frames_in_flight )
+{
+	const std::uint32_t back_buffer_count = 3;
+
+	for( std::uint32_t frames_in_flight = 1; frames_in_flight <= back_buffer_count; ++frames_in_flight )
+	{
+		// Frame numbers that were submitted and have not been waited for, the GPU finishes them in order
+		std::deque<std::uint32_t> in_flight;
+
+		for( std::uint32_t frame = 0; frame < 20; ++frame )
+		{
+			const auto frame_index = frame % back_buffer_count;
+
+			auto finish_up_to = [&in_flight]( std::uint32_t last_frame )
+			{
+				while( !in_flight.empty() && in_flight.front() <= last_frame )
+				{
+					in_flight.pop_front();
+				}
+			};
+
+			// The wait of the plug-in, for the last frame on the returned frame index
+			if( auto wait_index = wmr::GetFrameIndexToWaitFor( frame_index, back_buffer_count, frames_in_flight ) )
+			{
+				const auto distance = ( frame_index + back_buffer_count - *wait_index ) % back_buffer_count;
+				if( frame >= distance )
+				{
+					finish_up_to( frame - distance );
+				}
+			}
+
+			// The wait of Wisp, for the last frame on the current frame index
+			if( frame >= back_buffer_count )
+			{
+				finish_up_to( frame - back_buffer_count );
+			}
+
+			EXPECT_LT( in_flight.size(), frames_in_flight );
+
+			in_flight.push_back( frame );
+		}
+
+		// Steady state: the GPU may work on exactly the requested number of frames
+		EXPECT_EQ( in_flight.size(), frames_in_flight );
+	}
+}
@@ -0,0 +1,302 @@
+// Copyright 2019 Breda University of Applied Sciences and Team Wisp (Viktor Zoutman, Emilio Laiso, Jens Hagen, Meine Zeinstra, Tahar Meijs, Koen Buitenhuis, Niels Brunekreef, Darius Bouma, Florian Schut)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "synthetic_meshes.hpp"
+
+#include <gtest/gtest.h>
+
+// C++ standard
+#include <cstring>
+#include <memory>
+
+// Every triangle corner of the source has to be reproduced exactly by the vertex it is indexed with
+static void ExpectCornersMatch( const wmr::MeshSource& source, const std::vector<synthetic::Vertex>& vertices, const std::vector<std::uint32_t>& indices )
+{
+	ASSERT_EQ( indices.size(), source.m_corner_points.size() );
+
+	for( size_t corner = 0; corner < indices.size(); ++corner )
+	{
+		ASSERT_LT( indices[corner], vertices.size() );
+		const auto& vertex = vertices[indices[corner]];
+
+		auto point = source.m_corner_points[corner];
+		auto normal = source.m_corner_normals[corner];
+		auto tangent = source.m_corner_tangents[corner];
+		auto uv = source.m_corner_uvs[corner];
+
+		for( int i = 0; i < 3; ++i )
+		{
+			EXPECT_EQ( vertex.m_pos[i], source.m_points[point * 3 + i] );
+			EXPECT_EQ( vertex.m_normal[i], source.m_normals[normal * 3 + i] );
+			EXPECT_EQ( vertex.m_tangent[i], source.m_tangents[tangent * 3 + i] );
+			EXPECT_EQ( vertex.m_bitangent[i], source.m_bitangents[normal * 3 + i] );
+		}
+
+		EXPECT_EQ( vertex.m_uv[0], source.m_u[uv] );
+		EXPECT_EQ( vertex.m_uv[1], source.m_v[uv] );
+	}
+}
+
+TEST( mesh_converter, grid )
+{
+	auto source = synthetic::MakeGrid( 16, 8 );
+	ASSERT_TRUE( source.IsValid() );
+	EXPECT_EQ( source.GetTriangleCount(), 16u * 8u * 2u );
+
+	std::vector<synthetic::Vertex> vertices;
+	std::vector<std::uint32_t> indices;
+	wmr::ConvertMesh( source, vertices, indices );
+
+	// One vertex per grid point
+	EXPECT_EQ( vertices.size(), source.GetPointCount() );
+	ExpectCornersMatch( source, vertices, indices );
+}
+
+TEST( mesh_converter, sphere_seam )
+{
+	const std::uint32_t segments = 24;
+	const std::uint32_t rings = 12;
+
+	auto source = synthetic::MakeSphere( segments, rings );
+	ASSERT_TRUE( source.IsValid() );
+
+	std::vector<synthetic::Vertex> vertices;
+	std::vector<std::uint32_t> indices;
+	wmr::ConvertMesh( source, vertices, indices );
+
+	// The UV seam duplicates one column of points
+	EXPECT_EQ( vertices.size(), ( segments + 1 ) * ( rings + 1 ) );
+	ExpectCornersMatch( source, vertices, indices );
+}
+
+TEST( mesh_converter, scan )
+{
+	auto source = synthetic::MakeScan( 5000 );
+	ASSERT_TRUE( source.IsValid() );
+
+	std::vector<synthetic::Vertex> vertices;
+	std::vector<std::uint32_t> indices;
+	wmr::ConvertMesh( source, vertices, indices );
+
+	// Chart borders split vertices, but the mesh should still be welded considerably
+	EXPECT_GT( vertices.size(), source.GetPointCount() );
+	EXPECT_LT( vertices.size(), indices.size() / 2 );
+	ExpectCornersMatch( source, vertices, indices );
+}
+
+TEST( mesh_converter, invalid_source )
+{
+	auto source = synthetic::MakeGrid( 2, 2 );
+	source.m_corner_uvs.back() = static_cast<std::int32_t>( source.m_u.size() );
+	EXPECT_FALSE( source.IsValid() );
+
+	source = synthetic::MakeGrid( 2, 2 );
+	source.m_corner_normals.pop_back();
+	EXPECT_FALSE( source.IsValid() );
+}
+
+TEST( mesh_converter, parallel_matches_single_threaded )
+{
+	const wmr::MeshSource sources[] = {
+		synthetic::MakeGrid( 40, 30 ),
+		synthetic::MakeSphere( 48, 24 ),
+		synthetic::MakeScan( 5000 )
+	};
+
+	for( const auto& source : sources )
+	{
+		std::vector<synthetic::Vertex> expected_vertices;
+		std::vector<std::uint32_t> expected_indices;
+		wmr::ConvertMesh( source, expected_vertices, expected_indices );
+
+		for( std::size_t thread_count : { 1, 2, 3, 4, 7 } )
+		{
+			wmr::ThreadPool pool( thread_count );
+
+			// Use tiny chunks, so every mesh gets split over all threads
+			std::vector<synthetic::Vertex> vertices;
+			std::vector<std::uint32_t> indices;
+			wmr::ConvertMesh( source, vertices, indices, &pool, 1 );
+
+			EXPECT_EQ( indices, expected_indices );
+			ASSERT_EQ( vertices.size(), expected_vertices.size() );
+			EXPECT_EQ( std::memcmp( vertices.data(), expected_vertices.data(), vertices.size() * sizeof( synthetic::Vertex ) ), 0 );
+		}
+	}
+}
+
+TEST( mesh_converter, resolve_triangle_corners )
+{
+	// A quad (points 0-3) and a pentagon (points 1, 4, 5, 6, 2) that share an edge
+	wmr::PolygonSource polygons;
+	polygons.m_polygon_vertex_counts = { 4, 5 };
+	polygons.m_polygon_triangle_counts = { 2, 3 };
+	polygons.m_face_vertex_points = { 0, 1, 2, 3, 1, 4, 5, 6, 2 };
+	polygons.m_face_vertex_normals = { 10, 11, 12, 13, 14, 15, 16, 17, 18 };
+	polygons.m_face_vertex_tangents = { 20, 21, 22, 23, 24, 25, 26, 27, 28 };
+	polygons.m_face_vertex_uvs = { 30, 31, 32, 33, 34, 35, 36, 37, 38 };
+	polygons.m_triangle_points = { 0, 1, 2, 0, 2, 3, 1, 4, 5, 1, 5, 6, 1, 6, 2 };
+
+	// Face-vertex used by every triangle corner
+	const std::vector<std::int32_t> expected_face_vertices = { 0, 1, 2, 0, 2, 3, 4, 5, 6, 4, 6, 7, 4, 7, 8 };
+
+	for( std::size_t thread_count : { 0, 1, 3 } )
+	{
+		std::unique_ptr<wmr::ThreadPool> pool = thread_count ? std::make_unique<wmr::ThreadPool>( thread_count ) : nullptr;
+
+		wmr::MeshSource source;
+		wmr::ResolveTriangleCorners( polygons, source, pool.get() );
+
+		ASSERT_EQ( source.m_corner_points, polygons.m_triangle_points );
+		ASSERT_EQ( source.m_corner_normals.size(), expected_face_vertices.size() );
+
+		for( std::size_t corner = 0; corner < expected_face_vertices.size(); ++corner )
+		{
+			auto face_vertex = expected_face_vertices[corner];
+			EXPECT_EQ( source.m_corner_normals[corner], polygons.m_face_vertex_normals[face_vertex] );
+			EXPECT_EQ( source.m_corner_tangents[corner], polygons.m_face_vertex_tangents[face_vertex] );
+			EXPECT_EQ( source.m_corner_uvs[corner], polygons.m_face_vertex_uvs[face_vertex] );
+		}
+	}
+}
+
+TEST( mesh_converter, resolve_offsets_match_point_search )
+{
+	auto polygons = synthetic::MakeCappedCylinderPolygons( 64, 3 );
+
+	wmr::MeshSource expected;
+	auto point_polygons = polygons;
+	point_polygons.m_triangle_face_vertices.clear();
+	wmr::ResolveTriangleCorners( point_polygons, expected );
+
+	// 64 * 3 quads and two caps of 62 triangles each
+	EXPECT_EQ( expected.GetTriangleCount(), 64u * 3u * 2u + 62u * 2u );
+
+	wmr::MeshSource source;
+	wmr::ResolveTriangleCorners( polygons, source );
+
+	EXPECT_EQ( source.m_corner_points, expected.m_corner_points );
+	EXPECT_EQ( source.m_corner_normals, expected.m_corner_normals );
+	EXPECT_EQ( source.m_corner_tangents, expected.m_corner_tangents );
+	EXPECT_EQ( source.m_corner_uvs, expected.m_corner_uvs );
+}
+
+TEST( mesh_converter, same_vertex_compares_every_member )
+{
+	synthetic::Vertex a{};
+	a.m_pos[0] = 1.0f;
+	a.m_uv[1] = 0.5f;
+
+	EXPECT_TRUE( wmr::IsSameVertex( a, a ) );
+
+	auto b = a;
+	b.m_bitangent[2] = 1.0f;
+	EXPECT_FALSE( wmr::IsSameVertex( a, b ) );
+
+	b = a;
+	b.m_uv[1] = 0.25f;
+	EXPECT_FALSE( wmr::IsSameVertex( a, b ) );
+}
+
+TEST( mesh_converter, patch_vertices_matches_full_conversion )
+{
+	auto source = synthetic::MakeScan( 5000 );
+
+	std::vector<synthetic::Vertex> vertices;
+	std::vector<std::uint32_t> indices;
+	std::vector<wmr::FaceVertexKey> unique_keys;
+	wmr::ConvertMesh( source, vertices, indices, unique_keys );
+
+	// Nothing changed, so nothing has to be uploaded
+	std::vector<wmr::VertexRange> dirty_ranges;
+	wmr::PatchVertices( source, unique_keys, vertices, dirty_ranges );
+	EXPECT_TRUE( dirty_ranges.empty() );
+
+	// Move a few points and change the normal of one of them, like a move tool edit would
+	const auto original_vertices = vertices;
+	for( std::int32_t point : { 10, 11, 2000 } )
+	{
+		source.m_points[point * 3 + 1] += 0.5f;
+	}
+	source.m_normals[11 * 3 + 0] = 0.25f;
+
+	wmr::PatchVertices( source, unique_keys, vertices, dirty_ranges );
+
+	std::vector<synthetic::Vertex> expected_vertices;
+	std::vector<std::uint32_t> expected_indices;
+	wmr::ConvertMesh( source, expected_vertices, expected_indices );
+
+	ASSERT_EQ( vertices.size(), expected_vertices.size() );
+	EXPECT_EQ( indices, expected_indices );
+	EXPECT_EQ( std::memcmp( vertices.data(), expected_vertices.data(), vertices.size() * sizeof( synthetic::Vertex ) ), 0 );
+
+	// Every vertex outside of the dirty ranges is unchanged
+	ASSERT_FALSE( dirty_ranges.empty() );
+	std::vector<bool> in_range( vertices.size(), false );
+	for( const auto& range : dirty_ranges )
+	{
+		ASSERT_LE( range.m_first + range.m_count, vertices.size() );
+		std::fill_n( in_range.begin() + range.m_first, range.m_count, true );
+	}
+
+	std::size_t dirty_vertex_count = 0;
+	for( std::size_t i = 0; i < vertices.size(); ++i )
+	{
+		if( in_range[i] )
+		{
+			++dirty_vertex_count;
+			continue;
+		}
+
+		EXPECT_EQ( std::memcmp( &vertices[i], &original_vertices[i], sizeof( synthetic::Vertex ) ), 0 );
+	}
+
+	EXPECT_LT( dirty_vertex_count, vertices.size() / 10 );
+}
+
+TEST( mesh_converter, build_dirty_ranges )
+{
+	std::vector<wmr::VertexRange> ranges;
+	wmr::BuildDirtyRanges( { 0, 1, 1, 0, 0, 1, 0, 0, 0, 0, 1 }, 2, ranges );
+
+	ASSERT_EQ( ranges.size(), 2u );
+	EXPECT_EQ( ranges[0].m_first, 1u );
+	EXPECT_EQ( ranges[0].m_count, 5u );
+	EXPECT_EQ( ranges[1].m_first, 10u );
+	EXPECT_EQ( ranges[1].m_count, 1u );
+
+	wmr::BuildDirtyRanges( { 0, 0, 0 }, 2, ranges );
+	EXPECT_TRUE( ranges.empty() );
+}
+
+TEST( mesh_converter, topology_detects_changes )
+{
+	auto polygons = synthetic::MakeCappedCylinderPolygons( 16, 2 );
+	auto source = synthetic::MakeGrid( 4, 4 );
+	const auto topology = wmr::GetMeshTopology( source, polygons );
+
+	// Moving points does not change the topology
+	source.m_points[0] += 1.0f;
+	EXPECT_EQ( wmr::GetMeshTopology( source, polygons ), topology );
+
+	// Rewiring a face-vertex does
+	auto rewired = polygons;
+	std::swap( rewired.m_face_vertex_points[0], rewired.m_face_vertex_points[1] );
+	EXPECT_FALSE( wmr::GetMeshTopology( source, rewired ) == topology );
+
+	// Adding a UV does as well
+	source.m_u.push_back( 0.0f );
+	source.m_v.push_back( 0.0f );
+	EXPECT_FALSE( wmr::GetMeshTopology( source, polygons ) == topology );
+}
@@ -0,0 +1,205 @@
+// Copyright 2019 Breda University of Applied Sciences and Team Wisp (Viktor Zoutman, Emilio Laiso, Jens Hagen, Meine Zeinstra, Tahar Meijs, Koen Buitenhuis, Niels Brunekreef, Darius Bouma, Florian Schut)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "plugin/framegraph/pipeline_description.hpp"
+
+#include <gtest/gtest.h>
+
+// C++ standard
+#include <sstream>
+#include <string>
+
+namespace
+{
+	bool Parse( const std::string& text, wmr::PipelineDescription& description, std::string& error )
+	{
+		std::istringstream stream( text );
+		return wmr::ParsePipelineDescription( stream, description, error );
+	}
+
+	std::string ShippedPipeline( const std::string& file_name )
+	{
+		return std::string( WMR_PIPELINE_DIRECTORY ) + "/" + file_name;
+	}
+}
+
+TEST( PipelineDescription, ParsesTasksInputsAndToggles )
+{
+	wmr::PipelineDescription description;
+	std::string error;
+
+	ASSERT_TRUE( Parse(
+		"# Comment\n"
+		"pipeline test\n"
+		"requires ray_tracing\n"
+		"\n"
+		"task deferred_main\n"
+		"task bloom_extract_bright inputs deferred_main toggle bloom\n"
+		"  task post_processing toggle post_processing inputs bloom_extract_bright deferred_main\n",
+		description, error ) ) << error;
+
+	EXPECT_EQ( description.m_name, "test" );
+	EXPECT_TRUE( description.m_requires_ray_tracing );
+	ASSERT_EQ( description.m_tasks.size(), 3u );
+
+	EXPECT_TRUE( description.m_tasks[0].m_inputs.empty() );
+	EXPECT_TRUE( description.m_tasks[0].m_toggle.empty() );
+	EXPECT_EQ( description.m_tasks[0].GetSignature(), "deferred_main()" );
+
+	EXPECT_EQ( description.m_tasks[1].m_toggle, "bloom" );
+	EXPECT_EQ( description.m_tasks[1].m_line, 6u );
+	EXPECT_EQ( description.m_tasks[1].GetSignature(), "bloom_extract_bright(deferred_main)" );
+
+	EXPECT_EQ( description.m_tasks[2].m_toggle, "post_processing" );
+	EXPECT_EQ( description.m_tasks[2].GetSignature(), "post_processing(bloom_extract_bright,deferred_main)" );
+
+	EXPECT_EQ( description.FindTask( "bloom_extract_bright" ), 1u );
+	EXPECT_EQ( description.FindTask( "hbao" ), 3u );
+}
+
+TEST( PipelineDescription, RejectsMalformedDescriptions )
+{
+	wmr::PipelineDescription description;
+	std::string error;
+
+	EXPECT_FALSE( Parse( "task deferred_main\n", description, error ) );
+	EXPECT_FALSE( Parse( "pipeline test\n", description, error ) );
+	EXPECT_FALSE( Parse( "pipeline test\npipeline again\ntask a\n", description, error ) );
+	EXPECT_FALSE( Parse( "pipeline test\nrequires magic\ntask a\n", description, error ) );
+	EXPECT_FALSE( Parse( "pipeline test\nshader a\n", description, error ) );
+	EXPECT_FALSE( Parse( "pipeline test\ntask\n", description, error ) );
+	EXPECT_FALSE( Parse( "pipeline test\ntask a toggle\n", description, error ) );
+
+	EXPECT_FALSE( Parse( "pipeline test\ntask a b\n", description, error ) );
+	EXPECT_EQ( error, "line 2: unexpected \"b\"" );
+
+	// Added to every pipeline by the frame graph manager
+	EXPECT_FALSE( Parse( "pipeline test\ntask gpu_frame_timer_begin\ntask a\n", description, error ) );
+	EXPECT_EQ( error, "line 2: the task \"gpu_frame_timer_begin\" is added by the renderer" );
+	EXPECT_FALSE( Parse( "pipeline test\ntask a\ntask gpu_frame_timer_end\n", description, error ) );
+	EXPECT_FALSE( Parse( "pipeline test\ntask vertex_patch_upload\ntask a\n", description, error ) );
+}
+
+TEST( PipelineDescription, RejectsInvalidTaskOrder )
+{
+	wmr::PipelineDescription description;
+	std::string error;
+
+	// Reads the output of a later task
+	EXPECT_FALSE( Parse( "pipeline test\ntask a inputs b\ntask b\n", description, error ) );
+	EXPECT_EQ( error, "line 2: the task \"a\" reads \"b\", which executes after it" );
+
+	// Reads its own output
+	EXPECT_FALSE( Parse( "pipeline test\ntask a inputs a\n", description, error ) );
+
+	// Reads a task that does not exist
+	EXPECT_FALSE( Parse( "pipeline test\ntask a inputs c\n", description, error ) );
+
+	// Declared twice
+	EXPECT_FALSE( Parse( "pipeline test\ntask a\ntask b inputs a\ntask a\n", description, error ) );
+	EXPECT_EQ( error, "line 4: the task \"a\" is declared twice" );
+}
+
+TEST( PipelineDescription, ShippedDescriptionsAreValid )
+{
+	const struct
+	{
+		const char* m_file_name;
+		const char* m_name;
+		bool m_requires_ray_tracing;
+	} pipelines[] =
+	{
+		{ "deferred.pipeline", "deferred", false },
+		{ "deferred_low_end.pipeline", "deferred", false },
+		{ "hybrid_ray_tracing.pipeline", "hybrid_ray_tracing", true },
+		{ "progressive_path_tracing.pipeline", "progressive_path_tracing", true }
+	};
+
+	for ( const auto& pipeline : pipelines )
+	{
+		SCOPED_TRACE( pipeline.m_file_name );
+
+		wmr::PipelineDescription description;
+		std::string error;
+
+		ASSERT_TRUE( wmr::LoadPipelineDescription( ShippedPipeline( pipeline.m_file_name ), description, error ) ) << error;
+
+		EXPECT_EQ( description.m_name, pipeline.m_name );
+		EXPECT_EQ( description.m_requires_ray_tracing, pipeline.m_requires_ray_tracing );
+
+		// The viewport reads the output of the readback tasks
+		EXPECT_LT( description.FindTask( "pixel_data_readback" ), description.m_tasks.size() );
+		EXPECT_LT( description.FindTask( "depth_data_readback" ), description.m_tasks.size() );
+	}
+}
+
+TEST( PipelineDescription, ReportsMissingFiles )
+{
+	wmr::PipelineDescription description;
+	std::string error;
+
+	EXPECT_FALSE( wmr::LoadPipelineDescription( ShippedPipeline( "does_not_exist.pipeline" ), description, error ) );
+	EXPECT_NE( error.find( "cannot open" ), std::string::npos );
+}
+
+TEST( PipelineDescription, PruningBypassesDisabledChains )
+{
+	wmr::PipelineDescription description;
+	std::string error;
+
+	ASSERT_TRUE( wmr::LoadPipelineDescription( ShippedPipeline( "deferred.pipeline" ), description, error ) ) << error;
+
+	auto signature_of = []( const wmr::PipelineDescription& pipeline, const std::string& name )
+	{
+		const auto index = pipeline.FindTask( name );
+		return index < pipeline.m_tasks.size() ? pipeline.m_tasks[index].GetSignature() : std::string();
+	};
+
+	// Nothing disabled
+	const auto complete = wmr::PrunePipeline( description, {} );
+	EXPECT_EQ( complete.m_tasks.size(), description.m_tasks.size() );
+
+	// Depth of field: post-processing reads the bloom composition directly
+	const auto no_dof = wmr::PrunePipeline( description, { "dof" } );
+	EXPECT_EQ( no_dof.m_tasks.size(), description.m_tasks.size() - 7 );
+	EXPECT_EQ( signature_of( no_dof, "post_processing" ), "post_processing(bloom_composition)" );
+	EXPECT_TRUE( wmr::ValidatePipelineOrder( no_dof, error ) ) << error;
+
+	// Bloom: the depth of field reads the deferred composition directly
+	const auto no_bloom = wmr::PrunePipeline( description, { "bloom" } );
+	EXPECT_EQ( no_bloom.m_tasks.size(), description.m_tasks.size() - 4 );
+	EXPECT_EQ( signature_of( no_bloom, "down_scale" ), "down_scale(deferred_composition,dof_coc)" );
+	EXPECT_EQ( signature_of( no_bloom, "dof_composition" ), "dof_composition(deferred_composition,dof_bokeh_post_filter,dof_coc)" );
+	EXPECT_TRUE( wmr::ValidatePipelineOrder( no_bloom, error ) ) << error;
+
+	// Everything that can be disabled: chains of bypasses resolve to the first remaining output
+	const auto minimal = wmr::PrunePipeline( description, { "bloom", "dof", "hbao" } );
+	EXPECT_EQ( minimal.FindTask( "hbao" ), minimal.m_tasks.size() );
+	EXPECT_EQ( signature_of( minimal, "post_processing" ), "post_processing(deferred_composition)" );
+	EXPECT_EQ( signature_of( minimal, "pixel_data_readback" ), "pixel_data_readback(post_processing)" );
+	EXPECT_TRUE( wmr::ValidatePipelineOrder( minimal, error ) ) << error;
+}
+
+TEST( PipelineDescription, PruningDropsInputsWithoutBypass )
+{
+	wmr::PipelineDescription description;
+	std::string error;
+
+	ASSERT_TRUE( Parse( "pipeline test\ntask a toggle x\ntask b inputs a\n", description, error ) ) << error;
+
+	const auto pruned = wmr::PrunePipeline( description, { "x" } );
+	ASSERT_EQ( pruned.m_tasks.size(), 1u );
+	EXPECT_EQ( pruned.m_tasks[0].GetSignature(), "b()" );
+}
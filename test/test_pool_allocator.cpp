@@ -0,0 +1,198 @@
+// Copyright 2019 Breda University of Applied Sciences and Team Wisp (Viktor Zoutman, Emilio Laiso, Jens Hagen, Meine Zeinstra, Tahar Meijs, Koen Buitenhuis, Niels Brunekreef, Darius Bouma, Florian Schut)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "plugin/renderer/pool_allocator.hpp"
+
+#include <gtest/gtest.h>
+
+// C++ standard
+#include <cstdint>
+#include <vector>
+
+TEST( pool_allocator, best_fit )
+{
+	wmr::PoolAllocator allocator;
+	auto page = allocator.AddPage( 1000 );
+
+	auto a = allocator.Allocate( page, 100 );
+	auto b = allocator.Allocate( page, 300 );
+	auto c = allocator.Allocate( page, 50 );
+	auto d = allocator.Allocate( page, 200 );
+	auto e = allocator.Allocate( page, 100 );
+	ASSERT_TRUE( a && b && c && d && e );
+
+	// Leaves free blocks of 300 (b), 200 (d), and 250 (tail)
+	allocator.Free( *b );
+	allocator.Free( *d );
+
+	// The smallest block that fits is used, even though a larger one comes first
+	auto f = allocator.Allocate( page, 180 );
+	ASSERT_TRUE( f );
+	EXPECT_EQ( f->m_offset, d->m_offset );
+
+	EXPECT_EQ( allocator.GetPageUsedSize( page ), 100u + 50u + 100u + 180u );
+	EXPECT_EQ( allocator.GetPageLargestFreeBlock( page ), 300u );
+	EXPECT_FALSE( allocator.Allocate( page, 301 ) );
+}
+
+TEST( pool_allocator, free_merges_neighbours )
+{
+	wmr::PoolAllocator allocator;
+	auto page = allocator.AddPage( 400 );
+
+	std::vector<wmr::PoolAllocation> allocations;
+	for( int i = 0; i < 4; ++i )
+	{
+		allocations.push_back( *allocator.Allocate( page, 100 ) );
+	}
+	EXPECT_FALSE( allocator.Allocate( page, 1 ) );
+
+	// Free in an order that needs merges on both sides
+	allocator.Free( allocations[0] );
+	allocator.Free( allocations[2] );
+	allocator.Free( allocations[1] );
+	EXPECT_EQ( allocator.GetPageLargestFreeBlock( page ), 300u );
+
+	allocator.Free( allocations[3] );
+	EXPECT_EQ( allocator.GetPageLargestFreeBlock( page ), 400u );
+	EXPECT_EQ( allocator.GetPageUsedSize( page ), 0u );
+
+	auto all = allocator.Allocate( page, 400 );
+	ASSERT_TRUE( all );
+	EXPECT_EQ( all->m_offset, 0u );
+}
+
+TEST( pool_allocator, alignment )
+{
+	wmr::PoolAllocator allocator( 16 );
+	auto page = allocator.AddPage( 256 );
+
+	auto a = allocator.Allocate( page, 1 );
+	auto b = allocator.Allocate( page, 17 );
+	ASSERT_TRUE( a && b );
+
+	EXPECT_EQ( a->m_size, 16u );
+	EXPECT_EQ( b->m_offset, 16u );
+	EXPECT_EQ( b->m_size, 32u );
+}
+
+TEST( pool_allocator, statistics )
+{
+	wmr::PoolAllocator allocator;
+	auto page = allocator.AddPage( 1000 );
+
+	auto a = allocator.Allocate( page, 250 );
+	auto b = allocator.Allocate( page, 250 );
+	auto c = allocator.Allocate( page, 250 );
+	ASSERT_TRUE( a && b && c );
+	allocator.Free( *b );
+
+	// 500 bytes free, split over two blocks of 250
+	auto statistics = allocator.GetStatistics();
+	EXPECT_EQ( statistics.m_page_count, 1u );
+	EXPECT_EQ( statistics.m_capacity, 1000u );
+	EXPECT_EQ( statistics.m_used, 500u );
+	EXPECT_EQ( statistics.m_largest_free_block, 250u );
+	EXPECT_FLOAT_EQ( statistics.m_occupancy, 0.5f );
+	EXPECT_FLOAT_EQ( statistics.m_fragmentation, 0.5f );
+
+	allocator.Free( *c );
+	EXPECT_FLOAT_EQ( allocator.GetStatistics().m_fragmentation, 0.0f );
+}
+
+TEST( pool_allocator, released_page_slots_are_reused )
+{
+	wmr::PoolAllocator allocator;
+	auto first = allocator.AddPage( 100 );
+	auto second = allocator.AddPage( 200 );
+
+	allocator.ReleasePage( first );
+	EXPECT_FALSE( allocator.IsPageActive( first ) );
+	EXPECT_FALSE( allocator.Allocate( first, 10 ) );
+	EXPECT_EQ( allocator.GetStatistics().m_page_count, 1u );
+
+	// The new page takes the slot of the released page, the other page keeps its index
+	auto third = allocator.AddPage( 300 );
+	EXPECT_EQ( third, first );
+	EXPECT_EQ( allocator.GetPageCapacity( third ), 300u );
+	EXPECT_EQ( allocator.GetPageCapacity( second ), 200u );
+}
+
+TEST( model_pool_allocator, grows_and_picks_best_page )
+{
+	wmr::ModelPoolAllocator allocator;
+
+	// The caller adds a page when nothing fits
+	EXPECT_FALSE( allocator.Allocate( 10, 10 ) );
+	auto first = allocator.AddPage( 1000, 100 );
+
+	auto a = allocator.Allocate( 900, 50 );
+	ASSERT_TRUE( a );
+	EXPECT_EQ( a->m_vertices.m_page, first );
+	EXPECT_EQ( a->m_indices.m_page, first );
+
+	// Index data does not fit in the first page anymore
+	EXPECT_FALSE( allocator.Allocate( 50, 60 ) );
+	auto second = allocator.AddPage( 1000, 100 );
+
+	auto b = allocator.Allocate( 50, 60 );
+	ASSERT_TRUE( b );
+	EXPECT_EQ( b->m_vertices.m_page, second );
+
+	// Fits in both pages, the first page is the tighter fit
+	auto c = allocator.Allocate( 90, 30 );
+	ASSERT_TRUE( c );
+	EXPECT_EQ( c->m_vertices.m_page, first );
+
+	// Excluding a page forces the allocation elsewhere
+	auto d = allocator.Allocate( 5, 5, first );
+	ASSERT_TRUE( d );
+	EXPECT_EQ( d->m_vertices.m_page, second );
+}
+
+TEST( model_pool_allocator, sparse_page_compaction )
+{
+	wmr::ModelPoolAllocator allocator;
+	auto first = allocator.AddPage( 1000, 1000 );
+
+	// A single page is never compacted
+	auto a = allocator.Allocate( 100, 100 );
+	ASSERT_TRUE( a );
+	EXPECT_FALSE( allocator.FindSparsePage( 0.25f ) );
+
+	auto b = allocator.Allocate( 800, 800 );
+	ASSERT_TRUE( b );
+	auto second = allocator.AddPage( 1000, 1000 );
+	auto c = allocator.Allocate( 500, 100, first );
+	ASSERT_TRUE( c );
+
+	// The first page is 90% full and the second page 50%, neither is sparse
+	EXPECT_FALSE( allocator.FindSparsePage( 0.25f ) );
+
+	// After deleting the large model, the first page only holds 10% and can be emptied into the second page
+	allocator.Free( *b );
+	auto sparse = allocator.FindSparsePage( 0.25f );
+	ASSERT_TRUE( sparse );
+	EXPECT_EQ( *sparse, first );
+
+	auto moved = allocator.Allocate( a->m_vertices.m_size, a->m_indices.m_size, *sparse );
+	ASSERT_TRUE( moved );
+	EXPECT_EQ( moved->m_vertices.m_page, second );
+	allocator.Free( *a );
+
+	EXPECT_TRUE( allocator.IsPageEmpty( first ) );
+	allocator.ReleasePage( first );
+	EXPECT_EQ( allocator.GetVertexStatistics().m_page_count, 1u );
+	EXPECT_EQ( allocator.GetVertexStatistics().m_used, 600u );
+}
@@ -0,0 +1,105 @@
+// Copyright 2019 Breda University of Applied Sciences and Team Wisp (Viktor Zoutman, Emilio Laiso, Jens Hagen, Meine Zeinstra, Tahar Meijs, Koen Buitenhuis, Niels Brunekreef, Darius Bouma, Florian Schut)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "miscellaneous/profiler.hpp"
+
+#include <gtest/gtest.h>
+
+// C++ standard
+#include <chrono>
+#include <thread>
+
+TEST( RollingTimingStatistics, EmptyWindowIsZero )
+{
+	wmr::RollingTimingStatistics timer( 8 );
+	const auto statistics = timer.GetStatistics();
+
+	EXPECT_EQ( statistics.m_sample_count, 0u );
+	EXPECT_EQ( statistics.m_min, 0.0 );
+	EXPECT_EQ( statistics.m_average, 0.0 );
+	EXPECT_EQ( statistics.m_p95, 0.0 );
+}
+
+TEST( RollingTimingStatistics, MinAverageAndPercentile )
+{
+	wmr::RollingTimingStatistics timer( 100 );
+
+	// 1 ... 100 in a scrambled order
+	for ( int i = 0; i < 100; ++i )
+	{
+		timer.AddSample( static_cast<double>( ( i * 37 ) % 100 + 1 ) );
+	}
+
+	const auto statistics = timer.GetStatistics();
+	EXPECT_EQ( statistics.m_sample_count, 100u );
+	EXPECT_DOUBLE_EQ( statistics.m_min, 1.0 );
+	EXPECT_DOUBLE_EQ( statistics.m_average, 50.5 );
+	EXPECT_DOUBLE_EQ( statistics.m_p95, 95.0 );
+}
+
+TEST( RollingTimingStatistics, OldSamplesLeaveTheWindow )
+{
+	wmr::RollingTimingStatistics timer( 4 );
+
+	for ( double sample : { 100.0, 100.0, 1.0, 2.0, 3.0, 4.0 } )
+	{
+		timer.AddSample( sample );
+	}
+
+	const auto statistics = timer.GetStatistics();
+	EXPECT_EQ( statistics.m_sample_count, 4u );
+	EXPECT_DOUBLE_EQ( statistics.m_min, 1.0 );
+	EXPECT_DOUBLE_EQ( statistics.m_average, 2.5 );
+	EXPECT_DOUBLE_EQ( statistics.m_p95, 4.0 );
+
+	timer.Reset();
+	EXPECT_EQ( timer.GetStatistics().m_sample_count, 0u );
+}
+
+TEST( Profiler, ReportsTimersInFirstSampleOrder )
+{
+	wmr::Profiler profiler( 16 );
+	profiler.AddSample( "gpu/deferred/frame", 4.0 );
+	profiler.AddSample( "cpu/renderer update", 1.0 );
+	profiler.AddSample( "gpu/deferred/frame", 6.0 );
+
+	const auto statistics = profiler.GetStatistics();
+	ASSERT_EQ( statistics.size(), 2u );
+
+	EXPECT_EQ( statistics[0].first, "gpu/deferred/frame" );
+	EXPECT_EQ( statistics[0].second.m_sample_count, 2u );
+	EXPECT_DOUBLE_EQ( statistics[0].second.m_average, 5.0 );
+
+	EXPECT_EQ( statistics[1].first, "cpu/renderer update" );
+	EXPECT_EQ( statistics[1].second.m_sample_count, 1u );
+
+	profiler.Reset();
+	EXPECT_TRUE( profiler.GetStatistics().empty() );
+}
+
+TEST( Profiler, ScopedTimerMeasuresItsScope )
+{
+	wmr::Profiler profiler;
+
+	{
+		wmr::ScopedCPUTimer timer( profiler, "cpu/sleep" );
+		std::this_thread::sleep_for( std::chrono::milliseconds( 2 ) );
+	}
+
+	const auto statistics = profiler.GetStatistics();
+	ASSERT_EQ( statistics.size(), 1u );
+	EXPECT_EQ( statistics[0].first, "cpu/sleep" );
+	EXPECT_GE( statistics[0].second.m_min, 2.0 );
+}
@@ -0,0 +1,143 @@
+// Copyright 2019 Breda University of Applied Sciences and Team Wisp (Viktor Zoutman, Emilio Laiso, Jens Hagen, Meine Zeinstra, Tahar Meijs, Koen Buitenhuis, Niels Brunekreef, Darius Bouma, Florian Schut)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "wisp_render_tasks/readback_ring.hpp"
+
+#include <gtest/gtest.h>
+
+// C++ standard
+#include <array>
+#include <cstdint>
+
+namespace
+{
+	//! Simulated GPU with one fence per frame index, like Wisp
+	struct FakeGpu
+	{
+		std::array<std::uint64_t, 3> m_completed_values = {};
+
+		wr::ReadbackRing::IsFenceComplete Query() const
+		{
+			return [ this ]( const wr::ReadbackFence& fence )
+			{
+				return m_completed_values[ fence.m_fence_index ] >= fence.m_value;
+			};
+		}
+	};
+
+	//! Record a frame: publish, acquire a write slot, and submit the copy
+	std::uint32_t RecordFrame( wr::ReadbackRing& ring, const FakeGpu& gpu, std::uint32_t frame )
+	{
+		ring.PublishNewestCompleted( gpu.Query() );
+
+		auto slot = ring.AcquireWriteSlot();
+		ring.Submit( slot, { frame % 3, frame + 1 } );
+
+		return slot;
+	}
+}
+
+TEST( readback_ring, nothing_is_published_before_a_copy_completes )
+{
+	wr::ReadbackRing ring( 3 );
+	FakeGpu gpu;
+
+	RecordFrame( ring, gpu, 0 );
+	RecordFrame( ring, gpu, 1 );
+
+	EXPECT_FALSE( ring.PublishNewestCompleted( gpu.Query() ).has_value() );
+}
+
+TEST( readback_ring, publishes_the_newest_completed_copy )
+{
+	wr::ReadbackRing ring( 3 );
+	FakeGpu gpu;
+
+	auto slot_0 = RecordFrame( ring, gpu, 0 );
+	auto slot_1 = RecordFrame( ring, gpu, 1 );
+
+	// Frame 1 completes before frame 0 is queried, frame 1 is newer so it wins
+	gpu.m_completed_values[ 0 ] = 1;
+	gpu.m_completed_values[ 1 ] = 2;
+
+	auto published = ring.PublishNewestCompleted( gpu.Query() );
+	ASSERT_TRUE( published.has_value() );
+	EXPECT_EQ( *published, slot_1 );
+	EXPECT_NE( slot_0, slot_1 );
+
+	// No newer copy completed, the published slot stays the same
+	EXPECT_EQ( ring.PublishNewestCompleted( gpu.Query() ), published );
+}
+
+TEST( readback_ring, never_writes_to_the_published_slot )
+{
+	wr::ReadbackRing ring( 3 );
+	FakeGpu gpu;
+
+	// Three frames in flight, the GPU lags behind by two frames
+	for( std::uint32_t frame = 0; frame < 64; ++frame )
+	{
+		if( frame >= 2 )
+		{
+			gpu.m_completed_values[ ( frame - 2 ) % 3 ] = frame - 1;
+		}
+
+		auto slot = RecordFrame( ring, gpu, frame );
+
+		auto published = ring.GetPublishedSlot();
+		if( published )
+		{
+			EXPECT_NE( slot, *published );
+		}
+	}
+
+	EXPECT_TRUE( ring.GetPublishedSlot().has_value() );
+}
+
+TEST( readback_ring, single_frame_in_flight_reads_the_previous_frame )
+{
+	wr::ReadbackRing ring( 3 );
+	FakeGpu gpu;
+
+	std::array<std::uint32_t, 8> slots;
+	for( std::uint32_t frame = 0; frame < slots.size(); ++frame )
+	{
+		// The GPU finished all previous frames before this frame is recorded
+		if( frame > 0 )
+		{
+			gpu.m_completed_values[ ( frame - 1 ) % 3 ] = frame;
+		}
+
+		slots[ frame ] = RecordFrame( ring, gpu, frame );
+
+		if( frame > 0 )
+		{
+			EXPECT_EQ( ring.GetPublishedSlot(), slots[ frame - 1 ] );
+		}
+	}
+}
+
+TEST( readback_ring, reset_forgets_submissions )
+{
+	wr::ReadbackRing ring( 2 );
+	FakeGpu gpu;
+
+	RecordFrame( ring, gpu, 0 );
+	gpu.m_completed_values[ 0 ] = 1;
+	EXPECT_TRUE( ring.PublishNewestCompleted( gpu.Query() ).has_value() );
+
+	ring.Reset();
+	EXPECT_FALSE( ring.GetPublishedSlot().has_value() );
+	EXPECT_EQ( ring.GetSlotCount(), 2u );
+}
@@ -0,0 +1,161 @@
+// Copyright 2019 Breda University of Applied Sciences and Team Wisp (Viktor Zoutman, Emilio Laiso, Jens Hagen, Meine Zeinstra, Tahar Meijs, Koen Buitenhuis, Niels Brunekreef, Darius Bouma, Florian Schut)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "plugin/renderer/resolution_scale_controller.hpp"
+
+#include <gtest/gtest.h>
+
+// C++ standard
+#include <cmath>
+#include <cstdint>
+
+namespace
+{
+	//! Simulated GPU: the frame time is proportional to the number of pixels, plus a fixed cost
+	struct FrameTimeTrace
+	{
+		double m_full_resolution_time = 30.0;	//!< Milliseconds per frame at scale 1, excluding the fixed cost
+		double m_fixed_time = 1.0;				//!< Milliseconds per frame that do not depend on the resolution
+		double m_noise = 0.0;					//!< Amplitude of the deterministic noise in milliseconds
+
+		double FrameTime( double scale, std::uint32_t frame ) const
+		{
+			// Cheap deterministic noise in [-1, 1]
+			const auto noise = std::sin( frame * 12.9898 ) * std::cos( frame * 4.1414 );
+
+			return m_fixed_time + m_full_resolution_time * scale * scale + m_noise * noise;
+		}
+	};
+
+	//! Feed a number of frames to the controller
+	void RunTrace( wmr::ResolutionScaleController& controller, const FrameTimeTrace& trace, std::uint32_t frame_count, std::uint32_t first_frame = 0 )
+	{
+		for( auto frame = first_frame; frame < first_frame + frame_count; ++frame )
+		{
+			controller.AddFrameTime( trace.FrameTime( controller.GetScale(), frame ) );
+		}
+	}
+}
+
+TEST( resolution_scale_controller, stays_at_full_resolution_within_budget )
+{
+	wmr::ResolutionScaleController controller;
+
+	FrameTimeTrace trace;
+	trace.m_full_resolution_time = 8.0;
+
+	RunTrace( controller, trace, 1000 );
+
+	EXPECT_DOUBLE_EQ( controller.GetScale(), 1.0 );
+	EXPECT_EQ( controller.GetScaleChangeCount(), 0u );
+}
+
+TEST( resolution_scale_controller, scales_down_to_fit_the_budget )
+{
+	wmr::ResolutionScaleController controller;
+
+	FrameTimeTrace trace;
+	trace.m_full_resolution_time = 30.0;
+
+	RunTrace( controller, trace, 1000 );
+
+	EXPECT_LT( controller.GetScale(), 1.0 );
+	EXPECT_LE( trace.FrameTime( controller.GetScale(), 0 ), controller.GetSettings().m_target_frame_time );
+
+	// A single step up would not fit the budget anymore, the controller did not give away more than a step
+	const auto one_step_up = controller.GetScale() + controller.GetSettings().m_scale_step;
+	EXPECT_GT( trace.FrameTime( one_step_up, 0 ), controller.GetSettings().m_target_frame_time * controller.GetSettings().m_target_occupancy );
+}
+
+TEST( resolution_scale_controller, settles_without_thrashing_on_a_noisy_trace )
+{
+	wmr::ResolutionScaleController controller;
+
+	FrameTimeTrace trace;
+	trace.m_full_resolution_time = 25.0;
+	trace.m_noise = 2.0;
+
+	RunTrace( controller, trace, 100 );
+	const auto changes_after_warm_up = controller.GetScaleChangeCount();
+
+	RunTrace( controller, trace, 5000, 100 );
+
+	// The dead band absorbs the noise, once settled the scale does not move anymore
+	EXPECT_LE( changes_after_warm_up, 3u );
+	EXPECT_EQ( controller.GetScaleChangeCount(), changes_after_warm_up );
+}
+
+TEST( resolution_scale_controller, scales_back_up_when_the_load_drops )
+{
+	wmr::ResolutionScaleController controller;
+
+	FrameTimeTrace heavy;
+	heavy.m_full_resolution_time = 40.0;
+
+	RunTrace( controller, heavy, 500 );
+	EXPECT_LT( controller.GetScale(), 1.0 );
+
+	FrameTimeTrace light;
+	light.m_full_resolution_time = 5.0;
+
+	RunTrace( controller, light, 500 );
+	EXPECT_DOUBLE_EQ( controller.GetScale(), 1.0 );
+}
+
+TEST( resolution_scale_controller, never_goes_below_the_minimum_scale )
+{
+	wmr::ResolutionScaleController controller;
+
+	FrameTimeTrace trace;
+	trace.m_full_resolution_time = 500.0;
+
+	RunTrace( controller, trace, 1000 );
+
+	EXPECT_DOUBLE_EQ( controller.GetScale(), controller.GetSettings().m_min_scale );
+}
+
+TEST( resolution_scale_controller, waits_a_full_window_and_cooldown_between_changes )
+{
+	wmr::ResolutionScaleSettings settings;
+	settings.m_sample_window = 4;
+	settings.m_cooldown_frames = 10;
+
+	wmr::ResolutionScaleController controller( settings );
+
+	// Far over budget, every decision scales down until the minimum is reached
+	std::uint32_t frame = 0;
+	while( !controller.AddFrameTime( 1000.0 ) )
+	{
+		++frame;
+	}
+	EXPECT_EQ( frame, settings.m_sample_window - 1 );
+
+	// The frames of the cooldown and the next window do not change anything
+	for( std::uint32_t i = 0; i < settings.m_cooldown_frames + settings.m_sample_window - 1; ++i )
+	{
+		EXPECT_FALSE( controller.AddFrameTime( 1000.0 ) );
+	}
+}
+
+TEST( resolution_scale_controller, scaled_resolution_is_never_empty )
+{
+	auto resolution = wmr::ScaleResolution( 3840, 2160, 0.5 );
+	EXPECT_EQ( resolution.first, 1920u );
+	EXPECT_EQ( resolution.second, 1080u );
+
+	resolution = wmr::ScaleResolution( 1, 1, 0.25 );
+	EXPECT_EQ( resolution.first, 1u );
+	EXPECT_EQ( resolution.second, 1u );
+}
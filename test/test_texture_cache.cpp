@@ -0,0 +1,252 @@
+// Copyright 2019 Breda University of Applied Sciences and Team Wisp (Viktor Zoutman, Emilio Laiso, Jens Hagen, Meine Zeinstra, Tahar Meijs, Koen Buitenhuis, Niels Brunekreef, Darius Bouma, Florian Schut)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "plugin/renderer/texture_cache.hpp"
+
+#include <gtest/gtest.h>
+
+// C++ standard
+#include <atomic>
+#include <condition_variable>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <string>
+
+namespace
+{
+	// Temporary directory with a source texture file, removed when the test ends
+	class TextureCacheTest : public ::testing::Test
+	{
+	protected:
+		void SetUp() override
+		{
+			const auto* test_info = ::testing::UnitTest::GetInstance()->current_test_info();
+			m_directory = std::filesystem::temp_directory_path() / ( std::string( "wmr_texture_cache_" ) + test_info->name() );
+			std::filesystem::remove_all( m_directory );
+			std::filesystem::create_directories( m_directory );
+
+			m_source_path = ( m_directory / "brick.png" ).string();
+			WriteSource( "source" );
+		}
+
+		void TearDown() override
+		{
+			std::filesystem::remove_all( m_directory );
+		}
+
+		void WriteSource( const std::string& contents )
+		{
+			std::ofstream( m_source_path, std::ios::binary | std::ios::trunc ) << contents;
+		}
+
+		std::string GetCacheDirectory() const
+		{
+			return ( m_directory / "cache" ).string();
+		}
+
+		static void MakeTexture( std::uint8_t alpha, wmr::DecodedTexture& texture )
+		{
+			texture.m_width = 4;
+			texture.m_height = 4;
+			texture.m_pixels.assign( 4 * 4 * 4, 255 );
+			texture.m_pixels[ 7 ] = alpha;
+		}
+
+		// Decodes every source file into a texture with transparent pixels
+		static bool DecodeTransparent( const std::string&, wmr::DecodedTexture& texture, std::string& )
+		{
+			MakeTexture( 128, texture );
+			return true;
+		}
+
+		// Decodes every source file into an opaque texture
+		static bool DecodeOpaque( const std::string&, wmr::DecodedTexture& texture, std::string& )
+		{
+			MakeTexture( 255, texture );
+			return true;
+		}
+
+		std::filesystem::path m_directory;
+		std::string m_source_path;
+	};
+
+	// Writes the name of the format instead of a DDS file
+	bool WriteFormat( const wmr::DecodedTexture&, wmr::CompressedTextureFormat format, const std::string& output_path, std::string& )
+	{
+		std::ofstream( output_path, std::ios::binary ) << static_cast<int>( format );
+		return true;
+	}
+}
+
+TEST( texture_cache, compressed_format_by_role )
+{
+	EXPECT_EQ( wmr::SelectCompressedTextureFormat( wmr::TextureRole::COLOR, false ), wmr::CompressedTextureFormat::BC1 );
+	EXPECT_EQ( wmr::SelectCompressedTextureFormat( wmr::TextureRole::COLOR, true ), wmr::CompressedTextureFormat::BC3 );
+	EXPECT_EQ( wmr::SelectCompressedTextureFormat( wmr::TextureRole::NORMAL, false ), wmr::CompressedTextureFormat::BC5 );
+	EXPECT_EQ( wmr::SelectCompressedTextureFormat( wmr::TextureRole::DATA, false ), wmr::CompressedTextureFormat::BC7 );
+
+	wmr::DecodedTexture texture;
+	texture.m_pixels = { 10, 20, 30, 255, 40, 50, 60, 255 };
+	EXPECT_FALSE( wmr::HasTransparentPixels( texture ) );
+	texture.m_pixels[ 7 ] = 254;
+	EXPECT_TRUE( wmr::HasTransparentPixels( texture ) );
+}
+
+TEST_F( TextureCacheTest, miss_build_hit )
+{
+	wmr::TextureCache cache( GetCacheDirectory(), DecodeTransparent, WriteFormat, 4 );
+
+	EXPECT_FALSE( cache.Find( m_source_path, wmr::TextureRole::COLOR ) );
+
+	EXPECT_TRUE( cache.Build( m_source_path, wmr::TextureRole::COLOR ) );
+	cache.WaitForBuilds();
+
+	auto cached = cache.Find( m_source_path, wmr::TextureRole::COLOR );
+	ASSERT_TRUE( cached );
+	EXPECT_EQ( *cached, cache.GetCachePath( m_source_path, wmr::TextureRole::COLOR ) );
+
+	// The texture has transparent pixels
+	std::ifstream file( *cached );
+	int format = -1;
+	file >> format;
+	EXPECT_EQ( format, static_cast<int>( wmr::CompressedTextureFormat::BC3 ) );
+
+	// No temporary files are left behind
+	std::size_t file_count = 0;
+	for( const auto& entry : std::filesystem::directory_iterator( GetCacheDirectory() ) )
+	{
+		EXPECT_EQ( entry.path().extension(), ".dds" );
+		++file_count;
+	}
+	EXPECT_EQ( file_count, 1u );
+
+	const auto statistics = cache.GetStatistics();
+	EXPECT_EQ( statistics.m_hits, 1u );
+	EXPECT_EQ( statistics.m_misses, 1u );
+	EXPECT_EQ( statistics.m_builds_completed, 1u );
+	EXPECT_EQ( statistics.m_builds_failed, 0u );
+	EXPECT_EQ( statistics.m_builds_pending, 0u );
+}
+
+TEST_F( TextureCacheTest, key_includes_role_and_source_file )
+{
+	wmr::TextureCache cache( GetCacheDirectory(), DecodeOpaque, WriteFormat, 4 );
+
+	const auto color_path = cache.GetCachePath( m_source_path, wmr::TextureRole::COLOR );
+	EXPECT_FALSE( color_path.empty() );
+	EXPECT_NE( cache.GetCachePath( m_source_path, wmr::TextureRole::NORMAL ), color_path );
+	EXPECT_TRUE( cache.GetCachePath( ( m_directory / "missing.png" ).string(), wmr::TextureRole::COLOR ).empty() );
+
+	cache.Build( m_source_path, wmr::TextureRole::COLOR );
+	cache.WaitForBuilds();
+	EXPECT_TRUE( cache.Find( m_source_path, wmr::TextureRole::COLOR ) );
+
+	// Editing the source file invalidates the cached copy
+	WriteSource( "edited source" );
+	EXPECT_NE( cache.GetCachePath( m_source_path, wmr::TextureRole::COLOR ), color_path );
+	EXPECT_FALSE( cache.Find( m_source_path, wmr::TextureRole::COLOR ) );
+}
+
+TEST_F( TextureCacheTest, failed_builds_leave_no_copy )
+{
+	std::atomic<int> build_count = 0;
+
+	wmr::TextureCache cache( GetCacheDirectory(), DecodeOpaque, [&]( const wmr::DecodedTexture&, wmr::CompressedTextureFormat, const std::string& output_path, std::string& error )
+	{
+		++build_count;
+		std::ofstream( output_path ) << "partial";
+		error = "compression failed";
+		return false;
+	}, 4 );
+
+	cache.Build( m_source_path, wmr::TextureRole::DATA );
+	cache.WaitForBuilds();
+
+	EXPECT_EQ( build_count, 1 );
+	EXPECT_FALSE( cache.Find( m_source_path, wmr::TextureRole::DATA ) );
+	EXPECT_TRUE( std::filesystem::is_empty( GetCacheDirectory() ) );
+	EXPECT_EQ( cache.GetStatistics().m_builds_failed, 1u );
+}
+
+TEST( texture_cache, reduced_copies_are_stored_next_to_the_cached_copy )
+{
+	const auto directory = std::filesystem::path( "cache" );
+	const auto cache_path = ( directory / "0123456789abcdef.dds" ).string();
+
+	EXPECT_EQ( wmr::GetReducedCachePath( cache_path, 0 ), cache_path );
+	EXPECT_EQ( wmr::GetReducedCachePath( cache_path, 2 ), ( directory / "0123456789abcdef.mip2.dds" ).string() );
+}
+
+TEST_F( TextureCacheTest, invalidate_removes_copy )
+{
+	wmr::TextureCache cache( GetCacheDirectory(), DecodeOpaque, WriteFormat, 4 );
+
+	cache.Build( m_source_path, wmr::TextureRole::NORMAL );
+	cache.WaitForBuilds();
+
+	auto cached = cache.Find( m_source_path, wmr::TextureRole::NORMAL );
+	ASSERT_TRUE( cached );
+
+	// Reduced copies made from the cached copy, and the copy of another texture
+	std::ofstream( wmr::GetReducedCachePath( *cached, 1 ) ) << "reduced";
+	std::ofstream( wmr::GetReducedCachePath( *cached, 3 ) ) << "reduced";
+	const auto other_path = ( std::filesystem::path( GetCacheDirectory() ) / "0123456789abcdef.mip1.dds" ).string();
+	std::ofstream( other_path ) << "other";
+
+	cache.Invalidate( *cached );
+	EXPECT_FALSE( cache.Find( m_source_path, wmr::TextureRole::NORMAL ) );
+	EXPECT_FALSE( std::filesystem::exists( wmr::GetReducedCachePath( *cached, 1 ) ) );
+	EXPECT_FALSE( std::filesystem::exists( wmr::GetReducedCachePath( *cached, 3 ) ) );
+	EXPECT_TRUE( std::filesystem::exists( other_path ) );
+}
+
+TEST_F( TextureCacheTest, pending_builds_are_bounded )
+{
+	const auto other_source_path = ( m_directory / "tiles.png" ).string();
+	std::ofstream( other_source_path, std::ios::binary ) << "other source";
+
+	std::mutex mutex;
+	std::condition_variable condition;
+	bool release = false;
+
+	// Blocks the background thread until the test releases it, so the first copy stays pending
+	wmr::TextureCache cache( GetCacheDirectory(), [&]( const std::string& source_path, wmr::DecodedTexture& texture, std::string& error )
+	{
+		std::unique_lock<std::mutex> lock( mutex );
+		condition.wait( lock, [&]() { return release; } );
+		return DecodeOpaque( source_path, texture, error );
+	}, WriteFormat, 1 );
+
+	EXPECT_TRUE( cache.Build( m_source_path, wmr::TextureRole::COLOR ) );
+	EXPECT_FALSE( cache.Build( m_source_path, wmr::TextureRole::COLOR ) );
+	EXPECT_FALSE( cache.Build( other_source_path, wmr::TextureRole::COLOR ) );
+	EXPECT_EQ( cache.GetStatistics().m_builds_pending, 1u );
+
+	{
+		std::lock_guard<std::mutex> lock( mutex );
+		release = true;
+	}
+	condition.notify_all();
+	cache.WaitForBuilds();
+
+	// The skipped copy is queued when it is missed again
+	EXPECT_FALSE( cache.Find( other_source_path, wmr::TextureRole::COLOR ) );
+	EXPECT_TRUE( cache.Build( other_source_path, wmr::TextureRole::COLOR ) );
+	cache.WaitForBuilds();
+
+	EXPECT_TRUE( cache.Find( m_source_path, wmr::TextureRole::COLOR ) );
+	EXPECT_TRUE( cache.Find( other_source_path, wmr::TextureRole::COLOR ) );
+}
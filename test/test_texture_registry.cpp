@@ -0,0 +1,101 @@
+// Copyright 2019 Breda University of Applied Sciences and Team Wisp (Viktor Zoutman, Emilio Laiso, Jens Hagen, Meine Zeinstra, Tahar Meijs, Koen Buitenhuis, Niels Brunekreef, Darius Bouma, Florian Schut)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "plugin/renderer/texture_registry.hpp"
+
+#include <gtest/gtest.h>
+
+// C++ standard
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <unordered_set>
+
+TEST( texture_registry, hash_is_stable_and_spreads )
+{
+	EXPECT_EQ( wmr::HashTexturePath( "textures/brick.png" ), wmr::HashTexturePath( std::string( "textures/brick.png" ) ) );
+
+	// Paths that only differ in a single character or in length end up with different hashes
+	std::unordered_set<std::uint64_t> hashes;
+	for( int i = 0; i < 10000; ++i )
+	{
+		hashes.insert( wmr::HashTexturePath( "textures/brick_" + std::to_string( i ) + ".png" ) );
+	}
+	hashes.insert( wmr::HashTexturePath( "" ) );
+	hashes.insert( wmr::HashTexturePath( "a" ) );
+	hashes.insert( wmr::HashTexturePath( "aa" ) );
+
+	EXPECT_EQ( hashes.size(), 10003u );
+}
+
+TEST( texture_registry, canonical_path_ignores_spelling )
+{
+	auto canonical = wmr::CanonicalizeTexturePath( "textures/brick.png" );
+
+	EXPECT_TRUE( std::filesystem::path( canonical ).is_absolute() );
+	EXPECT_EQ( wmr::CanonicalizeTexturePath( "./textures/../textures/./brick.png" ), canonical );
+	EXPECT_EQ( wmr::CanonicalizeTexturePath( ( std::filesystem::current_path() / "textures" / "brick.png" ).string() ), canonical );
+	EXPECT_NE( wmr::CanonicalizeTexturePath( "textures/brick2.png" ), canonical );
+}
+
+TEST( texture_registry, lookup_both_ways )
+{
+	wmr::TextureRegistry registry;
+
+	EXPECT_TRUE( registry.Add( "/textures/a.png", 1 ) );
+	EXPECT_TRUE( registry.Add( "/textures/b.png", 2 ) );
+
+	// Neither the path nor the ID can be registered twice
+	EXPECT_FALSE( registry.Add( "/textures/a.png", 3 ) );
+	EXPECT_FALSE( registry.Add( "/textures/c.png", 2 ) );
+	EXPECT_EQ( registry.GetSize(), 2u );
+
+	ASSERT_NE( registry.FindID( "/textures/b.png" ), nullptr );
+	EXPECT_EQ( *registry.FindID( "/textures/b.png" ), 2u );
+	ASSERT_NE( registry.FindPath( 1 ), nullptr );
+	EXPECT_EQ( *registry.FindPath( 1 ), "/textures/a.png" );
+	EXPECT_EQ( registry.FindID( "/textures/c.png" ), nullptr );
+	EXPECT_EQ( registry.FindPath( 3 ), nullptr );
+
+	EXPECT_TRUE( registry.Remove( 1 ) );
+	EXPECT_FALSE( registry.Remove( 1 ) );
+	EXPECT_EQ( registry.FindID( "/textures/a.png" ), nullptr );
+	EXPECT_EQ( registry.FindPath( 1 ), nullptr );
+
+	// The path can be reused by another texture once it was removed
+	EXPECT_TRUE( registry.Add( "/textures/a.png", 4 ) );
+	EXPECT_EQ( *registry.FindID( "/textures/a.png" ), 4u );
+
+	registry.Clear();
+	EXPECT_EQ( registry.GetSize(), 0u );
+	EXPECT_EQ( registry.FindPath( 2 ), nullptr );
+}
+
+TEST( texture_registry, many_textures_never_alias )
+{
+	wmr::TextureRegistry registry;
+
+	for( std::uint64_t id = 0; id < 20000; ++id )
+	{
+		ASSERT_TRUE( registry.Add( "/textures/t" + std::to_string( id ), id ) );
+	}
+
+	for( std::uint64_t id = 0; id < 20000; ++id )
+	{
+		auto found = registry.FindID( "/textures/t" + std::to_string( id ) );
+		ASSERT_NE( found, nullptr );
+		EXPECT_EQ( *found, id );
+	}
+}
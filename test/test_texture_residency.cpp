@@ -0,0 +1,246 @@
+// Copyright 2019 Breda University of Applied Sciences and Team Wisp (Viktor Zoutman, Emilio Laiso, Jens Hagen, Meine Zeinstra, Tahar Meijs, Koen Buitenhuis, Niels Brunekreef, Darius Bouma, Florian Schut)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "plugin/renderer/async_texture_loader.hpp"
+#include "plugin/renderer/texture_residency.hpp"
+
+#include <gtest/gtest.h>
+
+// C++ standard
+#include <cstdint>
+#include <string>
+
+namespace
+{
+	wmr::TextureResidencyDesc MakeDesc( std::uint32_t size, bool compressed = true )
+	{
+		wmr::TextureResidencyDesc desc;
+		desc.m_width = size;
+		desc.m_height = size;
+		desc.m_mip_chain = compressed;
+
+		if( compressed )
+		{
+			desc.m_format = wmr::CompressedTextureFormat::BC1;
+		}
+
+		return desc;
+	}
+
+	// Loads the levels of the cached copy of a 2048 pixel BC1 texture that fit the maximum size, as the texture cache does
+	bool DecodeCachedCopy( const wmr::TextureLoadRequest& request, wmr::DecodedTexture& texture, std::string& )
+	{
+		const auto first_mip = wmr::SelectFirstMip( 2048, 2048, true, request.m_max_size, wmr::GetMipCount( 2048, 2048 ) );
+
+		texture.m_cached_path = wmr::GetReducedCachePath( "cache/" + request.m_path + ".dds", first_mip );
+		texture.m_compressed_format = wmr::CompressedTextureFormat::BC1;
+		texture.m_mip_chain = true;
+		texture.m_first_mip = first_mip;
+		texture.m_width = 2048 >> first_mip;
+		texture.m_height = 2048 >> first_mip;
+
+		return true;
+	}
+}
+
+TEST( texture_residency, memory_size )
+{
+	EXPECT_EQ( wmr::GetMipCount( 256, 256 ), 9u );
+	EXPECT_EQ( wmr::GetMipCount( 300, 200 ), 9u );
+	EXPECT_EQ( wmr::GetMipCount( 1, 1 ), 1u );
+
+	// 8-bit RGBA without mips
+	EXPECT_EQ( wmr::GetTextureMemorySize( MakeDesc( 256, false ), 0 ), 256u * 256u * 4u );
+	EXPECT_EQ( wmr::GetTextureMemorySize( MakeDesc( 256, false ), 1 ), 128u * 128u * 4u );
+
+	// BC1 with a full mip chain, the levels below 4x4 still take a whole block
+	EXPECT_EQ( wmr::GetTextureMemorySize( MakeDesc( 256 ), 0 ), 32768u + 8192u + 2048u + 512u + 128u + 32u + 8u + 8u + 8u );
+	EXPECT_EQ( wmr::GetTextureMemorySize( MakeDesc( 256 ), 7 ), 8u + 8u );
+
+	auto bc7 = MakeDesc( 256 );
+	bc7.m_format = wmr::CompressedTextureFormat::BC7;
+	EXPECT_EQ( wmr::GetTextureMemorySize( bc7, 8 ), 16u );
+}
+
+TEST( texture_residency, select_first_mip )
+{
+	EXPECT_EQ( wmr::SelectFirstMip( 2048, 2048, true, 512, 12 ), 2u );
+	EXPECT_EQ( wmr::SelectFirstMip( 2048, 2048, true, 0, 12 ), 0u );
+	EXPECT_EQ( wmr::SelectFirstMip( 2048, 2048, true, 4096, 12 ), 0u );
+
+	// 250 pixels is not a multiple of four, a block-compressed texture cannot start there
+	EXPECT_EQ( wmr::SelectFirstMip( 1000, 1000, true, 256, 10 ), 1u );
+	EXPECT_EQ( wmr::SelectFirstMip( 1000, 1000, false, 256, 10 ), 2u );
+
+	// Only the available levels can be selected
+	EXPECT_EQ( wmr::SelectFirstMip( 2048, 2048, true, 16, 3 ), 2u );
+}
+
+TEST( texture_residency, evicts_least_recently_used_first )
+{
+	const auto full_size = wmr::GetTextureMemorySize( MakeDesc( 2048 ), 0 );
+	const auto reduced_size = wmr::GetTextureMemorySize( MakeDesc( 2048 ), 1 );
+
+	wmr::TextureResidency residency( 2 * full_size + reduced_size, 128 );
+	residency.Add( "a", MakeDesc( 2048 ), 0, 1 );
+	residency.Add( "b", MakeDesc( 2048 ), 0, 2 );
+	residency.Add( "c", MakeDesc( 2048 ), 0, 3 );
+
+	// "a" was the first texture to be used, but is used again in the latest frame
+	residency.Touch( "a", 4 );
+
+	auto changes = residency.Plan( 0, 8 );
+	ASSERT_EQ( changes.size(), 1u );
+	EXPECT_EQ( changes[ 0 ].m_key, "b" );
+	EXPECT_EQ( changes[ 0 ].m_first_mip, 1u );
+	EXPECT_EQ( changes[ 0 ].m_max_size, 1024u );
+
+	// The change is in progress, it is not planned again
+	EXPECT_TRUE( residency.Plan( 0, 8 ).empty() );
+
+	residency.Reload( "b", MakeDesc( 2048 ), 1 );
+
+	const auto statistics = residency.GetStatistics();
+	EXPECT_EQ( statistics.m_used, 2 * full_size + reduced_size );
+	EXPECT_EQ( statistics.m_texture_count, 3u );
+	EXPECT_EQ( statistics.m_reduced_texture_count, 1u );
+	EXPECT_EQ( statistics.m_evicted_mips, 1u );
+	EXPECT_EQ( statistics.m_evicted_bytes, full_size - reduced_size );
+	EXPECT_TRUE( residency.Plan( 0, 8 ).empty() );
+}
+
+TEST( texture_residency, drops_levels_the_viewport_cannot_show_first )
+{
+	const auto budget = wmr::GetTextureMemorySize( MakeDesc( 4096 ), 1 ) + wmr::GetTextureMemorySize( MakeDesc( 512 ), 0 );
+
+	wmr::TextureResidency residency( budget, 128 );
+	residency.Add( "small", MakeDesc( 512 ), 0, 1 );
+	residency.Add( "large", MakeDesc( 4096 ), 0, 2 );
+
+	// A 1000 pixel viewport cannot show more than the 1024 pixel level of the large texture
+	auto changes = residency.Plan( 1000, 8 );
+	ASSERT_EQ( changes.size(), 1u );
+	EXPECT_EQ( changes[ 0 ].m_key, "large" );
+	EXPECT_EQ( changes[ 0 ].m_first_mip, 2u );
+}
+
+TEST( texture_residency, never_drops_below_the_minimum_size )
+{
+	wmr::TextureResidency residency( 0, 128 );
+	residency.Add( "a", MakeDesc( 1024 ), 0, 1 );
+	residency.Add( "tiny", MakeDesc( 64 ), 0, 1 );
+
+	auto changes = residency.Plan( 0, 8 );
+	ASSERT_EQ( changes.size(), 1u );
+	EXPECT_EQ( changes[ 0 ].m_key, "a" );
+	EXPECT_EQ( changes[ 0 ].m_max_size, 128u );
+}
+
+TEST( texture_residency, restores_levels_when_there_is_room )
+{
+	const auto reduced_size = wmr::GetTextureMemorySize( MakeDesc( 2048 ), 1 );
+
+	wmr::TextureResidency residency( reduced_size, 128 );
+	residency.Add( "a", MakeDesc( 2048 ), 0, 1 );
+
+	auto changes = residency.Plan( 0, 8 );
+	ASSERT_EQ( changes.size(), 1u );
+	residency.Reload( "a", MakeDesc( 2048 ), changes[ 0 ].m_first_mip );
+	EXPECT_GT( residency.GetMaxNewTextureSize( 1000 ), 0u );
+
+	// Growing the budget brings the dropped level back
+	residency.SetBudget( wmr::GetTextureMemorySize( MakeDesc( 2048 ), 0 ) );
+	EXPECT_EQ( residency.GetMaxNewTextureSize( 1000 ), 0u );
+
+	changes = residency.Plan( 0, 8 );
+	ASSERT_EQ( changes.size(), 1u );
+	EXPECT_EQ( changes[ 0 ].m_first_mip, 0u );
+
+	// A failed load can be planned again
+	residency.CancelChange( "a" );
+	changes = residency.Plan( 0, 8 );
+	ASSERT_EQ( changes.size(), 1u );
+
+	residency.Reload( "a", MakeDesc( 2048 ), 0 );
+
+	const auto statistics = residency.GetStatistics();
+	EXPECT_EQ( statistics.m_restorations, 1u );
+	EXPECT_EQ( statistics.m_reduced_texture_count, 0u );
+	EXPECT_TRUE( residency.Plan( 0, 8 ).empty() );
+
+	residency.Remove( "a" );
+	EXPECT_EQ( residency.GetStatistics().m_used, 0u );
+}
+
+TEST( texture_residency, limits_changes_per_plan )
+{
+	wmr::TextureResidency residency( 0, 128 );
+
+	for( int i = 0; i < 5; ++i )
+	{
+		residency.Add( std::to_string( i ), MakeDesc( 1024 ), 0, i );
+	}
+
+	EXPECT_EQ( residency.Plan( 0, 2 ).size(), 2u );
+	EXPECT_EQ( residency.Plan( 0, 2 ).size(), 2u );
+	EXPECT_EQ( residency.Plan( 0, 2 ).size(), 1u );
+	EXPECT_TRUE( residency.Plan( 0, 2 ).empty() );
+}
+
+TEST( texture_residency, evictions_load_within_the_budget )
+{
+	const auto budget = wmr::GetTextureMemorySize( MakeDesc( 2048 ), 0 );
+
+	wmr::TextureResidency residency( budget, 128 );
+	residency.Add( "a", MakeDesc( 2048 ), 0, 1 );
+	residency.Add( "b", MakeDesc( 2048 ), 0, 2 );
+	residency.Add( "c", MakeDesc( 2048 ), 0, 3 );
+
+	wmr::AsyncTextureLoader loader( 2, DecodeCachedCopy );
+
+	// Plan, load the textures again at the planned size, and report the outcome, like the texture manager every frame
+	for( int frame = 0; frame < 8; ++frame )
+	{
+		for( const auto& change : residency.Plan( 0, 2 ) )
+		{
+			loader.Request( change.m_key, wmr::TextureRole::COLOR, change.m_max_size );
+		}
+
+		loader.WaitForAll();
+
+		for( const auto& result : loader.CollectCompleted() )
+		{
+			ASSERT_TRUE( result.m_success );
+
+			const auto& texture = result.m_texture;
+			EXPECT_GT( texture.m_first_mip, 0u );
+			EXPECT_EQ( texture.m_cached_path, wmr::GetReducedCachePath( "cache/" + result.m_path + ".dds", texture.m_first_mip ) );
+
+			wmr::TextureResidencyDesc desc;
+			desc.m_width = texture.m_width << texture.m_first_mip;
+			desc.m_height = texture.m_height << texture.m_first_mip;
+			desc.m_format = texture.m_compressed_format;
+			desc.m_mip_chain = texture.m_mip_chain;
+
+			residency.Reload( result.m_path, desc, texture.m_first_mip );
+		}
+	}
+
+	const auto statistics = residency.GetStatistics();
+	EXPECT_LE( statistics.m_used, budget );
+	EXPECT_EQ( statistics.m_reduced_texture_count, 3u );
+	EXPECT_GT( statistics.m_evicted_bytes, 0u );
+	EXPECT_TRUE( residency.Plan( 0, 2 ).empty() );
+}
@@ -0,0 +1,106 @@
+// Copyright 2019 Breda University of Applied Sciences and Team Wisp (Viktor Zoutman, Emilio Laiso, Jens Hagen, Meine Zeinstra, Tahar Meijs, Koen Buitenhuis, Niels Brunekreef, Darius Bouma, Florian Schut)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "miscellaneous/thread_pool.hpp"
+
+#include <gtest/gtest.h>
+
+// C++ standard
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+TEST( thread_pool, enqueue )
+{
+	wmr::ThreadPool pool( 2 );
+	std::atomic<int> counter = 0;
+
+	std::vector<std::future<void>> futures;
+	for( int i = 0; i < 100; ++i )
+	{
+		futures.push_back( pool.Enqueue( [&counter]() { ++counter; } ) );
+	}
+
+	for( auto& future : futures )
+	{
+		future.get();
+	}
+
+	EXPECT_EQ( counter, 100 );
+}
+
+TEST( thread_pool, parallel_for_covers_range )
+{
+	wmr::ThreadPool pool( 3 );
+
+	for( std::size_t count : { 1, 2, 7, 1000 } )
+	{
+		for( std::size_t chunk_count : { 1, 4, 5000 } )
+		{
+			std::vector<int> visits( count, 0 );
+			std::vector<std::size_t> chunk_begins( std::min( count, chunk_count ), count );
+
+			pool.ParallelFor( count, chunk_count, [&]( std::size_t chunk, std::size_t begin, std::size_t end )
+			{
+				chunk_begins[chunk] = begin;
+				for( auto i = begin; i < end; ++i )
+				{
+					++visits[i];
+				}
+			} );
+
+			// Every item is visited once, and the chunks are laid out in order
+			EXPECT_EQ( visits, std::vector<int>( count, 1 ) );
+			EXPECT_TRUE( std::is_sorted( chunk_begins.begin(), chunk_begins.end() ) );
+			EXPECT_EQ( chunk_begins.front(), 0u );
+		}
+	}
+}
+
+TEST( thread_pool, parallel_for_forwards_exceptions )
+{
+	wmr::ThreadPool pool( 2 );
+
+	EXPECT_THROW( pool.ParallelFor( 100, 3, []( std::size_t chunk, std::size_t, std::size_t )
+	{
+		if( chunk == 2 )
+		{
+			throw std::runtime_error( "chunk failed" );
+		}
+	} ), std::runtime_error );
+}
+
+TEST( thread_pool, parallel_for_waits_for_chunks_when_first_chunk_throws )
+{
+	wmr::ThreadPool pool( 3 );
+	std::atomic<int> finished_chunks = 0;
+
+	EXPECT_THROW( pool.ParallelFor( 4, 4, [&finished_chunks]( std::size_t chunk, std::size_t, std::size_t )
+	{
+		if( chunk == 0 )
+		{
+			throw std::runtime_error( "first chunk failed" );
+		}
+
+		// Still running when the calling thread throws
+		std::this_thread::sleep_for( std::chrono::milliseconds( 50 ) );
+		++finished_chunks;
+	} ), std::runtime_error );
+
+	// The worker chunks finished before ParallelFor returned
+	EXPECT_EQ( finished_chunks, 3 );
+}
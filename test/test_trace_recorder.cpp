@@ -0,0 +1,177 @@
+// Copyright 2019 Breda University of Applied Sciences and Team Wisp (Viktor Zoutman, Emilio Laiso, Jens Hagen, Meine Zeinstra, Tahar Meijs, Koen Buitenhuis, Niels Brunekreef, Darius Bouma, Florian Schut)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "miscellaneous/trace_recorder.hpp"
+
+#include <gtest/gtest.h>
+
+// C++ standard
+#include <chrono>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+	std::size_t CountOccurrences( const std::string& text, const std::string& pattern )
+	{
+		std::size_t count = 0;
+
+		for ( auto position = text.find( pattern ); position != std::string::npos; position = text.find( pattern, position + 1 ) )
+		{
+			++count;
+		}
+
+		return count;
+	}
+}
+
+TEST( TraceRecorder, IgnoresEventsWhenNotRecording )
+{
+	wmr::TraceRecorder recorder( 16 );
+
+	{
+		wmr::ScopedTraceEvent event( "ignored", "test", recorder );
+	}
+
+	EXPECT_FALSE( recorder.IsRecording() );
+	EXPECT_EQ( recorder.GetEventCount(), 0u );
+}
+
+TEST( TraceRecorder, RecordsScopedEvents )
+{
+	wmr::TraceRecorder recorder( 16 );
+	recorder.Start();
+
+	{
+		wmr::ScopedTraceEvent outer( "outer", "test", recorder );
+		wmr::ScopedTraceEvent inner( "inner", "test", recorder );
+	}
+
+	recorder.Stop();
+
+	// Events after Stop() are ignored
+	{
+		wmr::ScopedTraceEvent event( "late", "test", recorder );
+	}
+
+	EXPECT_EQ( recorder.GetEventCount(), 2u );
+
+	std::stringstream json;
+	recorder.WriteJSON( json );
+
+	EXPECT_NE( json.str().find( "\"name\":\"outer\"" ), std::string::npos );
+	EXPECT_NE( json.str().find( "\"name\":\"inner\"" ), std::string::npos );
+	EXPECT_EQ( json.str().find( "late" ), std::string::npos );
+	EXPECT_EQ( CountOccurrences( json.str(), "\"ph\":\"X\"" ), 2u );
+}
+
+TEST( TraceRecorder, StartDiscardsThePreviousRecording )
+{
+	wmr::TraceRecorder recorder( 16 );
+	const auto now = std::chrono::steady_clock::now();
+
+	recorder.Start();
+	recorder.AddEvent( "first", "test", now, now );
+	recorder.AddEvent( "first", "test", now, now );
+	recorder.Stop();
+	EXPECT_EQ( recorder.GetEventCount(), 2u );
+
+	recorder.Start();
+	EXPECT_EQ( recorder.GetEventCount(), 0u );
+
+	recorder.AddEvent( "second", "test", now, now );
+	recorder.Stop();
+
+	std::stringstream json;
+	recorder.WriteJSON( json );
+
+	EXPECT_EQ( recorder.GetEventCount(), 1u );
+	EXPECT_EQ( json.str().find( "first" ), std::string::npos );
+}
+
+TEST( TraceRecorder, DropsEventsWhenTheThreadBufferIsFull )
+{
+	wmr::TraceRecorder recorder( 4 );
+	const auto now = std::chrono::steady_clock::now();
+
+	recorder.Start();
+
+	for ( int i = 0; i < 10; ++i )
+	{
+		recorder.AddEvent( "event", "test", now, now );
+	}
+
+	EXPECT_EQ( recorder.GetEventCount(), 4u );
+	EXPECT_EQ( recorder.GetDroppedEventCount(), 6u );
+}
+
+TEST( TraceRecorder, EveryThreadGetsATimeline )
+{
+	wmr::TraceRecorder recorder( 1024 );
+	recorder.Start();
+
+	const std::size_t thread_count = 4;
+	const std::size_t events_per_thread = 100;
+
+	std::vector<std::thread> threads;
+
+	for ( std::size_t thread = 0; thread < thread_count; ++thread )
+	{
+		threads.emplace_back( [&recorder, events_per_thread]()
+		{
+			for ( std::size_t i = 0; i < events_per_thread; ++i )
+			{
+				wmr::ScopedTraceEvent event( "work", "test", recorder );
+			}
+		} );
+	}
+
+	// Reading while the threads record only sees completed events
+	EXPECT_LE( recorder.GetEventCount(), thread_count * events_per_thread );
+
+	for ( auto& thread : threads )
+	{
+		thread.join();
+	}
+
+	recorder.Stop();
+
+	EXPECT_EQ( recorder.GetEventCount(), thread_count * events_per_thread );
+	EXPECT_EQ( recorder.GetDroppedEventCount(), 0u );
+
+	std::stringstream json;
+	recorder.WriteJSON( json );
+
+	EXPECT_EQ( CountOccurrences( json.str(), "\"thread_name\"" ), thread_count );
+	EXPECT_EQ( CountOccurrences( json.str(), "\"name\":\"work\"" ), thread_count * events_per_thread );
+}
+
+TEST( TraceRecorder, EscapesNames )
+{
+	wmr::TraceRecorder recorder( 4 );
+	const auto now = std::chrono::steady_clock::now();
+
+	recorder.Start();
+	recorder.AddEvent( "quote \" and \\ backslash", "test", now, now + std::chrono::microseconds( 1500 ) );
+	recorder.Stop();
+
+	std::stringstream json;
+	recorder.WriteJSON( json );
+
+	EXPECT_NE( json.str().find( "\"quote \\\" and \\\\ backslash\"" ), std::string::npos );
+	EXPECT_NE( json.str().find( "\"dur\":1500.000" ), std::string::npos );
+}
@@ -0,0 +1,181 @@
+// Copyright 2019 Breda University of Applied Sciences and Team Wisp (Viktor Zoutman, Emilio Laiso, Jens Hagen, Meine Zeinstra, Tahar Meijs, Koen Buitenhuis, Niels Brunekreef, Darius Bouma, Florian Schut)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "plugin/parsers/transform_hierarchy.hpp"
+
+#include <gtest/gtest.h>
+
+// C++ standard
+#include <algorithm>
+#include <vector>
+
+namespace
+{
+	wmr::Matrix4 Translation( double x, double y, double z )
+	{
+		auto matrix = wmr::IDENTITY_MATRIX;
+		matrix[12] = x;
+		matrix[13] = y;
+		matrix[14] = z;
+		return matrix;
+	}
+
+	wmr::Matrix4 Scale( double s )
+	{
+		auto matrix = wmr::IDENTITY_MATRIX;
+		matrix[0] = s;
+		matrix[5] = s;
+		matrix[10] = s;
+		return matrix;
+	}
+
+	void ExpectTranslation( const wmr::Matrix4& matrix, double x, double y, double z )
+	{
+		EXPECT_DOUBLE_EQ( matrix[12], x );
+		EXPECT_DOUBLE_EQ( matrix[13], y );
+		EXPECT_DOUBLE_EQ( matrix[14], z );
+	}
+
+	bool Contains( const std::vector<wmr::TransformHierarchy::NodeId>& nodes, wmr::TransformHierarchy::NodeId node )
+	{
+		return std::find( nodes.begin(), nodes.end(), node ) != nodes.end();
+	}
+}
+
+TEST( transform_hierarchy, world_matrix_follows_the_maya_convention )
+{
+	wmr::TransformHierarchy hierarchy;
+	std::vector<wmr::TransformHierarchy::NodeId> updated;
+
+	// The parent scales by two, the child is translated in the space of the parent
+	auto parent = hierarchy.AddNode( wmr::TransformHierarchy::INVALID_NODE, wmr::Multiply( Scale( 2.0 ), Translation( 1.0, 0.0, 0.0 ) ) );
+	auto child = hierarchy.AddNode( parent, Translation( 0.0, 3.0, 0.0 ) );
+
+	hierarchy.Update( updated );
+
+	ExpectTranslation( hierarchy.GetWorldMatrix( parent ), 1.0, 0.0, 0.0 );
+	ExpectTranslation( hierarchy.GetWorldMatrix( child ), 1.0, 6.0, 0.0 );
+	EXPECT_EQ( hierarchy.GetWorldMatrix( child ), hierarchy.CalculateWorldMatrix( child ) );
+	EXPECT_EQ( updated.size(), 2u );
+	EXPECT_FALSE( hierarchy.HasPendingChanges() );
+}
+
+TEST( transform_hierarchy, moving_a_root_updates_its_subtree_once )
+{
+	wmr::TransformHierarchy hierarchy;
+	std::vector<wmr::TransformHierarchy::NodeId> updated;
+
+	// A chain of 64 nodes, each one unit above its parent
+	std::vector<wmr::TransformHierarchy::NodeId> chain;
+	chain.push_back( hierarchy.AddNode() );
+	for( int i = 1; i < 64; ++i )
+	{
+		chain.push_back( hierarchy.AddNode( chain.back(), Translation( 0.0, 1.0, 0.0 ) ) );
+	}
+	auto unrelated = hierarchy.AddNode();
+
+	hierarchy.Update( updated );
+
+	// Change the root and several nodes within its subtree in the same frame
+	hierarchy.SetLocalMatrix( chain[ 0 ], Translation( 5.0, 0.0, 0.0 ) );
+	hierarchy.SetLocalMatrix( chain[ 40 ], Translation( 0.0, 2.0, 0.0 ) );
+	hierarchy.SetLocalMatrix( chain[ 10 ], Translation( 0.0, 1.0, 0.0 ) );
+
+	hierarchy.Update( updated );
+
+	EXPECT_EQ( updated.size(), chain.size() );
+	EXPECT_FALSE( Contains( updated, unrelated ) );
+
+	// Top-down: the root comes first and every node is recalculated exactly once
+	EXPECT_EQ( updated.front(), chain[ 0 ] );
+	auto sorted = updated;
+	std::sort( sorted.begin(), sorted.end() );
+	EXPECT_EQ( std::unique( sorted.begin(), sorted.end() ), sorted.end() );
+
+	ExpectTranslation( hierarchy.GetWorldMatrix( chain.back() ), 5.0, 64.0, 0.0 );
+}
+
+TEST( transform_hierarchy, only_dirty_subtrees_are_recalculated )
+{
+	wmr::TransformHierarchy hierarchy;
+	std::vector<wmr::TransformHierarchy::NodeId> updated;
+
+	auto root = hierarchy.AddNode();
+	auto left = hierarchy.AddNode( root );
+	auto left_child = hierarchy.AddNode( left );
+	auto right = hierarchy.AddNode( root );
+
+	hierarchy.Update( updated );
+
+	hierarchy.SetLocalMatrix( left, Translation( 1.0, 0.0, 0.0 ) );
+	EXPECT_TRUE( hierarchy.IsDirty( left ) );
+	EXPECT_FALSE( hierarchy.IsDirty( right ) );
+
+	hierarchy.Update( updated );
+
+	ASSERT_EQ( updated.size(), 2u );
+	EXPECT_EQ( updated[ 0 ], left );
+	EXPECT_EQ( updated[ 1 ], left_child );
+	ExpectTranslation( hierarchy.GetWorldMatrix( left_child ), 1.0, 0.0, 0.0 );
+
+	// Nothing changed, nothing to do
+	hierarchy.Update( updated );
+	EXPECT_TRUE( updated.empty() );
+}
+
+TEST( transform_hierarchy, reparenting )
+{
+	wmr::TransformHierarchy hierarchy;
+	std::vector<wmr::TransformHierarchy::NodeId> updated;
+
+	auto a = hierarchy.AddNode( wmr::TransformHierarchy::INVALID_NODE, Translation( 1.0, 0.0, 0.0 ) );
+	auto b = hierarchy.AddNode( wmr::TransformHierarchy::INVALID_NODE, Translation( 0.0, 1.0, 0.0 ) );
+	auto c = hierarchy.AddNode( b, Translation( 0.0, 0.0, 1.0 ) );
+
+	hierarchy.Update( updated );
+
+	EXPECT_TRUE( hierarchy.SetParent( b, a ) );
+	hierarchy.Update( updated );
+
+	EXPECT_EQ( hierarchy.GetParent( b ), a );
+	ExpectTranslation( hierarchy.GetWorldMatrix( c ), 1.0, 1.0, 1.0 );
+
+	// A node cannot become a child of its own subtree
+	EXPECT_FALSE( hierarchy.SetParent( a, c ) );
+	EXPECT_EQ( hierarchy.GetParent( a ), wmr::TransformHierarchy::INVALID_NODE );
+}
+
+TEST( transform_hierarchy, removed_nodes_detach_their_children )
+{
+	wmr::TransformHierarchy hierarchy;
+	std::vector<wmr::TransformHierarchy::NodeId> updated;
+
+	auto root = hierarchy.AddNode( wmr::TransformHierarchy::INVALID_NODE, Translation( 1.0, 0.0, 0.0 ) );
+	auto child = hierarchy.AddNode( root, Translation( 0.0, 1.0, 0.0 ) );
+
+	hierarchy.Update( updated );
+	hierarchy.RemoveNode( root );
+	hierarchy.Update( updated );
+
+	EXPECT_FALSE( hierarchy.IsValid( root ) );
+	EXPECT_EQ( hierarchy.GetNodeCount(), 1u );
+	EXPECT_EQ( hierarchy.GetParent( child ), wmr::TransformHierarchy::INVALID_NODE );
+	ExpectTranslation( hierarchy.GetWorldMatrix( child ), 0.0, 1.0, 0.0 );
+
+	// The slot of the removed node is reused
+	auto reused = hierarchy.AddNode( child );
+	EXPECT_EQ( reused, root );
+	hierarchy.Update( updated );
+	ExpectTranslation( hierarchy.GetWorldMatrix( reused ), 0.0, 1.0, 0.0 );
+}
@@ -0,0 +1,136 @@
+// Copyright 2019 Breda University of Applied Sciences and Team Wisp (Viktor Zoutman, Emilio Laiso, Jens Hagen, Meine Zeinstra, Tahar Meijs, Koen Buitenhuis, Niels Brunekreef, Darius Bouma, Florian Schut)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "plugin/parsers/vertex_welder.hpp"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+// Feed a stream of face-vertex keys through a welder and return the resulting index buffer
+static std::vector<std::uint32_t> WeldStream( wmr::VertexWelder& welder, const std::vector<wmr::FaceVertexKey>& stream )
+{
+	std::vector<std::uint32_t> indices;
+	std::uint32_t expected_new_index = 0;
+
+	for( const auto& key : stream )
+	{
+		bool is_new = false;
+		auto index = welder.Weld( key, is_new );
+
+		// New vertices are always numbered sequentially
+		if( is_new )
+		{
+			EXPECT_EQ( index, expected_new_index++ );
+		}
+
+		indices.push_back( index );
+	}
+
+	return indices;
+}
+
+TEST( vertex_welder, shared_quad_corners )
+{
+	// A quad split into two triangles, all attributes shared per point (smooth, single UV shell)
+	std::vector<wmr::FaceVertexKey> stream = {
+		{ 0, 0, 0, 0 }, { 1, 1, 1, 1 }, { 2, 2, 2, 2 },
+		{ 0, 0, 0, 0 }, { 2, 2, 2, 2 }, { 3, 3, 3, 3 }
+	};
+
+	wmr::VertexWelder welder;
+	auto indices = WeldStream( welder, stream );
+
+	EXPECT_EQ( welder.GetUniqueVertexCount(), 4u );
+	EXPECT_EQ( indices, ( std::vector<std::uint32_t>{ 0, 1, 2, 0, 2, 3 } ) );
+}
+
+TEST( vertex_welder, split_on_any_attribute )
+{
+	// The same point referenced with a different normal, tangent, or UV must not be merged
+	std::vector<wmr::FaceVertexKey> stream = {
+		{ 0, 0, 0, 0 },
+		{ 0, 1, 0, 0 },
+		{ 0, 0, 1, 0 },
+		{ 0, 0, 0, 1 },
+		{ 0, 0, 0, 0 }
+	};
+
+	wmr::VertexWelder welder;
+	auto indices = WeldStream( welder, stream );
+
+	EXPECT_EQ( welder.GetUniqueVertexCount(), 4u );
+	EXPECT_EQ( indices.back(), 0u );
+}
+
+TEST( vertex_welder, smooth_grid_vertex_count )
+{
+	// A smooth, single UV shell grid of quads has exactly one vertex per grid point
+	const std::int32_t quads_x = 64;
+	const std::int32_t quads_y = 32;
+	const std::int32_t points_x = quads_x + 1;
+
+	std::vector<wmr::FaceVertexKey> stream;
+	for( std::int32_t y = 0; y < quads_y; ++y )
+	{
+		for( std::int32_t x = 0; x < quads_x; ++x )
+		{
+			std::int32_t p0 = y * points_x + x;
+			std::int32_t p1 = p0 + 1;
+			std::int32_t p2 = p0 + points_x + 1;
+			std::int32_t p3 = p0 + points_x;
+
+			for( auto p : { p0, p1, p2, p0, p2, p3 } )
+			{
+				stream.push_back( { p, p, p, p } );
+			}
+		}
+	}
+
+	wmr::VertexWelder welder;
+	welder.Reserve( points_x * ( quads_y + 1 ) );
+	auto indices = WeldStream( welder, stream );
+
+	EXPECT_EQ( welder.GetUniqueVertexCount(), static_cast<size_t>( points_x * ( quads_y + 1 ) ) );
+	EXPECT_EQ( indices.size(), stream.size() );
+
+	// Unwelded, every corner would have been its own vertex
+	EXPECT_LT( welder.GetUniqueVertexCount() * 5, stream.size() );
+}
+
+TEST( vertex_welder, hard_edged_cube_vertex_count )
+{
+	// A cube with per-face normals and UVs: 6 faces * 4 corners, points are shared between faces
+	const std::int32_t face_points[6][4] = {
+		{ 0, 1, 2, 3 }, { 4, 5, 6, 7 }, { 0, 1, 5, 4 },
+		{ 2, 3, 7, 6 }, { 0, 3, 7, 4 }, { 1, 2, 6, 5 }
+	};
+
+	std::vector<wmr::FaceVertexKey> stream;
+	for( std::int32_t face = 0; face < 6; ++face )
+	{
+		for( auto corner : { 0, 1, 2, 0, 2, 3 } )
+		{
+			stream.push_back( { face_points[face][corner], face, face, face * 4 + corner } );
+		}
+	}
+
+	wmr::VertexWelder welder;
+	WeldStream( welder, stream );
+
+	EXPECT_EQ( welder.GetUniqueVertexCount(), 24u );
+
+	welder.Clear();
+	EXPECT_EQ( welder.GetUniqueVertexCount(), 0u );
+}